@@ -3,12 +3,32 @@
  */
 #pragma once
 
+#include <memory>
+
 class Window;
+class JobSystem;
 
 class Application
 {
 public:
 
+    // How the application loop advances the game time.
+    enum LoopMode
+    {
+        // Update and render once per frame with the measured frame time (capped to the max time step).
+        VariableTimestep,
+        // Update with a constant time step as often as required to catch up with the real time,
+        // then render once. RenderEventArgs::Alpha is set to the fraction of a time step that
+        // has not been simulated yet.
+        FixedTimestep,
+        // Like VariableTimestep, but the update of the next frame runs on a worker thread while
+        // the current frame is rendered on the main thread. The game must keep the state that
+        // is rendered separate from the state that is updated (for example with a
+        // CameraSnapshotBuffer). Messages (input and resize events) are only dispatched while no
+        // update is running, but OnUpdate must not call functions of the window.
+        Pipelined,
+    };
+
     /**
      * Create the application singleton with the application instance handle.
      */
@@ -62,6 +82,29 @@ public:
      */
     void Quit(int exitCode = 0);
 
+    void set_LoopMode( LoopMode loopMode );
+    LoopMode get_LoopMode() const;
+
+    /**
+     * The duration (in seconds) of an update in FixedTimestep mode.
+     */
+    void set_FixedTimeStep( float timeStep );
+    float get_FixedTimeStep() const;
+
+    /**
+     * The maximum number of updates per frame in FixedTimestep mode. If the updates can't keep
+     * up with the real time, the remaining time is dropped so the application slows down instead
+     * of spending more and more time on updates.
+     */
+    void set_MaxUpdatesPerFrame( int maxUpdatesPerFrame );
+    int get_MaxUpdatesPerFrame() const;
+
+    /**
+     * The job system that runs jobs on all cores. The thread that created the
+     * application is worker 0 of the job system.
+     */
+    JobSystem& get_JobSystem();
+
 protected:
 
     // Create an application instance.
@@ -73,6 +116,12 @@ private:
     // The application instance handle that this application was created with.
     HINSTANCE m_hInstance;
 
+    LoopMode m_LoopMode;
+    float m_FixedTimeStep;
+    int m_MaxUpdatesPerFrame;
+
+    std::unique_ptr<JobSystem> m_JobSystem;
+
     // Return this invalid window when either an error occurs when creating a window
     // or the user asks for window by name but no window with that name exists.
     static Window ms_InvalidWindow;
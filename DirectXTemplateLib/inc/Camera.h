@@ -3,6 +3,8 @@
  */
 #pragma once
 
+struct CameraSnapshot;
+
 class Camera
 {
 public:
@@ -24,6 +26,17 @@ public:
         RightHanded
     };
 
+    // How the distance to the camera is mapped to the depth buffer.
+    enum DepthMode
+    {
+        // The near plane maps to a depth of 0 and the far plane to 1.
+        StandardDepth,
+        // The near plane maps to a depth of 1 and the far plane to 0. With a floating-point depth
+        // buffer, the precision of the float cancels out the non-linear distribution of the depth
+        // values, so the precision stays nearly constant over the whole depth range.
+        ReverseDepth,
+    };
+
     Camera(Handedness handedness = LeftHanded);
     virtual ~Camera();
 
@@ -45,6 +58,64 @@ public:
     DirectX::XMMATRIX get_ProjectionMatrix() const;
     DirectX::XMMATRIX get_InverseProjectionMatrix() const;
 
+    void set_DepthMode( DepthMode depthMode );
+    DepthMode get_DepthMode() const;
+
+    /**
+     * Move the far clipping plane to infinity. The far distance passed to set_Projection
+     * is ignored while this is enabled and the far frustum plane accepts everything.
+     */
+    void set_InfiniteFarPlane( bool infiniteFarPlane );
+    bool get_InfiniteFarPlane() const;
+
+    /**
+     * The value the depth buffer must be cleared to and the depth test that must be used
+     * for the current depth mode (1.0 and LESS for StandardDepth, 0.0 and GREATER for ReverseDepth).
+     */
+    float get_DepthClearValue() const;
+    D3D11_COMPARISON_FUNC get_DepthComparison() const;
+
+    /**
+     * The combined view and projection matrix (view * projection) and its inverse.
+     * Both are cached until the view or projection changes.
+     */
+    DirectX::XMMATRIX get_ViewProjectionMatrix() const;
+    DirectX::XMMATRIX get_InverseViewProjectionMatrix() const;
+
+    /**
+     * Compute the projected size (in pixels) of a sphere.
+     * This is the approximate height on the viewport of a sphere with the given 
+     * world-space position and radius. If the camera is inside the sphere,
+     * FLT_MAX is returned.
+     */
+    float XM_CALLCONV get_ProjectedSize( DirectX::FXMVECTOR position, float radius ) const;
+
+    // The order of the planes returned by get_FrustumPlanes and ExtractFrustumPlanes.
+    enum FrustumPlane
+    {
+        LeftPlane,
+        RightPlane,
+        BottomPlane,
+        TopPlane,
+        NearPlane,
+        FarPlane,
+        FrustumPlaneCount
+    };
+
+    /**
+     * Compute the world-space planes of the view frustum.
+     * The planes are normalized and their normals point into the frustum.
+     * They are cached with the view-projection matrix.
+     */
+    void get_FrustumPlanes( DirectX::XMVECTOR planes[FrustumPlaneCount] ) const;
+    /**
+     * Extract the planes of the view frustum from a combined (world-)view-projection matrix.
+     * The planes are expressed in the space that the matrix transforms from.
+     * The depth mode determines which of the depth planes is the near plane. Planes at infinity
+     * are replaced by a plane that contains every point.
+     */
+    static void XM_CALLCONV ExtractFrustumPlanes( DirectX::FXMMATRIX viewProjectionMatrix, DirectX::XMVECTOR planes[FrustumPlaneCount], DepthMode depthMode = StandardDepth );
+
     /**
      * Set the camera's position in world-space.
      */
@@ -65,11 +136,20 @@ public:
     void XM_CALLCONV Translate( DirectX::FXMVECTOR translation, Space space = LocalSpace );
     void Rotate( DirectX::FXMVECTOR quaternion );
 
+    /**
+     * Copy the current state of the camera (including all derived matrices and the frustum planes)
+     * into a snapshot that can be handed to other threads (see CameraSnapshotBuffer).
+     * The camera itself is not thread-safe because its matrices are updated lazily.
+     */
+    void get_Snapshot( CameraSnapshot& snapshot ) const;
+
 protected:
     virtual void UpdateViewMatrix() const;
     virtual void UpdateInverseViewMatrix() const;
     virtual void UpdateProjectionMatrix() const;
     virtual void UpdateInverseProjectionMatrix() const;
+    virtual void UpdateViewProjectionMatrix() const;
+    virtual void UpdateInverseViewProjectionMatrix() const;
 
     // This data must be aligned otherwise the SSE intrinsics fail
     // and throw exceptions.
@@ -83,6 +163,8 @@ protected:
 
         DirectX::XMMATRIX m_ViewMatrix, m_InverseViewMatrix;
         DirectX::XMMATRIX m_ProjectionMatrix, m_InverseProjectionMatrix;
+        DirectX::XMMATRIX m_ViewProjectionMatrix, m_InverseViewProjectionMatrix;
+        DirectX::XMVECTOR m_FrustumPlanes[FrustumPlaneCount];
     };
     AlignedData* pData;
 
@@ -92,12 +174,17 @@ protected:
     float m_zNear;      // Near clip distance
     float m_zFar;       // Far clip distance.
 
+    DepthMode m_DepthMode;
+    bool m_InfiniteFarPlane;
+
     D3D11_VIEWPORT m_Viewport;
 
     // True if the view matrix needs to be updated.
     mutable bool m_ViewDirty, m_InverseViewDirty;
     // True if the projection matrix needs to be updated.
     mutable bool m_ProjectionDirty, m_InverseProjectionDirty;
+    // True if the view-projection matrix (and the frustum planes) need to be updated.
+    mutable bool m_ViewProjectionDirty, m_InverseViewProjectionDirty;
 
     Handedness m_Handedness;
 
@@ -0,0 +1,141 @@
+/**
+ *   @brief Record the movement of a camera and play it back for reproducible benchmarks.
+ */
+#pragma once
+
+#include <Camera.h>
+
+// A sample of the camera's position and orientation. This is also the layout of the keys in a camera path file.
+struct CameraPathKey
+{
+    // The time (in seconds) since the start of the path.
+    float Time;
+    DirectX::XMFLOAT3 Position;
+    // Rotation quaternion.
+    DirectX::XMFLOAT4 Rotation;
+};
+
+// The header of a camera path file. It is followed by KeyCount CameraPathKey structures.
+struct CameraPathFileHeader
+{
+    static const uint32_t FileMagic = 0x48545043; // 'CPTH'
+    static const uint32_t FileVersion = 1;
+
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t KeyCount;
+    uint32_t Reserved;
+};
+
+/**
+ * A sequence of camera keys that is interpolated with a Catmull-Rom spline for the
+ * position and a squad (spherical quadrangle) spline for the rotation.
+ */
+class CameraPath
+{
+public:
+    CameraPath();
+
+    void Clear();
+
+    /**
+     * Append a key to the end of the path. The time must not be less than the time of the last key.
+     * The sign of the quaternion is adjusted so consecutive rotations are interpolated along the shortest arc.
+     */
+    void XM_CALLCONV AddKey( float time, DirectX::FXMVECTOR position, DirectX::FXMVECTOR rotation );
+
+    size_t get_KeyCount() const;
+    const CameraPathKey& get_Key( size_t index ) const;
+
+    /**
+     * The time of the last key.
+     */
+    float get_Duration() const;
+
+    /**
+     * Interpolate the position and rotation at the given time. Times outside of the
+     * path are clamped to the first and last key. The path must contain at least one key.
+     */
+    void Evaluate( float time, DirectX::XMVECTOR& position, DirectX::XMVECTOR& rotation ) const;
+
+    /**
+     * Save the path to a binary camera path file or load it from one.
+     * These functions throw a std::exception if the file can't be written or read.
+     */
+    void Save( const std::wstring& fileName ) const;
+    void Load( const std::wstring& fileName );
+
+private:
+    std::vector<CameraPathKey> m_Keys;
+};
+
+/**
+ * Samples the position and rotation of a camera while the camera is moved by the user.
+ */
+class CameraPathRecorder
+{
+public:
+    /**
+     * @param sampleInterval The minimum time (in seconds) between two keys. If this is 0, a key is recorded for every update.
+     */
+    CameraPathRecorder( float sampleInterval = 1.0f / 30.0f );
+
+    /**
+     * Clear the path and start recording.
+     */
+    void Start();
+    /**
+     * Stop recording. The last state of the camera is always added to the path.
+     */
+    void Stop( const Camera& camera );
+    bool IsRecording() const;
+
+    /**
+     * Advance the recording time and sample the camera if the sample interval has passed.
+     * Call this once per update after the camera has been moved.
+     */
+    void Record( const Camera& camera, float elapsedTime );
+
+    const CameraPath& get_Path() const;
+
+private:
+    CameraPath m_Path;
+    float m_SampleInterval;
+    float m_Time;
+    // The time of the last key (negative if no key has been recorded yet).
+    float m_LastKeyTime;
+    bool m_IsRecording;
+};
+
+/**
+ * Moves a camera along a CameraPath.
+ */
+class CameraPathPlayer
+{
+public:
+    CameraPathPlayer();
+
+    /**
+     * Start playing the path from the beginning. The path must remain valid while it is playing.
+     * @param loop Restart the path when the end is reached.
+     */
+    void Play( const CameraPath& path, bool loop = false );
+    void Stop();
+    bool IsPlaying() const;
+
+    /**
+     * Advance the playback time and move the camera to the interpolated key.
+     * @returns false if the end of the path was reached (and the path is not looping).
+     */
+    bool Update( Camera& camera, float elapsedTime );
+
+    /**
+     * The playback time in seconds.
+     */
+    float get_Time() const;
+
+private:
+    const CameraPath* m_Path;
+    float m_Time;
+    bool m_Loop;
+};
\ No newline at end of file
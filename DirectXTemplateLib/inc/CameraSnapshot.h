@@ -0,0 +1,93 @@
+/**
+ *   @brief An immutable copy of the state of a camera that can be shared between threads.
+ */
+#pragma once
+
+#include <Camera.h>
+#include <atomic>
+
+/**
+ * The state of a camera at the time it was captured with Camera::get_Snapshot.
+ * The matrices are stored in unaligned types so snapshots can be copied and
+ * stored anywhere (load them with XMLoadFloat4x4 before use).
+ */
+struct CameraSnapshot
+{
+    // The number of the publication this snapshot belongs to (see CameraSnapshotBuffer).
+    uint64_t Version;
+
+    DirectX::XMFLOAT4X4 ViewMatrix;
+    DirectX::XMFLOAT4X4 InverseViewMatrix;
+    DirectX::XMFLOAT4X4 ProjectionMatrix;
+    DirectX::XMFLOAT4X4 ViewProjectionMatrix;
+    DirectX::XMFLOAT4X4 InverseViewProjectionMatrix;
+
+    // World-space frustum planes in the order of Camera::FrustumPlane.
+    DirectX::XMFLOAT4 FrustumPlanes[Camera::FrustumPlaneCount];
+
+    // World-space position and rotation quaternion of the camera.
+    DirectX::XMFLOAT4 Translation;
+    DirectX::XMFLOAT4 Rotation;
+
+    D3D11_VIEWPORT Viewport;
+    // Vertical field of view in degrees.
+    float FieldOfView;
+    float AspectRatio;
+    float NearClipDistance;
+    // FLT_MAX if the camera uses an infinite far plane.
+    float FarClipDistance;
+    Camera::DepthMode DepthMode;
+
+    /**
+     * Load the frustum planes (for example for FrustumCuller::Cull).
+     */
+    void get_FrustumPlanes( DirectX::XMVECTOR planes[Camera::FrustumPlaneCount] ) const;
+};
+
+/**
+ * Publishes camera snapshots from one thread (usually the update thread) to any number of
+ * reader threads (for example render or culling threads) without locks.
+ * The snapshots are double-buffered: the writer always fills the buffer that readers are
+ * not expected to read, and each buffer is protected by a sequence counter so readers can
+ * detect (and retry) the rare case where a buffer is overwritten while it is being copied.
+ * Publish must only be called from a single thread at a time.
+ */
+class CameraSnapshotBuffer
+{
+public:
+    CameraSnapshotBuffer();
+
+    /**
+     * Capture the state of the camera and make it the current snapshot.
+     * @returns The version of the published snapshot.
+     */
+    uint64_t Publish( const Camera& camera );
+
+    /**
+     * Copy the most recently published snapshot.
+     * @returns false if no snapshot has been published yet.
+     */
+    bool Read( CameraSnapshot& snapshot ) const;
+
+    /**
+     * The version of the most recently published snapshot (0 if none was published).
+     * Readers can compare this to the version of their last snapshot to skip redundant reads.
+     */
+    uint64_t get_Version() const;
+
+private:
+    struct Buffer
+    {
+        // Odd while the snapshot is being written.
+        std::atomic<uint64_t> Sequence;
+        CameraSnapshot Snapshot;
+    };
+
+    Buffer m_Buffers[2];
+    // The latest version. It is stored in buffer ( version & 1 ).
+    std::atomic<uint64_t> m_Version;
+
+    // Prevent copying.
+    CameraSnapshotBuffer( const CameraSnapshotBuffer& );
+    CameraSnapshotBuffer& operator=( const CameraSnapshotBuffer& );
+};
\ No newline at end of file
@@ -0,0 +1,93 @@
+/**
+ *   @brief A large dynamic constant buffer that the constants of all draws of a frame are written to.
+ */
+#pragma once
+
+#include <RingBufferAllocator.h>
+
+#include <memory>
+
+/**
+ * Replaces many small constant buffers that are updated with UpdateSubresource before every
+ * draw. The constants of a frame are written to ranges of a single dynamic buffer that is
+ * mapped with D3D11_MAP_WRITE_NO_OVERWRITE (or D3D11_MAP_WRITE_DISCARD when the ring is full)
+ * and the ranges are bound with the constant buffer offsets of ID3D11DeviceContext1.
+ *
+ * The ranges of a frame are in use until the GPU has finished the frame. This is tracked with
+ * an event query per frame. Requires a device that supports constant buffer offsetting and
+ * D3D11_MAP_WRITE_NO_OVERWRITE on dynamic constant buffers (Direct3D 11.1).
+ */
+class ConstantBufferRing
+{
+public:
+    // Constant buffer offsets are specified in multiples of 16 constants (256 bytes).
+    static const UINT Alignment = 256;
+
+    ConstantBufferRing();
+    ~ConstantBufferRing();
+
+    /**
+     * Create the buffer.
+     * @param capacity The size of the buffer in bytes.
+     * @returns false if the buffer could not be created or the device does not support constant buffer offsetting.
+     */
+    bool Initialize( ID3D11Device* device, UINT capacity );
+
+    /**
+     * Release the ranges of the frames that the GPU has finished.
+     */
+    void BeginFrame( ID3D11DeviceContext* deviceContext );
+    /**
+     * The ranges that were mapped since BeginFrame are in use until the GPU has finished the frame.
+     */
+    void EndFrame( ID3D11DeviceContext* deviceContext );
+
+    /**
+     * Allocate a range of the buffer and map it for writing. Write all constants of the
+     * frame with as few maps as possible, for example one range for all draws.
+     * @param size The size of the range in bytes.
+     * @param offset The offset of the range in bytes (a multiple of Alignment).
+     * @returns A pointer to the range or nullptr if the range could not be mapped.
+     */
+    void* Map( ID3D11DeviceContext* deviceContext, UINT size, UINT& offset );
+    void Unmap( ID3D11DeviceContext* deviceContext );
+
+    /**
+     * Bind a part of the buffer to a constant buffer slot of the vertex or pixel shader.
+     * @param offset The offset of the constants in bytes (a multiple of Alignment).
+     * @param size The size of the constants in bytes.
+     */
+    void VSSetConstantBuffer( ID3D11DeviceContext1* deviceContext, UINT slot, UINT offset, UINT size ) const;
+    void PSSetConstantBuffer( ID3D11DeviceContext1* deviceContext, UINT slot, UINT offset, UINT size ) const;
+
+    /**
+     * Round a size up to a multiple of Alignment.
+     */
+    static UINT get_AlignedSize( UINT size );
+
+    ID3D11Buffer* get_Buffer() const;
+    const RingBufferAllocator& get_Allocator() const;
+
+private:
+    // Prevent copying.
+    ConstantBufferRing( const ConstantBufferRing& copy );
+    ConstantBufferRing& operator=( const ConstantBufferRing& other );
+
+    struct PendingFrame
+    {
+        Microsoft::WRL::ComPtr<ID3D11Query> Query;
+        uint64_t FenceValue;
+    };
+
+    Microsoft::WRL::ComPtr<ID3D11Device> m_d3dDevice;
+    Microsoft::WRL::ComPtr<ID3D11Buffer> m_d3dBuffer;
+
+    std::unique_ptr<RingBufferAllocator> m_Allocator;
+    // The buffer must be discarded when it is mapped for the first time.
+    bool m_bMapped;
+
+    // The frames that the GPU has not finished and the queries that can be reused.
+    std::deque<PendingFrame> m_PendingFrames;
+    std::vector<Microsoft::WRL::ComPtr<ID3D11Query>> m_FreeQueries;
+    uint64_t m_NextFenceValue;
+};
\ No newline at end of file
@@ -0,0 +1,355 @@
+/**
+ *   @brief A device context that forwards all calls to another device context.
+ */
+#pragma once
+
+#include <map>
+
+/**
+ * Implements ID3D11DeviceContext1 by forwarding every call to a wrapped device context.
+ * Every call of a device context method is reported to OnCall first, so derived classes
+ * can count, filter or log the calls that a demo issues.
+ *
+ * Without a wrapped device context the calls are only reported: set calls are ignored,
+ * get calls return null interfaces and zero values and buffers are mapped to CPU memory.
+ * This makes it possible to run rendering code without a GPU.
+ *
+ * The wrapper is a COM object. It is created with a reference count of 1, so attach it to
+ * a ComPtr (ComPtr::Attach) instead of assigning it.
+ */
+class DeviceContextWrapper : public ID3D11DeviceContext1
+{
+public:
+    /**
+     * The methods of ID3D11DeviceContext1 that are reported to OnCall.
+     */
+    enum Call
+    {
+        // Pipeline state.
+        IASetInputLayoutCall,
+        IASetVertexBuffersCall,
+        IASetIndexBufferCall,
+        IASetPrimitiveTopologyCall,
+        VSSetShaderCall,
+        VSSetConstantBuffersCall,
+        VSSetConstantBuffers1Call,
+        VSSetShaderResourcesCall,
+        VSSetSamplersCall,
+        HSSetShaderCall,
+        HSSetConstantBuffersCall,
+        HSSetConstantBuffers1Call,
+        HSSetShaderResourcesCall,
+        HSSetSamplersCall,
+        DSSetShaderCall,
+        DSSetConstantBuffersCall,
+        DSSetConstantBuffers1Call,
+        DSSetShaderResourcesCall,
+        DSSetSamplersCall,
+        GSSetShaderCall,
+        GSSetConstantBuffersCall,
+        GSSetConstantBuffers1Call,
+        GSSetShaderResourcesCall,
+        GSSetSamplersCall,
+        PSSetShaderCall,
+        PSSetConstantBuffersCall,
+        PSSetConstantBuffers1Call,
+        PSSetShaderResourcesCall,
+        PSSetSamplersCall,
+        CSSetShaderCall,
+        CSSetConstantBuffersCall,
+        CSSetConstantBuffers1Call,
+        CSSetShaderResourcesCall,
+        CSSetSamplersCall,
+        CSSetUnorderedAccessViewsCall,
+        SOSetTargetsCall,
+        RSSetStateCall,
+        RSSetViewportsCall,
+        RSSetScissorRectsCall,
+        OMSetRenderTargetsCall,
+        OMSetRenderTargetsAndUnorderedAccessViewsCall,
+        OMSetBlendStateCall,
+        OMSetDepthStencilStateCall,
+        SetPredicationCall,
+
+        // Draw and dispatch.
+        DrawCall,
+        DrawIndexedCall,
+        DrawInstancedCall,
+        DrawIndexedInstancedCall,
+        DrawAutoCall,
+        DrawInstancedIndirectCall,
+        DrawIndexedInstancedIndirectCall,
+        DispatchCall,
+        DispatchIndirectCall,
+
+        // Resources.
+        MapCall,
+        UnmapCall,
+        UpdateSubresourceCall,
+        UpdateSubresource1Call,
+        CopyResourceCall,
+        CopySubresourceRegionCall,
+        CopySubresourceRegion1Call,
+        CopyStructureCountCall,
+        ResolveSubresourceCall,
+        ClearRenderTargetViewCall,
+        ClearDepthStencilViewCall,
+        ClearUnorderedAccessViewUintCall,
+        ClearUnorderedAccessViewFloatCall,
+        ClearViewCall,
+        DiscardResourceCall,
+        DiscardViewCall,
+        DiscardView1Call,
+        GenerateMipsCall,
+        SetResourceMinLODCall,
+        GetResourceMinLODCall,
+
+        // Queries.
+        BeginCall,
+        EndCall,
+        GetDataCall,
+
+        // Pipeline state queries.
+        IAGetInputLayoutCall,
+        IAGetVertexBuffersCall,
+        IAGetIndexBufferCall,
+        IAGetPrimitiveTopologyCall,
+        VSGetShaderCall,
+        VSGetConstantBuffersCall,
+        VSGetConstantBuffers1Call,
+        VSGetShaderResourcesCall,
+        VSGetSamplersCall,
+        HSGetShaderCall,
+        HSGetConstantBuffersCall,
+        HSGetConstantBuffers1Call,
+        HSGetShaderResourcesCall,
+        HSGetSamplersCall,
+        DSGetShaderCall,
+        DSGetConstantBuffersCall,
+        DSGetConstantBuffers1Call,
+        DSGetShaderResourcesCall,
+        DSGetSamplersCall,
+        GSGetShaderCall,
+        GSGetConstantBuffersCall,
+        GSGetConstantBuffers1Call,
+        GSGetShaderResourcesCall,
+        GSGetSamplersCall,
+        PSGetShaderCall,
+        PSGetConstantBuffersCall,
+        PSGetConstantBuffers1Call,
+        PSGetShaderResourcesCall,
+        PSGetSamplersCall,
+        CSGetShaderCall,
+        CSGetConstantBuffersCall,
+        CSGetConstantBuffers1Call,
+        CSGetShaderResourcesCall,
+        CSGetSamplersCall,
+        CSGetUnorderedAccessViewsCall,
+        SOGetTargetsCall,
+        RSGetStateCall,
+        RSGetViewportsCall,
+        RSGetScissorRectsCall,
+        OMGetRenderTargetsCall,
+        OMGetRenderTargetsAndUnorderedAccessViewsCall,
+        OMGetBlendStateCall,
+        OMGetDepthStencilStateCall,
+        GetPredicationCall,
+
+        // Device context.
+        ClearStateCall,
+        FlushCall,
+        ExecuteCommandListCall,
+        FinishCommandListCall,
+        GetTypeCall,
+        GetContextFlagsCall,
+        SwapDeviceContextStateCall,
+        CallCount
+    };
+
+    /**
+     * @param context The device context to forward the calls to (can be nullptr).
+     */
+    explicit DeviceContextWrapper( ID3D11DeviceContext* context = nullptr );
+    virtual ~DeviceContextWrapper();
+
+    /**
+     * The wrapped device context or nullptr if the calls are not forwarded.
+     */
+    ID3D11DeviceContext* get_Context() const;
+
+    /**
+     * The name of a device context method.
+     */
+    static const char* get_CallName( Call call );
+
+    // IUnknown
+    virtual HRESULT STDMETHODCALLTYPE QueryInterface( REFIID riid, void** ppvObject );
+    virtual ULONG STDMETHODCALLTYPE AddRef();
+    virtual ULONG STDMETHODCALLTYPE Release();
+
+    // ID3D11DeviceChild
+    virtual void STDMETHODCALLTYPE GetDevice( ID3D11Device** ppDevice );
+    virtual HRESULT STDMETHODCALLTYPE GetPrivateData( REFGUID guid, UINT* pDataSize, void* pData );
+    virtual HRESULT STDMETHODCALLTYPE SetPrivateData( REFGUID guid, UINT DataSize, const void* pData );
+    virtual HRESULT STDMETHODCALLTYPE SetPrivateDataInterface( REFGUID guid, const IUnknown* pData );
+
+    // ID3D11DeviceContext and ID3D11DeviceContext1
+
+    // Pipeline state.
+    virtual void STDMETHODCALLTYPE IASetInputLayout( ID3D11InputLayout* pInputLayout );
+    virtual void STDMETHODCALLTYPE IASetVertexBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppVertexBuffers, const UINT* pStrides, const UINT* pOffsets );
+    virtual void STDMETHODCALLTYPE IASetIndexBuffer( ID3D11Buffer* pIndexBuffer, DXGI_FORMAT Format, UINT Offset );
+    virtual void STDMETHODCALLTYPE IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY Topology );
+    virtual void STDMETHODCALLTYPE VSSetShader( ID3D11VertexShader* pVertexShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances );
+    virtual void STDMETHODCALLTYPE VSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers );
+    virtual void STDMETHODCALLTYPE VSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants );
+    virtual void STDMETHODCALLTYPE VSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews );
+    virtual void STDMETHODCALLTYPE VSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers );
+    virtual void STDMETHODCALLTYPE HSSetShader( ID3D11HullShader* pHullShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances );
+    virtual void STDMETHODCALLTYPE HSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers );
+    virtual void STDMETHODCALLTYPE HSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants );
+    virtual void STDMETHODCALLTYPE HSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews );
+    virtual void STDMETHODCALLTYPE HSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers );
+    virtual void STDMETHODCALLTYPE DSSetShader( ID3D11DomainShader* pDomainShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances );
+    virtual void STDMETHODCALLTYPE DSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers );
+    virtual void STDMETHODCALLTYPE DSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants );
+    virtual void STDMETHODCALLTYPE DSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews );
+    virtual void STDMETHODCALLTYPE DSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers );
+    virtual void STDMETHODCALLTYPE GSSetShader( ID3D11GeometryShader* pGeometryShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances );
+    virtual void STDMETHODCALLTYPE GSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers );
+    virtual void STDMETHODCALLTYPE GSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants );
+    virtual void STDMETHODCALLTYPE GSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews );
+    virtual void STDMETHODCALLTYPE GSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers );
+    virtual void STDMETHODCALLTYPE PSSetShader( ID3D11PixelShader* pPixelShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances );
+    virtual void STDMETHODCALLTYPE PSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers );
+    virtual void STDMETHODCALLTYPE PSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants );
+    virtual void STDMETHODCALLTYPE PSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews );
+    virtual void STDMETHODCALLTYPE PSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers );
+    virtual void STDMETHODCALLTYPE CSSetShader( ID3D11ComputeShader* pComputeShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances );
+    virtual void STDMETHODCALLTYPE CSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers );
+    virtual void STDMETHODCALLTYPE CSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants );
+    virtual void STDMETHODCALLTYPE CSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews );
+    virtual void STDMETHODCALLTYPE CSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers );
+    virtual void STDMETHODCALLTYPE CSSetUnorderedAccessViews( UINT StartSlot, UINT NumUAVs, ID3D11UnorderedAccessView* const* ppUnorderedAccessViews, const UINT* pUAVInitialCounts );
+    virtual void STDMETHODCALLTYPE SOSetTargets( UINT NumBuffers, ID3D11Buffer* const* ppSOTargets, const UINT* pOffsets );
+    virtual void STDMETHODCALLTYPE RSSetState( ID3D11RasterizerState* pRasterizerState );
+    virtual void STDMETHODCALLTYPE RSSetViewports( UINT NumViewports, const D3D11_VIEWPORT* pViewports );
+    virtual void STDMETHODCALLTYPE RSSetScissorRects( UINT NumRects, const D3D11_RECT* pRects );
+    virtual void STDMETHODCALLTYPE OMSetRenderTargets( UINT NumViews, ID3D11RenderTargetView* const* ppRenderTargetViews, ID3D11DepthStencilView* pDepthStencilView );
+    virtual void STDMETHODCALLTYPE OMSetRenderTargetsAndUnorderedAccessViews( UINT NumRTVs, ID3D11RenderTargetView* const* ppRenderTargetViews, ID3D11DepthStencilView* pDepthStencilView, UINT UAVStartSlot, UINT NumUAVs, ID3D11UnorderedAccessView* const* ppUnorderedAccessViews, const UINT* pUAVInitialCounts );
+    virtual void STDMETHODCALLTYPE OMSetBlendState( ID3D11BlendState* pBlendState, const FLOAT BlendFactor[4], UINT SampleMask );
+    virtual void STDMETHODCALLTYPE OMSetDepthStencilState( ID3D11DepthStencilState* pDepthStencilState, UINT StencilRef );
+    virtual void STDMETHODCALLTYPE SetPredication( ID3D11Predicate* pPredicate, BOOL PredicateValue );
+
+    // Draw and dispatch.
+    virtual void STDMETHODCALLTYPE Draw( UINT VertexCount, UINT StartVertexLocation );
+    virtual void STDMETHODCALLTYPE DrawIndexed( UINT IndexCount, UINT StartIndexLocation, INT BaseVertexLocation );
+    virtual void STDMETHODCALLTYPE DrawInstanced( UINT VertexCountPerInstance, UINT InstanceCount, UINT StartVertexLocation, UINT StartInstanceLocation );
+    virtual void STDMETHODCALLTYPE DrawIndexedInstanced( UINT IndexCountPerInstance, UINT InstanceCount, UINT StartIndexLocation, INT BaseVertexLocation, UINT StartInstanceLocation );
+    virtual void STDMETHODCALLTYPE DrawAuto();
+    virtual void STDMETHODCALLTYPE DrawInstancedIndirect( ID3D11Buffer* pBufferForArgs, UINT AlignedByteOffsetForArgs );
+    virtual void STDMETHODCALLTYPE DrawIndexedInstancedIndirect( ID3D11Buffer* pBufferForArgs, UINT AlignedByteOffsetForArgs );
+    virtual void STDMETHODCALLTYPE Dispatch( UINT ThreadGroupCountX, UINT ThreadGroupCountY, UINT ThreadGroupCountZ );
+    virtual void STDMETHODCALLTYPE DispatchIndirect( ID3D11Buffer* pBufferForArgs, UINT AlignedByteOffsetForArgs );
+
+    // Resources.
+    virtual HRESULT STDMETHODCALLTYPE Map( ID3D11Resource* pResource, UINT Subresource, D3D11_MAP MapType, UINT MapFlags, D3D11_MAPPED_SUBRESOURCE* pMappedResource );
+    virtual void STDMETHODCALLTYPE Unmap( ID3D11Resource* pResource, UINT Subresource );
+    virtual void STDMETHODCALLTYPE UpdateSubresource( ID3D11Resource* pDstResource, UINT DstSubresource, const D3D11_BOX* pDstBox, const void* pSrcData, UINT SrcRowPitch, UINT SrcDepthPitch );
+    virtual void STDMETHODCALLTYPE UpdateSubresource1( ID3D11Resource* pDstResource, UINT DstSubresource, const D3D11_BOX* pDstBox, const void* pSrcData, UINT SrcRowPitch, UINT SrcDepthPitch, UINT CopyFlags );
+    virtual void STDMETHODCALLTYPE CopyResource( ID3D11Resource* pDstResource, ID3D11Resource* pSrcResource );
+    virtual void STDMETHODCALLTYPE CopySubresourceRegion( ID3D11Resource* pDstResource, UINT DstSubresource, UINT DstX, UINT DstY, UINT DstZ, ID3D11Resource* pSrcResource, UINT SrcSubresource, const D3D11_BOX* pSrcBox );
+    virtual void STDMETHODCALLTYPE CopySubresourceRegion1( ID3D11Resource* pDstResource, UINT DstSubresource, UINT DstX, UINT DstY, UINT DstZ, ID3D11Resource* pSrcResource, UINT SrcSubresource, const D3D11_BOX* pSrcBox, UINT CopyFlags );
+    virtual void STDMETHODCALLTYPE CopyStructureCount( ID3D11Buffer* pDstBuffer, UINT DstAlignedByteOffset, ID3D11UnorderedAccessView* pSrcView );
+    virtual void STDMETHODCALLTYPE ResolveSubresource( ID3D11Resource* pDstResource, UINT DstSubresource, ID3D11Resource* pSrcResource, UINT SrcSubresource, DXGI_FORMAT Format );
+    virtual void STDMETHODCALLTYPE ClearRenderTargetView( ID3D11RenderTargetView* pRenderTargetView, const FLOAT ColorRGBA[4] );
+    virtual void STDMETHODCALLTYPE ClearDepthStencilView( ID3D11DepthStencilView* pDepthStencilView, UINT ClearFlags, FLOAT Depth, UINT8 Stencil );
+    virtual void STDMETHODCALLTYPE ClearUnorderedAccessViewUint( ID3D11UnorderedAccessView* pUnorderedAccessView, const UINT Values[4] );
+    virtual void STDMETHODCALLTYPE ClearUnorderedAccessViewFloat( ID3D11UnorderedAccessView* pUnorderedAccessView, const FLOAT Values[4] );
+    virtual void STDMETHODCALLTYPE ClearView( ID3D11View* pView, const FLOAT Color[4], const D3D11_RECT* pRect, UINT NumRects );
+    virtual void STDMETHODCALLTYPE DiscardResource( ID3D11Resource* pResource );
+    virtual void STDMETHODCALLTYPE DiscardView( ID3D11View* pResourceView );
+    virtual void STDMETHODCALLTYPE DiscardView1( ID3D11View* pResourceView, const D3D11_RECT* pRects, UINT NumRects );
+    virtual void STDMETHODCALLTYPE GenerateMips( ID3D11ShaderResourceView* pShaderResourceView );
+    virtual void STDMETHODCALLTYPE SetResourceMinLOD( ID3D11Resource* pResource, FLOAT MinLOD );
+    virtual FLOAT STDMETHODCALLTYPE GetResourceMinLOD( ID3D11Resource* pResource );
+
+    // Queries.
+    virtual void STDMETHODCALLTYPE Begin( ID3D11Asynchronous* pAsync );
+    virtual void STDMETHODCALLTYPE End( ID3D11Asynchronous* pAsync );
+    virtual HRESULT STDMETHODCALLTYPE GetData( ID3D11Asynchronous* pAsync, void* pData, UINT DataSize, UINT GetDataFlags );
+
+    // Pipeline state queries.
+    virtual void STDMETHODCALLTYPE IAGetInputLayout( ID3D11InputLayout** ppInputLayout );
+    virtual void STDMETHODCALLTYPE IAGetVertexBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppVertexBuffers, UINT* pStrides, UINT* pOffsets );
+    virtual void STDMETHODCALLTYPE IAGetIndexBuffer( ID3D11Buffer** pIndexBuffer, DXGI_FORMAT* Format, UINT* Offset );
+    virtual void STDMETHODCALLTYPE IAGetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY* pTopology );
+    virtual void STDMETHODCALLTYPE VSGetShader( ID3D11VertexShader** ppVertexShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances );
+    virtual void STDMETHODCALLTYPE VSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers );
+    virtual void STDMETHODCALLTYPE VSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants );
+    virtual void STDMETHODCALLTYPE VSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews );
+    virtual void STDMETHODCALLTYPE VSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers );
+    virtual void STDMETHODCALLTYPE HSGetShader( ID3D11HullShader** ppHullShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances );
+    virtual void STDMETHODCALLTYPE HSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers );
+    virtual void STDMETHODCALLTYPE HSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants );
+    virtual void STDMETHODCALLTYPE HSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews );
+    virtual void STDMETHODCALLTYPE HSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers );
+    virtual void STDMETHODCALLTYPE DSGetShader( ID3D11DomainShader** ppDomainShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances );
+    virtual void STDMETHODCALLTYPE DSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers );
+    virtual void STDMETHODCALLTYPE DSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants );
+    virtual void STDMETHODCALLTYPE DSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews );
+    virtual void STDMETHODCALLTYPE DSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers );
+    virtual void STDMETHODCALLTYPE GSGetShader( ID3D11GeometryShader** ppGeometryShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances );
+    virtual void STDMETHODCALLTYPE GSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers );
+    virtual void STDMETHODCALLTYPE GSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants );
+    virtual void STDMETHODCALLTYPE GSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews );
+    virtual void STDMETHODCALLTYPE GSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers );
+    virtual void STDMETHODCALLTYPE PSGetShader( ID3D11PixelShader** ppPixelShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances );
+    virtual void STDMETHODCALLTYPE PSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers );
+    virtual void STDMETHODCALLTYPE PSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants );
+    virtual void STDMETHODCALLTYPE PSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews );
+    virtual void STDMETHODCALLTYPE PSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers );
+    virtual void STDMETHODCALLTYPE CSGetShader( ID3D11ComputeShader** ppComputeShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances );
+    virtual void STDMETHODCALLTYPE CSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers );
+    virtual void STDMETHODCALLTYPE CSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants );
+    virtual void STDMETHODCALLTYPE CSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews );
+    virtual void STDMETHODCALLTYPE CSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers );
+    virtual void STDMETHODCALLTYPE CSGetUnorderedAccessViews( UINT StartSlot, UINT NumUAVs, ID3D11UnorderedAccessView** ppUnorderedAccessViews );
+    virtual void STDMETHODCALLTYPE SOGetTargets( UINT NumBuffers, ID3D11Buffer** ppSOTargets );
+    virtual void STDMETHODCALLTYPE RSGetState( ID3D11RasterizerState** ppRasterizerState );
+    virtual void STDMETHODCALLTYPE RSGetViewports( UINT* pNumViewports, D3D11_VIEWPORT* pViewports );
+    virtual void STDMETHODCALLTYPE RSGetScissorRects( UINT* pNumRects, D3D11_RECT* pRects );
+    virtual void STDMETHODCALLTYPE OMGetRenderTargets( UINT NumViews, ID3D11RenderTargetView** ppRenderTargetViews, ID3D11DepthStencilView** ppDepthStencilView );
+    virtual void STDMETHODCALLTYPE OMGetRenderTargetsAndUnorderedAccessViews( UINT NumRTVs, ID3D11RenderTargetView** ppRenderTargetViews, ID3D11DepthStencilView** ppDepthStencilView, UINT UAVStartSlot, UINT NumUAVs, ID3D11UnorderedAccessView** ppUnorderedAccessViews );
+    virtual void STDMETHODCALLTYPE OMGetBlendState( ID3D11BlendState** ppBlendState, FLOAT BlendFactor[4], UINT* pSampleMask );
+    virtual void STDMETHODCALLTYPE OMGetDepthStencilState( ID3D11DepthStencilState** ppDepthStencilState, UINT* pStencilRef );
+    virtual void STDMETHODCALLTYPE GetPredication( ID3D11Predicate** ppPredicate, BOOL* pPredicateValue );
+
+    // Device context.
+    virtual void STDMETHODCALLTYPE ClearState();
+    virtual void STDMETHODCALLTYPE Flush();
+    virtual void STDMETHODCALLTYPE ExecuteCommandList( ID3D11CommandList* pCommandList, BOOL RestoreContextState );
+    virtual HRESULT STDMETHODCALLTYPE FinishCommandList( BOOL RestoreDeferredContextState, ID3D11CommandList** ppCommandList );
+    virtual D3D11_DEVICE_CONTEXT_TYPE STDMETHODCALLTYPE GetType();
+    virtual UINT STDMETHODCALLTYPE GetContextFlags();
+    virtual void STDMETHODCALLTYPE SwapDeviceContextState( ID3DDeviceContextState* pState, ID3DDeviceContextState** ppPreviousState );
+protected:
+    /**
+     * Invoked before a device context method is forwarded to the wrapped device context.
+     */
+    virtual void OnCall( Call call );
+
+private:
+    // Prevent copying.
+    DeviceContextWrapper( const DeviceContextWrapper& copy );
+    DeviceContextWrapper& operator=( const DeviceContextWrapper& other );
+
+    volatile LONG m_ReferenceCount;
+
+    Microsoft::WRL::ComPtr<ID3D11DeviceContext> m_Context;
+    // nullptr if the wrapped device context does not support ID3D11DeviceContext1.
+    Microsoft::WRL::ComPtr<ID3D11DeviceContext1> m_Context1;
+
+    // The CPU memory that buffers are mapped to if there is no wrapped device context.
+    std::map<ID3D11Resource*, std::vector<uint8_t>> m_MappedData;
+};
\ No newline at end of file
@@ -1,4 +1,6 @@
 // System includes
+// Prevent windows.h from defining the min and max macros, which break std::min and std::max.
+#define NOMINMAX
 #include <windows.h>
 // Windows Runtime Template Library
 #include <wrl.h>
@@ -8,6 +10,8 @@
 #include <d3dcompiler.h>
 #include <DirectXMath.h>
 #include <DirectXColors.h>
+#include <DirectXPackedVector.h>
+#include <DirectXCollision.h>
 
 // Declare the XM_CALLCONV macro if we are using an old version of the DirectX Math library.
 // For more information about DirecX Math Library internals, see http://msdn.microsoft.com/en-us/library/windows/desktop/ee418728(v=vs.85).aspx
@@ -22,8 +26,12 @@ typedef const DirectX::XMMATRIX& FXMMATRIX;
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <algorithm>
 
+// Parallel Patterns Library
+#include <ppl.h>
+
 // Link library dependencies
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "dxgi.lib")
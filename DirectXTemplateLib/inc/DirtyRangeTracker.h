@@ -0,0 +1,51 @@
+/**
+ *   @brief Tracks the ranges of elements that have changed since the last upload.
+ *   The tracker does not access a resource, so it can be used (and tested) without a device.
+ */
+#pragma once
+
+#include <vector>
+
+class DirtyRangeTracker
+{
+public:
+    // A range of elements [Begin, End).
+    struct Range
+    {
+        UINT Begin;
+        UINT End;
+    };
+
+    /**
+     * @param mergeDistance Ranges with a gap of up to this many clean elements are merged,
+     * so a few scattered changes are uploaded with a single copy.
+     */
+    explicit DirtyRangeTracker( UINT mergeDistance = 0 );
+
+    /**
+     * Mark the elements [begin, end) as dirty.
+     */
+    void MarkDirty( UINT begin, UINT end );
+    void MarkDirty( UINT index );
+
+    bool IsDirty() const;
+
+    /**
+     * The dirty ranges sorted by their first element. The ranges don't overlap.
+     */
+    const std::vector<Range>& get_Ranges() const;
+
+    /**
+     * The number of dirty elements (including the clean elements in the gaps of merged ranges).
+     */
+    UINT get_DirtyCount() const;
+
+    /**
+     * Mark all elements as clean (after they have been uploaded).
+     */
+    void Clear();
+
+private:
+    UINT m_MergeDistance;
+    std::vector<Range> m_Ranges;
+};
\ No newline at end of file
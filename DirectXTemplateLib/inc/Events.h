@@ -152,26 +152,39 @@ class UpdateEventArgs : public EventArgs
 {
 public:
     typedef EventArgs base;
-    UpdateEventArgs( float fDeltaTime, float fTotalTime )
+    UpdateEventArgs( float fDeltaTime, float fTotalTime, uint64_t frameIndex = 0 )
         : ElapsedTime( fDeltaTime )
         , TotalTime( fTotalTime )
+        , FrameIndex( frameIndex )
     {}
 
     float ElapsedTime;
     float TotalTime;
+    // The index of the frame that this update produces. All updates of a frame (in
+    // FixedTimestep mode) have the same index.
+    uint64_t FrameIndex;
 };
 
 class RenderEventArgs : public EventArgs
 {
 public:
     typedef EventArgs base;
-    RenderEventArgs( float fDeltaTime, float fTotalTime )
+    RenderEventArgs( float fDeltaTime, float fTotalTime, float fAlpha = 1.0f, uint64_t frameIndex = 0 )
         : ElapsedTime( fDeltaTime )
         , TotalTime( fTotalTime )
+        , Alpha( fAlpha )
+        , FrameIndex( frameIndex )
     {}
 
     float ElapsedTime;
     float TotalTime;
+    // How far (0...1) the rendered frame lies between the previous and the last update.
+    // Use this to interpolate between the previous and current state of moving objects.
+    // This is always 1 when the application does not use a fixed timestep.
+    float Alpha;
+    // The index of the frame that is rendered. In Pipelined mode the update of the
+    // next frame (FrameIndex + 1) runs concurrently with the render of this frame.
+    uint64_t FrameIndex;
 };
 
 class UserEventArgs : public EventArgs
@@ -0,0 +1,74 @@
+/**
+ *   @brief Runs the update of the next frame on a worker thread while the current frame is rendered.
+ */
+#pragma once
+
+#include <Events.h>
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * A worker thread that runs one update at a time. The caller starts the update of frame N + 1
+ * with BeginUpdate, renders frame N and then waits for the update with WaitForUpdate. At most
+ * one update is in flight, so the frame latency is bounded to one frame and the caller's thread
+ * never runs concurrently with the update function outside of the BeginUpdate/WaitForUpdate pair.
+ * The pipeline does not depend on a window or device, so it can be driven headless.
+ */
+class FramePipeline
+{
+public:
+    typedef std::function<void( UpdateEventArgs& )> UpdateFunction;
+
+    /**
+     * Start the worker thread.
+     * @param update The function that is called on the worker thread for every BeginUpdate.
+     */
+    explicit FramePipeline( const UpdateFunction& update );
+    /**
+     * Wait for the running update (if any) and stop the worker thread.
+     */
+    ~FramePipeline();
+
+    /**
+     * Start the update of a frame on the worker thread. The previous update must have
+     * been waited for.
+     */
+    void BeginUpdate( const UpdateEventArgs& e );
+
+    /**
+     * Wait until the update that was started with BeginUpdate has finished. If the update
+     * function has thrown an exception, it is rethrown here. Returns immediately if no
+     * update is running.
+     */
+    void WaitForUpdate();
+
+    bool IsUpdating() const;
+
+private:
+    // Prevent copying.
+    FramePipeline( const FramePipeline& copy );
+    FramePipeline& operator=( const FramePipeline& other );
+
+    void Run();
+
+    enum State
+    {
+        Idle,
+        Updating,
+        Stopping,
+    };
+
+    UpdateFunction m_Update;
+    UpdateEventArgs m_UpdateEventArgs;
+
+    mutable std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    State m_State;
+    std::exception_ptr m_Exception;
+
+    std::thread m_Thread;
+};
\ No newline at end of file
@@ -0,0 +1,106 @@
+/**
+ *   @brief Collects the CPU time spent in the phases of the last frames.
+ */
+#pragma once
+
+/**
+ * Records the update, render and present times of the most recent frames in a ring buffer
+ * and computes percentiles and histograms over them. All memory is allocated in the
+ * constructor, so recording frames and querying statistics never allocates.
+ * The collector does not depend on a window or device, so it can be used headless.
+ */
+class FrameStatistics
+{
+public:
+    enum Phase
+    {
+        UpdatePhase,
+        RenderPhase,
+        PresentPhase,
+        // The time between the end of the previous frame and the end of this frame.
+        FramePhase,
+        PhaseCount
+    };
+
+    /**
+     * @param capacity The number of frames that are kept. Older frames are overwritten.
+     */
+    explicit FrameStatistics( size_t capacity = 4096 );
+
+    /**
+     * Add time to a phase of the current frame. A phase can be added multiple
+     * times per frame (for example if there are several updates per frame).
+     */
+    void AddTime( Phase phase, double seconds );
+    /**
+     * The time (in seconds) that has been added to a phase of the current frame.
+     */
+    double get_CurrentTime( Phase phase ) const;
+
+    /**
+     * Store the current frame in the ring buffer and start a new frame.
+     */
+    void EndFrame();
+
+    /**
+     * Remove all recorded frames.
+     */
+    void Reset();
+
+    /**
+     * The number of frames that have been recorded since the last reset (including overwritten frames).
+     */
+    uint64_t get_TotalFrameCount() const;
+    /**
+     * The number of frames in the ring buffer that the statistics are computed from.
+     */
+    size_t get_FrameCount() const;
+
+    /**
+     * The duration (in milliseconds) of a phase that the given percentage of the frames
+     * did not exceed. For example, the 99th percentile of the FramePhase is the
+     * frame time of the "1% low" frame rate. Returns 0 if no frames were recorded.
+     */
+    float get_Percentile( Phase phase, float percentile ) const;
+    float get_Average( Phase phase ) const;
+    float get_Maximum( Phase phase ) const;
+
+    /**
+     * Count the frames by the duration of a phase.
+     * @param bucketWidth The width of a bucket in milliseconds.
+     * @param buckets Receives the counts. Bucket i counts the frames in [i * bucketWidth, (i + 1) * bucketWidth)
+     * except for the last bucket which also counts all longer frames.
+     */
+    void get_Histogram( Phase phase, float bucketWidth, UINT* buckets, size_t bucketCount ) const;
+
+    /**
+     * Write the recorded frames (one line per frame in milliseconds) or a summary with
+     * percentiles and histograms.
+     * @returns false if the file could not be written.
+     */
+    bool SaveCsv( const std::wstring& fileName ) const;
+    bool SaveJson( const std::wstring& fileName ) const;
+
+    static const char* get_PhaseName( Phase phase );
+
+private:
+    struct Frame
+    {
+        uint64_t Number;
+        float Milliseconds[PhaseCount];
+    };
+
+    const Frame& get_Frame( size_t index ) const;
+
+    std::vector<Frame> m_Frames;
+    size_t m_NextFrame;
+    uint64_t m_TotalFrameCount;
+
+    // The phase times of the frame that is being recorded.
+    double m_CurrentTimes[PhaseCount];
+    // The time stamp of the end of the previous frame (0 before the first frame).
+    double m_PreviousFrameEnd;
+
+    // Scratch buffer for computing percentiles.
+    mutable std::vector<float> m_SortedTimes;
+};
\ No newline at end of file
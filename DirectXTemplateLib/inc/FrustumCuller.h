@@ -0,0 +1,81 @@
+/**
+ *   @brief Batch frustum culling of world-space bounding boxes.
+ */
+#pragma once
+
+#include <Camera.h>
+
+class JobSystem;
+
+/**
+ * Tests a set of world-space axis-aligned bounding boxes against the view frustum of a camera.
+ * The boxes are stored in SoA form (center and extents per axis) so that four boxes are
+ * tested against each plane at a time. The storage is reused between frames, so adding
+ * the same number of boxes every frame does not allocate memory.
+ */
+class FrustumCuller
+{
+public:
+    FrustumCuller();
+
+    /**
+     * Remove all boxes.
+     */
+    void Clear();
+
+    /**
+     * Add a world-space box.
+     * @returns The index of the box.
+     */
+    size_t AddBox( const DirectX::BoundingBox& box );
+    /**
+     * Add the world-space box that contains an object-space box transformed by a world matrix.
+     * @returns The index of the box.
+     */
+    size_t XM_CALLCONV AddBox( const DirectX::BoundingBox& box, DirectX::FXMMATRIX worldMatrix );
+    void set_Box( size_t index, const DirectX::BoundingBox& box );
+
+    size_t get_BoxCount() const;
+
+    /**
+     * Test all boxes against the view frustum of the camera.
+     * @param jobSystem If this is not null, large sets of boxes are tested in parallel.
+     * @returns The number of visible boxes.
+     */
+    size_t Cull( const Camera& camera, JobSystem* jobSystem = nullptr );
+    /**
+     * Test all boxes against a set of planes (see Camera::get_FrustumPlanes).
+     * @returns The number of visible boxes.
+     */
+    size_t Cull( const DirectX::XMVECTOR planes[Camera::FrustumPlaneCount], JobSystem* jobSystem = nullptr );
+
+    /**
+     * Query the result of the last Cull.
+     */
+    bool IsVisible( size_t index ) const;
+    /**
+     * The (ascending) indices of the boxes that were visible in the last Cull.
+     */
+    const std::vector<UINT>& get_VisibleBoxes() const;
+
+    /**
+     * The throughput of the last Cull in boxes per millisecond.
+     */
+    double get_BoxesPerMillisecond() const;
+
+private:
+    // Test the boxes [begin, end) and write their visibility. begin must be a multiple of 4.
+    void CullBoxes( const DirectX::XMVECTOR planes[Camera::FrustumPlaneCount], size_t begin, size_t end );
+
+    size_t m_BoxCount;
+
+    // Box centers and extents in SoA form. The arrays are padded to a multiple of 4 boxes.
+    std::vector<float> m_CenterX, m_CenterY, m_CenterZ;
+    std::vector<float> m_ExtentX, m_ExtentY, m_ExtentZ;
+
+    // The results of the last Cull.
+    // One byte per box (not std::vector<bool>) so that jobs can write the results of neighboring boxes.
+    std::vector<uint8_t> m_Visible;
+    std::vector<UINT> m_VisibleBoxes;
+    double m_BoxesPerMillisecond;
+};
\ No newline at end of file
@@ -4,8 +4,12 @@
 #pragma once
 
 #include <Events.h>
+#include <FrameStatistics.h>
+#include <RecordingDeviceContext.h>
+#include <StateFilteringDeviceContext.h>
 
 class Window;
+class JobSystem;
 
 class Game
 {
@@ -36,8 +40,27 @@ public:
     */
     virtual void Cleanup();
 
+    /**
+     * The update, render and present times of the last frames.
+     */
+    FrameStatistics& get_FrameStatistics();
+
+    /**
+     * The job system of the application.
+     */
+    JobSystem& get_JobSystem();
+
+    /**
+     * Drop the device context calls that bind state that is already bound (disabled by default).
+     * The filter forgets the bound inputs whenever outputs are bound, but it cannot see state that
+     * is changed by code that bypasses it. Must be set before the game is initialized.
+     */
+    void set_FilterRedundantState( bool filterRedundantState );
+    bool get_FilterRedundantState() const;
+
 protected:
     friend class Window;
+    friend class HeadlessRunner;
 
     // The window associated with this demo.
     Window& m_Window;
@@ -61,6 +84,26 @@ protected:
     // Present parameters used by the IDXGISwapChain1::Present1 method
     DXGI_PRESENT_PARAMETERS m_PresentParameters;
 
+    // The format of the depth buffer and the depth test of the depth/stencil state.
+    // Derived classes can change them in their constructor (for example to DXGI_FORMAT_D32_FLOAT_S8X24_UINT
+    // and Camera::get_DepthComparison for a reverse depth camera).
+    DXGI_FORMAT m_DepthStencilFormat;
+    D3D11_COMPARISON_FUNC m_DepthComparison;
+
+    // The driver type of the device if the game is created with a headless window.
+    // D3D_DRIVER_TYPE_WARP renders on the CPU, D3D_DRIVER_TYPE_NULL accepts the calls without rendering.
+    D3D_DRIVER_TYPE m_HeadlessDriverType;
+    // Counts the calls to the device context if the game is created with a headless window.
+    // m_d3dDeviceContext refers to the same device context.
+    Microsoft::WRL::ComPtr<RecordingDeviceContext> m_RecordingDeviceContext;
+    // Drops the redundant set calls if m_FilterRedundantState is true. m_d3dDeviceContext refers
+    // to the same device context, the recording device context (if any) is wrapped by it.
+    bool m_FilterRedundantState;
+    Microsoft::WRL::ComPtr<StateFilteringDeviceContext> m_StateFilteringDeviceContext;
+
+    // Frame times recorded by the window and Present.
+    FrameStatistics m_FrameStatistics;
+
     /**
      * Clear the contents of the back buffer, depth buffer, and stencil buffer.
      * This function is usually called before anything is rendered to the screen.
@@ -125,7 +168,10 @@ protected:
 
 private:
 
+    // Create the swap chain for the window.
+    bool CreateSwapChain();
     // Resize the front and back buffers associated with the swap chain.
+    // Without a swap chain (headless) an offscreen back buffer is created.
     bool ResizeSwapChain( int width, int height );
 
     bool m_bIsInitialized;
@@ -0,0 +1,147 @@
+/**
+ *   @brief A process-wide cache that shares geometry between objects that are
+ *   created with identical parameters.
+ */
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+/**
+ * Identifies a procedural shape and the parameters it was generated with.
+ */
+struct GeometryKey
+{
+    enum ShapeType
+    {
+        Cube,
+        Sphere,
+        Cone,
+        Torus,
+    };
+
+    static GeometryKey MakeCube( float size );
+    static GeometryKey MakeSphere( float diameter, size_t tessellation );
+    static GeometryKey MakeCone( float diameter, float height, size_t tessellation );
+    static GeometryKey MakeTorus( float diameter, float thickness, size_t tessellation );
+
+    ShapeType Shape;
+    // Shape dependent parameters (size, diameter, height, thickness). Unused parameters are 0.
+    float Parameters[2];
+    size_t Tessellation;
+
+    bool operator<( const GeometryKey& other ) const
+    {
+        return std::tie( Shape, Parameters[0], Parameters[1], Tessellation ) <
+            std::tie( other.Shape, other.Parameters[0], other.Parameters[1], other.Tessellation );
+    }
+};
+
+/**
+ * Ensures that only a single TData instance is alive for each unique TKey. The cache only holds weak
+ * references so an instance is destroyed (and removed from the cache) as soon as the last shared_ptr
+ * to it is released. This works like DirectXTK's SharedResourcePool except that the instances are
+ * created by a function supplied by the caller. Mesh uses it to share the buffers of its procedural shapes.
+ */
+template<typename TKey, typename TData>
+class GeometryCache
+{
+public:
+    GeometryCache()
+        : m_Entries( std::make_shared<Entries>() )
+    {}
+
+    /**
+     * Return the existing instance for the key or create a new one.
+     * @param create A function that returns a std::unique_ptr<TData> for the key. It is only
+     * called if there is no instance for the key.
+     */
+    template<typename TCreate>
+    std::shared_ptr<TData> DemandCreate( const TKey& key, TCreate create )
+    {
+        std::lock_guard<std::mutex> lock( m_Entries->Mutex );
+
+        auto pos = m_Entries->find( key );
+        if ( pos != m_Entries->end() )
+        {
+            std::shared_ptr<TData> existingData = pos->second.lock();
+            if ( existingData )
+            {
+                return existingData;
+            }
+
+            m_Entries->erase( pos );
+        }
+
+        // Remove the entry from the cache when the last reference is released.
+        std::shared_ptr<Entries> entries = m_Entries;
+        std::shared_ptr<TData> newData( create().release(), [entries, key]( TData* data )
+        {
+            {
+                std::lock_guard<std::mutex> lock( entries->Mutex );
+
+                // A new instance may have been added for the same key after this one expired.
+                auto pos = entries->find( key );
+                if ( pos != entries->end() && pos->second.expired() )
+                {
+                    entries->erase( pos );
+                }
+            }
+
+            std::default_delete<TData>()( data );
+        } );
+
+        m_Entries->insert( std::make_pair( key, std::weak_ptr<TData>( newData ) ) );
+
+        return newData;
+    }
+
+    /**
+     * The number of keys that currently have an instance.
+     */
+    size_t get_Size() const
+    {
+        std::lock_guard<std::mutex> lock( m_Entries->Mutex );
+        return m_Entries->size();
+    }
+
+private:
+    struct Entries : public std::map< TKey, std::weak_ptr<TData> >
+    {
+        std::mutex Mutex;
+    };
+
+    // The entries are shared with the deleters of the instances so the
+    // instances may outlive the cache.
+    std::shared_ptr<Entries> m_Entries;
+
+    // Prevent copying.
+    GeometryCache( const GeometryCache& );
+    GeometryCache& operator=( const GeometryCache& );
+};
+
+inline GeometryKey GeometryKey::MakeCube( float size )
+{
+    GeometryKey key = { Cube, { size, 0.0f }, 0 };
+    return key;
+}
+
+inline GeometryKey GeometryKey::MakeSphere( float diameter, size_t tessellation )
+{
+    GeometryKey key = { Sphere, { diameter, 0.0f }, tessellation };
+    return key;
+}
+
+inline GeometryKey GeometryKey::MakeCone( float diameter, float height, size_t tessellation )
+{
+    GeometryKey key = { Cone, { diameter, height }, tessellation };
+    return key;
+}
+
+inline GeometryKey GeometryKey::MakeTorus( float diameter, float thickness, size_t tessellation )
+{
+    GeometryKey key = { Torus, { diameter, thickness }, tessellation };
+    return key;
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+/**
+ *   @brief Runs a game without a window for a fixed number of frames.
+ */
+#pragma once
+
+#include <Window.h>
+
+class Game;
+
+/**
+ * Owns a headless window and runs the updates and renders of a game that is created
+ * with that window at a fixed time step. The game renders to an offscreen render target
+ * and the calls to its device context are counted (see Game::m_HeadlessDriverType). If the
+ * game filters redundant state, the elided calls are counted as well.
+ * Use it to profile or smoke-test a game without a GPU or a desktop session.
+ */
+class HeadlessRunner
+{
+public:
+    /**
+     * Create the headless window.
+     */
+    HeadlessRunner( const std::string& windowName, int clientWidth, int clientHeight );
+    ~HeadlessRunner();
+
+    /**
+     * The window to create the game with.
+     */
+    Window& get_Window();
+
+    /**
+     * Initialize the game, load its content and run it for a number of frames.
+     * The time step of the frames is fixed, so runs are repeatable.
+     * Afterwards the frame times and the device context calls are written to the stream
+     * and the window is destroyed, which unloads the content of the game. The window is
+     * also destroyed if the game could not be initialized or loaded.
+     * @returns false if the game could not be initialized or loaded.
+     */
+    bool Run( Game& game, uint64_t frameCount, float deltaTime, std::ostream& stream );
+
+private:
+    // Prevent copying.
+    HeadlessRunner( const HeadlessRunner& copy );
+    HeadlessRunner& operator=( const HeadlessRunner& other );
+
+    Window m_Window;
+};
\ No newline at end of file
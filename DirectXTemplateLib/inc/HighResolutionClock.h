@@ -0,0 +1,43 @@
+/**
+ *   @brief A clock based on the high-resolution performance counter.
+ */
+#pragma once
+
+class HighResolutionClock
+{
+public:
+    HighResolutionClock();
+
+    /**
+     * Advance the clock to the current time.
+     * @returns The time (in seconds) since the previous Tick (or Reset).
+     */
+    double Tick();
+
+    /**
+     * Restart the clock. The next Tick measures from this point.
+     */
+    void Reset();
+
+    /**
+     * The time (in seconds) between the last two ticks.
+     */
+    double get_DeltaSeconds() const;
+    /**
+     * The time (in seconds) between the last Reset and the last Tick.
+     */
+    double get_TotalSeconds() const;
+
+    /**
+     * The current value of the performance counter in seconds. Only the differences
+     * between two values are meaningful.
+     */
+    static double get_CurrentSeconds();
+
+private:
+    LARGE_INTEGER m_Frequency;
+    LARGE_INTEGER m_StartTime;
+    LARGE_INTEGER m_PreviousTime;
+    LONGLONG m_DeltaTicks;
+    LONGLONG m_TotalTicks;
+};
\ No newline at end of file
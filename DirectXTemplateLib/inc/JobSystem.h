@@ -0,0 +1,194 @@
+/**
+ *   @brief A work-stealing job scheduler with parallel-for and job counters.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct Job;
+
+/**
+ * Counts the unfinished jobs that were scheduled with it. Wait for a counter to wait for a
+ * group of jobs or pass it as the dependency of a job to run the job after the group.
+ */
+class JobCounter
+{
+public:
+    JobCounter();
+    ~JobCounter();
+
+    /**
+     * true if all jobs that were scheduled with this counter have finished.
+     */
+    bool IsDone() const;
+
+private:
+    friend class JobSystem;
+
+    // Prevent copying.
+    JobCounter( const JobCounter& copy );
+    JobCounter& operator=( const JobCounter& other );
+
+    std::atomic<int> m_Count;
+
+    // Protects the waiting jobs and the exception. The job that decrements the count to zero
+    // holds the lock, so the counter is not destroyed before it has released the waiting jobs.
+    mutable std::mutex m_Mutex;
+    // The jobs that depend on this counter. They are queued when the count reaches zero.
+    mutable Job* m_WaitingJobs;
+    // The first exception that was thrown by a job of this counter. Taken by Wait.
+    mutable std::exception_ptr m_Exception;
+};
+
+/**
+ * A Chase-Lev work-stealing deque. The owning thread pushes and pops jobs at the bottom,
+ * other threads steal jobs from the top. The capacity is fixed.
+ * See: Lê et al., "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+ */
+class WorkStealingQueue
+{
+public:
+    /**
+     * @param capacity The maximum number of jobs in the queue. Must be a power of 2.
+     */
+    explicit WorkStealingQueue( size_t capacity = 4096 );
+
+    /**
+     * Add a job to the bottom of the queue. Must only be called by the owning thread.
+     * @returns false if the queue is full.
+     */
+    bool Push( Job* job );
+    /**
+     * Remove the job at the bottom of the queue (the most recently pushed job).
+     * Must only be called by the owning thread.
+     * @returns nullptr if the queue is empty.
+     */
+    Job* Pop();
+    /**
+     * Remove the job at the top of the queue (the oldest job). Can be called by any thread.
+     * @returns nullptr if the queue is empty or another thread took the job first.
+     */
+    Job* Steal();
+
+private:
+    // Prevent copying.
+    WorkStealingQueue( const WorkStealingQueue& copy );
+    WorkStealingQueue& operator=( const WorkStealingQueue& other );
+
+    std::unique_ptr<std::atomic<Job*>[]> m_Jobs;
+    int64_t m_Mask;
+
+    std::atomic<int64_t> m_Top;
+    std::atomic<int64_t> m_Bottom;
+};
+
+/**
+ * Runs jobs on a pool of worker threads. Every worker (including the thread that created the
+ * job system) has its own work-stealing queue. Jobs scheduled by a worker are pushed to its own
+ * queue, jobs scheduled by other threads go to a shared queue. Idle workers steal jobs from
+ * the other queues and sleep when there is no work left.
+ *
+ * Waiting for a counter runs other jobs until the counter reaches zero, so jobs can wait for
+ * other jobs without blocking a worker. Jobs with a dependency wait on the dependency's counter
+ * and are only queued when it reaches zero, so workers never pick up a job that cannot run.
+ */
+class JobSystem
+{
+public:
+    typedef std::function<void()> JobFunction;
+    typedef std::function<void( size_t begin, size_t end )> RangeFunction;
+
+    /**
+     * Create the worker threads. The calling thread becomes worker 0, so threadCount - 1
+     * threads are created.
+     * @param threadCount The number of threads that run jobs (0 to use all hardware threads).
+     */
+    explicit JobSystem( size_t threadCount = 0 );
+    /**
+     * Wait for all scheduled jobs and stop the worker threads. Jobs whose dependency is never
+     * done are not run.
+     */
+    ~JobSystem();
+
+    /**
+     * The number of threads that run jobs (including the thread that created the job system).
+     */
+    size_t get_ThreadCount() const;
+
+    /**
+     * Schedule a job. If the job throws an exception, it still finishes and the exception is
+     * rethrown by Wait for its counter. Jobs without a counter must not throw.
+     * @param counter Incremented now and decremented when the job has finished (optional).
+     * @param dependency The job is not queued before this counter is done (optional).
+     */
+    void Schedule( const JobFunction& function, JobCounter* counter = nullptr, const JobCounter* dependency = nullptr );
+
+    /**
+     * Run jobs until the counter is done. Rethrows the first exception that was thrown by a job
+     * of the counter.
+     */
+    void Wait( const JobCounter& counter );
+
+    /**
+     * Call function( begin, end ) for consecutive sub-ranges of [begin, end) in parallel and
+     * wait until all sub-ranges have been processed.
+     * @param grainSize The size of the sub-ranges (0 to split the range evenly between the threads).
+     */
+    void ParallelFor( size_t begin, size_t end, size_t grainSize, const RangeFunction& function );
+
+private:
+    // Prevent copying.
+    JobSystem( const JobSystem& copy );
+    JobSystem& operator=( const JobSystem& other );
+
+    void WorkerThread( size_t workerIndex );
+
+    // Find a job in the own queue, the shared queue or the queues of the other workers.
+    Job* FindJob( int workerIndex );
+    // Run the job and finish it.
+    void Execute( Job* job );
+    // Decrement the counter of a finished job and queue the jobs that depend on the counter if it is done.
+    void Finish( JobCounter* counter, std::exception_ptr exception );
+    // Add a job to a queue and wake a sleeping worker.
+    void Enqueue( Job* job );
+    // Take a job from the free list of the calling worker or from the shared pool.
+    Job* AllocateJob();
+    // Return a job to the free list of the calling worker or to the shared pool.
+    void FreeJob( Job* job );
+    // The worker index of the calling thread or -1 if it is not a worker of this job system.
+    int get_WorkerIndex() const;
+
+    std::vector<std::unique_ptr<WorkStealingQueue>> m_Queues;
+    std::vector<std::thread> m_Threads;
+
+    // Jobs that are scheduled by threads that are not workers.
+    std::mutex m_SharedQueueMutex;
+    std::deque<Job*> m_SharedQueue;
+
+    // The number of jobs that are queued but have not been taken by a worker.
+    std::atomic<int64_t> m_PendingJobs;
+    std::atomic<int> m_SleepingWorkers;
+    std::mutex m_SleepMutex;
+    std::condition_variable m_WakeCondition;
+    std::atomic<bool> m_Stopping;
+
+    // The free jobs of every worker. Only accessed by the worker itself.
+    std::vector<std::vector<Job*>> m_FreeJobs;
+    // The free jobs of threads that are not workers and the jobs that workers gave back.
+    std::mutex m_JobPoolMutex;
+    std::vector<Job*> m_SharedFreeJobs;
+    // The jobs are allocated in blocks that are freed with the job system.
+    std::vector<std::unique_ptr<Job[]>> m_JobBlocks;
+
+    // The job system that the creating thread was a worker of before this one was created.
+    JobSystem* m_PreviousJobSystem;
+    int m_PreviousWorkerIndex;
+};
\ No newline at end of file
@@ -3,7 +3,16 @@
  */
 #pragma once
 
+#include <MeshInstanceStream.h>
+
 #include <memory>
+#include <functional>
+
+class Camera;
+struct GeometryKey;
+struct MeshFileLevelOfDetail;
+class MeshBufferPool;
+class MeshBufferAllocation;
 
 // Vertex struct holding position, normal vector, and texture mapping information.
 struct VertexPositionNormalTexture
@@ -33,18 +42,282 @@ struct VertexPositionNormalTexture
 };
 
 typedef std::vector<VertexPositionNormalTexture> VertexCollection;
-typedef std::vector<uint16_t> IndexCollection;
+// Indices are always generated as 32-bit values. Mesh::Initialize will narrow them
+// to 16-bit indices when the vertex count allows it.
+typedef std::vector<uint32_t> IndexCollection;
+
+// Post-transform vertex cache efficiency of an index buffer.
+struct VertexCacheStatistics
+{
+    // Average cache miss ratio: the number of transformed vertices per triangle.
+    // 0.5 is optimal for large regular meshes and 3.0 is the worst case.
+    float ACMR;
+    // Average transformed vertex ratio: the number of transformed vertices per vertex.
+    // 1.0 is optimal (each vertex is transformed exactly once).
+    float ATVR;
+};
+
+// The number of vertices and triangles before and after vertex welding.
+struct WeldStatistics
+{
+    size_t InitialVertexCount;
+    size_t VertexCount;
+    size_t InitialTriangleCount;
+    size_t TriangleCount;
+    // The number of triangles that were removed because they have no area.
+    size_t DegenerateTriangleCount;
+};
+
+// A range of triangles in the index buffer of a mesh.
+struct MeshCluster
+{
+    // The default limits that are used when Mesh::BuildClusters is specified.
+    static const size_t DefaultMaxVertices = 64;
+    static const size_t DefaultMaxTriangles = 124;
+
+    // The first index of the cluster in the index buffer.
+    UINT StartIndex;
+    // The number of indices (3 * the number of triangles) in the cluster.
+    UINT IndexCount;
+    // The number of unique vertices that are referenced by the cluster.
+    UINT VertexCount;
+
+    // Object-space bounding sphere of the cluster (xyz: center, w: radius).
+    DirectX::XMFLOAT4 BoundingSphere;
+    // Cone that contains the normals of all triangles in the cluster
+    // (xyz: axis, w: sine of the cone's half angle). If the cone is
+    // wider than a hemisphere, w is 1 and the cluster is never back-face culled.
+    DirectX::XMFLOAT4 NormalCone;
+};
+
+typedef std::vector<MeshCluster> MeshClusterCollection;
 
 class Mesh
 {
 public:
+
+    // Flags that control how the geometry is processed before the
+    // vertex and index buffers are created.
+    enum CreateFlags
+    {
+        DefaultFlags        = 0x0,
+        // Reorder the triangles for the post-transform vertex cache and
+        // the vertices for vertex fetch locality.
+        OptimizeForVertexCache = 0x1,
+        // Split the triangles into clusters that can be culled with a MeshClusterCuller
+        // and drawn with DrawClusters.
+        BuildClusters = 0x2,
+        // Store the vertices in one of the 16 byte packed vertex formats (see PackedVertex.h).
+        // The clusters are still computed from the full precision vertices.
+        PackVerticesAsHalf = 0x4,
+        PackVerticesAsUnorm16 = 0x8,
+        // Merge vertices with (nearly) identical attributes and remove degenerate triangles.
+        WeldDuplicateVertices = 0x10,
+    };
+
+    // The layout of the vertices in the vertex buffer.
+    enum VertexFormat
+    {
+        // VertexPositionNormalTexture
+        FloatVertexFormat,
+        // VertexPositionNormalTextureHalf
+        HalfVertexFormat,
+        // VertexPositionNormalTextureUnorm16
+        Unorm16VertexFormat,
+    };
     
     void Draw( ID3D11DeviceContext* pDeviceContext );
+    /**
+     * Draw a specific level of detail of this mesh. Level 0 is the most detailed
+     * level. If the level does not exist, the coarsest level is drawn.
+     */
+    void Draw( ID3D11DeviceContext* pDeviceContext, size_t levelOfDetail );
+
+    /**
+     * Add a coarser level of detail to the end of the LOD chain.
+     * @param mesh The mesh to use for the new level of detail.
+     * @param maxScreenSize The largest projected size (in pixels) at which this level should be used.
+     * The levels must be added with decreasing screen size.
+     */
+    void AddLevelOfDetail( std::unique_ptr<Mesh> mesh, float maxScreenSize );
+
+    /**
+     * The number of levels of detail including the base mesh.
+     */
+    size_t get_LevelOfDetailCount() const;
+
+    /**
+     * Draw a subset of the clusters of this mesh. Clusters that are adjacent in the
+     * index buffer are merged into a single draw call.
+     * @param visibleClusters The ascending indices of the clusters to draw (for example from MeshClusterCuller::Cull).
+     */
+    void DrawClusters( ID3D11DeviceContext* pDeviceContext, const std::vector<UINT>& visibleClusters );
+
+    /**
+     * Move the vertices and indices of this mesh and its levels of detail into a shared buffer pool.
+     * The geometry is copied on the GPU and the buffers of the mesh are released. The pool must use
+     * the vertex stride and index format of every level of detail.
+     */
+    void MoveToBufferPool( ID3D11DeviceContext* pDeviceContext, const std::shared_ptr<MeshBufferPool>& pool );
+    /**
+     * Draw a level of detail without binding the vertex and index buffers. The buffers of the
+     * mesh's pool must already be bound with MeshBufferPool::Bind, so many meshes in the same
+     * pool can be drawn without changing the input assembler state.
+     */
+    void Submit( ID3D11DeviceContext* pDeviceContext, size_t levelOfDetail = 0 );
+
+    /**
+     * Add an instance to the instance batch of a level of detail of this mesh. The batched
+     * instances are drawn with SubmitInstances.
+     * @param worldMatrix The world matrix of the instance. The dequantization matrix of the level of detail is applied to it.
+     * @param materialIndex The index of the instance's material in the material table.
+     */
+    void XM_CALLCONV AddInstance( DirectX::FXMMATRIX worldMatrix, UINT materialIndex, size_t levelOfDetail = 0 );
+    /**
+     * Copy the batched instances of every level of detail to the instance stream and draw each
+     * level of detail with a single instanced draw. The buffers of the mesh's pool, the instance
+     * stream and an input layout that contains MeshInstance::InputElements must already be bound.
+     * The instance batches are cleared.
+     * @returns The number of draw calls.
+     */
+    UINT SubmitInstances( ID3D11DeviceContext* pDeviceContext, MeshInstanceStream& instanceStream );
+    /**
+     * The number of batched instances of all levels of detail.
+     */
+    size_t get_InstanceCount() const;
+
+    /**
+     * The pool that holds the geometry of this mesh or nullptr if the mesh has its own buffers.
+     */
+    MeshBufferPool* get_BufferPool() const;
+    /**
+     * The location of the geometry in the vertex and index buffers. These are 0 for meshes that
+     * are not in a pool and may change when a pool is defragmented.
+     */
+    UINT get_BaseVertex() const;
+    UINT get_StartIndex() const;
+
+    /**
+     * The object-space bounding volumes of the mesh. They are computed from the full precision
+     * vertices, so they do not need to be dequantized for packed vertex formats.
+     */
+    const DirectX::BoundingBox& get_BoundingBox() const;
+    const DirectX::BoundingSphere& get_BoundingSphere() const;
 
-    static std::unique_ptr<Mesh> CreateCube( ID3D11DeviceContext* deviceContext, float size = 1, bool rhcoords = true);
-    static std::unique_ptr<Mesh> CreateSphere( ID3D11DeviceContext* deviceContext, float diameter = 1, size_t tessellation = 16, bool rhcoords = true);
-    static std::unique_ptr<Mesh> CreateCone( ID3D11DeviceContext* deviceContext, float diameter = 1, float height = 1, size_t tessellation = 32, bool rhcoords = true);
-    static std::unique_ptr<Mesh> CreateTorus( ID3D11DeviceContext* deviceContext, float diameter = 1, float thickness = 0.333f, size_t tessellation = 32, bool rhcoords = true);
+    /**
+     * The clusters of this mesh. This is empty unless the mesh was created with the BuildClusters flag.
+     */
+    const MeshClusterCollection& get_Clusters() const;
+
+    /**
+     * Select the coarsest level of detail that may be used for the given projected size.
+     * @param screenSize The projected size of the mesh (in pixels).
+     */
+    size_t SelectLevelOfDetail( float screenSize ) const;
+    /**
+     * Select the level of detail for a mesh that is rendered with the given camera.
+     * @param position The world-space position of the mesh.
+     * @param radius The world-space radius of the bounding sphere of the mesh.
+     */
+    size_t XM_CALLCONV SelectLevelOfDetail( const Camera& camera, DirectX::FXMVECTOR position, float radius ) const;
+
+    /**
+     * The format of the index buffer. This is DXGI_FORMAT_R16_UINT if the 
+     * mesh has at most 65535 vertices, otherwise it is DXGI_FORMAT_R32_UINT.
+     */
+    DXGI_FORMAT get_IndexFormat() const;
+
+    /**
+     * The index format of a mesh with the given number of vertices: DXGI_FORMAT_R16_UINT if all
+     * vertices can be addressed with 16-bit indices (the value 0xFFFF is reserved as the strip-cut
+     * index), otherwise DXGI_FORMAT_R32_UINT. Returns DXGI_FORMAT_UNKNOWN if the mesh needs 32-bit
+     * indices and the feature level does not support them (feature level 9.1).
+     */
+    static DXGI_FORMAT SelectIndexFormat( size_t vertexCount, D3D_FEATURE_LEVEL featureLevel );
+    /**
+     * Convert 32-bit indices to 16-bit indices.
+     * @returns false if an index does not fit into a 16-bit index (0xFFFF or more).
+     */
+    static bool NarrowIndices( const IndexCollection& indices, std::vector<uint16_t>& narrowIndices );
+
+    /**
+     * The format of the vertex buffer and the matching input layout description.
+     * Packed vertex formats store an octahedral encoded normal that must be decoded in the vertex shader.
+     */
+    VertexFormat get_VertexFormat() const;
+    UINT get_VertexStride() const;
+    const D3D11_INPUT_ELEMENT_DESC* get_InputElements( UINT& inputElementCount ) const;
+
+    /**
+     * The matrix that transforms the packed positions to object space. The matrix must be
+     * applied before the world matrix (for example WorldViewProjectionMatrix = dequantization * world * viewProjection).
+     * The normals are not quantized, so they should still be transformed with the inverse transpose of the world matrix.
+     * This is the identity matrix for meshes that use FloatVertexFormat.
+     * Each level of detail has its own quantization.
+     */
+    DirectX::XMMATRIX get_DequantizationMatrix( size_t levelOfDetail = 0 ) const;
+
+    /**
+     * The vertex cache efficiency of the index buffer before optimization.
+     */
+    const VertexCacheStatistics& get_InitialVertexCacheStatistics() const;
+    /**
+     * The vertex cache efficiency of the index buffer that is used to draw the mesh.
+     * This is the same as the initial statistics if the mesh was not optimized.
+     */
+    const VertexCacheStatistics& get_VertexCacheStatistics() const;
+
+    /**
+     * The vertices and triangles that were removed by welding. If the mesh was not
+     * created with the WeldDuplicateVertices flag, the initial and final counts are the same.
+     */
+    const WeldStatistics& get_WeldStatistics() const;
+
+    /**
+     * Create procedural shapes. For the tessellated shapes, levelsOfDetail - 1 coarser levels of
+     * detail are created by halving the tessellation for each level (down to a minimum of 3).
+     * Meshes that are created with identical parameters on the same device share their
+     * vertex and index buffers. The shared buffers are released with the last mesh that uses them.
+     */
+    static std::unique_ptr<Mesh> CreateCube( ID3D11DeviceContext* deviceContext, float size = 1, bool rhcoords = true, unsigned int flags = DefaultFlags );
+    static std::unique_ptr<Mesh> CreateSphere( ID3D11DeviceContext* deviceContext, float diameter = 1, size_t tessellation = 16, bool rhcoords = true, unsigned int flags = DefaultFlags, size_t levelsOfDetail = 1 );
+    static std::unique_ptr<Mesh> CreateCone( ID3D11DeviceContext* deviceContext, float diameter = 1, float height = 1, size_t tessellation = 32, bool rhcoords = true, unsigned int flags = DefaultFlags, size_t levelsOfDetail = 1 );
+    static std::unique_ptr<Mesh> CreateTorus( ID3D11DeviceContext* deviceContext, float diameter = 1, float thickness = 0.333f, size_t tessellation = 32, bool rhcoords = true, unsigned int flags = DefaultFlags, size_t levelsOfDetail = 1 );
+    /**
+     * Create a mesh from custom geometry. The geometry is not shared with other meshes.
+     * Throws an exception if the device does not support the index format that the mesh needs.
+     */
+    static std::unique_ptr<Mesh> CreateCustom( ID3D11DeviceContext* deviceContext, const VertexCollection& vertices, const IndexCollection& indices, bool rhcoords = true, unsigned int flags = DefaultFlags );
+
+    /**
+     * Save the mesh including all levels of detail and clusters to a binary mesh file (see MeshFile.h).
+     * The contents of the vertex and index buffers are read back from the GPU.
+     */
+    void Save( ID3D11DeviceContext* deviceContext, const std::wstring& fileName ) const;
+    /**
+     * Load a mesh from a binary mesh file. The file is memory mapped and the vertex and
+     * index buffers are created directly from the mapped payloads.
+     */
+    static std::unique_ptr<Mesh> Load( ID3D11DeviceContext* deviceContext, const std::wstring& fileName );
+
+    /**
+     * Generate the geometry of the procedural shapes without creating any GPU resources.
+     * The collections are resized to the exact number of vertices and indices that are
+     * required and large meshes are generated in parallel. The generated triangles use 
+     * right-handed winding.
+     */
+    static void GenerateCube( VertexCollection& vertices, IndexCollection& indices, float size = 1 );
+    static void GenerateSphere( VertexCollection& vertices, IndexCollection& indices, float diameter = 1, size_t tessellation = 16 );
+    static void GenerateCone( VertexCollection& vertices, IndexCollection& indices, float diameter = 1, float height = 1, size_t tessellation = 32 );
+    static void GenerateTorus( VertexCollection& vertices, IndexCollection& indices, float diameter = 1, float thickness = 0.333f, size_t tessellation = 32 );
+
+    /**
+     * Meshes with fewer vertices than the threshold are generated on the calling thread,
+     * larger meshes are generated in parallel. Set the threshold to SIZE_MAX to always 
+     * generate meshes serially. The default is 16384 vertices.
+     */
+    static void set_ParallelGenerationThreshold( size_t vertexCount );
+    static size_t get_ParallelGenerationThreshold();
 
 protected:
 
@@ -55,10 +328,65 @@ private:
     Mesh( const Mesh& copy );
     virtual ~Mesh();
 
-    void Initialize( ID3D11DeviceContext* deviceContext, VertexCollection& vertices, IndexCollection& indices, bool rhcoords );
+    void Initialize( ID3D11DeviceContext* deviceContext, VertexCollection& vertices, IndexCollection& indices, bool rhcoords, unsigned int flags );
+
+    // Return a copy of the shared mesh with the given parameters. If there is no such
+    // mesh, the create function is called to create it.
+    typedef std::function<std::unique_ptr<Mesh> ()> CreateFunction;
+    static std::unique_ptr<Mesh> CreateShared( ID3D11DeviceContext* deviceContext, const GeometryKey& geometryKey, bool rhcoords, unsigned int flags, size_t levelsOfDetail, const CreateFunction& create );
+    // Initialize a level of detail from a memory mapped mesh file.
+    void Initialize( ID3D11Device* device, const MeshFileLevelOfDetail& levelOfDetail, const uint8_t* fileData );
+
+    // Generates the geometry of a procedural shape at the given tessellation.
+    typedef std::function<void ( VertexCollection&, IndexCollection&, size_t )> GenerateFunction;
+
+    // Append coarser levels of detail by repeatedly halving the tessellation of a procedural shape.
+    // segmentsPerTessellation is the number of edges around the silhouette of the shape per unit of tessellation.
+    void CreateLevelsOfDetail( ID3D11DeviceContext* deviceContext, const GenerateFunction& generate, size_t tessellation, float segmentsPerTessellation, size_t levelsOfDetail, bool rhcoords, unsigned int flags );
+
+    // The mesh that is drawn for a level of detail.
+    Mesh* get_LevelOfDetail( size_t levelOfDetail );
+
+    // The buffers that hold the geometry of this mesh (its own or the ones of its pool).
+    ID3D11Buffer* get_VertexBuffer() const;
+    ID3D11Buffer* get_IndexBuffer() const;
+    void BindBuffers( ID3D11DeviceContext* pDeviceContext ) const;
     
     Microsoft::WRL::ComPtr<ID3D11Buffer> m_VertexBuffer;
     Microsoft::WRL::ComPtr<ID3D11Buffer> m_IndexBuffer;
 
+    UINT m_VertexCount;
     UINT m_IndexCount;
+    DXGI_FORMAT m_IndexFormat;
+
+    // Object-space bounds of the (unpacked) vertices.
+    DirectX::BoundingBox m_BoundingBox;
+    DirectX::BoundingSphere m_BoundingSphere;
+
+    VertexFormat m_VertexFormat;
+    UINT m_VertexStride;
+    // Packed positions are transformed to object space with: position * m_PositionScale + m_PositionOffset.
+    DirectX::XMFLOAT3 m_PositionScale;
+    DirectX::XMFLOAT3 m_PositionOffset;
+
+    VertexCacheStatistics m_InitialVertexCacheStatistics;
+    VertexCacheStatistics m_VertexCacheStatistics;
+    WeldStatistics m_WeldStatistics;
+
+    MeshClusterCollection m_Clusters;
+
+    // The largest projected size (in pixels) this mesh should be used for when
+    // it is a level of detail of another mesh.
+    float m_MaxScreenSize;
+    // Coarser levels of detail for this mesh.
+    std::vector< std::unique_ptr<Mesh> > m_LevelsOfDetail;
+
+    // The cached mesh this mesh was copied from. It keeps the shared buffers in the geometry cache.
+    std::shared_ptr<Mesh> m_SharedMesh;
+
+    // The location of the geometry if the mesh was moved to a buffer pool. Copies of the mesh share the allocation.
+    std::shared_ptr<MeshBufferAllocation> m_BufferAllocation;
+
+    // The instances that are drawn with the next SubmitInstances. Copies of the mesh start with an empty batch.
+    std::vector<MeshInstance> m_Instances;
 };
\ No newline at end of file
@@ -0,0 +1,119 @@
+/**
+ *   @brief Shares a single vertex buffer and index buffer between many meshes.
+ */
+#pragma once
+
+#include <OffsetAllocator.h>
+#include <memory>
+
+class MeshBufferPool;
+
+/**
+ * A range of vertices and indices in a MeshBufferPool. The ranges are released when the
+ * allocation is destroyed. The offsets change when the pool is defragmented or grown, so
+ * they must be queried every time the mesh is drawn.
+ */
+class MeshBufferAllocation
+{
+public:
+    ~MeshBufferAllocation();
+
+    MeshBufferPool& get_Pool() const;
+
+    // The offsets to use for DrawIndexed.
+    UINT get_BaseVertex() const;
+    UINT get_StartIndex() const;
+
+    UINT get_VertexCount() const;
+    UINT get_IndexCount() const;
+
+private:
+    friend class MeshBufferPool;
+
+    MeshBufferAllocation( const std::shared_ptr<MeshBufferPool>& pool, OffsetAllocator::Handle vertices, OffsetAllocator::Handle indices );
+
+    // The allocation keeps the pool alive.
+    std::shared_ptr<MeshBufferPool> m_Pool;
+    OffsetAllocator::Handle m_Vertices;
+    OffsetAllocator::Handle m_Indices;
+
+    // Prevent copying.
+    MeshBufferAllocation( const MeshBufferAllocation& );
+    MeshBufferAllocation& operator=( const MeshBufferAllocation& );
+};
+
+/**
+ * A large vertex buffer and index buffer that hold the geometry of many meshes, so that they
+ * can be drawn one after another without binding new buffers (see Mesh::MoveToBufferPool and
+ * Mesh::Submit). All meshes in a pool must use the same vertex stride and index format.
+ * The ranges are managed by an OffsetAllocator per buffer. If there is no free range for a new
+ * allocation, the pool is defragmented and grown (if required) by copying the geometry into
+ * new buffers on the GPU.
+ */
+class MeshBufferPool : public std::enable_shared_from_this<MeshBufferPool>
+{
+public:
+    /**
+     * Create a new pool.
+     * @param vertexCapacity The initial size of the vertex buffer (in vertices).
+     * @param indexCapacity The initial size of the index buffer (in indices).
+     */
+    static std::shared_ptr<MeshBufferPool> Create( ID3D11Device* device, UINT vertexStride, DXGI_FORMAT indexFormat = DXGI_FORMAT_R16_UINT, UINT vertexCapacity = 65536, UINT indexCapacity = 196608 );
+
+    virtual ~MeshBufferPool();
+
+    /**
+     * Allocate a range of vertices and a range of indices. The contents of the ranges are undefined.
+     * The pool is defragmented or grown if there is not enough contiguous free space.
+     */
+    std::shared_ptr<MeshBufferAllocation> Allocate( ID3D11DeviceContext* deviceContext, UINT vertexCount, UINT indexCount );
+
+    /**
+     * Move all allocations to the beginning of the buffers. This is done automatically
+     * when an allocation fails, but can be called at a convenient time (for example
+     * after loading a level) to avoid doing it during a frame.
+     */
+    void Defragment( ID3D11DeviceContext* deviceContext );
+
+    /**
+     * Bind the vertex and index buffers and the triangle list topology to the input assembler stage.
+     */
+    void Bind( ID3D11DeviceContext* deviceContext ) const;
+
+    ID3D11Buffer* get_VertexBuffer() const;
+    ID3D11Buffer* get_IndexBuffer() const;
+    UINT get_VertexStride() const;
+    DXGI_FORMAT get_IndexFormat() const;
+    UINT get_IndexSize() const;
+
+    /**
+     * The allocators of the vertex and index buffers (for example to query their fragmentation).
+     */
+    const OffsetAllocator& get_VertexAllocator() const;
+    const OffsetAllocator& get_IndexAllocator() const;
+
+private:
+    friend class MeshBufferAllocation;
+
+    MeshBufferPool( ID3D11Device* device, UINT vertexStride, DXGI_FORMAT indexFormat, UINT vertexCapacity, UINT indexCapacity );
+
+    bool TryAllocate( UINT vertexCount, UINT indexCount, OffsetAllocator::Handle& vertices, OffsetAllocator::Handle& indices );
+    void Free( OffsetAllocator::Handle vertices, OffsetAllocator::Handle indices );
+
+    // Defragment the allocations and copy them into new buffers with the given capacities.
+    void Resize( ID3D11DeviceContext* deviceContext, UINT vertexCapacity, UINT indexCapacity );
+
+    Microsoft::WRL::ComPtr<ID3D11Device> m_Device;
+    Microsoft::WRL::ComPtr<ID3D11Buffer> m_VertexBuffer;
+    Microsoft::WRL::ComPtr<ID3D11Buffer> m_IndexBuffer;
+
+    UINT m_VertexStride;
+    DXGI_FORMAT m_IndexFormat;
+
+    OffsetAllocator m_VertexAllocator;
+    OffsetAllocator m_IndexAllocator;
+
+    // Prevent copying.
+    MeshBufferPool( const MeshBufferPool& );
+    MeshBufferPool& operator=( const MeshBufferPool& );
+};
\ No newline at end of file
@@ -0,0 +1,53 @@
+/**
+ *   @brief Split triangle lists into small clusters that can be culled
+ *   individually on the CPU.
+ */
+#pragma once
+
+#include <Mesh.h>
+
+class Camera;
+
+/**
+ * Split a triangle list into clusters of consecutive triangles. The index buffer is not
+ * reordered so the triangle order should already be optimized for locality
+ * (for example with OptimizeVertexCache).
+ * @param maxVertices The maximum number of unique vertices in a cluster.
+ * @param maxTriangles The maximum number of triangles in a cluster.
+ */
+void BuildMeshClusters( const VertexCollection& vertices, const IndexCollection& indices, size_t maxVertices, size_t maxTriangles, MeshClusterCollection& clusters );
+
+/**
+ * Culls the clusters of a mesh against the view frustum and the normal cone of each
+ * cluster. The cluster bounds are stored in SoA form so that four clusters are tested at a time.
+ */
+class MeshClusterCuller
+{
+public:
+    MeshClusterCuller();
+    explicit MeshClusterCuller( const MeshClusterCollection& clusters );
+
+    /**
+     * Replace the clusters that are culled.
+     */
+    void set_Clusters( const MeshClusterCollection& clusters );
+    size_t get_ClusterCount() const;
+
+    /**
+     * Determine which clusters of a mesh are visible.
+     * The normal cone test assumes that the world matrix does not contain non-uniform scale.
+     * @param worldMatrix The world matrix of the mesh.
+     * @param camera The camera that is used to render the mesh.
+     * @param visibleClusters The (ascending) indices of the visible clusters.
+     * @returns The number of visible clusters.
+     */
+    size_t XM_CALLCONV Cull( DirectX::FXMMATRIX worldMatrix, const Camera& camera, std::vector<UINT>& visibleClusters ) const;
+
+private:
+    // The number of clusters (without padding).
+    size_t m_ClusterCount;
+
+    // Cluster bounds in SoA form. The arrays are padded to a multiple of 4 clusters.
+    std::vector<float> m_CenterX, m_CenterY, m_CenterZ, m_Radius;
+    std::vector<float> m_AxisX, m_AxisY, m_AxisZ, m_Cutoff;
+};
\ No newline at end of file
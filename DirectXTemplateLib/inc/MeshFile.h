@@ -0,0 +1,68 @@
+/**
+ *   @brief The binary file format that is used by Mesh::Save and Mesh::Load.
+ *
+ *   A mesh file consists of a MeshFileHeader followed by one MeshFileLevelOfDetail
+ *   descriptor for each level of detail (the base mesh is level 0). The vertex, index
+ *   and cluster data of each level are stored after the descriptors. Every payload starts
+ *   at a multiple of MeshFileHeader::PayloadAlignment bytes from the beginning of the file
+ *   so that the payloads can be used directly from a memory mapped file.
+ *   All values are stored in little-endian byte order.
+ */
+#pragma once
+
+#include <Mesh.h>
+
+struct MeshFileHeader
+{
+    // "DXTM"
+    static const uint32_t FileMagic = 0x4D545844;
+    // Increment the version whenever the layout of the file changes.
+    static const uint32_t FileVersion = 2;
+    static const uint32_t PayloadAlignment = 16;
+
+    uint32_t Magic;
+    uint32_t Version;
+    // The size of the file in bytes.
+    uint64_t FileSize;
+    // The number of MeshFileLevelOfDetail descriptors that follow the header.
+    uint32_t LevelOfDetailCount;
+    uint32_t Reserved;
+};
+
+struct MeshFileLevelOfDetail
+{
+    // Vertex format descriptor. VertexFormat is a Mesh::VertexFormat value.
+    uint32_t VertexFormat;
+    uint32_t VertexStride;
+    uint32_t VertexCount;
+    // The size of an index in bytes (2 or 4).
+    uint32_t IndexSize;
+    uint32_t IndexCount;
+    uint32_t ClusterCount;
+
+    // The largest projected size (in pixels) this level is used for.
+    float MaxScreenSize;
+
+    // Maps packed positions to object space (see PositionQuantization).
+    float PositionScale[3];
+    float PositionOffset[3];
+
+    // The object-space axis-aligned bounding box of the mesh.
+    float BoundsMin[3];
+    float BoundsMax[3];
+    // The object-space bounding sphere of the mesh (xyz: center, w: radius).
+    float BoundingSphere[4];
+
+    VertexCacheStatistics InitialCacheStatistics;
+    VertexCacheStatistics CacheStatistics;
+    uint32_t Reserved;
+
+    // Byte offsets of the payloads from the start of the file.
+    uint64_t VertexDataOffset;
+    uint64_t IndexDataOffset;
+    // An array of ClusterCount MeshCluster structures.
+    uint64_t ClusterDataOffset;
+};
+
+static_assert( sizeof(MeshFileHeader) == 24, "Unexpected size of the mesh file header." );
+static_assert( sizeof(MeshFileLevelOfDetail) == 136, "Unexpected size of the mesh file level of detail descriptor." );
\ No newline at end of file
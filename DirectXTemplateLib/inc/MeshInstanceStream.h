@@ -0,0 +1,68 @@
+/**
+ *   @brief A dynamic vertex buffer that the instances of the instanced mesh draws of a frame are written to.
+ */
+#pragma once
+
+// The per-instance data of an instanced mesh draw.
+struct MeshInstance
+{
+    // The world matrix. For packed vertex formats it includes the dequantization of the positions.
+    DirectX::XMFLOAT4X4 WorldMatrix;
+    // The inverse transpose of the world matrix to transform the normals.
+    DirectX::XMFLOAT4X4 InverseTransposeWorldMatrix;
+    // The index of the material in the material table.
+    UINT MaterialIndex;
+    // Add some padding to make the instance size a multiple of 16 bytes.
+    UINT Padding[3];
+
+    // The input elements of the instance data (WORLDMATRIX, INVERSETRANSPOSEWORLDMATRIX and MATERIALINDEX).
+    // They use input slot 1, so they can be combined with the vertex input elements in slot 0.
+    static const UINT InputSlot = 1;
+    static const int InputElementCount = 9;
+    static const D3D11_INPUT_ELEMENT_DESC InputElements[InputElementCount];
+};
+
+/**
+ * Instances are appended to the buffer with D3D11_MAP_WRITE_NO_OVERWRITE. When the buffer is
+ * full, it is discarded and filled again from the start, so instances that were appended
+ * for draws that have already been issued are never overwritten. The buffer is bound to
+ * MeshInstance::InputSlot and draws select their instances with the start instance location.
+ */
+class MeshInstanceStream
+{
+public:
+    MeshInstanceStream();
+
+    /**
+     * Create the buffer.
+     * @param capacity The number of instances that fit into the buffer.
+     * @returns false if the buffer could not be created.
+     */
+    bool Initialize( ID3D11Device* device, UINT capacity );
+
+    /**
+     * Copy instances to the buffer.
+     * @param startInstance The index of the first instance in the buffer (the start instance location of the draw).
+     * @returns false if the instances don't fit into the buffer or the buffer could not be mapped.
+     */
+    bool Append( ID3D11DeviceContext* deviceContext, const MeshInstance* instances, UINT instanceCount, UINT& startInstance );
+
+    /**
+     * Bind the buffer to MeshInstance::InputSlot.
+     */
+    void Bind( ID3D11DeviceContext* deviceContext ) const;
+
+    UINT get_Capacity() const;
+    ID3D11Buffer* get_Buffer() const;
+
+private:
+    // Prevent copying.
+    MeshInstanceStream( const MeshInstanceStream& copy );
+    MeshInstanceStream& operator=( const MeshInstanceStream& other );
+
+    Microsoft::WRL::ComPtr<ID3D11Buffer> m_d3dBuffer;
+
+    UINT m_Capacity;
+    // The index of the next instance that is written. The buffer is discarded when it is 0.
+    UINT m_InstanceCount;
+};
\ No newline at end of file
@@ -0,0 +1,65 @@
+/**
+ *   @brief Functions to optimize the index and vertex order of triangle lists
+ *   for the post-transform vertex cache and vertex fetch.
+ */
+#pragma once
+
+#include <Mesh.h>
+
+/**
+ * Simulate a FIFO post-transform vertex cache to measure the efficiency of an index buffer.
+ * @param indices The triangle list to analyze.
+ * @param vertexCount The number of vertices referenced by the index buffer.
+ * @param cacheSize The number of entries in the simulated vertex cache.
+ */
+VertexCacheStatistics AnalyzeVertexCache( const IndexCollection& indices, size_t vertexCount, size_t cacheSize = 16 );
+
+/**
+ * Reorder the triangles of a triangle list to improve post-transform vertex cache
+ * utilization. This is an implementation of Tom Forsyth's "Linear-Speed Vertex Cache Optimisation".
+ * The optimization is independent of the actual cache size of the hardware.
+ * @param indices The triangle list to reorder.
+ * @param vertexCount The number of vertices referenced by the index buffer.
+ */
+void OptimizeVertexCache( IndexCollection& indices, size_t vertexCount );
+
+/**
+ * Reorder the vertices so they appear in the same order as they are first referenced
+ * in the index buffer. This improves the locality of the vertex fetch and should be
+ * run after OptimizeVertexCache. Vertices that are not referenced are removed.
+ * @returns The number of vertices after the vertex buffer has been reordered.
+ */
+size_t OptimizeVertexFetch( VertexCollection& vertices, IndexCollection& indices );
+
+/**
+ * The maximum per-component differences of two vertices that are welded.
+ * A tolerance of 0 only welds vertices with identical attributes.
+ */
+struct WeldTolerances
+{
+    WeldTolerances( float position = 0.0f, float normal = 0.0f, float textureCoordinate = 0.0f )
+        : Position( position )
+        , Normal( normal )
+        , TextureCoordinate( textureCoordinate )
+    {}
+
+    float Position;
+    float Normal;
+    float TextureCoordinate;
+};
+
+/**
+ * Merge vertices whose position, normal and texture coordinates are all within the given tolerances,
+ * then remove degenerate triangles and vertices that are no longer referenced. Candidate vertices are
+ * found with a spatial hash of the positions so the pass runs in linear time.
+ * The remaining vertices keep their relative order.
+ * @param remap If not null, receives the new index of every input vertex (UINT_MAX if the vertex was removed).
+ */
+WeldStatistics WeldVertices( VertexCollection& vertices, IndexCollection& indices, const WeldTolerances& tolerances = WeldTolerances(), std::vector<uint32_t>* remap = nullptr );
+
+/**
+ * Remove triangles with two corners whose positions are within the tolerance (regardless of their
+ * other attributes) or whose corners are collinear.
+ * @returns The number of removed triangles.
+ */
+size_t RemoveDegenerateTriangles( const VertexCollection& vertices, IndexCollection& indices, float positionTolerance = 0.0f );
@@ -0,0 +1,81 @@
+/**
+ *   @brief Manages the allocation of ranges in a linear resource (for example the
+ *   elements of a vertex or index buffer). The allocator does not access the
+ *   resource itself, so it can be used (and tested) without a device.
+ */
+#pragma once
+
+#include <map>
+#include <vector>
+
+class OffsetAllocator
+{
+public:
+    // Identifies an allocation. Handles stay valid when the allocation is moved by Defragment.
+    typedef UINT Handle;
+    static const Handle InvalidHandle = UINT_MAX;
+
+    // Describes a range that must be copied to complete a defragmentation.
+    struct Move
+    {
+        Handle Allocation;
+        UINT SourceOffset;
+        UINT DestinationOffset;
+        UINT Size;
+    };
+
+    explicit OffsetAllocator( UINT capacity = 0 );
+
+    /**
+     * Allocate a range of the given size (which must be greater than 0). The smallest free
+     * range that fits is used to reduce fragmentation.
+     * @returns The handle of the allocation or InvalidHandle if there is no free range that is large enough.
+     */
+    Handle Allocate( UINT size );
+    void Free( Handle handle );
+
+    UINT get_Offset( Handle handle ) const;
+    UINT get_Size( Handle handle ) const;
+
+    /**
+     * Increase the capacity. The new space is added to the end of the resource.
+     */
+    void Grow( UINT capacity );
+
+    /**
+     * Move all allocations to the beginning of the resource (in order of their offsets) so that
+     * the free space is a single range at the end. The caller must copy the contents of each
+     * returned move from the old to the new offset. The moves are sorted by destination
+     * offset and only move ranges towards the beginning of the resource.
+     */
+    void Defragment( std::vector<Move>& moves );
+
+    UINT get_Capacity() const;
+    UINT get_UsedSize() const;
+    UINT get_FreeSize() const;
+    UINT get_LargestFreeRange() const;
+    UINT get_FreeRangeCount() const;
+    UINT get_AllocationCount() const;
+
+private:
+    void AddFreeRange( UINT offset, UINT size );
+    void RemoveFreeRange( std::map<UINT, UINT>::iterator range );
+
+    struct Range
+    {
+        UINT Offset;
+        UINT Size;
+    };
+
+    UINT m_Capacity;
+    UINT m_UsedSize;
+    UINT m_AllocationCount;
+
+    // Allocations indexed by handle. Unused handles have a size of 0.
+    std::vector<Range> m_Allocations;
+    std::vector<Handle> m_UnusedHandles;
+
+    // Free ranges by offset (for merging adjacent ranges) and by size (for best-fit allocation).
+    std::map<UINT, UINT> m_FreeRanges;
+    std::multimap<UINT, UINT> m_FreeRangesBySize;
+};
\ No newline at end of file
@@ -0,0 +1,93 @@
+/**
+ *   @brief Quantized variants of VertexPositionNormalTexture and the functions
+ *   to convert between the full precision and the packed vertex formats.
+ */
+#pragma once
+
+#include <Mesh.h>
+
+// Packed vertex with half precision positions (relative to the center of the mesh's AABB),
+// an octahedral encoded normal and half precision texture coordinates (16 bytes).
+struct VertexPositionNormalTextureHalf
+{
+    // xyz: position relative to PositionQuantization::Offset, w: 1.
+    DirectX::PackedVector::XMHALF4 position;
+    // Octahedral encoded normal. Use DecodeOctahedralNormal to reconstruct the normal.
+    DirectX::PackedVector::XMSHORTN2 normal;
+    DirectX::PackedVector::XMHALF2 textureCoordinate;
+
+    static const int InputElementCount = 3;
+    static const D3D11_INPUT_ELEMENT_DESC InputElements[InputElementCount];
+};
+
+// Packed vertex with 16-bit normalized positions (relative to the mesh's AABB),
+// an octahedral encoded normal and half precision texture coordinates (16 bytes).
+struct VertexPositionNormalTextureUnorm16
+{
+    // xyz: position in the [0...1] range of the AABB, w: 1.
+    DirectX::PackedVector::XMUSHORTN4 position;
+    // Octahedral encoded normal. Use DecodeOctahedralNormal to reconstruct the normal.
+    DirectX::PackedVector::XMSHORTN2 normal;
+    DirectX::PackedVector::XMHALF2 textureCoordinate;
+
+    static const int InputElementCount = 3;
+    static const D3D11_INPUT_ELEMENT_DESC InputElements[InputElementCount];
+};
+
+/**
+ * Maps packed positions back to object space: position = packedPosition * Scale + Offset.
+ */
+struct PositionQuantization
+{
+    DirectX::XMFLOAT3 Scale;
+    DirectX::XMFLOAT3 Offset;
+};
+
+/**
+ * Compute the quantization for half precision positions. Positions are stored relative to the
+ * center of the AABB of the vertices so the error of a coordinate is at most 2^-11 times
+ * its distance to the center (half precision has an 11-bit significand).
+ */
+PositionQuantization ComputeHalfQuantization( const VertexCollection& vertices );
+/**
+ * Compute the quantization for 16-bit normalized positions. The AABB of the vertices is mapped to
+ * the [0...1] range so the error of a coordinate is at most the size of the AABB / (2 * 65535).
+ */
+PositionQuantization ComputeUnorm16Quantization( const VertexCollection& vertices );
+
+/**
+ * Encode a unit length normal using octahedral mapping into two 16-bit normalized values.
+ * The encoding searches the neighbouring quantized values for the one that decodes to the
+ * closest normal so the angular error is minimal for the given precision.
+ */
+DirectX::PackedVector::XMSHORTN2 XM_CALLCONV EncodeOctahedralNormal( DirectX::FXMVECTOR normal );
+/**
+ * Decode an octahedral encoded normal. The result has unit length.
+ */
+DirectX::XMVECTOR XM_CALLCONV DecodeOctahedralNormal( const DirectX::PackedVector::XMSHORTN2& encodedNormal );
+
+/**
+ * Encode a vertex into a packed vertex format.
+ */
+void EncodeVertex( const VertexPositionNormalTexture& vertex, const PositionQuantization& quantization, VertexPositionNormalTextureHalf& packedVertex );
+void EncodeVertex( const VertexPositionNormalTexture& vertex, const PositionQuantization& quantization, VertexPositionNormalTextureUnorm16& packedVertex );
+
+/**
+ * Decode a packed vertex. This performs the same conversion as the input assembler
+ * and DecodeOctahedralNormal so it can be used to verify the precision of a packed mesh.
+ */
+void DecodeVertex( const VertexPositionNormalTextureHalf& packedVertex, const PositionQuantization& quantization, VertexPositionNormalTexture& vertex );
+void DecodeVertex( const VertexPositionNormalTextureUnorm16& packedVertex, const PositionQuantization& quantization, VertexPositionNormalTexture& vertex );
+
+/**
+ * Encode all vertices of a mesh.
+ */
+template<typename PackedVertex>
+void EncodeVertices( const VertexCollection& vertices, const PositionQuantization& quantization, std::vector<PackedVertex>& packedVertices )
+{
+    packedVertices.resize( vertices.size() );
+    for ( size_t i = 0; i < vertices.size(); ++i )
+    {
+        EncodeVertex( vertices[i], quantization, packedVertices[i] );
+    }
+}
\ No newline at end of file
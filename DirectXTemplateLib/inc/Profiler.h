@@ -0,0 +1,100 @@
+/**
+ *   @brief A low-overhead CPU profiler for nested scopes with export to the
+ *   Chrome trace event format (chrome://tracing or https://ui.perfetto.dev).
+ */
+#pragma once
+
+#include <cstdint>
+
+// Define PROFILER_ENABLED as 0 to remove all PROFILE_SCOPE and PROFILE_FUNCTION zones from the build.
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+#if PROFILER_ENABLED
+#define PROFILER_CONCATENATE_( a, b ) a##b
+#define PROFILER_CONCATENATE( a, b ) PROFILER_CONCATENATE_( a, b )
+/**
+ * Measure the time until the end of the enclosing scope. The name must be a string literal
+ * (or another string with static storage duration) because only the pointer is recorded.
+ */
+#define PROFILE_SCOPE( name ) ProfilerScope PROFILER_CONCATENATE( profilerScope, __LINE__ )( name )
+#define PROFILE_FUNCTION() PROFILE_SCOPE( __FUNCTION__ )
+#else
+#define PROFILE_SCOPE( name ) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#endif
+
+/**
+ * Every thread that records a scope gets its own ring buffer of the last EventsPerThread scopes.
+ * Only the owning thread writes to its buffer so recording a scope does not take a lock
+ * or allocate memory (except for the buffer itself the first time a thread records a scope).
+ * The buffers can be exported from any thread while the other threads keep recording.
+ */
+class Profiler
+{
+public:
+    static const size_t EventsPerThread = 1 << 16;
+
+    /**
+     * Recording can be paused at runtime. Scopes that are open when the profiler is
+     * disabled are still recorded.
+     */
+    static void set_Enabled( bool enabled );
+    static bool get_Enabled();
+
+    /**
+     * Name the calling thread in the exported trace. The name must have static storage duration.
+     */
+    static void set_ThreadName( const char* name );
+
+    /**
+     * The current value of the performance counter. Returns 0 if the profiler is disabled.
+     */
+    static int64_t BeginScope();
+    /**
+     * Record a scope that started at the time returned by BeginScope.
+     */
+    static void EndScope( const char* name, int64_t startTime );
+
+    /**
+     * Discard the recorded scopes of all threads.
+     */
+    static void Clear();
+
+    /**
+     * Write the recorded scopes of all threads as complete ("X") events in the Chrome trace event JSON format.
+     * @returns false if the file could not be written.
+     */
+    static bool SaveChromeTrace( const std::wstring& fileName );
+};
+
+#if PROFILER_ENABLED
+/**
+ * Records the time between its construction and destruction. Use the PROFILE_SCOPE macro.
+ */
+class ProfilerScope
+{
+public:
+    explicit ProfilerScope( const char* name )
+        : m_Name( name )
+        , m_StartTime( Profiler::BeginScope() )
+    {}
+
+    ~ProfilerScope()
+    {
+        if ( m_StartTime != 0 )
+        {
+            Profiler::EndScope( m_Name, m_StartTime );
+        }
+    }
+
+private:
+    // Prevent copying.
+    ProfilerScope( const ProfilerScope& copy );
+    ProfilerScope& operator=( const ProfilerScope& other );
+
+    const char* m_Name;
+    int64_t m_StartTime;
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,56 @@
+/**
+ *   @brief A device context that counts the calls that are made to it.
+ */
+#pragma once
+
+#include <DeviceContextWrapper.h>
+
+/**
+ * Counts the calls of each device context method and the number of vertices that are drawn.
+ * The calls are forwarded to the wrapped device context (if any).
+ */
+class RecordingDeviceContext : public DeviceContextWrapper
+{
+public:
+    /**
+     * @param context The device context to forward the calls to (nullptr to only count the calls).
+     */
+    explicit RecordingDeviceContext( ID3D11DeviceContext* context = nullptr );
+
+    /**
+     * The number of calls of a device context method since the last Reset.
+     */
+    uint64_t get_CallCount( Call call ) const;
+    /**
+     * The number of calls of all device context methods since the last Reset.
+     */
+    uint64_t get_TotalCallCount() const;
+    /**
+     * The number of vertices (or indices) that were drawn by all instances
+     * of the non-indirect draw calls since the last Reset.
+     */
+    uint64_t get_DrawnVertexCount() const;
+
+    /**
+     * Set all counts to 0.
+     */
+    void Reset();
+
+    /**
+     * Write the counts of the methods that were called.
+     * @param frameCount The counts are also written divided by the frame count.
+     */
+    void Print( std::ostream& stream, uint64_t frameCount = 1 ) const;
+
+    virtual void STDMETHODCALLTYPE Draw( UINT VertexCount, UINT StartVertexLocation );
+    virtual void STDMETHODCALLTYPE DrawIndexed( UINT IndexCount, UINT StartIndexLocation, INT BaseVertexLocation );
+    virtual void STDMETHODCALLTYPE DrawInstanced( UINT VertexCountPerInstance, UINT InstanceCount, UINT StartVertexLocation, UINT StartInstanceLocation );
+    virtual void STDMETHODCALLTYPE DrawIndexedInstanced( UINT IndexCountPerInstance, UINT InstanceCount, UINT StartIndexLocation, INT BaseVertexLocation, UINT StartInstanceLocation );
+
+protected:
+    virtual void OnCall( Call call );
+
+private:
+    uint64_t m_CallCounts[CallCount];
+    uint64_t m_DrawnVertexCount;
+};
\ No newline at end of file
@@ -0,0 +1,120 @@
+/**
+ *   @brief Sorts draw submissions by a packed 64-bit key and dispatches them in key order.
+ */
+#pragma once
+
+#include <functional>
+
+/**
+ * The fields of a sort key. Opaque submissions are sorted by layer, shader, material, mesh
+ * and front to back, so submissions that share pipeline state are dispatched together and
+ * near objects occlude far ones. Translucent submissions are sorted after the opaque ones of
+ * their layer and back to front before the state, so they are blended in the correct order.
+ *
+ * Bits (most significant first):
+ *   Opaque:      Layer (4) | 0 | Shader (10) | Material (16) | Mesh (16) | Depth (17)
+ *   Translucent: Layer (4) | 1 | Inverted depth (17) | Shader (10) | Material (16) | Mesh (16)
+ */
+struct RenderKey
+{
+    static const UINT LayerBits = 4;
+    static const UINT ShaderBits = 10;
+    static const UINT MaterialBits = 16;
+    static const UINT MeshBits = 16;
+    static const UINT DepthBits = 17;
+
+    // The fields that differ between two keys (see RenderQueue::Dispatch).
+    enum Changes
+    {
+        NoChanges           = 0x0,
+        LayerChanged        = 0x1,
+        TranslucencyChanged = 0x2,
+        ShaderChanged       = 0x4,
+        MaterialChanged     = 0x8,
+        MeshChanged         = 0x10,
+        AllChanged          = 0x1F,
+    };
+
+    RenderKey();
+    RenderKey( UINT layer, bool translucent, UINT shader, UINT material, UINT mesh, UINT depth );
+
+    uint64_t Pack() const;
+    static RenderKey Unpack( uint64_t key );
+
+    /**
+     * The fields (except the depth) that differ between two keys.
+     */
+    static unsigned int get_Changes( uint64_t previousKey, uint64_t key );
+
+    /**
+     * Quantize a view-space depth to DepthBits. The quantization keeps the upper bits of the
+     * float, so the precision is relative to the depth and no far plane is required.
+     * Depths <= 0 are mapped to 0.
+     */
+    static UINT QuantizeDepth( float depth );
+
+    UINT Layer;
+    bool Translucent;
+    UINT Shader;
+    UINT Material;
+    UINT Mesh;
+    UINT Depth;
+};
+
+// A submission to the render queue.
+struct RenderItem
+{
+    uint64_t Key;
+    // Identifies the draw for the dispatch function (for example an index into an array of draws).
+    UINT Data;
+};
+
+/**
+ * Collects the draws of a frame, sorts them by their keys with an LSD radix sort and calls a
+ * dispatch function for each draw in key order. The dispatch function is told which key fields
+ * changed since the previous draw, so it only sets the state that differs. The queue does not
+ * access the device, so sorting and dispatching can be benchmarked without one.
+ */
+class RenderQueue
+{
+public:
+    typedef std::function<void( const RenderItem& item, unsigned int changes )> DispatchFunction;
+
+    RenderQueue();
+
+    void Clear();
+    void Reserve( size_t itemCount );
+
+    void Submit( uint64_t key, UINT data );
+    void Submit( const RenderKey& key, UINT data );
+
+    /**
+     * Sort the items by their keys. The sort is stable and skips the passes over bytes that are
+     * the same in all keys, so it takes up to 8 passes over the items (none if all keys are equal).
+     */
+    void Sort();
+
+    /**
+     * Call the dispatch function for each item in the order of the queue. The changes of the
+     * first item are RenderKey::AllChanged.
+     */
+    void Dispatch( const DispatchFunction& dispatch ) const;
+
+    const std::vector<RenderItem>& get_Items() const;
+    /**
+     * The number of passes over the items of the last Sort.
+     */
+    UINT get_SortPassCount() const;
+
+private:
+    // Prevent copying.
+    RenderQueue( const RenderQueue& copy );
+    RenderQueue& operator=( const RenderQueue& other );
+
+    std::vector<RenderItem> m_Items;
+    // The items are sorted back and forth between the queue and this buffer.
+    std::vector<RenderItem> m_SortBuffer;
+    // The number of keys with each value of each byte. Cleared by every sort.
+    size_t m_Histograms[8][256];
+    UINT m_SortPassCount;
+};
\ No newline at end of file
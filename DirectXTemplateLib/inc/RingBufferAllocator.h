@@ -0,0 +1,83 @@
+/**
+ *   @brief Allocates the per-frame ranges of a dynamic buffer in a ring. The allocator
+ *   does not access the buffer or the GPU, so it can be used (and tested) without a device.
+ */
+#pragma once
+
+#include <deque>
+
+/**
+ * Allocates ranges linearly from a ring of a fixed capacity. The ranges that are allocated
+ * during a frame stay in use until the fence value of the frame has been completed by the GPU.
+ * Allocations wrap around to the beginning of the ring when there is no space left at the end.
+ *
+ * If a range does not fit in the free space, the allocator discards the whole ring and starts
+ * again at offset 0. The caller must then map the buffer with D3D11_MAP_WRITE_DISCARD (so the
+ * driver gives it new memory while the GPU still reads the old one). Otherwise the buffer is
+ * mapped with D3D11_MAP_WRITE_NO_OVERWRITE.
+ */
+class RingBufferAllocator
+{
+public:
+    static const UINT InvalidOffset = UINT_MAX;
+
+    explicit RingBufferAllocator( UINT capacity );
+
+    /**
+     * Allocate a range of the given size (which must be greater than 0).
+     * @param alignment The alignment of the offset (a power of 2).
+     * @param discard Set to true if the ring was discarded to make space for the range.
+     * @returns The offset of the range or InvalidOffset if the size exceeds the capacity.
+     */
+    UINT Allocate( UINT size, UINT alignment, bool& discard );
+
+    /**
+     * The ranges that were allocated since the last call are used by the GPU until
+     * the fence value is completed. Fence values must increase from frame to frame.
+     */
+    void FinishFrame( uint64_t fenceValue );
+
+    /**
+     * Release the ranges of all frames with a fence value less than or equal to the completed fence value.
+     */
+    void ReleaseFrames( uint64_t completedFenceValue );
+
+    /**
+     * Release all ranges and start again at offset 0.
+     */
+    void Discard();
+
+    UINT get_Capacity() const;
+    /**
+     * The number of bytes that are in use (including the alignment padding and
+     * the unused space at the end of the ring when an allocation has wrapped around).
+     */
+    UINT get_UsedSize() const;
+    /**
+     * The number of frames whose ranges are still in use by the GPU.
+     */
+    UINT get_FrameCount() const;
+
+private:
+    struct Frame
+    {
+        uint64_t FenceValue;
+        // The offset after the last range of the frame.
+        UINT EndOffset;
+        // The value of m_AllocatedSize after the last range of the frame.
+        uint64_t AllocatedSize;
+    };
+
+    UINT m_Capacity;
+    // The offset after the last allocated range.
+    UINT m_Head;
+    // The offset of the oldest range that is still in use.
+    UINT m_Tail;
+
+    // The total number of bytes that have been allocated and released. The difference is the used size,
+    // which tells a full ring from an empty ring when the head and the tail are at the same offset.
+    uint64_t m_AllocatedSize;
+    uint64_t m_ReleasedSize;
+
+    std::deque<Frame> m_Frames;
+};
\ No newline at end of file
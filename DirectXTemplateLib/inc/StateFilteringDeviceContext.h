@@ -0,0 +1,235 @@
+/**
+ *   @brief A device context that drops the set calls which bind state that is already bound.
+ */
+#pragma once
+
+#include <DeviceContextWrapper.h>
+
+/**
+ * Shadows the pipeline state that is bound to the wrapped device context and only forwards
+ * the set calls that change it. A call that binds several slots is narrowed to the slots that
+ * changed. The issued (forwarded) and elided calls are counted for each method.
+ *
+ * The shadowed state starts out unknown, so the first set call of every state is forwarded.
+ * Binding a render target, unordered access view or stream output target forgets the bound
+ * inputs (the runtime unbinds resources that are bound as input and output at the same time).
+ * ClearState, ExecuteCommandList and FinishCommandList forget the shadowed state if they reset
+ * the state of the context. Call InvalidateState if the wrapped device context is used directly.
+ *
+ * The bound objects are shadowed as raw pointers. The wrapped device context holds a reference
+ * to every bound object, so an object is not released (and its address is not reused) while it
+ * is shadowed. Without a wrapped device context the objects must stay alive while they are bound.
+ */
+class StateFilteringDeviceContext : public DeviceContextWrapper
+{
+public:
+    /**
+     * @param context The device context to forward the calls to (nullptr to only filter and count the calls).
+     */
+    explicit StateFilteringDeviceContext( ID3D11DeviceContext* context = nullptr );
+
+    /**
+     * The number of calls of a device context method that were forwarded since the last Reset.
+     */
+    uint64_t get_IssuedCallCount( Call call ) const;
+    /**
+     * The number of calls of a device context method that were dropped since the last Reset.
+     */
+    uint64_t get_ElidedCallCount( Call call ) const;
+    /**
+     * The number of calls of all device context methods that were forwarded since the last Reset.
+     */
+    uint64_t get_TotalIssuedCallCount() const;
+    /**
+     * The number of calls of all device context methods that were dropped since the last Reset.
+     */
+    uint64_t get_TotalElidedCallCount() const;
+
+    /**
+     * Set all counts to 0. The shadowed state is kept.
+     */
+    void Reset();
+
+    /**
+     * Forget the shadowed state, so the next set call of every state is forwarded.
+     */
+    void InvalidateState();
+
+    /**
+     * Write the issued and elided counts of the methods that were filtered.
+     * @param frameCount The counts are also written divided by the frame count.
+     */
+    void Print( std::ostream& stream, uint64_t frameCount = 1 ) const;
+
+    // Pipeline state.
+    virtual void STDMETHODCALLTYPE IASetInputLayout( ID3D11InputLayout* pInputLayout );
+    virtual void STDMETHODCALLTYPE IASetVertexBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppVertexBuffers, const UINT* pStrides, const UINT* pOffsets );
+    virtual void STDMETHODCALLTYPE IASetIndexBuffer( ID3D11Buffer* pIndexBuffer, DXGI_FORMAT Format, UINT Offset );
+    virtual void STDMETHODCALLTYPE IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY Topology );
+    virtual void STDMETHODCALLTYPE VSSetShader( ID3D11VertexShader* pVertexShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances );
+    virtual void STDMETHODCALLTYPE VSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers );
+    virtual void STDMETHODCALLTYPE VSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants );
+    virtual void STDMETHODCALLTYPE VSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews );
+    virtual void STDMETHODCALLTYPE VSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers );
+    virtual void STDMETHODCALLTYPE HSSetShader( ID3D11HullShader* pHullShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances );
+    virtual void STDMETHODCALLTYPE HSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers );
+    virtual void STDMETHODCALLTYPE HSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants );
+    virtual void STDMETHODCALLTYPE HSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews );
+    virtual void STDMETHODCALLTYPE HSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers );
+    virtual void STDMETHODCALLTYPE DSSetShader( ID3D11DomainShader* pDomainShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances );
+    virtual void STDMETHODCALLTYPE DSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers );
+    virtual void STDMETHODCALLTYPE DSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants );
+    virtual void STDMETHODCALLTYPE DSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews );
+    virtual void STDMETHODCALLTYPE DSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers );
+    virtual void STDMETHODCALLTYPE GSSetShader( ID3D11GeometryShader* pGeometryShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances );
+    virtual void STDMETHODCALLTYPE GSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers );
+    virtual void STDMETHODCALLTYPE GSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants );
+    virtual void STDMETHODCALLTYPE GSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews );
+    virtual void STDMETHODCALLTYPE GSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers );
+    virtual void STDMETHODCALLTYPE PSSetShader( ID3D11PixelShader* pPixelShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances );
+    virtual void STDMETHODCALLTYPE PSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers );
+    virtual void STDMETHODCALLTYPE PSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants );
+    virtual void STDMETHODCALLTYPE PSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews );
+    virtual void STDMETHODCALLTYPE PSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers );
+    virtual void STDMETHODCALLTYPE CSSetShader( ID3D11ComputeShader* pComputeShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances );
+    virtual void STDMETHODCALLTYPE CSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers );
+    virtual void STDMETHODCALLTYPE CSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants );
+    virtual void STDMETHODCALLTYPE CSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews );
+    virtual void STDMETHODCALLTYPE CSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers );
+    virtual void STDMETHODCALLTYPE CSSetUnorderedAccessViews( UINT StartSlot, UINT NumUAVs, ID3D11UnorderedAccessView* const* ppUnorderedAccessViews, const UINT* pUAVInitialCounts );
+    virtual void STDMETHODCALLTYPE SOSetTargets( UINT NumBuffers, ID3D11Buffer* const* ppSOTargets, const UINT* pOffsets );
+    virtual void STDMETHODCALLTYPE RSSetState( ID3D11RasterizerState* pRasterizerState );
+    virtual void STDMETHODCALLTYPE RSSetViewports( UINT NumViewports, const D3D11_VIEWPORT* pViewports );
+    virtual void STDMETHODCALLTYPE RSSetScissorRects( UINT NumRects, const D3D11_RECT* pRects );
+    virtual void STDMETHODCALLTYPE OMSetRenderTargets( UINT NumViews, ID3D11RenderTargetView* const* ppRenderTargetViews, ID3D11DepthStencilView* pDepthStencilView );
+    virtual void STDMETHODCALLTYPE OMSetRenderTargetsAndUnorderedAccessViews( UINT NumRTVs, ID3D11RenderTargetView* const* ppRenderTargetViews, ID3D11DepthStencilView* pDepthStencilView, UINT UAVStartSlot, UINT NumUAVs, ID3D11UnorderedAccessView* const* ppUnorderedAccessViews, const UINT* pUAVInitialCounts );
+    virtual void STDMETHODCALLTYPE OMSetBlendState( ID3D11BlendState* pBlendState, const FLOAT BlendFactor[4], UINT SampleMask );
+    virtual void STDMETHODCALLTYPE OMSetDepthStencilState( ID3D11DepthStencilState* pDepthStencilState, UINT StencilRef );
+
+    // Device context.
+    virtual void STDMETHODCALLTYPE ClearState();
+    virtual void STDMETHODCALLTYPE ExecuteCommandList( ID3D11CommandList* pCommandList, BOOL RestoreContextState );
+    virtual HRESULT STDMETHODCALLTYPE FinishCommandList( BOOL RestoreDeferredContextState, ID3D11CommandList** ppCommandList );
+    virtual void STDMETHODCALLTYPE SwapDeviceContextState( ID3DDeviceContextState* pState, ID3DDeviceContextState** ppPreviousState );
+
+protected:
+    virtual void OnCall( Call call );
+
+private:
+    enum Stage
+    {
+        VertexStage,
+        HullStage,
+        DomainStage,
+        GeometryStage,
+        PixelStage,
+        ComputeStage,
+        StageCount
+    };
+
+    // A value of the pipeline state and whether it is known to be bound.
+    template<typename T>
+    struct Shadow
+    {
+        Shadow()
+            : Value()
+            , Known( false )
+        {}
+
+        T Value;
+        bool Known;
+    };
+
+    struct VertexBufferBinding
+    {
+        ID3D11Buffer* Buffer;
+        UINT Stride;
+        UINT Offset;
+
+        bool operator==( const VertexBufferBinding& other ) const;
+    };
+
+    struct IndexBufferBinding
+    {
+        ID3D11Buffer* Buffer;
+        DXGI_FORMAT Format;
+        UINT Offset;
+
+        bool operator==( const IndexBufferBinding& other ) const;
+    };
+
+    // FirstConstant and NumConstants are 0 if the whole buffer is bound.
+    struct ConstantBufferBinding
+    {
+        ID3D11Buffer* Buffer;
+        UINT FirstConstant;
+        UINT NumConstants;
+
+        bool operator==( const ConstantBufferBinding& other ) const;
+    };
+
+    struct BlendStateBinding
+    {
+        ID3D11BlendState* BlendState;
+        FLOAT BlendFactor[4];
+        UINT SampleMask;
+
+        bool operator==( const BlendStateBinding& other ) const;
+    };
+
+    struct DepthStencilStateBinding
+    {
+        ID3D11DepthStencilState* DepthStencilState;
+        UINT StencilRef;
+
+        bool operator==( const DepthStencilStateBinding& other ) const;
+    };
+
+    struct StageState
+    {
+        Shadow<ID3D11DeviceChild*> Shader;
+        Shadow<ConstantBufferBinding> ConstantBuffers[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+        Shadow<ID3D11ShaderResourceView*> ShaderResources[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT];
+        Shadow<ID3D11SamplerState*> Samplers[D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT];
+    };
+
+    struct PipelineState
+    {
+        Shadow<ID3D11InputLayout*> InputLayout;
+        Shadow<VertexBufferBinding> VertexBuffers[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+        Shadow<IndexBufferBinding> IndexBuffer;
+        Shadow<D3D11_PRIMITIVE_TOPOLOGY> PrimitiveTopology;
+        StageState Stages[StageCount];
+        Shadow<ID3D11RasterizerState*> RasterizerState;
+        UINT ViewportCount;
+        D3D11_VIEWPORT Viewports[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
+        bool ViewportsKnown;
+        UINT ScissorRectCount;
+        D3D11_RECT ScissorRects[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
+        bool ScissorRectsKnown;
+        Shadow<BlendStateBinding> BlendState;
+        Shadow<DepthStencilStateBinding> DepthStencilState;
+    };
+
+    // Prevent copying.
+    StateFilteringDeviceContext( const StateFilteringDeviceContext& copy );
+    StateFilteringDeviceContext& operator=( const StateFilteringDeviceContext& other );
+
+    // Each filter function updates the shadowed state and returns true if the call must be forwarded.
+    // The functions that filter slots narrow the call to the slots [StartSlot + first, StartSlot + first + count).
+    bool FilterShader( Call call, Stage stage, ID3D11DeviceChild* pShader, UINT NumClassInstances );
+    bool FilterConstantBuffers( Call call, Stage stage, UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants, UINT& first, UINT& count );
+    bool FilterShaderResources( Call call, Stage stage, UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews, UINT& first, UINT& count );
+    bool FilterSamplers( Call call, Stage stage, UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers, UINT& first, UINT& count );
+    // Count the call as elided if the value is known to be bound, otherwise shadow the value.
+    template<typename T>
+    bool FilterValue( Call call, Shadow<T>& shadow, const T& value );
+
+    // Forget the bound vertex buffers, index buffer, constant buffers and shader resources.
+    void InvalidateInputs();
+
+    PipelineState m_State;
+
+    uint64_t m_IssuedCallCounts[CallCount];
+    uint64_t m_ElidedCallCounts[CallCount];
+};
\ No newline at end of file
@@ -0,0 +1,73 @@
+/**
+ *   @brief A table of structures in a structured buffer that persists across frames.
+ */
+#pragma once
+
+#include <DirtyRangeTracker.h>
+
+/**
+ * Keeps a CPU copy of a table of fixed-size elements (for example materials) and a structured
+ * buffer with a shader resource view that shaders index into. Only the elements that have changed
+ * since the last upload are copied to the buffer, so elements that don't change are uploaded once
+ * instead of before every draw.
+ */
+class StructuredBufferTable
+{
+public:
+    StructuredBufferTable();
+
+    /**
+     * Create the buffer and its shader resource view.
+     * @param elementSize The size of an element in bytes (a multiple of 4).
+     * @param capacity The number of elements.
+     * @param mergeDistance Dirty ranges with up to this many clean elements in between are uploaded with a single copy.
+     * @returns false if the buffer or the shader resource view could not be created.
+     */
+    bool Initialize( ID3D11Device* device, UINT elementSize, UINT capacity, UINT mergeDistance = 4 );
+
+    /**
+     * Set an element. The element is only marked as dirty if it is different from the current value.
+     * @returns true if the element has changed.
+     */
+    bool Set( UINT index, const void* element );
+    template<typename T>
+    bool Set( UINT index, const T& element )
+    {
+        assert( sizeof(T) == m_ElementSize );
+        return Set( index, static_cast<const void*>( &element ) );
+    }
+
+    const void* Get( UINT index ) const;
+    template<typename T>
+    const T& Get( UINT index ) const
+    {
+        assert( sizeof(T) == m_ElementSize );
+        return *static_cast<const T*>( Get( index ) );
+    }
+
+    /**
+     * Copy the dirty elements to the buffer.
+     * @returns The number of elements that were copied.
+     */
+    UINT Upload( ID3D11DeviceContext* deviceContext );
+
+    UINT get_ElementSize() const;
+    UINT get_Capacity() const;
+
+    ID3D11Buffer* get_Buffer() const;
+    ID3D11ShaderResourceView* get_ShaderResourceView() const;
+    const DirtyRangeTracker& get_DirtyRanges() const;
+
+private:
+    // Prevent copying.
+    StructuredBufferTable( const StructuredBufferTable& copy );
+    StructuredBufferTable& operator=( const StructuredBufferTable& other );
+
+    Microsoft::WRL::ComPtr<ID3D11Buffer> m_d3dBuffer;
+    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_d3dShaderResourceView;
+
+    UINT m_ElementSize;
+    UINT m_Capacity;
+    std::vector<uint8_t> m_Elements;
+    DirtyRangeTracker m_DirtyRanges;
+};
\ No newline at end of file
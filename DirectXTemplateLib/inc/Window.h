@@ -29,6 +29,12 @@ public:
      */
     bool IsValid() const;
 
+    /**
+     * A headless window has no window handle. Games that are created with a
+     * headless window render to an offscreen render target.
+     */
+    bool IsHeadless() const;
+
     const std::string& get_WindowName() const;
 
     int get_ClientWidth() const;
@@ -52,9 +58,13 @@ protected:
     friend class Application;
     // The DirectXTemplate class needs to register itself with a window.
     friend class Game;
+    // The headless runner creates a headless window and drives its updates.
+    friend class HeadlessRunner;
 
     Window();
     Window( HWND hWnd, const std::string& windowName, int clientWidth, int clientHeight, bool vSync, bool windowed );
+    // Create a headless window.
+    Window( const std::string& windowName, int clientWidth, int clientHeight );
     virtual ~Window();
 
     // Register a DirectXTemplate with this window. This allows
@@ -65,6 +75,8 @@ protected:
     // Update and Draw can only be called by the application.
     virtual void OnUpdate( UpdateEventArgs& e );
     virtual void OnRender( RenderEventArgs& e );
+    // All updates and the render of a frame have finished.
+    virtual void OnFrameEnd();
 
     // A keyboard key was pressed
     virtual void OnKeyPressed( KeyEventArgs& e );
@@ -94,6 +106,7 @@ private:
     int m_ClientHeight;
     bool m_VSync;
     bool m_bWindowed;
+    bool m_bHeadless;
 
     Game* m_pGame;
 };
\ No newline at end of file
@@ -1,8 +1,14 @@
 #include <DirectXTemplateLibPCH.h>
 #include <Application.h>
+#include <Profiler.h>
 #include "..\resource.h"
 
 #include <Window.h>
+#include <HighResolutionClock.h>
+#include <FramePipeline.h>
+#include <JobSystem.h>
+
+#include <memory>
 
 #define WINDOW_CLASS_NAME "DX11RenderWindowClass"
 
@@ -20,6 +26,10 @@ static LRESULT CALLBACK WndProc (HWND hwnd, UINT message, WPARAM wParam, LPARAM
 
 Application::Application( HINSTANCE hInst )
     : m_hInstance( hInst )
+    , m_LoopMode( VariableTimestep )
+    , m_FixedTimeStep( 1.0f / 60.0f )
+    , m_MaxUpdatesPerFrame( 5 )
+    , m_JobSystem( new JobSystem() )
 {
     WNDCLASSEX wndClass = {0};
 
@@ -135,11 +145,21 @@ int Application::Run()
 {
     MSG msg = {0};
 
-    static DWORD previousTime = timeGetTime();
-    static float totalTime = 0.0f;
+    Profiler::set_ThreadName( "Main" );
+
     static const float targetFramerate = 30.0f;
     static const float maxTimeStep = 1.0f / targetFramerate;
 
+    HighResolutionClock clock;
+    // The simulated time and the real time that has not been simulated yet (FixedTimestep only).
+    double totalTime = 0.0;
+    double accumulatedTime = 0.0;
+    uint64_t frameIndex = 0;
+
+    // Pipelined only: the worker thread and the update of the frame that is rendered next.
+    std::unique_ptr<FramePipeline> pipeline;
+    std::unique_ptr<UpdateEventArgs> updatedFrame;
+
     while ( msg.message != WM_QUIT )
     {
         if ( PeekMessage( &msg, 0, 0, 0, PM_REMOVE ) )
@@ -149,30 +169,156 @@ int Application::Run()
         }
         else
         {
-            DWORD currentTime = timeGetTime();
-            float deltaTime = ( currentTime - previousTime ) / 1000.0f;
-            previousTime = currentTime;
+            double deltaTime = clock.Tick();
 
-            // Cap the delta time to the max time step (useful if your 
-            // debugging and you don't want the deltaTime value to explode.
-            deltaTime = std::min<float>(deltaTime, maxTimeStep);
-
-            totalTime += deltaTime;
-
-            UpdateEventArgs updateEventArgs( deltaTime, totalTime );
-            RenderEventArgs renderEventArgs( deltaTime, totalTime );
+            switch ( m_LoopMode )
+            {
+            case VariableTimestep:
+                {
+                    // Cap the delta time to the max time step (useful if your 
+                    // debugging and you don't want the deltaTime value to explode.
+                    deltaTime = std::min<double>( deltaTime, maxTimeStep );
+
+                    totalTime += deltaTime;
+
+                    UpdateEventArgs updateEventArgs( static_cast<float>( deltaTime ), static_cast<float>( totalTime ), frameIndex );
+                    RenderEventArgs renderEventArgs( static_cast<float>( deltaTime ), static_cast<float>( totalTime ), 1.0f, frameIndex );
+
+                    for( WindowMap::value_type window : gs_Windows )
+                    {
+                        window.second->OnUpdate( updateEventArgs );
+                        window.second->OnRender( renderEventArgs );
+                    }
+                }
+                break;
+            case FixedTimestep:
+                {
+                    accumulatedTime += deltaTime;
+
+                    int updateCount = 0;
+                    while ( accumulatedTime >= m_FixedTimeStep && updateCount < m_MaxUpdatesPerFrame )
+                    {
+                        totalTime += m_FixedTimeStep;
+                        accumulatedTime -= m_FixedTimeStep;
+                        ++updateCount;
+
+                        UpdateEventArgs updateEventArgs( m_FixedTimeStep, static_cast<float>( totalTime ), frameIndex );
+                        for( WindowMap::value_type window : gs_Windows )
+                        {
+                            window.second->OnUpdate( updateEventArgs );
+                        }
+                    }
+
+                    // Drop the time the updates could not catch up with (for example after a breakpoint).
+                    if ( accumulatedTime >= m_FixedTimeStep )
+                    {
+                        accumulatedTime = std::fmod( accumulatedTime, static_cast<double>( m_FixedTimeStep ) );
+                    }
+
+                    float alpha = static_cast<float>( accumulatedTime / m_FixedTimeStep );
+                    RenderEventArgs renderEventArgs( static_cast<float>( deltaTime ), static_cast<float>( totalTime ), alpha, frameIndex );
+                    for( WindowMap::value_type window : gs_Windows )
+                    {
+                        window.second->OnRender( renderEventArgs );
+                    }
+                }
+                break;
+            case Pipelined:
+                {
+                    deltaTime = std::min<double>( deltaTime, maxTimeStep );
+
+                    if ( !pipeline )
+                    {
+                        pipeline.reset( new FramePipeline( []( UpdateEventArgs& e )
+                        {
+                            for( WindowMap::value_type window : gs_Windows )
+                            {
+                                window.second->OnUpdate( e );
+                            }
+                        } ) );
+                    }
+
+                    // The first frame has nothing to overlap with, so it is updated on this thread.
+                    if ( !updatedFrame )
+                    {
+                        totalTime += deltaTime;
+                        updatedFrame.reset( new UpdateEventArgs( static_cast<float>( deltaTime ), static_cast<float>( totalTime ), frameIndex ) );
+
+                        for( WindowMap::value_type window : gs_Windows )
+                        {
+                            window.second->OnUpdate( *updatedFrame );
+                        }
+                    }
+
+                    // Update the next frame while the last updated frame is rendered.
+                    totalTime += deltaTime;
+                    UpdateEventArgs nextFrame( static_cast<float>( deltaTime ), static_cast<float>( totalTime ), frameIndex + 1 );
+                    pipeline->BeginUpdate( nextFrame );
+
+                    RenderEventArgs renderEventArgs( updatedFrame->ElapsedTime, updatedFrame->TotalTime, 1.0f, frameIndex );
+                    for( WindowMap::value_type window : gs_Windows )
+                    {
+                        window.second->OnRender( renderEventArgs );
+                    }
+
+                    pipeline->WaitForUpdate();
+                    *updatedFrame = nextFrame;
+                }
+                break;
+            }
 
             for( WindowMap::value_type window : gs_Windows )
             {
-                window.second->OnUpdate( updateEventArgs );
-                window.second->OnRender( renderEventArgs );
+                window.second->OnFrameEnd();
             }
+
+            ++frameIndex;
         }
     }
 
+    // Stop the update thread before the windows are destroyed.
+    pipeline.reset();
+
     return static_cast<int>(msg.wParam);
 }
 
+void Application::set_LoopMode( LoopMode loopMode )
+{
+    m_LoopMode = loopMode;
+}
+
+Application::LoopMode Application::get_LoopMode() const
+{
+    return m_LoopMode;
+}
+
+void Application::set_FixedTimeStep( float timeStep )
+{
+    assert( timeStep > 0.0f );
+    m_FixedTimeStep = timeStep;
+}
+
+float Application::get_FixedTimeStep() const
+{
+    return m_FixedTimeStep;
+}
+
+void Application::set_MaxUpdatesPerFrame( int maxUpdatesPerFrame )
+{
+    assert( maxUpdatesPerFrame > 0 );
+    m_MaxUpdatesPerFrame = maxUpdatesPerFrame;
+}
+
+int Application::get_MaxUpdatesPerFrame() const
+{
+    return m_MaxUpdatesPerFrame;
+}
+
+JobSystem& Application::get_JobSystem()
+{
+    return *m_JobSystem;
+}
+
 void Application::Quit( int exitCode )
 {
     PostQuitMessage( exitCode );
@@ -1,5 +1,6 @@
 #include <DirectXTemplateLibPCH.h>
 #include <Camera.h>
+#include <CameraSnapshot.h>
 
 using namespace DirectX;
 
@@ -8,11 +9,15 @@ Camera::Camera( Handedness handedness )
     , m_InverseViewDirty( true )
     , m_ProjectionDirty( true )
     , m_InverseProjectionDirty( true )
+    , m_ViewProjectionDirty( true )
+    , m_InverseViewProjectionDirty( true )
     , m_Handedness( handedness )
     , m_vFoV( 45.0f )
     , m_AspectRatio( 1.0f )
     , m_zNear( 0.1f )
     , m_zFar( 100.0f )
+    , m_DepthMode( StandardDepth )
+    , m_InfiniteFarPlane( false )
 {
     pData = (AlignedData*)_aligned_malloc( sizeof(AlignedData), 16 );
     if ( pData == NULL )
@@ -59,6 +64,8 @@ void XM_CALLCONV Camera::set_LookAt( FXMVECTOR eye, FXMVECTOR target, FXMVECTOR
 
     m_InverseViewDirty = true;
     m_ViewDirty = false;
+    m_ViewProjectionDirty = true;
+    m_InverseViewProjectionDirty = true;
 }
 
 XMMATRIX Camera::get_ViewMatrix() const
@@ -74,8 +81,7 @@ XMMATRIX Camera::get_InverseViewMatrix() const
 {
     if ( m_InverseViewDirty )
     {
-        pData->m_InverseViewMatrix = XMMatrixInverse( nullptr, pData->m_ViewMatrix );
-        m_InverseViewDirty = false;
+        UpdateInverseViewMatrix();
     }
 
     return pData->m_InverseViewMatrix;
@@ -90,6 +96,8 @@ void Camera::set_Projection( float fovy, float aspect, float zNear, float zFar )
 
     m_ProjectionDirty = true;
     m_InverseProjectionDirty = true;
+    m_ViewProjectionDirty = true;
+    m_InverseViewProjectionDirty = true;
 }
 
 XMMATRIX Camera::get_ProjectionMatrix() const
@@ -112,10 +120,129 @@ XMMATRIX Camera::get_InverseProjectionMatrix() const
     return pData->m_InverseProjectionMatrix;
 }
 
+void Camera::set_DepthMode( DepthMode depthMode )
+{
+    m_DepthMode = depthMode;
+
+    m_ProjectionDirty = true;
+    m_InverseProjectionDirty = true;
+    m_ViewProjectionDirty = true;
+    m_InverseViewProjectionDirty = true;
+}
+
+Camera::DepthMode Camera::get_DepthMode() const
+{
+    return m_DepthMode;
+}
+
+void Camera::set_InfiniteFarPlane( bool infiniteFarPlane )
+{
+    m_InfiniteFarPlane = infiniteFarPlane;
+
+    m_ProjectionDirty = true;
+    m_InverseProjectionDirty = true;
+    m_ViewProjectionDirty = true;
+    m_InverseViewProjectionDirty = true;
+}
+
+bool Camera::get_InfiniteFarPlane() const
+{
+    return m_InfiniteFarPlane;
+}
+
+float Camera::get_DepthClearValue() const
+{
+    return ( m_DepthMode == ReverseDepth ) ? 0.0f : 1.0f;
+}
+
+D3D11_COMPARISON_FUNC Camera::get_DepthComparison() const
+{
+    return ( m_DepthMode == ReverseDepth ) ? D3D11_COMPARISON_GREATER : D3D11_COMPARISON_LESS;
+}
+
+XMMATRIX Camera::get_ViewProjectionMatrix() const
+{
+    if ( m_ViewProjectionDirty )
+    {
+        UpdateViewProjectionMatrix();
+    }
+
+    return pData->m_ViewProjectionMatrix;
+}
+
+XMMATRIX Camera::get_InverseViewProjectionMatrix() const
+{
+    if ( m_InverseViewProjectionDirty )
+    {
+        UpdateInverseViewProjectionMatrix();
+    }
+
+    return pData->m_InverseViewProjectionMatrix;
+}
+
+float XM_CALLCONV Camera::get_ProjectedSize( FXMVECTOR position, float radius ) const
+{
+    float distance = XMVectorGetX( XMVector3Length( position - pData->m_Translation ) );
+    if ( distance <= radius )
+    {
+        return FLT_MAX;
+    }
+
+    // The height of the view frustum at a distance of 1 unit from the camera.
+    float frustumHeight = 2.0f * std::tan( XMConvertToRadians( m_vFoV ) * 0.5f );
+
+    return ( 2.0f * radius / ( distance * frustumHeight ) ) * m_Viewport.Height;
+}
+
+void Camera::get_FrustumPlanes( XMVECTOR planes[FrustumPlaneCount] ) const
+{
+    if ( m_ViewProjectionDirty )
+    {
+        UpdateViewProjectionMatrix();
+    }
+
+    for ( int i = 0; i < FrustumPlaneCount; ++i )
+    {
+        planes[i] = pData->m_FrustumPlanes[i];
+    }
+}
+
+void XM_CALLCONV Camera::ExtractFrustumPlanes( FXMMATRIX viewProjectionMatrix, XMVECTOR planes[FrustumPlaneCount], DepthMode depthMode )
+{
+    // Gribb & Hartmann: the planes are linear combinations of the columns of the matrix.
+    // Direct3D clip space uses the [0...1] depth range, so the depth planes are z >= 0 and z <= w.
+    XMMATRIX columns = XMMatrixTranspose( viewProjectionMatrix );
+
+    planes[LeftPlane]   = columns.r[3] + columns.r[0];
+    planes[RightPlane]  = columns.r[3] - columns.r[0];
+    planes[BottomPlane] = columns.r[3] + columns.r[1];
+    planes[TopPlane]    = columns.r[3] - columns.r[1];
+
+    XMVECTOR zeroDepthPlane = columns.r[2];
+    XMVECTOR oneDepthPlane = columns.r[3] - columns.r[2];
+    planes[NearPlane] = ( depthMode == ReverseDepth ) ? oneDepthPlane : zeroDepthPlane;
+    planes[FarPlane]  = ( depthMode == ReverseDepth ) ? zeroDepthPlane : oneDepthPlane;
+
+    for ( int i = 0; i < FrustumPlaneCount; ++i )
+    {
+        // The far plane of an infinite projection has no normal.
+        if ( XMVector3Less( XMVector3LengthSq( planes[i] ), XMVectorReplicate( 1e-12f ) ) )
+        {
+            planes[i] = XMVectorSet( 0.0f, 0.0f, 0.0f, 1.0f );
+        }
+        else
+        {
+            planes[i] = XMPlaneNormalize( planes[i] );
+        }
+    }
+}
+
 void Camera::set_Translation( FXMVECTOR translation )
 {
     pData->m_Translation = translation;
     m_ViewDirty = true;
+    m_ViewProjectionDirty = true;
+    m_InverseViewProjectionDirty = true;
 }
 
 XMVECTOR Camera::get_Translation() const
@@ -126,6 +253,9 @@ XMVECTOR Camera::get_Translation() const
 void Camera::set_Rotation( FXMVECTOR rotation )
 {
     pData->m_Rotation = rotation;
+    m_ViewDirty = true;
+    m_ViewProjectionDirty = true;
+    m_InverseViewProjectionDirty = true;
 }
 
 XMVECTOR Camera::get_Rotation() const
@@ -153,6 +283,8 @@ void XM_CALLCONV Camera::Translate( FXMVECTOR translation, Space space )
 
     m_ViewDirty = true;
     m_InverseViewDirty = true;
+    m_ViewProjectionDirty = true;
+    m_InverseViewProjectionDirty = true;
 }
 
 void Camera::Rotate( FXMVECTOR quaternion )
@@ -161,6 +293,32 @@ void Camera::Rotate( FXMVECTOR quaternion )
 
     m_ViewDirty = true;
     m_InverseViewDirty = true;
+    m_ViewProjectionDirty = true;
+    m_InverseViewProjectionDirty = true;
+}
+
+void Camera::get_Snapshot( CameraSnapshot& snapshot ) const
+{
+    XMStoreFloat4x4( &snapshot.ViewMatrix, get_ViewMatrix() );
+    XMStoreFloat4x4( &snapshot.InverseViewMatrix, get_InverseViewMatrix() );
+    XMStoreFloat4x4( &snapshot.ProjectionMatrix, get_ProjectionMatrix() );
+    XMStoreFloat4x4( &snapshot.ViewProjectionMatrix, get_ViewProjectionMatrix() );
+    XMStoreFloat4x4( &snapshot.InverseViewProjectionMatrix, get_InverseViewProjectionMatrix() );
+
+    for ( int i = 0; i < FrustumPlaneCount; ++i )
+    {
+        XMStoreFloat4( &snapshot.FrustumPlanes[i], pData->m_FrustumPlanes[i] );
+    }
+
+    XMStoreFloat4( &snapshot.Translation, pData->m_Translation );
+    XMStoreFloat4( &snapshot.Rotation, pData->m_Rotation );
+
+    snapshot.Viewport = m_Viewport;
+    snapshot.FieldOfView = m_vFoV;
+    snapshot.AspectRatio = m_AspectRatio;
+    snapshot.NearClipDistance = m_zNear;
+    snapshot.FarClipDistance = m_InfiniteFarPlane ? FLT_MAX : m_zFar;
+    snapshot.DepthMode = m_DepthMode;
 }
 
 void Camera::UpdateViewMatrix() const
@@ -187,20 +345,36 @@ void Camera::UpdateInverseViewMatrix() const
 
 void Camera::UpdateProjectionMatrix() const
 {
+    // Reversing the depth range is the same as swapping the near and far planes.
+    float zNear = ( m_DepthMode == ReverseDepth ) ? m_zFar : m_zNear;
+    float zFar = ( m_DepthMode == ReverseDepth ) ? m_zNear : m_zFar;
+
     switch( m_Handedness )
     {
     case LeftHanded:
         {
-            pData->m_ProjectionMatrix = XMMatrixPerspectiveFovLH( XMConvertToRadians(m_vFoV), m_AspectRatio, m_zNear, m_zFar );
+            pData->m_ProjectionMatrix = XMMatrixPerspectiveFovLH( XMConvertToRadians(m_vFoV), m_AspectRatio, zNear, zFar );
         }
         break;
     case RightHanded:
         {
-            pData->m_ProjectionMatrix = XMMatrixPerspectiveFovRH( XMConvertToRadians(m_vFoV), m_AspectRatio, m_zNear, m_zFar );
+            pData->m_ProjectionMatrix = XMMatrixPerspectiveFovRH( XMConvertToRadians(m_vFoV), m_AspectRatio, zNear, zFar );
         }
         break;
     }
 
+    if ( m_InfiniteFarPlane )
+    {
+        // The limits of the depth terms as the far distance goes to infinity.
+        // The view direction is +z for left-handed and -z for right-handed cameras.
+        float direction = ( m_Handedness == LeftHanded ) ? 1.0f : -1.0f;
+        float depthScale = ( m_DepthMode == ReverseDepth ) ? 0.0f : direction;
+        float depthOffset = ( m_DepthMode == ReverseDepth ) ? m_zNear : -m_zNear;
+
+        pData->m_ProjectionMatrix.r[2] = XMVectorSetZ( pData->m_ProjectionMatrix.r[2], depthScale );
+        pData->m_ProjectionMatrix.r[3] = XMVectorSetZ( pData->m_ProjectionMatrix.r[3], depthOffset );
+    }
+
     m_ProjectionDirty = false;
     m_InverseProjectionDirty = true;
 }
@@ -212,6 +386,47 @@ void Camera::UpdateInverseProjectionMatrix() const
         UpdateProjectionMatrix();
     }
 
-    pData->m_InverseProjectionMatrix = XMMatrixInverse( nullptr, pData->m_ProjectionMatrix );
+    // All projection modes have the form:
+    //   | xScale 0      0 0 |
+    //   | 0      yScale 0 0 |
+    //   | 0      0      A s |
+    //   | 0      0      B 0 |
+    // where s is +1 (left-handed) or -1 (right-handed). The inverse is computed directly
+    // because XMMatrixInverse loses precision in the depth terms.
+    XMFLOAT4X4 projection;
+    XMStoreFloat4x4( &projection, pData->m_ProjectionMatrix );
+
+    float xScale = projection._11;
+    float yScale = projection._22;
+    float A = projection._33;
+    float s = projection._34;
+    float B = projection._43;
+
+    pData->m_InverseProjectionMatrix = XMMatrixSet(
+        1.0f / xScale, 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f / yScale, 0.0f, 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f / B,
+        0.0f, 0.0f, s, -A * s / B );
+
     m_InverseProjectionDirty = false;
 }
+
+void Camera::UpdateViewProjectionMatrix() const
+{
+    pData->m_ViewProjectionMatrix = get_ViewMatrix() * get_ProjectionMatrix();
+    ExtractFrustumPlanes( pData->m_ViewProjectionMatrix, pData->m_FrustumPlanes, m_DepthMode );
+
+    m_ViewProjectionDirty = false;
+    m_InverseViewProjectionDirty = true;
+}
+
+void Camera::UpdateInverseViewProjectionMatrix() const
+{
+    if ( m_ViewProjectionDirty )
+    {
+        UpdateViewProjectionMatrix();
+    }
+
+    pData->m_InverseViewProjectionMatrix = XMMatrixInverse( nullptr, pData->m_ViewProjectionMatrix );
+    m_InverseViewProjectionDirty = false;
+}
@@ -0,0 +1,259 @@
+#include <DirectXTemplateLibPCH.h>
+#include <CameraPath.h>
+
+#include <fstream>
+
+using namespace DirectX;
+
+CameraPath::CameraPath()
+{}
+
+void CameraPath::Clear()
+{
+    m_Keys.clear();
+}
+
+void XM_CALLCONV CameraPath::AddKey( float time, FXMVECTOR position, FXMVECTOR rotation )
+{
+    assert( m_Keys.empty() || time >= m_Keys.back().Time );
+
+    XMVECTOR q = XMQuaternionNormalize( rotation );
+
+    // q and -q are the same rotation. Pick the one that is closest to the previous key
+    // so the spline does not take the long way around.
+    if ( !m_Keys.empty() && XMVectorGetX( XMQuaternionDot( q, XMLoadFloat4( &m_Keys.back().Rotation ) ) ) < 0.0f )
+    {
+        q = -q;
+    }
+
+    CameraPathKey key;
+    key.Time = time;
+    XMStoreFloat3( &key.Position, position );
+    XMStoreFloat4( &key.Rotation, q );
+
+    m_Keys.push_back( key );
+}
+
+size_t CameraPath::get_KeyCount() const
+{
+    return m_Keys.size();
+}
+
+const CameraPathKey& CameraPath::get_Key( size_t index ) const
+{
+    assert( index < m_Keys.size() );
+    return m_Keys[index];
+}
+
+float CameraPath::get_Duration() const
+{
+    return m_Keys.empty() ? 0.0f : m_Keys.back().Time;
+}
+
+void CameraPath::Evaluate( float time, XMVECTOR& position, XMVECTOR& rotation ) const
+{
+    assert( !m_Keys.empty() );
+
+    // Find the segment [i1, i2] that contains the time.
+    auto next = std::upper_bound( m_Keys.begin(), m_Keys.end(), time, []( float t, const CameraPathKey& key )
+    {
+        return t < key.Time;
+    } );
+
+    if ( next == m_Keys.begin() || next == m_Keys.end() )
+    {
+        const CameraPathKey& key = ( next == m_Keys.begin() ) ? m_Keys.front() : m_Keys.back();
+        position = XMVectorSetW( XMLoadFloat3( &key.Position ), 1.0f );
+        rotation = XMLoadFloat4( &key.Rotation );
+        return;
+    }
+
+    size_t i2 = next - m_Keys.begin();
+    size_t i1 = i2 - 1;
+    // The end points are duplicated for the first and last segment.
+    size_t i0 = ( i1 > 0 ) ? i1 - 1 : i1;
+    size_t i3 = ( i2 + 1 < m_Keys.size() ) ? i2 + 1 : i2;
+
+    float segmentTime = m_Keys[i2].Time - m_Keys[i1].Time;
+    float t = ( segmentTime > 0.0f ) ? ( time - m_Keys[i1].Time ) / segmentTime : 0.0f;
+
+    position = XMVectorCatmullRom( XMLoadFloat3( &m_Keys[i0].Position ), XMLoadFloat3( &m_Keys[i1].Position ),
+        XMLoadFloat3( &m_Keys[i2].Position ), XMLoadFloat3( &m_Keys[i3].Position ), t );
+    position = XMVectorSetW( position, 1.0f );
+
+    XMVECTOR q1 = XMLoadFloat4( &m_Keys[i1].Rotation );
+    XMVECTOR a, b, c;
+    XMQuaternionSquadSetup( &a, &b, &c, XMLoadFloat4( &m_Keys[i0].Rotation ), q1,
+        XMLoadFloat4( &m_Keys[i2].Rotation ), XMLoadFloat4( &m_Keys[i3].Rotation ) );
+    rotation = XMQuaternionNormalize( XMQuaternionSquad( q1, a, b, c, t ) );
+}
+
+void CameraPath::Save( const std::wstring& fileName ) const
+{
+    std::ofstream file( fileName, std::ios::binary );
+    if ( !file )
+    {
+        throw std::exception("Failed to create camera path file.");
+    }
+
+    CameraPathFileHeader header = {};
+    header.Magic = CameraPathFileHeader::FileMagic;
+    header.Version = CameraPathFileHeader::FileVersion;
+    header.KeyCount = static_cast<uint32_t>( m_Keys.size() );
+
+    file.write( reinterpret_cast<const char*>( &header ), sizeof(CameraPathFileHeader) );
+    file.write( reinterpret_cast<const char*>( m_Keys.data() ), sizeof(CameraPathKey) * m_Keys.size() );
+
+    if ( !file )
+    {
+        throw std::exception("Failed to write camera path file.");
+    }
+}
+
+void CameraPath::Load( const std::wstring& fileName )
+{
+    std::ifstream file( fileName, std::ios::binary );
+    if ( !file )
+    {
+        throw std::exception("Failed to open camera path file.");
+    }
+
+    CameraPathFileHeader header;
+    if ( !file.read( reinterpret_cast<char*>( &header ), sizeof(CameraPathFileHeader) ) ||
+         header.Magic != CameraPathFileHeader::FileMagic || header.Version != CameraPathFileHeader::FileVersion )
+    {
+        throw std::exception("Invalid camera path file.");
+    }
+
+    std::vector<CameraPathKey> keys( header.KeyCount );
+    if ( !file.read( reinterpret_cast<char*>( keys.data() ), sizeof(CameraPathKey) * keys.size() ) )
+    {
+        throw std::exception("Camera path file is truncated.");
+    }
+
+    for ( size_t i = 1; i < keys.size(); ++i )
+    {
+        if ( !( keys[i].Time >= keys[i - 1].Time ) )
+        {
+            throw std::exception("Invalid camera path file.");
+        }
+    }
+
+    m_Keys.swap( keys );
+}
+
+CameraPathRecorder::CameraPathRecorder( float sampleInterval )
+    : m_SampleInterval( sampleInterval )
+    , m_Time( 0.0f )
+    , m_LastKeyTime( -1.0f )
+    , m_IsRecording( false )
+{}
+
+void CameraPathRecorder::Start()
+{
+    m_Path.Clear();
+    m_Time = 0.0f;
+    m_LastKeyTime = -1.0f;
+    m_IsRecording = true;
+}
+
+void CameraPathRecorder::Stop( const Camera& camera )
+{
+    if ( m_IsRecording && m_LastKeyTime < m_Time )
+    {
+        m_Path.AddKey( m_Time, camera.get_Translation(), camera.get_Rotation() );
+    }
+
+    m_IsRecording = false;
+}
+
+bool CameraPathRecorder::IsRecording() const
+{
+    return m_IsRecording;
+}
+
+void CameraPathRecorder::Record( const Camera& camera, float elapsedTime )
+{
+    if ( !m_IsRecording )
+    {
+        return;
+    }
+
+    // The first key is recorded at time 0, so the first update only establishes the start.
+    if ( m_LastKeyTime >= 0.0f )
+    {
+        m_Time += elapsedTime;
+    }
+
+    if ( m_LastKeyTime < 0.0f || m_Time - m_LastKeyTime >= m_SampleInterval )
+    {
+        m_Path.AddKey( m_Time, camera.get_Translation(), camera.get_Rotation() );
+        m_LastKeyTime = m_Time;
+    }
+}
+
+const CameraPath& CameraPathRecorder::get_Path() const
+{
+    return m_Path;
+}
+
+CameraPathPlayer::CameraPathPlayer()
+    : m_Path( nullptr )
+    , m_Time( 0.0f )
+    , m_Loop( false )
+{}
+
+void CameraPathPlayer::Play( const CameraPath& path, bool loop )
+{
+    m_Path = ( path.get_KeyCount() > 0 ) ? &path : nullptr;
+    m_Time = 0.0f;
+    m_Loop = loop;
+}
+
+void CameraPathPlayer::Stop()
+{
+    m_Path = nullptr;
+}
+
+bool CameraPathPlayer::IsPlaying() const
+{
+    return m_Path != nullptr;
+}
+
+bool CameraPathPlayer::Update( Camera& camera, float elapsedTime )
+{
+    if ( !m_Path )
+    {
+        return false;
+    }
+
+    // The first update shows the first key.
+    XMVECTOR position, rotation;
+    m_Path->Evaluate( m_Time, position, rotation );
+
+    camera.set_Translation( position );
+    camera.set_Rotation( rotation );
+
+    bool finished = ( m_Time >= m_Path->get_Duration() );
+    m_Time += elapsedTime;
+
+    if ( finished )
+    {
+        if ( m_Loop && m_Path->get_Duration() > 0.0f )
+        {
+            m_Time = 0.0f;
+        }
+        else
+        {
+            m_Path = nullptr;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+float CameraPathPlayer::get_Time() const
+{
+    return m_Time;
+}
@@ -0,0 +1,76 @@
+#include <DirectXTemplateLibPCH.h>
+#include <CameraSnapshot.h>
+
+using namespace DirectX;
+
+void CameraSnapshot::get_FrustumPlanes( XMVECTOR planes[Camera::FrustumPlaneCount] ) const
+{
+    for ( int i = 0; i < Camera::FrustumPlaneCount; ++i )
+    {
+        planes[i] = XMLoadFloat4( &FrustumPlanes[i] );
+    }
+}
+
+CameraSnapshotBuffer::CameraSnapshotBuffer()
+    : m_Version( 0 )
+{
+    for ( int i = 0; i < 2; ++i )
+    {
+        m_Buffers[i].Sequence.store( 0, std::memory_order_relaxed );
+        ZeroMemory( &m_Buffers[i].Snapshot, sizeof(CameraSnapshot) );
+    }
+}
+
+uint64_t CameraSnapshotBuffer::Publish( const Camera& camera )
+{
+    // Only the publishing thread modifies the version.
+    uint64_t version = m_Version.load( std::memory_order_relaxed ) + 1;
+    Buffer& buffer = m_Buffers[version & 1];
+
+    // Mark the buffer as being written. Readers that started copying it will retry.
+    uint64_t sequence = buffer.Sequence.load( std::memory_order_relaxed );
+    buffer.Sequence.store( sequence + 1, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+
+    camera.get_Snapshot( buffer.Snapshot );
+    buffer.Snapshot.Version = version;
+
+    buffer.Sequence.store( sequence + 2, std::memory_order_release );
+    m_Version.store( version, std::memory_order_release );
+
+    return version;
+}
+
+bool CameraSnapshotBuffer::Read( CameraSnapshot& snapshot ) const
+{
+    for ( ;; )
+    {
+        uint64_t version = m_Version.load( std::memory_order_acquire );
+        if ( version == 0 )
+        {
+            return false;
+        }
+
+        const Buffer& buffer = m_Buffers[version & 1];
+
+        uint64_t sequence = buffer.Sequence.load( std::memory_order_acquire );
+        if ( sequence & 1 )
+        {
+            // The writer has already moved on to this buffer; the other one is newer.
+            continue;
+        }
+
+        memcpy( &snapshot, &buffer.Snapshot, sizeof(CameraSnapshot) );
+
+        std::atomic_thread_fence( std::memory_order_acquire );
+        if ( buffer.Sequence.load( std::memory_order_relaxed ) == sequence )
+        {
+            return true;
+        }
+    }
+}
+
+uint64_t CameraSnapshotBuffer::get_Version() const
+{
+    return m_Version.load( std::memory_order_acquire );
+}
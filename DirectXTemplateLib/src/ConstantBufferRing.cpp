@@ -0,0 +1,162 @@
+#include <DirectXTemplateLibPCH.h>
+#include <ConstantBufferRing.h>
+
+ConstantBufferRing::ConstantBufferRing()
+    : m_bMapped( false )
+    , m_NextFenceValue( 1 )
+{}
+
+ConstantBufferRing::~ConstantBufferRing()
+{}
+
+bool ConstantBufferRing::Initialize( ID3D11Device* device, UINT capacity )
+{
+    assert( device );
+
+    D3D11_FEATURE_DATA_D3D11_OPTIONS options;
+    ZeroMemory( &options, sizeof(D3D11_FEATURE_DATA_D3D11_OPTIONS) );
+
+    HRESULT hr = device->CheckFeatureSupport( D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(D3D11_FEATURE_DATA_D3D11_OPTIONS) );
+    if ( FAILED( hr ) || !options.ConstantBufferOffsetting || !options.MapNoOverwriteOnDynamicConstantBuffer )
+    {
+        return false;
+    }
+
+    capacity = get_AlignedSize( capacity );
+
+    D3D11_BUFFER_DESC bufferDesc;
+    ZeroMemory( &bufferDesc, sizeof(D3D11_BUFFER_DESC) );
+
+    bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    bufferDesc.ByteWidth = capacity;
+    bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+
+    hr = device->CreateBuffer( &bufferDesc, nullptr, &m_d3dBuffer );
+    if ( FAILED( hr ) )
+    {
+        return false;
+    }
+
+    m_d3dDevice = device;
+    m_Allocator.reset( new RingBufferAllocator( capacity ) );
+    m_bMapped = false;
+    m_PendingFrames.clear();
+
+    return true;
+}
+
+void ConstantBufferRing::BeginFrame( ID3D11DeviceContext* deviceContext )
+{
+    assert( m_Allocator );
+
+    uint64_t completedFenceValue = 0;
+
+    // Don't flush the device context, frames that have not been submitted can't be finished anyway.
+    while ( !m_PendingFrames.empty() &&
+            deviceContext->GetData( m_PendingFrames.front().Query.Get(), nullptr, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH ) == S_OK )
+    {
+        completedFenceValue = m_PendingFrames.front().FenceValue;
+        m_FreeQueries.push_back( m_PendingFrames.front().Query );
+        m_PendingFrames.pop_front();
+    }
+
+    if ( completedFenceValue > 0 )
+    {
+        m_Allocator->ReleaseFrames( completedFenceValue );
+    }
+}
+
+void ConstantBufferRing::EndFrame( ID3D11DeviceContext* deviceContext )
+{
+    assert( m_Allocator );
+
+    PendingFrame frame;
+    frame.FenceValue = m_NextFenceValue++;
+
+    if ( !m_FreeQueries.empty() )
+    {
+        frame.Query = m_FreeQueries.back();
+        m_FreeQueries.pop_back();
+    }
+    else
+    {
+        D3D11_QUERY_DESC queryDesc = { D3D11_QUERY_EVENT, 0 };
+        if ( FAILED( m_d3dDevice->CreateQuery( &queryDesc, &frame.Query ) ) )
+        {
+            // Without a query the frame can't be tracked. Discard the ring when the next range is mapped.
+            m_bMapped = false;
+            m_Allocator->Discard();
+            return;
+        }
+    }
+
+    deviceContext->End( frame.Query.Get() );
+
+    m_Allocator->FinishFrame( frame.FenceValue );
+    m_PendingFrames.push_back( frame );
+}
+
+void* ConstantBufferRing::Map( ID3D11DeviceContext* deviceContext, UINT size, UINT& offset )
+{
+    assert( m_Allocator );
+
+    bool discard;
+    offset = m_Allocator->Allocate( get_AlignedSize( size ), Alignment, discard );
+    if ( offset == RingBufferAllocator::InvalidOffset )
+    {
+        return nullptr;
+    }
+
+    D3D11_MAP mapType = ( discard || !m_bMapped ) ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE;
+
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
+    if ( FAILED( deviceContext->Map( m_d3dBuffer.Get(), 0, mapType, 0, &mappedResource ) ) )
+    {
+        return nullptr;
+    }
+
+    m_bMapped = true;
+
+    return static_cast<uint8_t*>( mappedResource.pData ) + offset;
+}
+
+void ConstantBufferRing::Unmap( ID3D11DeviceContext* deviceContext )
+{
+    deviceContext->Unmap( m_d3dBuffer.Get(), 0 );
+}
+
+void ConstantBufferRing::VSSetConstantBuffer( ID3D11DeviceContext1* deviceContext, UINT slot, UINT offset, UINT size ) const
+{
+    assert( offset % Alignment == 0 );
+
+    // Offsets and sizes are specified in constants (16 bytes).
+    UINT firstConstant = offset / 16;
+    UINT numConstants = get_AlignedSize( size ) / 16;
+    deviceContext->VSSetConstantBuffers1( slot, 1, m_d3dBuffer.GetAddressOf(), &firstConstant, &numConstants );
+}
+
+void ConstantBufferRing::PSSetConstantBuffer( ID3D11DeviceContext1* deviceContext, UINT slot, UINT offset, UINT size ) const
+{
+    assert( offset % Alignment == 0 );
+
+    UINT firstConstant = offset / 16;
+    UINT numConstants = get_AlignedSize( size ) / 16;
+    deviceContext->PSSetConstantBuffers1( slot, 1, m_d3dBuffer.GetAddressOf(), &firstConstant, &numConstants );
+}
+
+UINT ConstantBufferRing::get_AlignedSize( UINT size )
+{
+    return ( size + Alignment - 1 ) & ~( Alignment - 1 );
+}
+
+ID3D11Buffer* ConstantBufferRing::get_Buffer() const
+{
+    return m_d3dBuffer.Get();
+}
+
+const RingBufferAllocator& ConstantBufferRing::get_Allocator() const
+{
+    assert( m_Allocator );
+    return *m_Allocator;
+}
@@ -0,0 +1,1669 @@
+#include <DirectXTemplateLibPCH.h>
+#include <DeviceContextWrapper.h>
+
+static const char* CallNames[] =
+{
+    "IASetInputLayout", "IASetVertexBuffers", "IASetIndexBuffer", "IASetPrimitiveTopology",
+    "VSSetShader", "VSSetConstantBuffers", "VSSetConstantBuffers1", "VSSetShaderResources",
+    "VSSetSamplers", "HSSetShader", "HSSetConstantBuffers", "HSSetConstantBuffers1",
+    "HSSetShaderResources", "HSSetSamplers", "DSSetShader", "DSSetConstantBuffers",
+    "DSSetConstantBuffers1", "DSSetShaderResources", "DSSetSamplers", "GSSetShader",
+    "GSSetConstantBuffers", "GSSetConstantBuffers1", "GSSetShaderResources", "GSSetSamplers",
+    "PSSetShader", "PSSetConstantBuffers", "PSSetConstantBuffers1", "PSSetShaderResources",
+    "PSSetSamplers", "CSSetShader", "CSSetConstantBuffers", "CSSetConstantBuffers1",
+    "CSSetShaderResources", "CSSetSamplers", "CSSetUnorderedAccessViews", "SOSetTargets",
+    "RSSetState", "RSSetViewports", "RSSetScissorRects", "OMSetRenderTargets",
+    "OMSetRenderTargetsAndUnorderedAccessViews", "OMSetBlendState", "OMSetDepthStencilState", "SetPredication",
+    "Draw", "DrawIndexed", "DrawInstanced", "DrawIndexedInstanced",
+    "DrawAuto", "DrawInstancedIndirect", "DrawIndexedInstancedIndirect", "Dispatch",
+    "DispatchIndirect", "Map", "Unmap", "UpdateSubresource",
+    "UpdateSubresource1", "CopyResource", "CopySubresourceRegion", "CopySubresourceRegion1",
+    "CopyStructureCount", "ResolveSubresource", "ClearRenderTargetView", "ClearDepthStencilView",
+    "ClearUnorderedAccessViewUint", "ClearUnorderedAccessViewFloat", "ClearView", "DiscardResource",
+    "DiscardView", "DiscardView1", "GenerateMips", "SetResourceMinLOD",
+    "GetResourceMinLOD", "Begin", "End", "GetData",
+    "IAGetInputLayout", "IAGetVertexBuffers", "IAGetIndexBuffer", "IAGetPrimitiveTopology",
+    "VSGetShader", "VSGetConstantBuffers", "VSGetConstantBuffers1", "VSGetShaderResources",
+    "VSGetSamplers", "HSGetShader", "HSGetConstantBuffers", "HSGetConstantBuffers1",
+    "HSGetShaderResources", "HSGetSamplers", "DSGetShader", "DSGetConstantBuffers",
+    "DSGetConstantBuffers1", "DSGetShaderResources", "DSGetSamplers", "GSGetShader",
+    "GSGetConstantBuffers", "GSGetConstantBuffers1", "GSGetShaderResources", "GSGetSamplers",
+    "PSGetShader", "PSGetConstantBuffers", "PSGetConstantBuffers1", "PSGetShaderResources",
+    "PSGetSamplers", "CSGetShader", "CSGetConstantBuffers", "CSGetConstantBuffers1",
+    "CSGetShaderResources", "CSGetSamplers", "CSGetUnorderedAccessViews", "SOGetTargets",
+    "RSGetState", "RSGetViewports", "RSGetScissorRects", "OMGetRenderTargets",
+    "OMGetRenderTargetsAndUnorderedAccessViews", "OMGetBlendState", "OMGetDepthStencilState", "GetPredication",
+    "ClearState", "Flush", "ExecuteCommandList", "FinishCommandList",
+    "GetType", "GetContextFlags", "SwapDeviceContextState",
+};
+
+static_assert( _countof(CallNames) == DeviceContextWrapper::CallCount, "A call name is missing." );
+
+// Set the values that a get method returns if there is no wrapped device context.
+template<typename T>
+static void ClearArray( T* pValues, UINT count )
+{
+    if ( pValues )
+    {
+        std::fill( pValues, pValues + count, T() );
+    }
+}
+
+DeviceContextWrapper::DeviceContextWrapper( ID3D11DeviceContext* context )
+    : m_ReferenceCount( 1 )
+    , m_Context( context )
+{
+    if ( m_Context )
+    {
+        m_Context.As( &m_Context1 );
+    }
+}
+
+DeviceContextWrapper::~DeviceContextWrapper()
+{}
+
+ID3D11DeviceContext* DeviceContextWrapper::get_Context() const
+{
+    return m_Context.Get();
+}
+
+const char* DeviceContextWrapper::get_CallName( Call call )
+{
+    assert( call >= 0 && call < CallCount );
+    return CallNames[call];
+}
+
+void DeviceContextWrapper::OnCall( Call call )
+{
+    // By default, do nothing.
+}
+
+HRESULT STDMETHODCALLTYPE DeviceContextWrapper::QueryInterface( REFIID riid, void** ppvObject )
+{
+    if ( !ppvObject )
+    {
+        return E_POINTER;
+    }
+
+    // Only report ID3D11DeviceContext1 if the calls can be forwarded to it.
+    bool supportsContext1 = m_Context1 || !m_Context;
+
+    if ( riid == __uuidof(IUnknown) || riid == __uuidof(ID3D11DeviceChild) || riid == __uuidof(ID3D11DeviceContext) ||
+         ( riid == __uuidof(ID3D11DeviceContext1) && supportsContext1 ) )
+    {
+        *ppvObject = static_cast<ID3D11DeviceContext1*>( this );
+        AddRef();
+        return S_OK;
+    }
+
+    *ppvObject = nullptr;
+    return E_NOINTERFACE;
+}
+
+ULONG STDMETHODCALLTYPE DeviceContextWrapper::AddRef()
+{
+    return InterlockedIncrement( &m_ReferenceCount );
+}
+
+ULONG STDMETHODCALLTYPE DeviceContextWrapper::Release()
+{
+    ULONG referenceCount = InterlockedDecrement( &m_ReferenceCount );
+    if ( referenceCount == 0 )
+    {
+        delete this;
+    }
+
+    return referenceCount;
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::GetDevice( ID3D11Device** ppDevice )
+{
+    if ( m_Context )
+    {
+        m_Context->GetDevice( ppDevice );
+    }
+    else
+    {
+        ClearArray( ppDevice, 1 );
+    }
+}
+
+HRESULT STDMETHODCALLTYPE DeviceContextWrapper::GetPrivateData( REFGUID guid, UINT* pDataSize, void* pData )
+{
+    if ( m_Context )
+    {
+        return m_Context->GetPrivateData( guid, pDataSize, pData );
+    }
+
+    ClearArray( pDataSize, 1 );
+    return DXGI_ERROR_NOT_FOUND;
+}
+
+HRESULT STDMETHODCALLTYPE DeviceContextWrapper::SetPrivateData( REFGUID guid, UINT DataSize, const void* pData )
+{
+    return m_Context ? m_Context->SetPrivateData( guid, DataSize, pData ) : E_NOTIMPL;
+}
+
+HRESULT STDMETHODCALLTYPE DeviceContextWrapper::SetPrivateDataInterface( REFGUID guid, const IUnknown* pData )
+{
+    return m_Context ? m_Context->SetPrivateDataInterface( guid, pData ) : E_NOTIMPL;
+}
+
+HRESULT STDMETHODCALLTYPE DeviceContextWrapper::Map( ID3D11Resource* pResource, UINT Subresource, D3D11_MAP MapType, UINT MapFlags, D3D11_MAPPED_SUBRESOURCE* pMappedResource )
+{
+    OnCall( MapCall );
+
+    if ( m_Context )
+    {
+        return m_Context->Map( pResource, Subresource, MapType, MapFlags, pMappedResource );
+    }
+
+    // Without a device context, buffers are mapped to CPU memory. The memory is kept
+    // between the calls, so data that is mapped with D3D11_MAP_WRITE_NO_OVERWRITE is preserved.
+    D3D11_RESOURCE_DIMENSION resourceDimension = D3D11_RESOURCE_DIMENSION_UNKNOWN;
+    if ( pResource )
+    {
+        pResource->GetType( &resourceDimension );
+    }
+
+    if ( resourceDimension != D3D11_RESOURCE_DIMENSION_BUFFER || !pMappedResource )
+    {
+        return E_INVALIDARG;
+    }
+
+    D3D11_BUFFER_DESC bufferDesc;
+    static_cast<ID3D11Buffer*>( pResource )->GetDesc( &bufferDesc );
+
+    std::vector<uint8_t>& mappedData = m_MappedData[pResource];
+    mappedData.resize( bufferDesc.ByteWidth );
+
+    pMappedResource->pData = mappedData.data();
+    pMappedResource->RowPitch = bufferDesc.ByteWidth;
+    pMappedResource->DepthPitch = bufferDesc.ByteWidth;
+
+    return S_OK;
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::IASetInputLayout( ID3D11InputLayout* pInputLayout )
+{
+    OnCall( IASetInputLayoutCall );
+
+    if ( m_Context )
+    {
+        m_Context->IASetInputLayout( pInputLayout );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::IASetVertexBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppVertexBuffers, const UINT* pStrides, const UINT* pOffsets )
+{
+    OnCall( IASetVertexBuffersCall );
+
+    if ( m_Context )
+    {
+        m_Context->IASetVertexBuffers( StartSlot, NumBuffers, ppVertexBuffers, pStrides, pOffsets );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::IASetIndexBuffer( ID3D11Buffer* pIndexBuffer, DXGI_FORMAT Format, UINT Offset )
+{
+    OnCall( IASetIndexBufferCall );
+
+    if ( m_Context )
+    {
+        m_Context->IASetIndexBuffer( pIndexBuffer, Format, Offset );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY Topology )
+{
+    OnCall( IASetPrimitiveTopologyCall );
+
+    if ( m_Context )
+    {
+        m_Context->IASetPrimitiveTopology( Topology );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::VSSetShader( ID3D11VertexShader* pVertexShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances )
+{
+    OnCall( VSSetShaderCall );
+
+    if ( m_Context )
+    {
+        m_Context->VSSetShader( pVertexShader, ppClassInstances, NumClassInstances );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::VSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers )
+{
+    OnCall( VSSetConstantBuffersCall );
+
+    if ( m_Context )
+    {
+        m_Context->VSSetConstantBuffers( StartSlot, NumBuffers, ppConstantBuffers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::VSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants )
+{
+    OnCall( VSSetConstantBuffers1Call );
+
+    if ( m_Context1 )
+    {
+        m_Context1->VSSetConstantBuffers1( StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::VSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews )
+{
+    OnCall( VSSetShaderResourcesCall );
+
+    if ( m_Context )
+    {
+        m_Context->VSSetShaderResources( StartSlot, NumViews, ppShaderResourceViews );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::VSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers )
+{
+    OnCall( VSSetSamplersCall );
+
+    if ( m_Context )
+    {
+        m_Context->VSSetSamplers( StartSlot, NumSamplers, ppSamplers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::HSSetShader( ID3D11HullShader* pHullShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances )
+{
+    OnCall( HSSetShaderCall );
+
+    if ( m_Context )
+    {
+        m_Context->HSSetShader( pHullShader, ppClassInstances, NumClassInstances );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::HSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers )
+{
+    OnCall( HSSetConstantBuffersCall );
+
+    if ( m_Context )
+    {
+        m_Context->HSSetConstantBuffers( StartSlot, NumBuffers, ppConstantBuffers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::HSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants )
+{
+    OnCall( HSSetConstantBuffers1Call );
+
+    if ( m_Context1 )
+    {
+        m_Context1->HSSetConstantBuffers1( StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::HSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews )
+{
+    OnCall( HSSetShaderResourcesCall );
+
+    if ( m_Context )
+    {
+        m_Context->HSSetShaderResources( StartSlot, NumViews, ppShaderResourceViews );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::HSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers )
+{
+    OnCall( HSSetSamplersCall );
+
+    if ( m_Context )
+    {
+        m_Context->HSSetSamplers( StartSlot, NumSamplers, ppSamplers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::DSSetShader( ID3D11DomainShader* pDomainShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances )
+{
+    OnCall( DSSetShaderCall );
+
+    if ( m_Context )
+    {
+        m_Context->DSSetShader( pDomainShader, ppClassInstances, NumClassInstances );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::DSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers )
+{
+    OnCall( DSSetConstantBuffersCall );
+
+    if ( m_Context )
+    {
+        m_Context->DSSetConstantBuffers( StartSlot, NumBuffers, ppConstantBuffers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::DSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants )
+{
+    OnCall( DSSetConstantBuffers1Call );
+
+    if ( m_Context1 )
+    {
+        m_Context1->DSSetConstantBuffers1( StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::DSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews )
+{
+    OnCall( DSSetShaderResourcesCall );
+
+    if ( m_Context )
+    {
+        m_Context->DSSetShaderResources( StartSlot, NumViews, ppShaderResourceViews );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::DSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers )
+{
+    OnCall( DSSetSamplersCall );
+
+    if ( m_Context )
+    {
+        m_Context->DSSetSamplers( StartSlot, NumSamplers, ppSamplers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::GSSetShader( ID3D11GeometryShader* pGeometryShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances )
+{
+    OnCall( GSSetShaderCall );
+
+    if ( m_Context )
+    {
+        m_Context->GSSetShader( pGeometryShader, ppClassInstances, NumClassInstances );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::GSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers )
+{
+    OnCall( GSSetConstantBuffersCall );
+
+    if ( m_Context )
+    {
+        m_Context->GSSetConstantBuffers( StartSlot, NumBuffers, ppConstantBuffers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::GSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants )
+{
+    OnCall( GSSetConstantBuffers1Call );
+
+    if ( m_Context1 )
+    {
+        m_Context1->GSSetConstantBuffers1( StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::GSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews )
+{
+    OnCall( GSSetShaderResourcesCall );
+
+    if ( m_Context )
+    {
+        m_Context->GSSetShaderResources( StartSlot, NumViews, ppShaderResourceViews );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::GSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers )
+{
+    OnCall( GSSetSamplersCall );
+
+    if ( m_Context )
+    {
+        m_Context->GSSetSamplers( StartSlot, NumSamplers, ppSamplers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::PSSetShader( ID3D11PixelShader* pPixelShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances )
+{
+    OnCall( PSSetShaderCall );
+
+    if ( m_Context )
+    {
+        m_Context->PSSetShader( pPixelShader, ppClassInstances, NumClassInstances );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::PSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers )
+{
+    OnCall( PSSetConstantBuffersCall );
+
+    if ( m_Context )
+    {
+        m_Context->PSSetConstantBuffers( StartSlot, NumBuffers, ppConstantBuffers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::PSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants )
+{
+    OnCall( PSSetConstantBuffers1Call );
+
+    if ( m_Context1 )
+    {
+        m_Context1->PSSetConstantBuffers1( StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::PSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews )
+{
+    OnCall( PSSetShaderResourcesCall );
+
+    if ( m_Context )
+    {
+        m_Context->PSSetShaderResources( StartSlot, NumViews, ppShaderResourceViews );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::PSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers )
+{
+    OnCall( PSSetSamplersCall );
+
+    if ( m_Context )
+    {
+        m_Context->PSSetSamplers( StartSlot, NumSamplers, ppSamplers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::CSSetShader( ID3D11ComputeShader* pComputeShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances )
+{
+    OnCall( CSSetShaderCall );
+
+    if ( m_Context )
+    {
+        m_Context->CSSetShader( pComputeShader, ppClassInstances, NumClassInstances );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::CSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers )
+{
+    OnCall( CSSetConstantBuffersCall );
+
+    if ( m_Context )
+    {
+        m_Context->CSSetConstantBuffers( StartSlot, NumBuffers, ppConstantBuffers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::CSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants )
+{
+    OnCall( CSSetConstantBuffers1Call );
+
+    if ( m_Context1 )
+    {
+        m_Context1->CSSetConstantBuffers1( StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::CSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews )
+{
+    OnCall( CSSetShaderResourcesCall );
+
+    if ( m_Context )
+    {
+        m_Context->CSSetShaderResources( StartSlot, NumViews, ppShaderResourceViews );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::CSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers )
+{
+    OnCall( CSSetSamplersCall );
+
+    if ( m_Context )
+    {
+        m_Context->CSSetSamplers( StartSlot, NumSamplers, ppSamplers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::CSSetUnorderedAccessViews( UINT StartSlot, UINT NumUAVs, ID3D11UnorderedAccessView* const* ppUnorderedAccessViews, const UINT* pUAVInitialCounts )
+{
+    OnCall( CSSetUnorderedAccessViewsCall );
+
+    if ( m_Context )
+    {
+        m_Context->CSSetUnorderedAccessViews( StartSlot, NumUAVs, ppUnorderedAccessViews, pUAVInitialCounts );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::SOSetTargets( UINT NumBuffers, ID3D11Buffer* const* ppSOTargets, const UINT* pOffsets )
+{
+    OnCall( SOSetTargetsCall );
+
+    if ( m_Context )
+    {
+        m_Context->SOSetTargets( NumBuffers, ppSOTargets, pOffsets );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::RSSetState( ID3D11RasterizerState* pRasterizerState )
+{
+    OnCall( RSSetStateCall );
+
+    if ( m_Context )
+    {
+        m_Context->RSSetState( pRasterizerState );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::RSSetViewports( UINT NumViewports, const D3D11_VIEWPORT* pViewports )
+{
+    OnCall( RSSetViewportsCall );
+
+    if ( m_Context )
+    {
+        m_Context->RSSetViewports( NumViewports, pViewports );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::RSSetScissorRects( UINT NumRects, const D3D11_RECT* pRects )
+{
+    OnCall( RSSetScissorRectsCall );
+
+    if ( m_Context )
+    {
+        m_Context->RSSetScissorRects( NumRects, pRects );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::OMSetRenderTargets( UINT NumViews, ID3D11RenderTargetView* const* ppRenderTargetViews, ID3D11DepthStencilView* pDepthStencilView )
+{
+    OnCall( OMSetRenderTargetsCall );
+
+    if ( m_Context )
+    {
+        m_Context->OMSetRenderTargets( NumViews, ppRenderTargetViews, pDepthStencilView );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::OMSetRenderTargetsAndUnorderedAccessViews( UINT NumRTVs, ID3D11RenderTargetView* const* ppRenderTargetViews, ID3D11DepthStencilView* pDepthStencilView, UINT UAVStartSlot, UINT NumUAVs, ID3D11UnorderedAccessView* const* ppUnorderedAccessViews, const UINT* pUAVInitialCounts )
+{
+    OnCall( OMSetRenderTargetsAndUnorderedAccessViewsCall );
+
+    if ( m_Context )
+    {
+        m_Context->OMSetRenderTargetsAndUnorderedAccessViews( NumRTVs, ppRenderTargetViews, pDepthStencilView, UAVStartSlot, NumUAVs, ppUnorderedAccessViews, pUAVInitialCounts );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::OMSetBlendState( ID3D11BlendState* pBlendState, const FLOAT BlendFactor[4], UINT SampleMask )
+{
+    OnCall( OMSetBlendStateCall );
+
+    if ( m_Context )
+    {
+        m_Context->OMSetBlendState( pBlendState, BlendFactor, SampleMask );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::OMSetDepthStencilState( ID3D11DepthStencilState* pDepthStencilState, UINT StencilRef )
+{
+    OnCall( OMSetDepthStencilStateCall );
+
+    if ( m_Context )
+    {
+        m_Context->OMSetDepthStencilState( pDepthStencilState, StencilRef );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::SetPredication( ID3D11Predicate* pPredicate, BOOL PredicateValue )
+{
+    OnCall( SetPredicationCall );
+
+    if ( m_Context )
+    {
+        m_Context->SetPredication( pPredicate, PredicateValue );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::Draw( UINT VertexCount, UINT StartVertexLocation )
+{
+    OnCall( DrawCall );
+
+    if ( m_Context )
+    {
+        m_Context->Draw( VertexCount, StartVertexLocation );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::DrawIndexed( UINT IndexCount, UINT StartIndexLocation, INT BaseVertexLocation )
+{
+    OnCall( DrawIndexedCall );
+
+    if ( m_Context )
+    {
+        m_Context->DrawIndexed( IndexCount, StartIndexLocation, BaseVertexLocation );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::DrawInstanced( UINT VertexCountPerInstance, UINT InstanceCount, UINT StartVertexLocation, UINT StartInstanceLocation )
+{
+    OnCall( DrawInstancedCall );
+
+    if ( m_Context )
+    {
+        m_Context->DrawInstanced( VertexCountPerInstance, InstanceCount, StartVertexLocation, StartInstanceLocation );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::DrawIndexedInstanced( UINT IndexCountPerInstance, UINT InstanceCount, UINT StartIndexLocation, INT BaseVertexLocation, UINT StartInstanceLocation )
+{
+    OnCall( DrawIndexedInstancedCall );
+
+    if ( m_Context )
+    {
+        m_Context->DrawIndexedInstanced( IndexCountPerInstance, InstanceCount, StartIndexLocation, BaseVertexLocation, StartInstanceLocation );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::DrawAuto()
+{
+    OnCall( DrawAutoCall );
+
+    if ( m_Context )
+    {
+        m_Context->DrawAuto();
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::DrawInstancedIndirect( ID3D11Buffer* pBufferForArgs, UINT AlignedByteOffsetForArgs )
+{
+    OnCall( DrawInstancedIndirectCall );
+
+    if ( m_Context )
+    {
+        m_Context->DrawInstancedIndirect( pBufferForArgs, AlignedByteOffsetForArgs );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::DrawIndexedInstancedIndirect( ID3D11Buffer* pBufferForArgs, UINT AlignedByteOffsetForArgs )
+{
+    OnCall( DrawIndexedInstancedIndirectCall );
+
+    if ( m_Context )
+    {
+        m_Context->DrawIndexedInstancedIndirect( pBufferForArgs, AlignedByteOffsetForArgs );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::Dispatch( UINT ThreadGroupCountX, UINT ThreadGroupCountY, UINT ThreadGroupCountZ )
+{
+    OnCall( DispatchCall );
+
+    if ( m_Context )
+    {
+        m_Context->Dispatch( ThreadGroupCountX, ThreadGroupCountY, ThreadGroupCountZ );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::DispatchIndirect( ID3D11Buffer* pBufferForArgs, UINT AlignedByteOffsetForArgs )
+{
+    OnCall( DispatchIndirectCall );
+
+    if ( m_Context )
+    {
+        m_Context->DispatchIndirect( pBufferForArgs, AlignedByteOffsetForArgs );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::Unmap( ID3D11Resource* pResource, UINT Subresource )
+{
+    OnCall( UnmapCall );
+
+    if ( m_Context )
+    {
+        m_Context->Unmap( pResource, Subresource );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::UpdateSubresource( ID3D11Resource* pDstResource, UINT DstSubresource, const D3D11_BOX* pDstBox, const void* pSrcData, UINT SrcRowPitch, UINT SrcDepthPitch )
+{
+    OnCall( UpdateSubresourceCall );
+
+    if ( m_Context )
+    {
+        m_Context->UpdateSubresource( pDstResource, DstSubresource, pDstBox, pSrcData, SrcRowPitch, SrcDepthPitch );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::UpdateSubresource1( ID3D11Resource* pDstResource, UINT DstSubresource, const D3D11_BOX* pDstBox, const void* pSrcData, UINT SrcRowPitch, UINT SrcDepthPitch, UINT CopyFlags )
+{
+    OnCall( UpdateSubresource1Call );
+
+    if ( m_Context1 )
+    {
+        m_Context1->UpdateSubresource1( pDstResource, DstSubresource, pDstBox, pSrcData, SrcRowPitch, SrcDepthPitch, CopyFlags );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::CopyResource( ID3D11Resource* pDstResource, ID3D11Resource* pSrcResource )
+{
+    OnCall( CopyResourceCall );
+
+    if ( m_Context )
+    {
+        m_Context->CopyResource( pDstResource, pSrcResource );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::CopySubresourceRegion( ID3D11Resource* pDstResource, UINT DstSubresource, UINT DstX, UINT DstY, UINT DstZ, ID3D11Resource* pSrcResource, UINT SrcSubresource, const D3D11_BOX* pSrcBox )
+{
+    OnCall( CopySubresourceRegionCall );
+
+    if ( m_Context )
+    {
+        m_Context->CopySubresourceRegion( pDstResource, DstSubresource, DstX, DstY, DstZ, pSrcResource, SrcSubresource, pSrcBox );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::CopySubresourceRegion1( ID3D11Resource* pDstResource, UINT DstSubresource, UINT DstX, UINT DstY, UINT DstZ, ID3D11Resource* pSrcResource, UINT SrcSubresource, const D3D11_BOX* pSrcBox, UINT CopyFlags )
+{
+    OnCall( CopySubresourceRegion1Call );
+
+    if ( m_Context1 )
+    {
+        m_Context1->CopySubresourceRegion1( pDstResource, DstSubresource, DstX, DstY, DstZ, pSrcResource, SrcSubresource, pSrcBox, CopyFlags );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::CopyStructureCount( ID3D11Buffer* pDstBuffer, UINT DstAlignedByteOffset, ID3D11UnorderedAccessView* pSrcView )
+{
+    OnCall( CopyStructureCountCall );
+
+    if ( m_Context )
+    {
+        m_Context->CopyStructureCount( pDstBuffer, DstAlignedByteOffset, pSrcView );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::ResolveSubresource( ID3D11Resource* pDstResource, UINT DstSubresource, ID3D11Resource* pSrcResource, UINT SrcSubresource, DXGI_FORMAT Format )
+{
+    OnCall( ResolveSubresourceCall );
+
+    if ( m_Context )
+    {
+        m_Context->ResolveSubresource( pDstResource, DstSubresource, pSrcResource, SrcSubresource, Format );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::ClearRenderTargetView( ID3D11RenderTargetView* pRenderTargetView, const FLOAT ColorRGBA[4] )
+{
+    OnCall( ClearRenderTargetViewCall );
+
+    if ( m_Context )
+    {
+        m_Context->ClearRenderTargetView( pRenderTargetView, ColorRGBA );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::ClearDepthStencilView( ID3D11DepthStencilView* pDepthStencilView, UINT ClearFlags, FLOAT Depth, UINT8 Stencil )
+{
+    OnCall( ClearDepthStencilViewCall );
+
+    if ( m_Context )
+    {
+        m_Context->ClearDepthStencilView( pDepthStencilView, ClearFlags, Depth, Stencil );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::ClearUnorderedAccessViewUint( ID3D11UnorderedAccessView* pUnorderedAccessView, const UINT Values[4] )
+{
+    OnCall( ClearUnorderedAccessViewUintCall );
+
+    if ( m_Context )
+    {
+        m_Context->ClearUnorderedAccessViewUint( pUnorderedAccessView, Values );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::ClearUnorderedAccessViewFloat( ID3D11UnorderedAccessView* pUnorderedAccessView, const FLOAT Values[4] )
+{
+    OnCall( ClearUnorderedAccessViewFloatCall );
+
+    if ( m_Context )
+    {
+        m_Context->ClearUnorderedAccessViewFloat( pUnorderedAccessView, Values );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::ClearView( ID3D11View* pView, const FLOAT Color[4], const D3D11_RECT* pRect, UINT NumRects )
+{
+    OnCall( ClearViewCall );
+
+    if ( m_Context1 )
+    {
+        m_Context1->ClearView( pView, Color, pRect, NumRects );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::DiscardResource( ID3D11Resource* pResource )
+{
+    OnCall( DiscardResourceCall );
+
+    if ( m_Context1 )
+    {
+        m_Context1->DiscardResource( pResource );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::DiscardView( ID3D11View* pResourceView )
+{
+    OnCall( DiscardViewCall );
+
+    if ( m_Context1 )
+    {
+        m_Context1->DiscardView( pResourceView );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::DiscardView1( ID3D11View* pResourceView, const D3D11_RECT* pRects, UINT NumRects )
+{
+    OnCall( DiscardView1Call );
+
+    if ( m_Context1 )
+    {
+        m_Context1->DiscardView1( pResourceView, pRects, NumRects );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::GenerateMips( ID3D11ShaderResourceView* pShaderResourceView )
+{
+    OnCall( GenerateMipsCall );
+
+    if ( m_Context )
+    {
+        m_Context->GenerateMips( pShaderResourceView );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::SetResourceMinLOD( ID3D11Resource* pResource, FLOAT MinLOD )
+{
+    OnCall( SetResourceMinLODCall );
+
+    if ( m_Context )
+    {
+        m_Context->SetResourceMinLOD( pResource, MinLOD );
+    }
+}
+
+FLOAT STDMETHODCALLTYPE DeviceContextWrapper::GetResourceMinLOD( ID3D11Resource* pResource )
+{
+    OnCall( GetResourceMinLODCall );
+
+    if ( m_Context )
+    {
+        return m_Context->GetResourceMinLOD( pResource );
+    }
+
+    return 0.0f;
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::Begin( ID3D11Asynchronous* pAsync )
+{
+    OnCall( BeginCall );
+
+    if ( m_Context )
+    {
+        m_Context->Begin( pAsync );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::End( ID3D11Asynchronous* pAsync )
+{
+    OnCall( EndCall );
+
+    if ( m_Context )
+    {
+        m_Context->End( pAsync );
+    }
+}
+
+HRESULT STDMETHODCALLTYPE DeviceContextWrapper::GetData( ID3D11Asynchronous* pAsync, void* pData, UINT DataSize, UINT GetDataFlags )
+{
+    OnCall( GetDataCall );
+
+    if ( m_Context )
+    {
+        return m_Context->GetData( pAsync, pData, DataSize, GetDataFlags );
+    }
+
+    if ( pData )
+    {
+        ZeroMemory( pData, DataSize );
+    }
+    return S_OK;
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::IAGetInputLayout( ID3D11InputLayout** ppInputLayout )
+{
+    OnCall( IAGetInputLayoutCall );
+
+    if ( m_Context )
+    {
+        m_Context->IAGetInputLayout( ppInputLayout );
+    }
+    else
+    {
+        ClearArray( ppInputLayout, 1 );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::IAGetVertexBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppVertexBuffers, UINT* pStrides, UINT* pOffsets )
+{
+    OnCall( IAGetVertexBuffersCall );
+
+    if ( m_Context )
+    {
+        m_Context->IAGetVertexBuffers( StartSlot, NumBuffers, ppVertexBuffers, pStrides, pOffsets );
+    }
+    else
+    {
+        ClearArray( ppVertexBuffers, NumBuffers );
+        ClearArray( pStrides, NumBuffers );
+        ClearArray( pOffsets, NumBuffers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::IAGetIndexBuffer( ID3D11Buffer** pIndexBuffer, DXGI_FORMAT* Format, UINT* Offset )
+{
+    OnCall( IAGetIndexBufferCall );
+
+    if ( m_Context )
+    {
+        m_Context->IAGetIndexBuffer( pIndexBuffer, Format, Offset );
+    }
+    else
+    {
+        ClearArray( pIndexBuffer, 1 );
+        ClearArray( Format, 1 );
+        ClearArray( Offset, 1 );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::IAGetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY* pTopology )
+{
+    OnCall( IAGetPrimitiveTopologyCall );
+
+    if ( m_Context )
+    {
+        m_Context->IAGetPrimitiveTopology( pTopology );
+    }
+    else
+    {
+        ClearArray( pTopology, 1 );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::VSGetShader( ID3D11VertexShader** ppVertexShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances )
+{
+    OnCall( VSGetShaderCall );
+
+    if ( m_Context )
+    {
+        m_Context->VSGetShader( ppVertexShader, ppClassInstances, pNumClassInstances );
+    }
+    else
+    {
+        ClearArray( ppVertexShader, 1 );
+        ClearArray( pNumClassInstances, 1 );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::VSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers )
+{
+    OnCall( VSGetConstantBuffersCall );
+
+    if ( m_Context )
+    {
+        m_Context->VSGetConstantBuffers( StartSlot, NumBuffers, ppConstantBuffers );
+    }
+    else
+    {
+        ClearArray( ppConstantBuffers, NumBuffers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::VSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants )
+{
+    OnCall( VSGetConstantBuffers1Call );
+
+    if ( m_Context1 )
+    {
+        m_Context1->VSGetConstantBuffers1( StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+    }
+    else
+    {
+        ClearArray( ppConstantBuffers, NumBuffers );
+        ClearArray( pFirstConstant, NumBuffers );
+        ClearArray( pNumConstants, NumBuffers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::VSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews )
+{
+    OnCall( VSGetShaderResourcesCall );
+
+    if ( m_Context )
+    {
+        m_Context->VSGetShaderResources( StartSlot, NumViews, ppShaderResourceViews );
+    }
+    else
+    {
+        ClearArray( ppShaderResourceViews, NumViews );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::VSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers )
+{
+    OnCall( VSGetSamplersCall );
+
+    if ( m_Context )
+    {
+        m_Context->VSGetSamplers( StartSlot, NumSamplers, ppSamplers );
+    }
+    else
+    {
+        ClearArray( ppSamplers, NumSamplers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::HSGetShader( ID3D11HullShader** ppHullShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances )
+{
+    OnCall( HSGetShaderCall );
+
+    if ( m_Context )
+    {
+        m_Context->HSGetShader( ppHullShader, ppClassInstances, pNumClassInstances );
+    }
+    else
+    {
+        ClearArray( ppHullShader, 1 );
+        ClearArray( pNumClassInstances, 1 );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::HSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers )
+{
+    OnCall( HSGetConstantBuffersCall );
+
+    if ( m_Context )
+    {
+        m_Context->HSGetConstantBuffers( StartSlot, NumBuffers, ppConstantBuffers );
+    }
+    else
+    {
+        ClearArray( ppConstantBuffers, NumBuffers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::HSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants )
+{
+    OnCall( HSGetConstantBuffers1Call );
+
+    if ( m_Context1 )
+    {
+        m_Context1->HSGetConstantBuffers1( StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+    }
+    else
+    {
+        ClearArray( ppConstantBuffers, NumBuffers );
+        ClearArray( pFirstConstant, NumBuffers );
+        ClearArray( pNumConstants, NumBuffers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::HSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews )
+{
+    OnCall( HSGetShaderResourcesCall );
+
+    if ( m_Context )
+    {
+        m_Context->HSGetShaderResources( StartSlot, NumViews, ppShaderResourceViews );
+    }
+    else
+    {
+        ClearArray( ppShaderResourceViews, NumViews );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::HSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers )
+{
+    OnCall( HSGetSamplersCall );
+
+    if ( m_Context )
+    {
+        m_Context->HSGetSamplers( StartSlot, NumSamplers, ppSamplers );
+    }
+    else
+    {
+        ClearArray( ppSamplers, NumSamplers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::DSGetShader( ID3D11DomainShader** ppDomainShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances )
+{
+    OnCall( DSGetShaderCall );
+
+    if ( m_Context )
+    {
+        m_Context->DSGetShader( ppDomainShader, ppClassInstances, pNumClassInstances );
+    }
+    else
+    {
+        ClearArray( ppDomainShader, 1 );
+        ClearArray( pNumClassInstances, 1 );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::DSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers )
+{
+    OnCall( DSGetConstantBuffersCall );
+
+    if ( m_Context )
+    {
+        m_Context->DSGetConstantBuffers( StartSlot, NumBuffers, ppConstantBuffers );
+    }
+    else
+    {
+        ClearArray( ppConstantBuffers, NumBuffers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::DSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants )
+{
+    OnCall( DSGetConstantBuffers1Call );
+
+    if ( m_Context1 )
+    {
+        m_Context1->DSGetConstantBuffers1( StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+    }
+    else
+    {
+        ClearArray( ppConstantBuffers, NumBuffers );
+        ClearArray( pFirstConstant, NumBuffers );
+        ClearArray( pNumConstants, NumBuffers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::DSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews )
+{
+    OnCall( DSGetShaderResourcesCall );
+
+    if ( m_Context )
+    {
+        m_Context->DSGetShaderResources( StartSlot, NumViews, ppShaderResourceViews );
+    }
+    else
+    {
+        ClearArray( ppShaderResourceViews, NumViews );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::DSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers )
+{
+    OnCall( DSGetSamplersCall );
+
+    if ( m_Context )
+    {
+        m_Context->DSGetSamplers( StartSlot, NumSamplers, ppSamplers );
+    }
+    else
+    {
+        ClearArray( ppSamplers, NumSamplers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::GSGetShader( ID3D11GeometryShader** ppGeometryShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances )
+{
+    OnCall( GSGetShaderCall );
+
+    if ( m_Context )
+    {
+        m_Context->GSGetShader( ppGeometryShader, ppClassInstances, pNumClassInstances );
+    }
+    else
+    {
+        ClearArray( ppGeometryShader, 1 );
+        ClearArray( pNumClassInstances, 1 );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::GSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers )
+{
+    OnCall( GSGetConstantBuffersCall );
+
+    if ( m_Context )
+    {
+        m_Context->GSGetConstantBuffers( StartSlot, NumBuffers, ppConstantBuffers );
+    }
+    else
+    {
+        ClearArray( ppConstantBuffers, NumBuffers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::GSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants )
+{
+    OnCall( GSGetConstantBuffers1Call );
+
+    if ( m_Context1 )
+    {
+        m_Context1->GSGetConstantBuffers1( StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+    }
+    else
+    {
+        ClearArray( ppConstantBuffers, NumBuffers );
+        ClearArray( pFirstConstant, NumBuffers );
+        ClearArray( pNumConstants, NumBuffers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::GSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews )
+{
+    OnCall( GSGetShaderResourcesCall );
+
+    if ( m_Context )
+    {
+        m_Context->GSGetShaderResources( StartSlot, NumViews, ppShaderResourceViews );
+    }
+    else
+    {
+        ClearArray( ppShaderResourceViews, NumViews );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::GSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers )
+{
+    OnCall( GSGetSamplersCall );
+
+    if ( m_Context )
+    {
+        m_Context->GSGetSamplers( StartSlot, NumSamplers, ppSamplers );
+    }
+    else
+    {
+        ClearArray( ppSamplers, NumSamplers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::PSGetShader( ID3D11PixelShader** ppPixelShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances )
+{
+    OnCall( PSGetShaderCall );
+
+    if ( m_Context )
+    {
+        m_Context->PSGetShader( ppPixelShader, ppClassInstances, pNumClassInstances );
+    }
+    else
+    {
+        ClearArray( ppPixelShader, 1 );
+        ClearArray( pNumClassInstances, 1 );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::PSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers )
+{
+    OnCall( PSGetConstantBuffersCall );
+
+    if ( m_Context )
+    {
+        m_Context->PSGetConstantBuffers( StartSlot, NumBuffers, ppConstantBuffers );
+    }
+    else
+    {
+        ClearArray( ppConstantBuffers, NumBuffers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::PSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants )
+{
+    OnCall( PSGetConstantBuffers1Call );
+
+    if ( m_Context1 )
+    {
+        m_Context1->PSGetConstantBuffers1( StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+    }
+    else
+    {
+        ClearArray( ppConstantBuffers, NumBuffers );
+        ClearArray( pFirstConstant, NumBuffers );
+        ClearArray( pNumConstants, NumBuffers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::PSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews )
+{
+    OnCall( PSGetShaderResourcesCall );
+
+    if ( m_Context )
+    {
+        m_Context->PSGetShaderResources( StartSlot, NumViews, ppShaderResourceViews );
+    }
+    else
+    {
+        ClearArray( ppShaderResourceViews, NumViews );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::PSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers )
+{
+    OnCall( PSGetSamplersCall );
+
+    if ( m_Context )
+    {
+        m_Context->PSGetSamplers( StartSlot, NumSamplers, ppSamplers );
+    }
+    else
+    {
+        ClearArray( ppSamplers, NumSamplers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::CSGetShader( ID3D11ComputeShader** ppComputeShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances )
+{
+    OnCall( CSGetShaderCall );
+
+    if ( m_Context )
+    {
+        m_Context->CSGetShader( ppComputeShader, ppClassInstances, pNumClassInstances );
+    }
+    else
+    {
+        ClearArray( ppComputeShader, 1 );
+        ClearArray( pNumClassInstances, 1 );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::CSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers )
+{
+    OnCall( CSGetConstantBuffersCall );
+
+    if ( m_Context )
+    {
+        m_Context->CSGetConstantBuffers( StartSlot, NumBuffers, ppConstantBuffers );
+    }
+    else
+    {
+        ClearArray( ppConstantBuffers, NumBuffers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::CSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants )
+{
+    OnCall( CSGetConstantBuffers1Call );
+
+    if ( m_Context1 )
+    {
+        m_Context1->CSGetConstantBuffers1( StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+    }
+    else
+    {
+        ClearArray( ppConstantBuffers, NumBuffers );
+        ClearArray( pFirstConstant, NumBuffers );
+        ClearArray( pNumConstants, NumBuffers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::CSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews )
+{
+    OnCall( CSGetShaderResourcesCall );
+
+    if ( m_Context )
+    {
+        m_Context->CSGetShaderResources( StartSlot, NumViews, ppShaderResourceViews );
+    }
+    else
+    {
+        ClearArray( ppShaderResourceViews, NumViews );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::CSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers )
+{
+    OnCall( CSGetSamplersCall );
+
+    if ( m_Context )
+    {
+        m_Context->CSGetSamplers( StartSlot, NumSamplers, ppSamplers );
+    }
+    else
+    {
+        ClearArray( ppSamplers, NumSamplers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::CSGetUnorderedAccessViews( UINT StartSlot, UINT NumUAVs, ID3D11UnorderedAccessView** ppUnorderedAccessViews )
+{
+    OnCall( CSGetUnorderedAccessViewsCall );
+
+    if ( m_Context )
+    {
+        m_Context->CSGetUnorderedAccessViews( StartSlot, NumUAVs, ppUnorderedAccessViews );
+    }
+    else
+    {
+        ClearArray( ppUnorderedAccessViews, NumUAVs );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::SOGetTargets( UINT NumBuffers, ID3D11Buffer** ppSOTargets )
+{
+    OnCall( SOGetTargetsCall );
+
+    if ( m_Context )
+    {
+        m_Context->SOGetTargets( NumBuffers, ppSOTargets );
+    }
+    else
+    {
+        ClearArray( ppSOTargets, NumBuffers );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::RSGetState( ID3D11RasterizerState** ppRasterizerState )
+{
+    OnCall( RSGetStateCall );
+
+    if ( m_Context )
+    {
+        m_Context->RSGetState( ppRasterizerState );
+    }
+    else
+    {
+        ClearArray( ppRasterizerState, 1 );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::RSGetViewports( UINT* pNumViewports, D3D11_VIEWPORT* pViewports )
+{
+    OnCall( RSGetViewportsCall );
+
+    if ( m_Context )
+    {
+        m_Context->RSGetViewports( pNumViewports, pViewports );
+    }
+    else
+    {
+        ClearArray( pNumViewports, 1 );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::RSGetScissorRects( UINT* pNumRects, D3D11_RECT* pRects )
+{
+    OnCall( RSGetScissorRectsCall );
+
+    if ( m_Context )
+    {
+        m_Context->RSGetScissorRects( pNumRects, pRects );
+    }
+    else
+    {
+        ClearArray( pNumRects, 1 );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::OMGetRenderTargets( UINT NumViews, ID3D11RenderTargetView** ppRenderTargetViews, ID3D11DepthStencilView** ppDepthStencilView )
+{
+    OnCall( OMGetRenderTargetsCall );
+
+    if ( m_Context )
+    {
+        m_Context->OMGetRenderTargets( NumViews, ppRenderTargetViews, ppDepthStencilView );
+    }
+    else
+    {
+        ClearArray( ppRenderTargetViews, NumViews );
+        ClearArray( ppDepthStencilView, 1 );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::OMGetRenderTargetsAndUnorderedAccessViews( UINT NumRTVs, ID3D11RenderTargetView** ppRenderTargetViews, ID3D11DepthStencilView** ppDepthStencilView, UINT UAVStartSlot, UINT NumUAVs, ID3D11UnorderedAccessView** ppUnorderedAccessViews )
+{
+    OnCall( OMGetRenderTargetsAndUnorderedAccessViewsCall );
+
+    if ( m_Context )
+    {
+        m_Context->OMGetRenderTargetsAndUnorderedAccessViews( NumRTVs, ppRenderTargetViews, ppDepthStencilView, UAVStartSlot, NumUAVs, ppUnorderedAccessViews );
+    }
+    else
+    {
+        ClearArray( ppRenderTargetViews, NumRTVs );
+        ClearArray( ppDepthStencilView, 1 );
+        ClearArray( ppUnorderedAccessViews, NumUAVs );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::OMGetBlendState( ID3D11BlendState** ppBlendState, FLOAT BlendFactor[4], UINT* pSampleMask )
+{
+    OnCall( OMGetBlendStateCall );
+
+    if ( m_Context )
+    {
+        m_Context->OMGetBlendState( ppBlendState, BlendFactor, pSampleMask );
+    }
+    else
+    {
+        ClearArray( ppBlendState, 1 );
+        ClearArray( BlendFactor, 4 );
+        ClearArray( pSampleMask, 1 );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::OMGetDepthStencilState( ID3D11DepthStencilState** ppDepthStencilState, UINT* pStencilRef )
+{
+    OnCall( OMGetDepthStencilStateCall );
+
+    if ( m_Context )
+    {
+        m_Context->OMGetDepthStencilState( ppDepthStencilState, pStencilRef );
+    }
+    else
+    {
+        ClearArray( ppDepthStencilState, 1 );
+        ClearArray( pStencilRef, 1 );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::GetPredication( ID3D11Predicate** ppPredicate, BOOL* pPredicateValue )
+{
+    OnCall( GetPredicationCall );
+
+    if ( m_Context )
+    {
+        m_Context->GetPredication( ppPredicate, pPredicateValue );
+    }
+    else
+    {
+        ClearArray( ppPredicate, 1 );
+        ClearArray( pPredicateValue, 1 );
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::ClearState()
+{
+    OnCall( ClearStateCall );
+
+    if ( m_Context )
+    {
+        m_Context->ClearState();
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::Flush()
+{
+    OnCall( FlushCall );
+
+    if ( m_Context )
+    {
+        m_Context->Flush();
+    }
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::ExecuteCommandList( ID3D11CommandList* pCommandList, BOOL RestoreContextState )
+{
+    OnCall( ExecuteCommandListCall );
+
+    if ( m_Context )
+    {
+        m_Context->ExecuteCommandList( pCommandList, RestoreContextState );
+    }
+}
+
+HRESULT STDMETHODCALLTYPE DeviceContextWrapper::FinishCommandList( BOOL RestoreDeferredContextState, ID3D11CommandList** ppCommandList )
+{
+    OnCall( FinishCommandListCall );
+
+    if ( m_Context )
+    {
+        return m_Context->FinishCommandList( RestoreDeferredContextState, ppCommandList );
+    }
+
+    ClearArray( ppCommandList, 1 );
+    return DXGI_ERROR_INVALID_CALL;
+}
+
+D3D11_DEVICE_CONTEXT_TYPE STDMETHODCALLTYPE DeviceContextWrapper::GetType()
+{
+    OnCall( GetTypeCall );
+
+    if ( m_Context )
+    {
+        return m_Context->GetType();
+    }
+
+    return D3D11_DEVICE_CONTEXT_IMMEDIATE;
+}
+
+UINT STDMETHODCALLTYPE DeviceContextWrapper::GetContextFlags()
+{
+    OnCall( GetContextFlagsCall );
+
+    if ( m_Context )
+    {
+        return m_Context->GetContextFlags();
+    }
+
+    return 0;
+}
+
+void STDMETHODCALLTYPE DeviceContextWrapper::SwapDeviceContextState( ID3DDeviceContextState* pState, ID3DDeviceContextState** ppPreviousState )
+{
+    OnCall( SwapDeviceContextStateCall );
+
+    if ( m_Context1 )
+    {
+        m_Context1->SwapDeviceContextState( pState, ppPreviousState );
+    }
+    else
+    {
+        ClearArray( ppPreviousState, 1 );
+    }
+}
@@ -0,0 +1,64 @@
+#include <DirectXTemplateLibPCH.h>
+#include <DirtyRangeTracker.h>
+
+DirtyRangeTracker::DirtyRangeTracker( UINT mergeDistance )
+    : m_MergeDistance( mergeDistance )
+{}
+
+void DirtyRangeTracker::MarkDirty( UINT begin, UINT end )
+{
+    if ( begin >= end )
+    {
+        return;
+    }
+
+    // The first range that ends close enough to the new range to be merged with it.
+    auto first = std::lower_bound( m_Ranges.begin(), m_Ranges.end(), begin, [this]( const Range& range, UINT value )
+    {
+        return range.End + m_MergeDistance < value;
+    } );
+
+    // Merge all ranges that start close enough to the end of the new range.
+    Range merged = { begin, end };
+    auto last = first;
+    while ( last != m_Ranges.end() && last->Begin <= end + m_MergeDistance )
+    {
+        merged.Begin = std::min( merged.Begin, last->Begin );
+        merged.End = std::max( merged.End, last->End );
+        ++last;
+    }
+
+    first = m_Ranges.erase( first, last );
+    m_Ranges.insert( first, merged );
+}
+
+void DirtyRangeTracker::MarkDirty( UINT index )
+{
+    MarkDirty( index, index + 1 );
+}
+
+bool DirtyRangeTracker::IsDirty() const
+{
+    return !m_Ranges.empty();
+}
+
+const std::vector<DirtyRangeTracker::Range>& DirtyRangeTracker::get_Ranges() const
+{
+    return m_Ranges;
+}
+
+UINT DirtyRangeTracker::get_DirtyCount() const
+{
+    UINT dirtyCount = 0;
+    for ( const Range& range : m_Ranges )
+    {
+        dirtyCount += range.End - range.Begin;
+    }
+
+    return dirtyCount;
+}
+
+void DirtyRangeTracker::Clear()
+{
+    m_Ranges.clear();
+}
@@ -0,0 +1,92 @@
+#include <DirectXTemplateLibPCH.h>
+#include <FramePipeline.h>
+#include <Profiler.h>
+
+FramePipeline::FramePipeline( const UpdateFunction& update )
+    : m_Update( update )
+    , m_UpdateEventArgs( 0.0f, 0.0f )
+    , m_State( Idle )
+{
+    assert( m_Update );
+
+    // Start the thread after all members have been initialized.
+    m_Thread = std::thread( &FramePipeline::Run, this );
+}
+
+FramePipeline::~FramePipeline()
+{
+    {
+        std::unique_lock<std::mutex> lock( m_Mutex );
+        m_Condition.wait( lock, [this]() { return m_State != Updating; } );
+
+        m_State = Stopping;
+    }
+    m_Condition.notify_all();
+
+    m_Thread.join();
+}
+
+void FramePipeline::BeginUpdate( const UpdateEventArgs& e )
+{
+    {
+        std::lock_guard<std::mutex> lock( m_Mutex );
+        assert( m_State == Idle && "The previous update must be waited for before the next update is started." );
+
+        m_UpdateEventArgs = e;
+        m_State = Updating;
+    }
+    m_Condition.notify_all();
+}
+
+void FramePipeline::WaitForUpdate()
+{
+    std::exception_ptr exception;
+    {
+        std::unique_lock<std::mutex> lock( m_Mutex );
+        m_Condition.wait( lock, [this]() { return m_State != Updating; } );
+
+        std::swap( exception, m_Exception );
+    }
+
+    if ( exception )
+    {
+        std::rethrow_exception( exception );
+    }
+}
+
+bool FramePipeline::IsUpdating() const
+{
+    std::lock_guard<std::mutex> lock( m_Mutex );
+    return m_State == Updating;
+}
+
+void FramePipeline::Run()
+{
+    Profiler::set_ThreadName( "Update" );
+
+    std::unique_lock<std::mutex> lock( m_Mutex );
+
+    for ( ;; )
+    {
+        m_Condition.wait( lock, [this]() { return m_State != Idle; } );
+        if ( m_State == Stopping )
+        {
+            break;
+        }
+
+        lock.unlock();
+        try
+        {
+            m_Update( m_UpdateEventArgs );
+        }
+        catch ( ... )
+        {
+            // Only this thread writes the exception while an update is running.
+            m_Exception = std::current_exception();
+        }
+        lock.lock();
+
+        m_State = Idle;
+        m_Condition.notify_all();
+    }
+}
@@ -0,0 +1,232 @@
+#include <DirectXTemplateLibPCH.h>
+#include <FrameStatistics.h>
+#include <HighResolutionClock.h>
+
+#include <fstream>
+
+FrameStatistics::FrameStatistics( size_t capacity )
+    : m_Frames( std::max<size_t>( capacity, 1 ) )
+    , m_SortedTimes( std::max<size_t>( capacity, 1 ) )
+{
+    Reset();
+}
+
+void FrameStatistics::AddTime( Phase phase, double seconds )
+{
+    assert( phase < FramePhase );
+    m_CurrentTimes[phase] += seconds;
+}
+
+double FrameStatistics::get_CurrentTime( Phase phase ) const
+{
+    assert( phase < PhaseCount );
+    return m_CurrentTimes[phase];
+}
+
+void FrameStatistics::EndFrame()
+{
+    double currentTime = HighResolutionClock::get_CurrentSeconds();
+
+    // The first frame has no previous frame, so its frame time is the sum of its phases.
+    if ( m_PreviousFrameEnd > 0.0 )
+    {
+        m_CurrentTimes[FramePhase] = currentTime - m_PreviousFrameEnd;
+    }
+    else
+    {
+        m_CurrentTimes[FramePhase] = m_CurrentTimes[UpdatePhase] + m_CurrentTimes[RenderPhase] + m_CurrentTimes[PresentPhase];
+    }
+    m_PreviousFrameEnd = currentTime;
+
+    Frame& frame = m_Frames[m_NextFrame];
+    frame.Number = m_TotalFrameCount;
+    for ( int i = 0; i < PhaseCount; ++i )
+    {
+        frame.Milliseconds[i] = static_cast<float>( m_CurrentTimes[i] * 1000.0 );
+        m_CurrentTimes[i] = 0.0;
+    }
+
+    m_NextFrame = ( m_NextFrame + 1 ) % m_Frames.size();
+    ++m_TotalFrameCount;
+}
+
+void FrameStatistics::Reset()
+{
+    m_NextFrame = 0;
+    m_TotalFrameCount = 0;
+    m_PreviousFrameEnd = 0.0;
+
+    for ( int i = 0; i < PhaseCount; ++i )
+    {
+        m_CurrentTimes[i] = 0.0;
+    }
+}
+
+uint64_t FrameStatistics::get_TotalFrameCount() const
+{
+    return m_TotalFrameCount;
+}
+
+size_t FrameStatistics::get_FrameCount() const
+{
+    return static_cast<size_t>( std::min<uint64_t>( m_TotalFrameCount, m_Frames.size() ) );
+}
+
+// Frames are indexed from the oldest (0) to the newest (get_FrameCount() - 1).
+const FrameStatistics::Frame& FrameStatistics::get_Frame( size_t index ) const
+{
+    assert( index < get_FrameCount() );
+
+    size_t oldestFrame = ( m_TotalFrameCount > m_Frames.size() ) ? m_NextFrame : 0;
+    return m_Frames[( oldestFrame + index ) % m_Frames.size()];
+}
+
+float FrameStatistics::get_Percentile( Phase phase, float percentile ) const
+{
+    size_t frameCount = get_FrameCount();
+    if ( frameCount == 0 )
+    {
+        return 0.0f;
+    }
+
+    for ( size_t i = 0; i < frameCount; ++i )
+    {
+        m_SortedTimes[i] = get_Frame( i ).Milliseconds[phase];
+    }
+
+    // Nearest rank.
+    float rank = std::min( std::max( percentile, 0.0f ), 100.0f ) / 100.0f * frameCount;
+    size_t index = std::min( static_cast<size_t>( std::ceil( rank ) ), frameCount );
+    index = ( index > 0 ) ? index - 1 : 0;
+
+    std::nth_element( m_SortedTimes.begin(), m_SortedTimes.begin() + index, m_SortedTimes.begin() + frameCount );
+    return m_SortedTimes[index];
+}
+
+float FrameStatistics::get_Average( Phase phase ) const
+{
+    size_t frameCount = get_FrameCount();
+    if ( frameCount == 0 )
+    {
+        return 0.0f;
+    }
+
+    double sum = 0.0;
+    for ( size_t i = 0; i < frameCount; ++i )
+    {
+        sum += get_Frame( i ).Milliseconds[phase];
+    }
+
+    return static_cast<float>( sum / frameCount );
+}
+
+float FrameStatistics::get_Maximum( Phase phase ) const
+{
+    float maximum = 0.0f;
+    for ( size_t i = 0; i < get_FrameCount(); ++i )
+    {
+        maximum = std::max( maximum, get_Frame( i ).Milliseconds[phase] );
+    }
+
+    return maximum;
+}
+
+void FrameStatistics::get_Histogram( Phase phase, float bucketWidth, UINT* buckets, size_t bucketCount ) const
+{
+    assert( bucketWidth > 0.0f && buckets && bucketCount > 0 );
+
+    std::fill( buckets, buckets + bucketCount, 0 );
+
+    for ( size_t i = 0; i < get_FrameCount(); ++i )
+    {
+        size_t bucket = static_cast<size_t>( get_Frame( i ).Milliseconds[phase] / bucketWidth );
+        ++buckets[std::min( bucket, bucketCount - 1 )];
+    }
+}
+
+const char* FrameStatistics::get_PhaseName( Phase phase )
+{
+    static const char* PhaseNames[PhaseCount] = { "Update", "Render", "Present", "Frame" };
+
+    assert( phase < PhaseCount );
+    return PhaseNames[phase];
+}
+
+bool FrameStatistics::SaveCsv( const std::wstring& fileName ) const
+{
+    std::ofstream file( fileName );
+    if ( !file )
+    {
+        return false;
+    }
+
+    file << "Number";
+    for ( int phase = 0; phase < PhaseCount; ++phase )
+    {
+        file << "," << get_PhaseName( static_cast<Phase>( phase ) );
+    }
+    file << "\n";
+
+    for ( size_t i = 0; i < get_FrameCount(); ++i )
+    {
+        const Frame& frame = get_Frame( i );
+
+        file << frame.Number;
+        for ( int phase = 0; phase < PhaseCount; ++phase )
+        {
+            file << "," << frame.Milliseconds[phase];
+        }
+        file << "\n";
+    }
+
+    return static_cast<bool>( file );
+}
+
+bool FrameStatistics::SaveJson( const std::wstring& fileName ) const
+{
+    static const float Percentiles[] = { 50.0f, 90.0f, 99.0f, 99.9f };
+    static const char* PercentileNames[] = { "p50", "p90", "p99", "p99.9" };
+    // Histogram buckets of 1 ms up to 100 ms.
+    static const size_t BucketCount = 100;
+    static const float BucketWidth = 1.0f;
+
+    std::ofstream file( fileName );
+    if ( !file )
+    {
+        return false;
+    }
+
+    file << "{\n";
+    file << "  \"totalFrameCount\": " << m_TotalFrameCount << ",\n";
+    file << "  \"frameCount\": " << get_FrameCount() << ",\n";
+    file << "  \"histogramBucketWidth\": " << BucketWidth << ",\n";
+    file << "  \"phases\": {\n";
+
+    UINT buckets[BucketCount];
+    for ( int p = 0; p < PhaseCount; ++p )
+    {
+        Phase phase = static_cast<Phase>( p );
+
+        file << "    \"" << get_PhaseName( phase ) << "\": {\n";
+        file << "      \"average\": " << get_Average( phase ) << ",\n";
+        file << "      \"maximum\": " << get_Maximum( phase ) << ",\n";
+        for ( size_t i = 0; i < _countof(Percentiles); ++i )
+        {
+            file << "      \"" << PercentileNames[i] << "\": " << get_Percentile( phase, Percentiles[i] ) << ",\n";
+        }
+
+        get_Histogram( phase, BucketWidth, buckets, BucketCount );
+        file << "      \"histogram\": [";
+        for ( size_t i = 0; i < BucketCount; ++i )
+        {
+            file << ( i > 0 ? ", " : "" ) << buckets[i];
+        }
+        file << "]\n";
+        file << "    }" << ( p + 1 < PhaseCount ? "," : "" ) << "\n";
+    }
+
+    file << "  }\n";
+    file << "}\n";
+
+    return static_cast<bool>( file );
+}
@@ -0,0 +1,193 @@
+#include <DirectXTemplateLibPCH.h>
+#include <FrustumCuller.h>
+#include <Profiler.h>
+#include <JobSystem.h>
+
+using namespace DirectX;
+
+FrustumCuller::FrustumCuller()
+    : m_BoxCount( 0 )
+    , m_BoxesPerMillisecond( 0.0 )
+{}
+
+void FrustumCuller::Clear()
+{
+    // Keep the capacity of the arrays for the next frame.
+    m_BoxCount = 0;
+    m_CenterX.clear();
+    m_CenterY.clear();
+    m_CenterZ.clear();
+    m_ExtentX.clear();
+    m_ExtentY.clear();
+    m_ExtentZ.clear();
+    m_Visible.clear();
+    m_VisibleBoxes.clear();
+}
+
+size_t FrustumCuller::AddBox( const BoundingBox& box )
+{
+    if ( m_BoxCount == m_CenterX.size() )
+    {
+        // Add 4 boxes at a time to keep the arrays padded. The padding boxes
+        // are tested but their results are ignored.
+        size_t paddedCount = m_BoxCount + 4;
+        m_CenterX.resize( paddedCount, 0.0f );
+        m_CenterY.resize( paddedCount, 0.0f );
+        m_CenterZ.resize( paddedCount, 0.0f );
+        m_ExtentX.resize( paddedCount, 0.0f );
+        m_ExtentY.resize( paddedCount, 0.0f );
+        m_ExtentZ.resize( paddedCount, 0.0f );
+    }
+
+    size_t index = m_BoxCount++;
+    m_Visible.push_back( 1 );
+
+    set_Box( index, box );
+
+    return index;
+}
+
+size_t XM_CALLCONV FrustumCuller::AddBox( const BoundingBox& box, FXMMATRIX worldMatrix )
+{
+    BoundingBox worldBox;
+    box.Transform( worldBox, worldMatrix );
+
+    return AddBox( worldBox );
+}
+
+void FrustumCuller::set_Box( size_t index, const BoundingBox& box )
+{
+    assert( index < m_BoxCount );
+
+    m_CenterX[index] = box.Center.x;
+    m_CenterY[index] = box.Center.y;
+    m_CenterZ[index] = box.Center.z;
+    m_ExtentX[index] = box.Extents.x;
+    m_ExtentY[index] = box.Extents.y;
+    m_ExtentZ[index] = box.Extents.z;
+}
+
+size_t FrustumCuller::get_BoxCount() const
+{
+    return m_BoxCount;
+}
+
+size_t FrustumCuller::Cull( const Camera& camera, JobSystem* jobSystem )
+{
+    XMVECTOR planes[Camera::FrustumPlaneCount];
+    camera.get_FrustumPlanes( planes );
+
+    return Cull( planes, jobSystem );
+}
+
+// Cull with a single thread if there are fewer boxes than this.
+static const size_t ParallelCullThreshold = 16384;
+// The number of boxes a job tests. A multiple of 4.
+static const size_t ParallelCullGrainSize = 8192;
+
+size_t FrustumCuller::Cull( const XMVECTOR planes[Camera::FrustumPlaneCount], JobSystem* jobSystem )
+{
+    PROFILE_FUNCTION();
+
+    static LARGE_INTEGER frequency = {};
+    if ( frequency.QuadPart == 0 )
+    {
+        QueryPerformanceFrequency( &frequency );
+    }
+
+    LARGE_INTEGER startTime;
+    QueryPerformanceCounter( &startTime );
+
+    if ( jobSystem && m_BoxCount >= ParallelCullThreshold )
+    {
+        // The grain size is a multiple of 4, so every range starts at a group of 4 boxes.
+        jobSystem->ParallelFor( 0, m_BoxCount, ParallelCullGrainSize, [this, planes]( size_t begin, size_t end )
+        {
+            CullBoxes( planes, begin, end );
+        } );
+    }
+    else
+    {
+        CullBoxes( planes, 0, m_BoxCount );
+    }
+
+    m_VisibleBoxes.clear();
+    for ( size_t i = 0; i < m_BoxCount; ++i )
+    {
+        if ( m_Visible[i] )
+        {
+            m_VisibleBoxes.push_back( static_cast<UINT>( i ) );
+        }
+    }
+
+    LARGE_INTEGER endTime;
+    QueryPerformanceCounter( &endTime );
+
+    double milliseconds = ( endTime.QuadPart - startTime.QuadPart ) * 1000.0 / frequency.QuadPart;
+    m_BoxesPerMillisecond = ( milliseconds > 0.0 ) ? m_BoxCount / milliseconds : 0.0;
+
+    return m_VisibleBoxes.size();
+}
+
+void FrustumCuller::CullBoxes( const XMVECTOR planes[Camera::FrustumPlaneCount], size_t begin, size_t end )
+{
+    assert( begin % 4 == 0 );
+
+    // Splat the plane components. The absolute values of the normals are used to compute
+    // the projected radius of a box onto the plane normal.
+    XMVECTOR planeX[Camera::FrustumPlaneCount], planeY[Camera::FrustumPlaneCount], planeZ[Camera::FrustumPlaneCount], planeW[Camera::FrustumPlaneCount];
+    XMVECTOR absPlaneX[Camera::FrustumPlaneCount], absPlaneY[Camera::FrustumPlaneCount], absPlaneZ[Camera::FrustumPlaneCount];
+    for ( int p = 0; p < Camera::FrustumPlaneCount; ++p )
+    {
+        planeX[p] = XMVectorSplatX( planes[p] );
+        planeY[p] = XMVectorSplatY( planes[p] );
+        planeZ[p] = XMVectorSplatZ( planes[p] );
+        planeW[p] = XMVectorSplatW( planes[p] );
+        absPlaneX[p] = XMVectorAbs( planeX[p] );
+        absPlaneY[p] = XMVectorAbs( planeY[p] );
+        absPlaneZ[p] = XMVectorAbs( planeZ[p] );
+    }
+
+    for ( size_t i = begin; i < end; i += 4 )
+    {
+        XMVECTOR centerX = XMLoadFloat4( reinterpret_cast<const XMFLOAT4*>( &m_CenterX[i] ) );
+        XMVECTOR centerY = XMLoadFloat4( reinterpret_cast<const XMFLOAT4*>( &m_CenterY[i] ) );
+        XMVECTOR centerZ = XMLoadFloat4( reinterpret_cast<const XMFLOAT4*>( &m_CenterZ[i] ) );
+        XMVECTOR extentX = XMLoadFloat4( reinterpret_cast<const XMFLOAT4*>( &m_ExtentX[i] ) );
+        XMVECTOR extentY = XMLoadFloat4( reinterpret_cast<const XMFLOAT4*>( &m_ExtentY[i] ) );
+        XMVECTOR extentZ = XMLoadFloat4( reinterpret_cast<const XMFLOAT4*>( &m_ExtentZ[i] ) );
+
+        // A box is outside the frustum if it is completely behind any of the planes.
+        XMVECTOR visible = XMVectorTrueInt();
+        for ( int p = 0; p < Camera::FrustumPlaneCount; ++p )
+        {
+            XMVECTOR distance = XMVectorMultiplyAdd( centerX, planeX[p], XMVectorMultiplyAdd( centerY, planeY[p], XMVectorMultiplyAdd( centerZ, planeZ[p], planeW[p] ) ) );
+            XMVECTOR radius = XMVectorMultiplyAdd( extentX, absPlaneX[p], XMVectorMultiplyAdd( extentY, absPlaneY[p], extentZ * absPlaneZ[p] ) );
+            visible = XMVectorAndInt( visible, XMVectorGreaterOrEqual( distance + radius, XMVectorZero() ) );
+        }
+
+        uint32_t visibleMask[4];
+        XMStoreInt4( visibleMask, visible );
+
+        for ( size_t k = 0; k < 4 && i + k < end; ++k )
+        {
+            m_Visible[i + k] = ( visibleMask[k] != 0 );
+        }
+    }
+}
+
+bool FrustumCuller::IsVisible( size_t index ) const
+{
+    assert( index < m_BoxCount );
+    return m_Visible[index] != 0;
+}
+
+const std::vector<UINT>& FrustumCuller::get_VisibleBoxes() const
+{
+    return m_VisibleBoxes;
+}
+
+double FrustumCuller::get_BoxesPerMillisecond() const
+{
+    return m_BoxesPerMillisecond;
+}
@@ -1,6 +1,9 @@
 #include <DirectXTemplateLibPCH.h>
 #include <Game.h>
 #include <Window.h>
+#include <Application.h>
+#include <HighResolutionClock.h>
+#include <Profiler.h>
 
 Game::Game( Window& window )
     : m_Window( window )
@@ -12,6 +15,10 @@ Game::Game( Window& window )
     , m_d3dDepthStencilBuffer(nullptr)
     , m_d3dDepthStencilState(nullptr)
     , m_d3dRasterizerState(nullptr)
+    , m_DepthStencilFormat( DXGI_FORMAT_D24_UNORM_S8_UINT )
+    , m_DepthComparison( D3D11_COMPARISON_LESS )
+    , m_HeadlessDriverType( D3D_DRIVER_TYPE_WARP )
+    , m_FilterRedundantState( false )
     , m_bIsInitialized( false )
 {
     m_Window.RegisterDirectXTemplate(this);
@@ -123,17 +130,44 @@ bool Game::ResizeSwapChain( int width, int height )
     m_d3dDepthStencilView.Reset();
     m_d3dDepthStencilBuffer.Reset();
 
-    // Resize the swap chain buffers.
-    m_d3dSwapChain->ResizeBuffers( 1, width, height, DXGI_FORMAT_R8G8B8A8_UNORM, 0 );
-
-    // Next initialize the back buffer of the swap chain and associate it to a 
-    // render target view.
     Microsoft::WRL::ComPtr<ID3D11Texture2D> backBuffer;
-    HRESULT hr = m_d3dSwapChain->GetBuffer( 0, __uuidof(ID3D11Texture2D), &backBuffer );
-    if ( FAILED( hr ) )
+    HRESULT hr;
+
+    if ( m_d3dSwapChain )
     {
-        MessageBoxA( m_Window.get_WindowHandle(), "Failed to retrieve the swap chain back buffer.", "Error", MB_OK|MB_ICONERROR );
-        return false;
+        // Resize the swap chain buffers.
+        m_d3dSwapChain->ResizeBuffers( 1, width, height, DXGI_FORMAT_R8G8B8A8_UNORM, 0 );
+
+        // Next initialize the back buffer of the swap chain and associate it to a 
+        // render target view.
+        hr = m_d3dSwapChain->GetBuffer( 0, __uuidof(ID3D11Texture2D), &backBuffer );
+        if ( FAILED( hr ) )
+        {
+            MessageBoxA( m_Window.get_WindowHandle(), "Failed to retrieve the swap chain back buffer.", "Error", MB_OK|MB_ICONERROR );
+            return false;
+        }
+    }
+    else
+    {
+        // A headless game renders to an offscreen texture with the format of the swap chain.
+        D3D11_TEXTURE2D_DESC backBufferDesc;
+        ZeroMemory( &backBufferDesc, sizeof(D3D11_TEXTURE2D_DESC) );
+
+        backBufferDesc.ArraySize = 1;
+        backBufferDesc.BindFlags = D3D11_BIND_RENDER_TARGET;
+        backBufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        backBufferDesc.Width = width;
+        backBufferDesc.Height = height;
+        backBufferDesc.MipLevels = 1;
+        backBufferDesc.SampleDesc.Count = 1;
+        backBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+
+        hr = m_d3dDevice->CreateTexture2D( &backBufferDesc, nullptr, &backBuffer );
+        if ( FAILED( hr ) )
+        {
+            MessageBoxA( m_Window.get_WindowHandle(), "Failed to create the offscreen back buffer.", "Error", MB_OK|MB_ICONERROR );
+            return false;
+        }
     }
 
     hr = m_d3dDevice->CreateRenderTargetView( backBuffer.Get(), nullptr, &m_d3dRenderTargetView );
@@ -152,7 +186,7 @@ bool Game::ResizeSwapChain( int width, int height )
     depthStencilBufferDesc.ArraySize = 1;
     depthStencilBufferDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
     depthStencilBufferDesc.CPUAccessFlags = 0; // No CPU access required.
-    depthStencilBufferDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+    depthStencilBufferDesc.Format = m_DepthStencilFormat;
     depthStencilBufferDesc.Width = width;
     depthStencilBufferDesc.Height = height;
     depthStencilBufferDesc.MipLevels = 1;
@@ -178,6 +212,47 @@ bool Game::ResizeSwapChain( int width, int height )
 }
 
 
+bool Game::CreateSwapChain()
+{
+    Microsoft::WRL::ComPtr<IDXGIFactory2> factory;
+    HRESULT hr = CreateDXGIFactory( __uuidof(IDXGIFactory2), &factory );
+    if ( FAILED(hr) )
+    {
+        MessageBoxA( m_Window.get_WindowHandle(), "Failed to create IDXGIFactory2.", "Error", MB_OK|MB_ICONERROR );
+        return false;
+    }
+
+    DXGI_SWAP_CHAIN_DESC1 swapChainDesc;
+    ZeroMemory( &swapChainDesc, sizeof(DXGI_SWAP_CHAIN_DESC1) );
+
+    swapChainDesc.BufferCount = 1;
+    swapChainDesc.Width = m_Window.get_ClientWidth();
+    swapChainDesc.Height = m_Window.get_ClientHeight();
+    swapChainDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+    swapChainDesc.SampleDesc.Count = 1;
+    swapChainDesc.SampleDesc.Quality = 0;
+    swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
+    swapChainDesc.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH; // Use Alt-Enter to switch between full screen and windowed mode.
+
+    DXGI_SWAP_CHAIN_FULLSCREEN_DESC swapChainFullScreenDesc;
+    ZeroMemory( &swapChainFullScreenDesc, sizeof(DXGI_SWAP_CHAIN_FULLSCREEN_DESC) );
+
+    swapChainFullScreenDesc.RefreshRate = QueryRefreshRate( m_Window );
+    swapChainFullScreenDesc.Windowed = m_Window.get_Windowed();
+
+    hr = factory->CreateSwapChainForHwnd( m_d3dDevice.Get(), m_Window.get_WindowHandle(), 
+        &swapChainDesc, &swapChainFullScreenDesc, nullptr, &m_d3dSwapChain );
+
+    if ( FAILED(hr) )
+    {
+        MessageBoxA( m_Window.get_WindowHandle(), "Failed to create swap chain.", "Error", MB_OK|MB_ICONERROR );
+        return false;
+    }
+
+    return true;
+}
+
 bool Game::Initialize()
 {
     if ( !m_Window.IsValid() )
@@ -222,13 +297,16 @@ bool Game::Initialize()
     // is used to create our device and swap chain.
     D3D_FEATURE_LEVEL featureLevel;
 
-    hr = D3D11CreateDevice( nullptr, D3D_DRIVER_TYPE_HARDWARE, 
+    // A headless game does not need a GPU.
+    D3D_DRIVER_TYPE driverType = m_Window.IsHeadless() ? m_HeadlessDriverType : D3D_DRIVER_TYPE_HARDWARE;
+
+    hr = D3D11CreateDevice( nullptr, driverType, 
         nullptr, createDeviceFlags, featureLevels, _countof(featureLevels),
         D3D11_SDK_VERSION, &m_d3dDevice, &featureLevel, &m_d3dDeviceContext );
     
     if ( hr == E_INVALIDARG )
     {
-        hr = D3D11CreateDevice( nullptr, D3D_DRIVER_TYPE_HARDWARE, 
+        hr = D3D11CreateDevice( nullptr, driverType, 
             nullptr, createDeviceFlags, &featureLevels[1], _countof(featureLevels) - 1, 
             D3D11_SDK_VERSION, &m_d3dDevice, &featureLevel, &m_d3dDeviceContext );
     }
@@ -239,40 +317,23 @@ bool Game::Initialize()
         return false;
     }
 
-    Microsoft::WRL::ComPtr<IDXGIFactory2> factory;
-    hr = CreateDXGIFactory( __uuidof(IDXGIFactory2), &factory );
-    if ( FAILED(hr) )
+    if ( m_Window.IsHeadless() )
+    {
+        // Count the calls that the game makes to the device context.
+        m_RecordingDeviceContext.Attach( new RecordingDeviceContext( m_d3dDeviceContext.Get() ) );
+        m_d3dDeviceContext = m_RecordingDeviceContext;
+    }
+    else if ( !CreateSwapChain() )
     {
-        MessageBoxA( m_Window.get_WindowHandle(), "Failed to create IDXGIFactory2.", "Error", MB_OK|MB_ICONERROR );
         return false;
     }
 
-    DXGI_SWAP_CHAIN_DESC1 swapChainDesc;
-    ZeroMemory( &swapChainDesc, sizeof(DXGI_SWAP_CHAIN_DESC1) );
-
-    swapChainDesc.BufferCount = 1;
-    swapChainDesc.Width = m_Window.get_ClientWidth();
-    swapChainDesc.Height = m_Window.get_ClientHeight();
-    swapChainDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
-    swapChainDesc.SampleDesc.Count = 1;
-    swapChainDesc.SampleDesc.Quality = 0;
-    swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
-    swapChainDesc.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH; // Use Alt-Enter to switch between full screen and windowed mode.
-
-    DXGI_SWAP_CHAIN_FULLSCREEN_DESC swapChainFullScreenDesc;
-    ZeroMemory( &swapChainFullScreenDesc, sizeof(DXGI_SWAP_CHAIN_FULLSCREEN_DESC) );
-
-    swapChainFullScreenDesc.RefreshRate = QueryRefreshRate( m_Window );
-    swapChainFullScreenDesc.Windowed = m_Window.get_Windowed();
-
-    hr = factory->CreateSwapChainForHwnd( m_d3dDevice.Get(), m_Window.get_WindowHandle(), 
-        &swapChainDesc, &swapChainFullScreenDesc, nullptr, &m_d3dSwapChain );
-
-    if ( FAILED(hr) )
+    if ( m_FilterRedundantState )
     {
-        MessageBoxA( m_Window.get_WindowHandle(), "Failed to create swap chain.", "Error", MB_OK|MB_ICONERROR );
-        return false;
+        // Only forward the set calls that change the bound state. In a headless
+        // game the recording device context counts the calls that are forwarded.
+        m_StateFilteringDeviceContext.Attach( new StateFilteringDeviceContext( m_d3dDeviceContext.Get() ) );
+        m_d3dDeviceContext = m_StateFilteringDeviceContext;
     }
 
     if ( !ResizeSwapChain( m_Window.get_ClientWidth(), m_Window.get_ClientHeight() ) )
@@ -287,7 +348,7 @@ bool Game::Initialize()
 
     depthStencilStateDesc.DepthEnable = TRUE;
     depthStencilStateDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
-    depthStencilStateDesc.DepthFunc = D3D11_COMPARISON_LESS;
+    depthStencilStateDesc.DepthFunc = m_DepthComparison;
     depthStencilStateDesc.StencilEnable = FALSE;
 
     hr = m_d3dDevice->CreateDepthStencilState( &depthStencilStateDesc, &m_d3dDepthStencilState );
@@ -336,7 +397,16 @@ void Game::Clear( const FLOAT clearColor[4], FLOAT clearDepth, UINT8 clearStenci
 
 void Game::Present()
 {
-    if ( m_Window.get_VSync() )
+    PROFILE_FUNCTION();
+
+    double startTime = HighResolutionClock::get_CurrentSeconds();
+
+    if ( !m_d3dSwapChain )
+    {
+        // A headless game has nothing to present. Submit the commands instead.
+        m_d3dDeviceContext->Flush();
+    }
+    else if ( m_Window.get_VSync() )
     {
         m_d3dSwapChain->Present1( 1, 0, &m_PresentParameters );
     }
@@ -344,6 +414,29 @@ void Game::Present()
     {
         m_d3dSwapChain->Present1( 0, 0, &m_PresentParameters  );
     }
+
+    m_FrameStatistics.AddTime( FrameStatistics::PresentPhase, HighResolutionClock::get_CurrentSeconds() - startTime );
+}
+
+FrameStatistics& Game::get_FrameStatistics()
+{
+    return m_FrameStatistics;
+}
+
+JobSystem& Game::get_JobSystem()
+{
+    return Application::Get().get_JobSystem();
+}
+
+void Game::set_FilterRedundantState( bool filterRedundantState )
+{
+    assert( !m_bIsInitialized && "The state filter must be set before the game is initialized." );
+    m_FilterRedundantState = filterRedundantState;
+}
+
+bool Game::get_FilterRedundantState() const
+{
+    return m_FilterRedundantState;
 }
 
 void Game::Cleanup()
@@ -398,7 +491,7 @@ void Game::OnMouseWheel( MouseWheelEventArgs& e )
 
 void Game::OnResize( ResizeEventArgs& e )
 {
-    assert( m_d3dSwapChain );
+    assert( m_d3dSwapChain || m_Window.IsHeadless() );
     ResizeSwapChain( e.Width, e.Height );
 }
 
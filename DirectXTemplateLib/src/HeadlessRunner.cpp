@@ -0,0 +1,91 @@
+#include <DirectXTemplateLibPCH.h>
+#include <HeadlessRunner.h>
+#include <Game.h>
+#include <HighResolutionClock.h>
+#include <Profiler.h>
+
+#include <iomanip>
+
+HeadlessRunner::HeadlessRunner( const std::string& windowName, int clientWidth, int clientHeight )
+    : m_Window( windowName, clientWidth, clientHeight )
+{}
+
+HeadlessRunner::~HeadlessRunner()
+{}
+
+Window& HeadlessRunner::get_Window()
+{
+    return m_Window;
+}
+
+bool HeadlessRunner::Run( Game& game, uint64_t frameCount, float deltaTime, std::ostream& stream )
+{
+    assert( &game.m_Window == &m_Window && "The game must be created with the window of the runner." );
+
+    Profiler::set_ThreadName( "Main" );
+
+    if ( !game.Initialize() || !game.LoadContent() )
+    {
+        m_Window.Destroy();
+        return false;
+    }
+
+    // Only count the calls of the frames.
+    RecordingDeviceContext* recordingDeviceContext = game.m_RecordingDeviceContext.Get();
+    assert( recordingDeviceContext );
+    recordingDeviceContext->Reset();
+
+    StateFilteringDeviceContext* stateFilteringDeviceContext = game.m_StateFilteringDeviceContext.Get();
+    if ( stateFilteringDeviceContext )
+    {
+        stateFilteringDeviceContext->Reset();
+    }
+
+    FrameStatistics& frameStatistics = game.get_FrameStatistics();
+    frameStatistics.Reset();
+
+    double startTime = HighResolutionClock::get_CurrentSeconds();
+
+    for ( uint64_t frameIndex = 0; frameIndex < frameCount; ++frameIndex )
+    {
+        float totalTime = deltaTime * ( frameIndex + 1 );
+
+        UpdateEventArgs updateEventArgs( deltaTime, totalTime, frameIndex );
+        RenderEventArgs renderEventArgs( deltaTime, totalTime, 1.0f, frameIndex );
+
+        m_Window.OnUpdate( updateEventArgs );
+        m_Window.OnRender( renderEventArgs );
+        m_Window.OnFrameEnd();
+    }
+
+    double runTime = HighResolutionClock::get_CurrentSeconds() - startTime;
+
+    stream << m_Window.get_WindowName() << ": " << frameCount << " frames in " << std::fixed << std::setprecision( 3 )
+           << runTime << " s (" << frameCount / std::max( runTime, 1e-9 ) << " FPS)" << std::endl << std::endl;
+
+    stream << std::left << std::setw( 12 ) << "Phase" << std::right << std::setw( 12 ) << "Average ms" << std::setw( 12 ) << "p50 ms"
+           << std::setw( 12 ) << "p99 ms" << std::setw( 12 ) << "Max ms" << std::endl;
+
+    for ( int phase = 0; phase < FrameStatistics::PhaseCount; ++phase )
+    {
+        FrameStatistics::Phase p = static_cast<FrameStatistics::Phase>( phase );
+        stream << std::left << std::setw( 12 ) << FrameStatistics::get_PhaseName( p ) << std::right
+               << std::setw( 12 ) << frameStatistics.get_Average( p )
+               << std::setw( 12 ) << frameStatistics.get_Percentile( p, 50.0f )
+               << std::setw( 12 ) << frameStatistics.get_Percentile( p, 99.0f )
+               << std::setw( 12 ) << frameStatistics.get_Maximum( p ) << std::endl;
+    }
+    stream << std::endl;
+
+    recordingDeviceContext->Print( stream, frameCount );
+
+    if ( stateFilteringDeviceContext )
+    {
+        stream << std::endl << "Redundant state filter:" << std::endl;
+        stateFilteringDeviceContext->Print( stream, frameCount );
+    }
+
+    m_Window.Destroy();
+
+    return true;
+}
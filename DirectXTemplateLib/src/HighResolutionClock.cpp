@@ -0,0 +1,54 @@
+#include <DirectXTemplateLibPCH.h>
+#include <HighResolutionClock.h>
+
+HighResolutionClock::HighResolutionClock()
+    : m_DeltaTicks( 0 )
+    , m_TotalTicks( 0 )
+{
+    QueryPerformanceFrequency( &m_Frequency );
+    Reset();
+}
+
+double HighResolutionClock::Tick()
+{
+    LARGE_INTEGER currentTime;
+    QueryPerformanceCounter( &currentTime );
+
+    m_DeltaTicks = currentTime.QuadPart - m_PreviousTime.QuadPart;
+    m_TotalTicks = currentTime.QuadPart - m_StartTime.QuadPart;
+    m_PreviousTime = currentTime;
+
+    return get_DeltaSeconds();
+}
+
+void HighResolutionClock::Reset()
+{
+    QueryPerformanceCounter( &m_StartTime );
+    m_PreviousTime = m_StartTime;
+    m_DeltaTicks = 0;
+    m_TotalTicks = 0;
+}
+
+double HighResolutionClock::get_DeltaSeconds() const
+{
+    return static_cast<double>( m_DeltaTicks ) / m_Frequency.QuadPart;
+}
+
+double HighResolutionClock::get_TotalSeconds() const
+{
+    return static_cast<double>( m_TotalTicks ) / m_Frequency.QuadPart;
+}
+
+double HighResolutionClock::get_CurrentSeconds()
+{
+    static LARGE_INTEGER frequency = {};
+    if ( frequency.QuadPart == 0 )
+    {
+        QueryPerformanceFrequency( &frequency );
+    }
+
+    LARGE_INTEGER currentTime;
+    QueryPerformanceCounter( &currentTime );
+
+    return static_cast<double>( currentTime.QuadPart ) / frequency.QuadPart;
+}
@@ -0,0 +1,453 @@
+#include <DirectXTemplateLibPCH.h>
+#include <JobSystem.h>
+#include <Profiler.h>
+
+struct Job
+{
+    JobSystem::JobFunction Function;
+    JobCounter* Counter;
+    // The next job in the list of jobs that wait for the same counter.
+    Job* Next;
+};
+
+// The number of jobs that are allocated at once when the pool is empty.
+static const size_t JobBlockSize = 256;
+
+// The job system and worker index of the calling thread.
+static thread_local JobSystem* t_JobSystem = nullptr;
+static thread_local int t_WorkerIndex = -1;
+
+// The names of the worker threads in profiles.
+static const char* WorkerThreadNames[] =
+{
+    "Worker 0", "Worker 1", "Worker 2", "Worker 3", "Worker 4", "Worker 5", "Worker 6", "Worker 7",
+    "Worker 8", "Worker 9", "Worker 10", "Worker 11", "Worker 12", "Worker 13", "Worker 14", "Worker 15",
+};
+
+JobCounter::JobCounter()
+    : m_Count( 0 )
+    , m_WaitingJobs( nullptr )
+{}
+
+JobCounter::~JobCounter()
+{
+    // Wait until the job that finished the counter has released the waiting jobs.
+    std::lock_guard<std::mutex> lock( m_Mutex );
+}
+
+bool JobCounter::IsDone() const
+{
+    return m_Count.load( std::memory_order_acquire ) == 0;
+}
+
+WorkStealingQueue::WorkStealingQueue( size_t capacity )
+    : m_Jobs( new std::atomic<Job*>[capacity] )
+    , m_Mask( static_cast<int64_t>( capacity ) - 1 )
+    , m_Top( 0 )
+    , m_Bottom( 0 )
+{
+    assert( capacity > 0 && ( capacity & ( capacity - 1 ) ) == 0 && "The capacity must be a power of 2." );
+}
+
+bool WorkStealingQueue::Push( Job* job )
+{
+    int64_t bottom = m_Bottom.load( std::memory_order_relaxed );
+    int64_t top = m_Top.load( std::memory_order_acquire );
+
+    if ( bottom - top > m_Mask )
+    {
+        return false;
+    }
+
+    // The release store publishes the job to the thieves that acquire m_Bottom.
+    m_Jobs[bottom & m_Mask].store( job, std::memory_order_relaxed );
+    m_Bottom.store( bottom + 1, std::memory_order_release );
+
+    return true;
+}
+
+Job* WorkStealingQueue::Pop()
+{
+    int64_t bottom = m_Bottom.load( std::memory_order_relaxed ) - 1;
+    m_Bottom.store( bottom, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    int64_t top = m_Top.load( std::memory_order_relaxed );
+
+    if ( top > bottom )
+    {
+        // The queue was empty.
+        m_Bottom.store( bottom + 1, std::memory_order_relaxed );
+        return nullptr;
+    }
+
+    Job* job = m_Jobs[bottom & m_Mask].load( std::memory_order_relaxed );
+    if ( top == bottom )
+    {
+        // This is the last job. Race against the thieves for it.
+        if ( !m_Top.compare_exchange_strong( top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed ) )
+        {
+            job = nullptr;
+        }
+        m_Bottom.store( bottom + 1, std::memory_order_relaxed );
+    }
+
+    return job;
+}
+
+Job* WorkStealingQueue::Steal()
+{
+    int64_t top = m_Top.load( std::memory_order_acquire );
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    int64_t bottom = m_Bottom.load( std::memory_order_acquire );
+
+    if ( top >= bottom )
+    {
+        return nullptr;
+    }
+
+    Job* job = m_Jobs[top & m_Mask].load( std::memory_order_relaxed );
+    if ( !m_Top.compare_exchange_strong( top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed ) )
+    {
+        // Another thread took the job.
+        return nullptr;
+    }
+
+    return job;
+}
+
+JobSystem::JobSystem( size_t threadCount )
+    : m_PendingJobs( 0 )
+    , m_SleepingWorkers( 0 )
+    , m_Stopping( false )
+{
+    if ( threadCount == 0 )
+    {
+        threadCount = std::max<size_t>( std::thread::hardware_concurrency(), 1 );
+    }
+
+    for ( size_t i = 0; i < threadCount; ++i )
+    {
+        m_Queues.emplace_back( new WorkStealingQueue() );
+    }
+    m_FreeJobs.resize( threadCount );
+
+    // The creating thread is worker 0. The job system it belonged to before is restored in the destructor.
+    m_PreviousJobSystem = t_JobSystem;
+    m_PreviousWorkerIndex = t_WorkerIndex;
+    t_JobSystem = this;
+    t_WorkerIndex = 0;
+
+    for ( size_t i = 1; i < threadCount; ++i )
+    {
+        m_Threads.emplace_back( &JobSystem::WorkerThread, this, i );
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    // Finish the jobs that are still queued. Jobs that wait for a counter that is never done
+    // are not queued, so they don't keep this loop running. They are freed with the job blocks.
+    Job* job;
+    while ( ( job = FindJob( get_WorkerIndex() ) ) != nullptr )
+    {
+        Execute( job );
+    }
+
+    {
+        std::lock_guard<std::mutex> lock( m_SleepMutex );
+        m_Stopping = true;
+    }
+    m_WakeCondition.notify_all();
+
+    for ( auto& thread : m_Threads )
+    {
+        thread.join();
+    }
+
+    if ( t_JobSystem == this )
+    {
+        t_JobSystem = m_PreviousJobSystem;
+        t_WorkerIndex = m_PreviousWorkerIndex;
+    }
+}
+
+size_t JobSystem::get_ThreadCount() const
+{
+    return m_Queues.size();
+}
+
+int JobSystem::get_WorkerIndex() const
+{
+    return ( t_JobSystem == this ) ? t_WorkerIndex : -1;
+}
+
+void JobSystem::Schedule( const JobFunction& function, JobCounter* counter, const JobCounter* dependency )
+{
+    Job* job = AllocateJob();
+    job->Function = function;
+    job->Counter = counter;
+    job->Next = nullptr;
+
+    if ( counter )
+    {
+        counter->m_Count.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    if ( dependency )
+    {
+        // The count is checked under the lock that Finish holds while it decrements the count,
+        // so the job is either queued here or released by the job that finishes the dependency.
+        std::lock_guard<std::mutex> lock( dependency->m_Mutex );
+        if ( !dependency->IsDone() )
+        {
+            job->Next = dependency->m_WaitingJobs;
+            dependency->m_WaitingJobs = job;
+            return;
+        }
+    }
+
+    Enqueue( job );
+}
+
+void JobSystem::Enqueue( Job* job )
+{
+    int workerIndex = get_WorkerIndex();
+
+    // Count the job before it is visible to other threads, so a thief never sees a negative count.
+    m_PendingJobs.fetch_add( 1, std::memory_order_seq_cst );
+
+    if ( workerIndex < 0 || !m_Queues[workerIndex]->Push( job ) )
+    {
+        std::lock_guard<std::mutex> lock( m_SharedQueueMutex );
+        m_SharedQueue.push_back( job );
+    }
+
+    if ( m_SleepingWorkers.load( std::memory_order_seq_cst ) > 0 )
+    {
+        // Lock the mutex so the notification can't get lost between a worker's check and its wait.
+        std::lock_guard<std::mutex> lock( m_SleepMutex );
+        m_WakeCondition.notify_one();
+    }
+}
+
+Job* JobSystem::FindJob( int workerIndex )
+{
+    Job* job = ( workerIndex >= 0 ) ? m_Queues[workerIndex]->Pop() : nullptr;
+
+    if ( !job )
+    {
+        std::lock_guard<std::mutex> lock( m_SharedQueueMutex );
+        if ( !m_SharedQueue.empty() )
+        {
+            job = m_SharedQueue.front();
+            m_SharedQueue.pop_front();
+        }
+    }
+
+    // Start with the next worker so the thieves do not all go for the same queue.
+    size_t firstQueue = ( workerIndex >= 0 ) ? workerIndex + 1 : 0;
+    size_t queueCount = ( workerIndex >= 0 ) ? m_Queues.size() - 1 : m_Queues.size();
+    for ( size_t i = 0; !job && i < queueCount; ++i )
+    {
+        job = m_Queues[( firstQueue + i ) % m_Queues.size()]->Steal();
+    }
+
+    if ( job )
+    {
+        m_PendingJobs.fetch_sub( 1, std::memory_order_relaxed );
+    }
+
+    return job;
+}
+
+void JobSystem::Execute( Job* job )
+{
+    // A job that throws still finishes, otherwise the threads that wait for its counter would hang.
+    std::exception_ptr exception;
+    try
+    {
+        job->Function();
+    }
+    catch ( ... )
+    {
+        exception = std::current_exception();
+    }
+
+    JobCounter* counter = job->Counter;
+    FreeJob( job );
+
+    if ( counter )
+    {
+        Finish( counter, exception );
+    }
+    else
+    {
+        assert( !exception && "A job without a counter threw an exception." );
+    }
+}
+
+void JobSystem::Finish( JobCounter* counter, std::exception_ptr exception )
+{
+    Job* waitingJobs = nullptr;
+    {
+        std::lock_guard<std::mutex> lock( counter->m_Mutex );
+        if ( exception && !counter->m_Exception )
+        {
+            counter->m_Exception = exception;
+        }
+
+        if ( counter->m_Count.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+        {
+            waitingJobs = counter->m_WaitingJobs;
+            counter->m_WaitingJobs = nullptr;
+        }
+    }
+
+    // The counter may be destroyed as soon as the lock is released.
+    while ( waitingJobs )
+    {
+        Job* next = waitingJobs->Next;
+        Enqueue( waitingJobs );
+        waitingJobs = next;
+    }
+}
+
+Job* JobSystem::AllocateJob()
+{
+    int workerIndex = get_WorkerIndex();
+    if ( workerIndex >= 0 && !m_FreeJobs[workerIndex].empty() )
+    {
+        Job* job = m_FreeJobs[workerIndex].back();
+        m_FreeJobs[workerIndex].pop_back();
+        return job;
+    }
+
+    std::lock_guard<std::mutex> lock( m_JobPoolMutex );
+    if ( m_SharedFreeJobs.empty() )
+    {
+        m_JobBlocks.emplace_back( new Job[JobBlockSize] );
+        Job* block = m_JobBlocks.back().get();
+        for ( size_t i = 0; i < JobBlockSize; ++i )
+        {
+            m_SharedFreeJobs.push_back( &block[i] );
+        }
+    }
+
+    Job* job = m_SharedFreeJobs.back();
+    m_SharedFreeJobs.pop_back();
+    return job;
+}
+
+void JobSystem::FreeJob( Job* job )
+{
+    // Release the captures of the function now instead of when the job is reused.
+    job->Function = nullptr;
+
+    int workerIndex = get_WorkerIndex();
+    if ( workerIndex >= 0 )
+    {
+        std::vector<Job*>& freeJobs = m_FreeJobs[workerIndex];
+        freeJobs.push_back( job );
+
+        // Workers that run more jobs than they schedule give jobs back to the shared pool.
+        if ( freeJobs.size() >= 2 * JobBlockSize )
+        {
+            std::lock_guard<std::mutex> lock( m_JobPoolMutex );
+            m_SharedFreeJobs.insert( m_SharedFreeJobs.end(), freeJobs.end() - JobBlockSize, freeJobs.end() );
+            freeJobs.resize( freeJobs.size() - JobBlockSize );
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock( m_JobPoolMutex );
+    m_SharedFreeJobs.push_back( job );
+}
+
+void JobSystem::Wait( const JobCounter& counter )
+{
+    int workerIndex = get_WorkerIndex();
+
+    while ( !counter.IsDone() )
+    {
+        // Threads that are not workers help with the shared queue and by stealing.
+        Job* job = FindJob( workerIndex );
+        if ( job )
+        {
+            Execute( job );
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // Wait until the job that finished the counter has released the lock, then take its exception.
+    std::exception_ptr exception;
+    {
+        std::lock_guard<std::mutex> lock( counter.m_Mutex );
+        std::swap( exception, counter.m_Exception );
+    }
+
+    if ( exception )
+    {
+        std::rethrow_exception( exception );
+    }
+}
+
+void JobSystem::ParallelFor( size_t begin, size_t end, size_t grainSize, const RangeFunction& function )
+{
+    if ( begin >= end )
+    {
+        return;
+    }
+
+    if ( grainSize == 0 )
+    {
+        // A few sub-ranges per thread so threads that finish early can steal the rest.
+        grainSize = std::max<size_t>( ( end - begin ) / ( get_ThreadCount() * 4 ), 1 );
+    }
+
+    JobCounter counter;
+    for ( size_t first = begin; first < end; first += grainSize )
+    {
+        size_t last = std::min( first + grainSize, end );
+        Schedule( [&function, first, last]() { function( first, last ); }, &counter );
+    }
+
+    Wait( counter );
+}
+
+void JobSystem::WorkerThread( size_t workerIndex )
+{
+    t_JobSystem = this;
+    t_WorkerIndex = static_cast<int>( workerIndex );
+
+    if ( workerIndex < _countof(WorkerThreadNames) )
+    {
+        Profiler::set_ThreadName( WorkerThreadNames[workerIndex] );
+    }
+
+    for ( ;; )
+    {
+        Job* job = FindJob( static_cast<int>( workerIndex ) );
+        if ( job )
+        {
+            Execute( job );
+            continue;
+        }
+
+        // Only stop when there is no work left, so jobs that are scheduled by running jobs are not lost.
+        if ( m_Stopping.load( std::memory_order_relaxed ) )
+        {
+            break;
+        }
+
+        std::unique_lock<std::mutex> lock( m_SleepMutex );
+        m_SleepingWorkers.fetch_add( 1, std::memory_order_seq_cst );
+        m_WakeCondition.wait( lock, [this]()
+        {
+            return m_Stopping.load( std::memory_order_relaxed ) || m_PendingJobs.load( std::memory_order_seq_cst ) > 0;
+        } );
+        m_SleepingWorkers.fetch_sub( 1, std::memory_order_relaxed );
+    }
+}
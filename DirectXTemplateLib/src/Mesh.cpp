@@ -1,5 +1,15 @@
 #include <DirectXTemplateLibPCH.h>
 #include <Mesh.h>
+#include <MeshOptimizer.h>
+#include <MeshClusters.h>
+#include <PackedVertex.h>
+#include <MeshFile.h>
+#include <GeometryCache.h>
+#include <MeshBufferPool.h>
+#include <Camera.h>
+#include <Profiler.h>
+
+#include <atomic>
 
 using namespace DirectX;
 using namespace Microsoft::WRL;
@@ -12,8 +22,48 @@ const D3D11_INPUT_ELEMENT_DESC VertexPositionNormalTexture::InputElements[] =
 };
 
 Mesh::Mesh()
-    : m_IndexCount( 0 )
-{}
+    : m_VertexCount( 0 )
+    , m_IndexCount( 0 )
+    , m_IndexFormat( DXGI_FORMAT_R16_UINT )
+    , m_BoundingBox( XMFLOAT3( 0.0f, 0.0f, 0.0f ), XMFLOAT3( 0.0f, 0.0f, 0.0f ) )
+    , m_BoundingSphere( XMFLOAT3( 0.0f, 0.0f, 0.0f ), 0.0f )
+    , m_VertexFormat( FloatVertexFormat )
+    , m_VertexStride( sizeof(VertexPositionNormalTexture) )
+    , m_PositionScale( 1.0f, 1.0f, 1.0f )
+    , m_PositionOffset( 0.0f, 0.0f, 0.0f )
+    , m_MaxScreenSize( FLT_MAX )
+{
+    ZeroMemory( &m_InitialVertexCacheStatistics, sizeof(VertexCacheStatistics) );
+    ZeroMemory( &m_VertexCacheStatistics, sizeof(VertexCacheStatistics) );
+    ZeroMemory( &m_WeldStatistics, sizeof(WeldStatistics) );
+}
+
+// Copies share the vertex and index buffers of the original mesh.
+Mesh::Mesh( const Mesh& copy )
+    : m_VertexBuffer( copy.m_VertexBuffer )
+    , m_IndexBuffer( copy.m_IndexBuffer )
+    , m_VertexCount( copy.m_VertexCount )
+    , m_IndexCount( copy.m_IndexCount )
+    , m_IndexFormat( copy.m_IndexFormat )
+    , m_BoundingBox( copy.m_BoundingBox )
+    , m_BoundingSphere( copy.m_BoundingSphere )
+    , m_VertexFormat( copy.m_VertexFormat )
+    , m_VertexStride( copy.m_VertexStride )
+    , m_PositionScale( copy.m_PositionScale )
+    , m_PositionOffset( copy.m_PositionOffset )
+    , m_InitialVertexCacheStatistics( copy.m_InitialVertexCacheStatistics )
+    , m_VertexCacheStatistics( copy.m_VertexCacheStatistics )
+    , m_WeldStatistics( copy.m_WeldStatistics )
+    , m_Clusters( copy.m_Clusters )
+    , m_MaxScreenSize( copy.m_MaxScreenSize )
+    , m_SharedMesh( copy.m_SharedMesh )
+    , m_BufferAllocation( copy.m_BufferAllocation )
+{
+    for ( auto it = copy.m_LevelsOfDetail.begin(); it != copy.m_LevelsOfDetail.end(); ++it )
+    {
+        m_LevelsOfDetail.push_back( std::unique_ptr<Mesh>( new Mesh( **it ) ) );
+    }
+}
 
 Mesh::~Mesh()
 {
@@ -24,86 +74,515 @@ void Mesh::Draw( ID3D11DeviceContext* pDeviceContext )
 {
     assert( pDeviceContext );
 
-    const UINT strides[] = { sizeof(VertexPositionNormalTexture) };
-    const UINT offsets[] = { 0 };
+    BindBuffers( pDeviceContext );
+    pDeviceContext->DrawIndexed( m_IndexCount, get_StartIndex(), get_BaseVertex() );
+}
 
-    pDeviceContext->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
-    pDeviceContext->IASetVertexBuffers( 0, 1, m_VertexBuffer.GetAddressOf(), strides, offsets );
-    pDeviceContext->IASetIndexBuffer( m_IndexBuffer.Get(), DXGI_FORMAT_R16_UINT, 0 );
-    pDeviceContext->DrawIndexed( m_IndexCount, 0, 0 );
+void Mesh::Draw( ID3D11DeviceContext* pDeviceContext, size_t levelOfDetail )
+{
+    if ( levelOfDetail == 0 || m_LevelsOfDetail.empty() )
+    {
+        Draw( pDeviceContext );
+    }
+    else
+    {
+        levelOfDetail = std::min( levelOfDetail, m_LevelsOfDetail.size() );
+        m_LevelsOfDetail[levelOfDetail - 1]->Draw( pDeviceContext );
+    }
 }
 
-std::unique_ptr<Mesh> Mesh::CreateSphere( ID3D11DeviceContext* pDeviceContext, float diameter, size_t tessellation, bool rhcoords )
+void Mesh::DrawClusters( ID3D11DeviceContext* pDeviceContext, const std::vector<UINT>& visibleClusters )
 {
-    VertexCollection vertices;
-    IndexCollection indices;
+    PROFILE_FUNCTION();
+
+    assert( pDeviceContext );
+
+    if ( visibleClusters.empty() )
+    {
+        return;
+    }
+
+    BindBuffers( pDeviceContext );
+
+    const UINT baseIndex = get_StartIndex();
+    const INT baseVertex = get_BaseVertex();
+
+    // Clusters are stored contiguously in the index buffer so runs of
+    // consecutive clusters can be drawn with a single call.
+    UINT startIndex = 0;
+    UINT indexCount = 0;
+    for ( auto it = visibleClusters.begin(); it != visibleClusters.end(); ++it )
+    {
+        assert( *it < m_Clusters.size() );
+        const MeshCluster& cluster = m_Clusters[*it];
+
+        if ( indexCount > 0 && startIndex + indexCount != cluster.StartIndex )
+        {
+            pDeviceContext->DrawIndexed( indexCount, baseIndex + startIndex, baseVertex );
+            indexCount = 0;
+        }
+
+        if ( indexCount == 0 )
+        {
+            startIndex = cluster.StartIndex;
+        }
+        indexCount += cluster.IndexCount;
+    }
+
+    pDeviceContext->DrawIndexed( indexCount, baseIndex + startIndex, baseVertex );
+}
+
+void Mesh::MoveToBufferPool( ID3D11DeviceContext* pDeviceContext, const std::shared_ptr<MeshBufferPool>& pool )
+{
+    PROFILE_FUNCTION();
+
+    assert( pDeviceContext && pool );
+
+    // Check all levels of detail before anything is moved.
+    if ( pool->get_VertexStride() != m_VertexStride || pool->get_IndexFormat() != m_IndexFormat )
+    {
+        throw std::exception("Mesh buffer pool does not match the vertex stride or index format of the mesh.");
+    }
+    for ( auto it = m_LevelsOfDetail.begin(); it != m_LevelsOfDetail.end(); ++it )
+    {
+        if ( pool->get_VertexStride() != (*it)->m_VertexStride || pool->get_IndexFormat() != (*it)->m_IndexFormat )
+        {
+            throw std::exception("Mesh buffer pool does not match the vertex stride or index format of a level of detail.");
+        }
+    }
+
+    if ( m_BufferAllocation && &m_BufferAllocation->get_Pool() == pool.get() )
+    {
+        return;
+    }
+
+    std::shared_ptr<MeshBufferAllocation> allocation = pool->Allocate( pDeviceContext, m_VertexCount, m_IndexCount );
+
+    // The source is either the mesh's own buffers or the range of a previous pool.
+    const UINT indexSize = ( m_IndexFormat == DXGI_FORMAT_R32_UINT ) ? 4 : 2;
+    const UINT sourceBaseVertex = get_BaseVertex();
+    const UINT sourceStartIndex = get_StartIndex();
+
+    D3D11_BOX vertexBox = { sourceBaseVertex * m_VertexStride, 0, 0, ( sourceBaseVertex + m_VertexCount ) * m_VertexStride, 1, 1 };
+    pDeviceContext->CopySubresourceRegion( pool->get_VertexBuffer(), 0, allocation->get_BaseVertex() * m_VertexStride, 0, 0, get_VertexBuffer(), 0, &vertexBox );
+
+    D3D11_BOX indexBox = { sourceStartIndex * indexSize, 0, 0, ( sourceStartIndex + m_IndexCount ) * indexSize, 1, 1 };
+    pDeviceContext->CopySubresourceRegion( pool->get_IndexBuffer(), 0, allocation->get_StartIndex() * indexSize, 0, 0, get_IndexBuffer(), 0, &indexBox );
+
+    m_BufferAllocation = allocation;
+    m_VertexBuffer.Reset();
+    m_IndexBuffer.Reset();
+    // The shared mesh is only kept alive for its buffers.
+    m_SharedMesh.reset();
+
+    for ( auto it = m_LevelsOfDetail.begin(); it != m_LevelsOfDetail.end(); ++it )
+    {
+        (*it)->MoveToBufferPool( pDeviceContext, pool );
+    }
+}
+
+void Mesh::Submit( ID3D11DeviceContext* pDeviceContext, size_t levelOfDetail )
+{
+    assert( pDeviceContext );
 
+    Mesh* mesh = get_LevelOfDetail( levelOfDetail );
+    pDeviceContext->DrawIndexed( mesh->m_IndexCount, mesh->get_StartIndex(), mesh->get_BaseVertex() );
+}
+
+void XM_CALLCONV Mesh::AddInstance( FXMMATRIX worldMatrix, UINT materialIndex, size_t levelOfDetail )
+{
+    Mesh* mesh = get_LevelOfDetail( levelOfDetail );
+
+    // The positions are dequantized before they are transformed to world space. The normals are not quantized.
+    mesh->m_Instances.emplace_back();
+    MeshInstance& instance = mesh->m_Instances.back();
+    XMStoreFloat4x4( &instance.WorldMatrix, mesh->get_DequantizationMatrix() * worldMatrix );
+    XMStoreFloat4x4( &instance.InverseTransposeWorldMatrix, XMMatrixTranspose( XMMatrixInverse( nullptr, worldMatrix ) ) );
+    instance.MaterialIndex = materialIndex;
+}
+
+UINT Mesh::SubmitInstances( ID3D11DeviceContext* pDeviceContext, MeshInstanceStream& instanceStream )
+{
+    assert( pDeviceContext );
+
+    UINT drawCount = 0;
+
+    for ( size_t levelOfDetail = 0; levelOfDetail <= m_LevelsOfDetail.size(); ++levelOfDetail )
+    {
+        Mesh* mesh = get_LevelOfDetail( levelOfDetail );
+        if ( mesh->m_Instances.empty() )
+        {
+            continue;
+        }
+
+        UINT instanceCount = static_cast<UINT>( mesh->m_Instances.size() );
+        UINT startInstance;
+        if ( instanceStream.Append( pDeviceContext, mesh->m_Instances.data(), instanceCount, startInstance ) )
+        {
+            pDeviceContext->DrawIndexedInstanced( mesh->m_IndexCount, instanceCount, mesh->get_StartIndex(), mesh->get_BaseVertex(), startInstance );
+            ++drawCount;
+        }
+
+        mesh->m_Instances.clear();
+    }
+
+    return drawCount;
+}
+
+size_t Mesh::get_InstanceCount() const
+{
+    size_t instanceCount = m_Instances.size();
+    for ( auto& levelOfDetail : m_LevelsOfDetail )
+    {
+        instanceCount += levelOfDetail->m_Instances.size();
+    }
+
+    return instanceCount;
+}
+
+Mesh* Mesh::get_LevelOfDetail( size_t levelOfDetail )
+{
+    if ( levelOfDetail == 0 || m_LevelsOfDetail.empty() )
+    {
+        return this;
+    }
+
+    return m_LevelsOfDetail[std::min( levelOfDetail, m_LevelsOfDetail.size() ) - 1].get();
+}
+
+MeshBufferPool* Mesh::get_BufferPool() const
+{
+    return m_BufferAllocation ? &m_BufferAllocation->get_Pool() : nullptr;
+}
+
+UINT Mesh::get_BaseVertex() const
+{
+    return m_BufferAllocation ? m_BufferAllocation->get_BaseVertex() : 0;
+}
+
+UINT Mesh::get_StartIndex() const
+{
+    return m_BufferAllocation ? m_BufferAllocation->get_StartIndex() : 0;
+}
+
+ID3D11Buffer* Mesh::get_VertexBuffer() const
+{
+    return m_BufferAllocation ? m_BufferAllocation->get_Pool().get_VertexBuffer() : m_VertexBuffer.Get();
+}
+
+ID3D11Buffer* Mesh::get_IndexBuffer() const
+{
+    return m_BufferAllocation ? m_BufferAllocation->get_Pool().get_IndexBuffer() : m_IndexBuffer.Get();
+}
+
+void Mesh::BindBuffers( ID3D11DeviceContext* pDeviceContext ) const
+{
+    if ( m_BufferAllocation )
+    {
+        m_BufferAllocation->get_Pool().Bind( pDeviceContext );
+    }
+    else
+    {
+        const UINT strides[] = { m_VertexStride };
+        const UINT offsets[] = { 0 };
+
+        pDeviceContext->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+        pDeviceContext->IASetVertexBuffers( 0, 1, m_VertexBuffer.GetAddressOf(), strides, offsets );
+        pDeviceContext->IASetIndexBuffer( m_IndexBuffer.Get(), m_IndexFormat, 0 );
+    }
+}
+
+const BoundingBox& Mesh::get_BoundingBox() const
+{
+    return m_BoundingBox;
+}
+
+const BoundingSphere& Mesh::get_BoundingSphere() const
+{
+    return m_BoundingSphere;
+}
+
+const MeshClusterCollection& Mesh::get_Clusters() const
+{
+    return m_Clusters;
+}
+
+void Mesh::AddLevelOfDetail( std::unique_ptr<Mesh> mesh, float maxScreenSize )
+{
+    assert( mesh && mesh.get() != this );
+    assert( m_LevelsOfDetail.empty() || maxScreenSize <= m_LevelsOfDetail.back()->m_MaxScreenSize );
+
+    mesh->m_MaxScreenSize = maxScreenSize;
+    m_LevelsOfDetail.push_back( std::move( mesh ) );
+}
+
+size_t Mesh::get_LevelOfDetailCount() const
+{
+    return m_LevelsOfDetail.size() + 1;
+}
+
+size_t Mesh::SelectLevelOfDetail( float screenSize ) const
+{
+    size_t levelOfDetail = 0;
+    for ( size_t i = 0; i < m_LevelsOfDetail.size(); ++i )
+    {
+        if ( screenSize <= m_LevelsOfDetail[i]->m_MaxScreenSize )
+        {
+            levelOfDetail = i + 1;
+        }
+    }
+
+    return levelOfDetail;
+}
+
+size_t XM_CALLCONV Mesh::SelectLevelOfDetail( const Camera& camera, FXMVECTOR position, float radius ) const
+{
+    return SelectLevelOfDetail( camera.get_ProjectedSize( position, radius ) );
+}
+
+DXGI_FORMAT Mesh::get_IndexFormat() const
+{
+    return m_IndexFormat;
+}
+
+Mesh::VertexFormat Mesh::get_VertexFormat() const
+{
+    return m_VertexFormat;
+}
+
+UINT Mesh::get_VertexStride() const
+{
+    return m_VertexStride;
+}
+
+const D3D11_INPUT_ELEMENT_DESC* Mesh::get_InputElements( UINT& inputElementCount ) const
+{
+    switch ( m_VertexFormat )
+    {
+    case HalfVertexFormat:
+        inputElementCount = VertexPositionNormalTextureHalf::InputElementCount;
+        return VertexPositionNormalTextureHalf::InputElements;
+    case Unorm16VertexFormat:
+        inputElementCount = VertexPositionNormalTextureUnorm16::InputElementCount;
+        return VertexPositionNormalTextureUnorm16::InputElements;
+    default:
+        inputElementCount = VertexPositionNormalTexture::InputElementCount;
+        return VertexPositionNormalTexture::InputElements;
+    }
+}
+
+XMMATRIX Mesh::get_DequantizationMatrix( size_t levelOfDetail ) const
+{
+    if ( levelOfDetail > 0 && !m_LevelsOfDetail.empty() )
+    {
+        levelOfDetail = std::min( levelOfDetail, m_LevelsOfDetail.size() );
+        return m_LevelsOfDetail[levelOfDetail - 1]->get_DequantizationMatrix();
+    }
+
+    return XMMatrixScaling( m_PositionScale.x, m_PositionScale.y, m_PositionScale.z ) *
+        XMMatrixTranslation( m_PositionOffset.x, m_PositionOffset.y, m_PositionOffset.z );
+}
+
+const VertexCacheStatistics& Mesh::get_InitialVertexCacheStatistics() const
+{
+    return m_InitialVertexCacheStatistics;
+}
+
+const VertexCacheStatistics& Mesh::get_VertexCacheStatistics() const
+{
+    return m_VertexCacheStatistics;
+}
+
+const WeldStatistics& Mesh::get_WeldStatistics() const
+{
+    return m_WeldStatistics;
+}
+
+// Identifies a shared mesh in the geometry cache.
+struct SharedMeshKey
+{
+    ID3D11Device* Device;
+    GeometryKey Geometry;
+    bool RHCoords;
+    unsigned int Flags;
+    size_t LevelsOfDetail;
+
+    bool operator<( const SharedMeshKey& other ) const
+    {
+        if ( Geometry < other.Geometry ) return true;
+        if ( other.Geometry < Geometry ) return false;
+        return std::tie( Device, RHCoords, Flags, LevelsOfDetail ) < std::tie( other.Device, other.RHCoords, other.Flags, other.LevelsOfDetail );
+    }
+};
+
+// Process-wide cache of the procedural meshes that are alive.
+static GeometryCache<SharedMeshKey, Mesh> g_SharedMeshes;
+
+std::unique_ptr<Mesh> Mesh::CreateShared( ID3D11DeviceContext* deviceContext, const GeometryKey& geometryKey, bool rhcoords, unsigned int flags, size_t levelsOfDetail, const CreateFunction& create )
+{
+    PROFILE_FUNCTION();
+
+    ComPtr<ID3D11Device> device;
+    deviceContext->GetDevice( &device );
+
+    // The cached mesh holds a reference to the device through its buffers so
+    // the device pointer cannot be reused while the entry exists.
+    SharedMeshKey key = { device.Get(), geometryKey, rhcoords, flags, levelsOfDetail };
+    std::shared_ptr<Mesh> sharedMesh = g_SharedMeshes.DemandCreate( key, create );
+
+    std::unique_ptr<Mesh> mesh( new Mesh( *sharedMesh ) );
+    mesh->m_SharedMesh = sharedMesh;
+
+    return mesh;
+}
+
+// Meshes with fewer vertices than this are generated on the calling thread.
+static std::atomic<size_t> g_ParallelGenerationThreshold( 16384 );
+
+void Mesh::set_ParallelGenerationThreshold( size_t vertexCount )
+{
+    g_ParallelGenerationThreshold.store( vertexCount, std::memory_order_relaxed );
+}
+
+size_t Mesh::get_ParallelGenerationThreshold()
+{
+    return g_ParallelGenerationThreshold.load( std::memory_order_relaxed );
+}
+
+// Helper invokes func(i) for every ring i in [0, ringCount). The rings are
+// distributed over all cores if the mesh is large enough.
+template<typename Func>
+static void ForEachRing( size_t ringCount, size_t verticesPerRing, const Func& func )
+{
+    if ( ringCount * verticesPerRing < Mesh::get_ParallelGenerationThreshold() )
+    {
+        for ( size_t i = 0; i < ringCount; ++i )
+        {
+            func( i );
+        }
+    }
+    else
+    {
+        concurrency::parallel_for( size_t(0), ringCount, func );
+    }
+}
+
+// Helper computes the sine and cosine of the angles (i * step + offset) for i in [0, count).
+// Four angles are evaluated at a time.
+static void ComputeSinCosTable( size_t count, float step, float offset, std::vector<float>& sines, std::vector<float>& cosines )
+{
+    // Pad the tables to a multiple of 4 so the last group can be stored in one go.
+    size_t paddedCount = ( count + 3 ) & ~static_cast<size_t>(3);
+    sines.resize( paddedCount );
+    cosines.resize( paddedCount );
+
+    static const XMVECTORF32 laneOffsets = { 0, 1, 2, 3 };
+
+    XMVECTOR vStep = XMVectorReplicate( step );
+    XMVECTOR vOffset = XMVectorReplicate( offset );
+
+    for ( size_t i = 0; i < paddedCount; i += 4 )
+    {
+        XMVECTOR angles = XMVectorMultiplyAdd( XMVectorAdd( XMVectorReplicate( static_cast<float>( i ) ), laneOffsets ), vStep, vOffset );
+        XMVECTOR sinAngles, cosAngles;
+
+        XMVectorSinCos( &sinAngles, &cosAngles, angles );
+
+        XMStoreFloat4( reinterpret_cast<XMFLOAT4*>( &sines[i] ), sinAngles );
+        XMStoreFloat4( reinterpret_cast<XMFLOAT4*>( &cosines[i] ), cosAngles );
+    }
+}
+
+void Mesh::GenerateSphere( VertexCollection& vertices, IndexCollection& indices, float diameter, size_t tessellation )
+{
     if (tessellation < 3)
         throw std::out_of_range("tessellation parameter out of range");
 
-    float radius = diameter / 2.0f;
-    size_t verticalSegments = tessellation;
-    size_t horizontalSegments = tessellation * 2;
+    const float radius = diameter / 2.0f;
+    const size_t verticalSegments = tessellation;
+    const size_t horizontalSegments = tessellation * 2;
+    const size_t stride = horizontalSegments + 1;
+
+    vertices.resize( ( verticalSegments + 1 ) * stride );
+    indices.resize( verticalSegments * stride * 6 );
+
+    // The sine and cosine of every latitude and longitude are computed only once.
+    std::vector<float> latitudeSin, latitudeCos;
+    std::vector<float> longitudeSin, longitudeCos;
+
+    ComputeSinCosTable( verticalSegments + 1, XM_PI / verticalSegments, -XM_PIDIV2, latitudeSin, latitudeCos );
+    ComputeSinCosTable( horizontalSegments + 1, XM_2PI / horizontalSegments, 0.0f, longitudeSin, longitudeCos );
 
     // Create rings of vertices at progressively higher latitudes.
-    for (size_t i = 0; i <= verticalSegments; i++)
+    ForEachRing( verticalSegments + 1, stride, [&]( size_t i )
     {
         float v = 1 - (float)i / verticalSegments;
 
-        float latitude = (i * XM_PI / verticalSegments) - XM_PIDIV2;
-        float dy, dxz;
+        float dy = latitudeSin[i];
+        float dxz = latitudeCos[i];
 
-        XMScalarSinCos(&dy, &dxz, latitude);
+        VertexPositionNormalTexture* ring = &vertices[i * stride];
 
         // Create a single ring of vertices at this latitude.
         for (size_t j = 0; j <= horizontalSegments; j++)
         {
             float u = (float)j / horizontalSegments;
 
-            float longitude = j * XM_2PI / horizontalSegments;
-            float dx, dz;
-
-            XMScalarSinCos(&dx, &dz, longitude);
-
-            dx *= dxz;
-            dz *= dxz;
+            float dx = longitudeSin[j] * dxz;
+            float dz = longitudeCos[j] * dxz;
 
-            XMVECTOR normal = XMVectorSet(dx, dy, dz, 0);
-            XMVECTOR textureCoordinate = XMVectorSet(u, v, 0, 0);
-
-            vertices.push_back(VertexPositionNormalTexture(normal * radius, normal, textureCoordinate));
+            ring[j].position = XMFLOAT3( dx * radius, dy * radius, dz * radius );
+            ring[j].normal = XMFLOAT3( dx, dy, dz );
+            ring[j].textureCoordinate = XMFLOAT2( u, v );
         }
-    }
+    } );
 
     // Fill the index buffer with triangles joining each pair of latitude rings.
-    size_t stride = horizontalSegments + 1;
-
-    for (size_t i = 0; i < verticalSegments; i++)
+    ForEachRing( verticalSegments, stride, [&]( size_t i )
     {
+        uint32_t* index = &indices[i * stride * 6];
+
         for (size_t j = 0; j <= horizontalSegments; j++)
         {
             size_t nextI = i + 1;
             size_t nextJ = (j + 1) % stride;
 
-            indices.push_back(i * stride + j);
-            indices.push_back(nextI * stride + j);
-            indices.push_back(i * stride + nextJ);
+            *index++ = static_cast<uint32_t>(i * stride + j);
+            *index++ = static_cast<uint32_t>(nextI * stride + j);
+            *index++ = static_cast<uint32_t>(i * stride + nextJ);
 
-            indices.push_back(i * stride + nextJ);
-            indices.push_back(nextI * stride + j);
-            indices.push_back(nextI * stride + nextJ);
+            *index++ = static_cast<uint32_t>(i * stride + nextJ);
+            *index++ = static_cast<uint32_t>(nextI * stride + j);
+            *index++ = static_cast<uint32_t>(nextI * stride + nextJ);
         }
-    }
+    } );
+}
 
-    // Create the primitive object.
-    std::unique_ptr<Mesh> mesh(new Mesh());
+std::unique_ptr<Mesh> Mesh::CreateSphere( ID3D11DeviceContext* pDeviceContext, float diameter, size_t tessellation, bool rhcoords, unsigned int flags, size_t levelsOfDetail )
+{
+    return CreateShared( pDeviceContext, GeometryKey::MakeSphere( diameter, tessellation ), rhcoords, flags, levelsOfDetail, [=]()
+    {
+        VertexCollection vertices;
+        IndexCollection indices;
 
-    mesh->Initialize( pDeviceContext, vertices, indices, rhcoords );
+        GenerateSphere( vertices, indices, diameter, tessellation );
 
-    return mesh;
+        // Create the primitive object.
+        std::unique_ptr<Mesh> mesh(new Mesh());
+
+        mesh->Initialize( pDeviceContext, vertices, indices, rhcoords, flags );
+
+        // A sphere has 2 * tessellation segments around its silhouette.
+        mesh->CreateLevelsOfDetail( pDeviceContext, [=]( VertexCollection& lodVertices, IndexCollection& lodIndices, size_t lodTessellation )
+        {
+            GenerateSphere( lodVertices, lodIndices, diameter, lodTessellation );
+        }, tessellation, 2.0f, levelsOfDetail, rhcoords, flags );
+
+        return mesh;
+    } );
 }
 
-std::unique_ptr<Mesh> Mesh::CreateCube( ID3D11DeviceContext* deviceContext, float size, bool rhcoords )
+void Mesh::GenerateCube( VertexCollection& vertices, IndexCollection& indices, float size )
 {
     // A cube has six faces, each one pointing in a different direction.
     const int FaceCount = 6;
@@ -126,8 +605,12 @@ std::unique_ptr<Mesh> Mesh::CreateCube( ID3D11DeviceContext* deviceContext, floa
         { 0, 0 },
     };
 
-    VertexCollection vertices;
-    IndexCollection indices;
+    vertices.clear();
+    indices.clear();
+
+    // Four vertices and six indices (two triangles) per face.
+    vertices.reserve( FaceCount * 4 );
+    indices.reserve( FaceCount * 6 );
 
     size /= 2;
 
@@ -158,13 +641,24 @@ std::unique_ptr<Mesh> Mesh::CreateCube( ID3D11DeviceContext* deviceContext, floa
         vertices.push_back(VertexPositionNormalTexture((normal + side1 + side2) * size, normal, textureCoordinates[2]));
         vertices.push_back(VertexPositionNormalTexture((normal + side1 - side2) * size, normal, textureCoordinates[3]));
     }
+}
 
-    // Create the primitive object.
-    std::unique_ptr<Mesh> mesh(new Mesh());
+std::unique_ptr<Mesh> Mesh::CreateCube( ID3D11DeviceContext* deviceContext, float size, bool rhcoords, unsigned int flags )
+{
+    return CreateShared( deviceContext, GeometryKey::MakeCube( size ), rhcoords, flags, 1, [=]()
+    {
+        VertexCollection vertices;
+        IndexCollection indices;
 
-    mesh->Initialize(deviceContext, vertices, indices, rhcoords);
+        GenerateCube( vertices, indices, size );
 
-    return mesh;
+        // Create the primitive object.
+        std::unique_ptr<Mesh> mesh(new Mesh());
+
+        mesh->Initialize(deviceContext, vertices, indices, rhcoords, flags);
+
+        return mesh;
+    } );
 }
 
 // Helper computes a point on a unit circle, aligned to the x/z plane and centered on the origin.
@@ -233,11 +727,8 @@ static void CreateCylinderCap(VertexCollection& vertices, IndexCollection& indic
     }
 }
 
-std::unique_ptr<Mesh> Mesh::CreateCone( ID3D11DeviceContext* deviceContext, float diameter, float height, size_t tessellation, bool rhcoords )
+void Mesh::GenerateCone( VertexCollection& vertices, IndexCollection& indices, float diameter, float height, size_t tessellation )
 {
-    VertexCollection vertices;
-    IndexCollection indices;
-
     if (tessellation < 3)
         throw std::out_of_range("tessellation parameter out of range");
 
@@ -248,6 +739,12 @@ std::unique_ptr<Mesh> Mesh::CreateCone( ID3D11DeviceContext* deviceContext, floa
     float radius = diameter / 2;
     size_t stride = tessellation + 1;
 
+    // Two vertices and one triangle per side segment plus a triangle fan for the cap.
+    vertices.clear();
+    indices.clear();
+    vertices.reserve( stride * 2 + tessellation );
+    indices.reserve( stride * 3 + ( tessellation - 2 ) * 3 );
+
     // Create a ring of triangles around the outside of the cone.
     for (size_t i = 0; i <= tessellation; i++)
     {
@@ -275,27 +772,47 @@ std::unique_ptr<Mesh> Mesh::CreateCone( ID3D11DeviceContext* deviceContext, floa
 
     // Create flat triangle fan caps to seal the bottom.
     CreateCylinderCap(vertices, indices, tessellation, height, radius, false);
+}
 
-    // Create the primitive object.
-    std::unique_ptr<Mesh> mesh(new Mesh());
+std::unique_ptr<Mesh> Mesh::CreateCone( ID3D11DeviceContext* deviceContext, float diameter, float height, size_t tessellation, bool rhcoords, unsigned int flags, size_t levelsOfDetail )
+{
+    return CreateShared( deviceContext, GeometryKey::MakeCone( diameter, height, tessellation ), rhcoords, flags, levelsOfDetail, [=]()
+    {
+        VertexCollection vertices;
+        IndexCollection indices;
 
-    mesh->Initialize(deviceContext, vertices, indices, rhcoords);
+        GenerateCone( vertices, indices, diameter, height, tessellation );
 
-    return mesh;
+        // Create the primitive object.
+        std::unique_ptr<Mesh> mesh(new Mesh());
+
+        mesh->Initialize(deviceContext, vertices, indices, rhcoords, flags);
+
+        mesh->CreateLevelsOfDetail( deviceContext, [=]( VertexCollection& lodVertices, IndexCollection& lodIndices, size_t lodTessellation )
+        {
+            GenerateCone( lodVertices, lodIndices, diameter, height, lodTessellation );
+        }, tessellation, 1.0f, levelsOfDetail, rhcoords, flags );
+
+        return mesh;
+    } );
 }
 
-std::unique_ptr<Mesh> Mesh::CreateTorus(_In_ ID3D11DeviceContext* deviceContext, float diameter, float thickness, size_t tessellation, bool rhcoords)
+void Mesh::GenerateTorus( VertexCollection& vertices, IndexCollection& indices, float diameter, float thickness, size_t tessellation )
 {
-    VertexCollection vertices;
-    IndexCollection indices;
-
     if (tessellation < 3)
         throw std::out_of_range("tesselation parameter out of range");
 
-    size_t stride = tessellation + 1;
+    const size_t stride = tessellation + 1;
+
+    vertices.resize( stride * stride );
+    indices.resize( stride * stride * 6 );
+
+    // The cross section of the tube is the same for every ring.
+    std::vector<float> innerSin, innerCos;
+    ComputeSinCosTable( stride, XM_2PI / tessellation, XM_PI, innerSin, innerCos );
 
     // First we loop around the main ring of the torus.
-    for (size_t i = 0; i <= tessellation; i++)
+    ForEachRing( stride, stride, [&]( size_t i )
     {
         float u = (float)i / tessellation;
 
@@ -305,63 +822,113 @@ std::unique_ptr<Mesh> Mesh::CreateTorus(_In_ ID3D11DeviceContext* deviceContext,
         // slice perpendicularly though the current ring position.
         XMMATRIX transform = XMMatrixTranslation(diameter / 2, 0, 0) * XMMatrixRotationY(outerAngle);
 
+        VertexPositionNormalTexture* ring = &vertices[i * stride];
+        uint32_t* index = &indices[i * stride * 6];
+
         // Now we loop along the other axis, around the side of the tube.
         for (size_t j = 0; j <= tessellation; j++)
         {
             float v = 1 - (float)j / tessellation;
 
-            float innerAngle = j * XM_2PI / tessellation + XM_PI;
-            float dx, dy;
-
-            XMScalarSinCos(&dy, &dx, innerAngle);
-
             // Create a vertex.
-            XMVECTOR normal = XMVectorSet(dx, dy, 0, 0);
+            XMVECTOR normal = XMVectorSet(innerCos[j], innerSin[j], 0, 0);
             XMVECTOR position = normal * thickness / 2;
-            XMVECTOR textureCoordinate = XMVectorSet(u, v, 0, 0);
 
-            position = XMVector3Transform(position, transform);
-            normal = XMVector3TransformNormal(normal, transform);
-
-            vertices.push_back(VertexPositionNormalTexture(position, normal, textureCoordinate));
+            XMStoreFloat3(&ring[j].position, XMVector3Transform(position, transform));
+            XMStoreFloat3(&ring[j].normal, XMVector3TransformNormal(normal, transform));
+            ring[j].textureCoordinate = XMFLOAT2(u, v);
 
             // And create indices for two triangles.
             size_t nextI = (i + 1) % stride;
             size_t nextJ = (j + 1) % stride;
 
-            indices.push_back(i * stride + j);
-            indices.push_back(i * stride + nextJ);
-            indices.push_back(nextI * stride + j);
+            *index++ = static_cast<uint32_t>(i * stride + j);
+            *index++ = static_cast<uint32_t>(i * stride + nextJ);
+            *index++ = static_cast<uint32_t>(nextI * stride + j);
 
-            indices.push_back(i * stride + nextJ);
-            indices.push_back(nextI * stride + nextJ);
-            indices.push_back(nextI * stride + j);
+            *index++ = static_cast<uint32_t>(i * stride + nextJ);
+            *index++ = static_cast<uint32_t>(nextI * stride + nextJ);
+            *index++ = static_cast<uint32_t>(nextI * stride + j);
         }
-    }
+    } );
+}
 
-    // Create the primitive object.
-    std::unique_ptr<Mesh> mesh(new Mesh());
+std::unique_ptr<Mesh> Mesh::CreateTorus(_In_ ID3D11DeviceContext* deviceContext, float diameter, float thickness, size_t tessellation, bool rhcoords, unsigned int flags, size_t levelsOfDetail)
+{
+    return CreateShared( deviceContext, GeometryKey::MakeTorus( diameter, thickness, tessellation ), rhcoords, flags, levelsOfDetail, [=]()
+    {
+        VertexCollection vertices;
+        IndexCollection indices;
+
+        GenerateTorus( vertices, indices, diameter, thickness, tessellation );
+
+        // Create the primitive object.
+        std::unique_ptr<Mesh> mesh(new Mesh());
 
-    mesh->Initialize(deviceContext, vertices, indices, rhcoords);
+        mesh->Initialize(deviceContext, vertices, indices, rhcoords, flags);
+
+        mesh->CreateLevelsOfDetail( deviceContext, [=]( VertexCollection& lodVertices, IndexCollection& lodIndices, size_t lodTessellation )
+        {
+            GenerateTorus( lodVertices, lodIndices, diameter, thickness, lodTessellation );
+        }, tessellation, 1.0f, levelsOfDetail, rhcoords, flags );
+
+        return mesh;
+    } );
+}
+
+std::unique_ptr<Mesh> Mesh::CreateCustom( ID3D11DeviceContext* deviceContext, const VertexCollection& vertices, const IndexCollection& indices, bool rhcoords, unsigned int flags )
+{
+    // Initialize welds, reverses and reorders the geometry in place.
+    VertexCollection meshVertices( vertices );
+    IndexCollection meshIndices( indices );
+
+    std::unique_ptr<Mesh> mesh( new Mesh() );
+
+    mesh->Initialize( deviceContext, meshVertices, meshIndices, rhcoords, flags );
 
     return mesh;
 }
 
+// The maximum length (in pixels) of an edge along the silhouette of a
+// procedural shape before the next finer level of detail is selected.
+static const float MaxSilhouetteEdgeLength = 6.0f;
+
+void Mesh::CreateLevelsOfDetail( ID3D11DeviceContext* deviceContext, const GenerateFunction& generate, size_t tessellation, float segmentsPerTessellation, size_t levelsOfDetail, bool rhcoords, unsigned int flags )
+{
+    PROFILE_FUNCTION();
+
+    VertexCollection vertices;
+    IndexCollection indices;
+
+    for ( size_t level = 1; level < levelsOfDetail && tessellation > 3; ++level )
+    {
+        tessellation = std::max<size_t>( tessellation / 2, 3 );
+
+        generate( vertices, indices, tessellation );
+
+        std::unique_ptr<Mesh> mesh( new Mesh() );
+        mesh->Initialize( deviceContext, vertices, indices, rhcoords, flags );
+
+        // The silhouette of a shape with a projected size of s pixels is about (PI * s) pixels long.
+        float silhouetteSegments = tessellation * segmentsPerTessellation;
+        AddLevelOfDetail( std::move( mesh ), silhouetteSegments * MaxSilhouetteEdgeLength / XM_PI );
+    }
+}
+
 // Helper for creating a D3D vertex or index buffer.
-template<typename T>
-static void CreateBuffer(_In_ ID3D11Device* device, T const& data, D3D11_BIND_FLAG bindFlags, _Outptr_ ID3D11Buffer** pBuffer)
+static void CreateBuffer(_In_ ID3D11Device* device, const void* data, UINT byteWidth, D3D11_BIND_FLAG bindFlags, _Outptr_ ID3D11Buffer** pBuffer)
 {
     assert( pBuffer != 0 );
 
     D3D11_BUFFER_DESC bufferDesc = { 0 };
 
-    bufferDesc.ByteWidth = (UINT)data.size() * sizeof(T::value_type);
+    bufferDesc.ByteWidth = byteWidth;
     bufferDesc.BindFlags = bindFlags;
     bufferDesc.Usage = D3D11_USAGE_DEFAULT;
 
     D3D11_SUBRESOURCE_DATA dataDesc = { 0 };
 
-    dataDesc.pSysMem = data.data();
+    dataDesc.pSysMem = data;
 
     HRESULT hr = device->CreateBuffer(&bufferDesc, &dataDesc, pBuffer);
     if ( FAILED(hr) )
@@ -370,6 +937,12 @@ static void CreateBuffer(_In_ ID3D11Device* device, T const& data, D3D11_BIND_FL
     }
 }
 
+template<typename T>
+static void CreateBuffer(_In_ ID3D11Device* device, T const& data, D3D11_BIND_FLAG bindFlags, _Outptr_ ID3D11Buffer** pBuffer)
+{
+    CreateBuffer( device, data.data(), (UINT)data.size() * sizeof(T::value_type), bindFlags, pBuffer );
+}
+
 // Helper for flipping winding of geometric primitives for LH vs. RH coords
 static void ReverseWinding( IndexCollection& indices, VertexCollection& vertices )
 {
@@ -385,20 +958,443 @@ static void ReverseWinding( IndexCollection& indices, VertexCollection& vertices
     }
 }
 
-void Mesh::Initialize( ID3D11DeviceContext* deviceContext, VertexCollection& vertices, IndexCollection& indices, bool rhcoords )
+// The tolerances used for the WeldDuplicateVertices flag. They only merge vertices that
+// differ by rounding errors, so seams with different texture coordinates are preserved.
+static const WeldTolerances MeshWeldTolerances( 1e-5f, 1e-4f, 1e-5f );
+
+DXGI_FORMAT Mesh::SelectIndexFormat( size_t vertexCount, D3D_FEATURE_LEVEL featureLevel )
 {
-    if ( vertices.size() >= USHRT_MAX )
-        throw std::exception("Too many vertices for 16-bit index buffer");
+    // The largest index is vertexCount - 1, which must not be 0xFFFF because that value is
+    // reserved as the strip-cut index. So at most 65535 vertices can use 16-bit indices.
+    if ( vertexCount <= USHRT_MAX )
+    {
+        return DXGI_FORMAT_R16_UINT;
+    }
 
-    if ( !rhcoords )
-        ReverseWinding( indices, vertices );
+    // Feature level 9.1 hardware only supports 16-bit index buffers.
+    if ( featureLevel < D3D_FEATURE_LEVEL_9_2 || vertexCount > UINT_MAX )
+    {
+        return DXGI_FORMAT_UNKNOWN;
+    }
+
+    return DXGI_FORMAT_R32_UINT;
+}
+
+bool Mesh::NarrowIndices( const IndexCollection& indices, std::vector<uint16_t>& narrowIndices )
+{
+    narrowIndices.resize( indices.size() );
+    for ( size_t i = 0; i < indices.size(); ++i )
+    {
+        if ( indices[i] >= USHRT_MAX )
+        {
+            return false;
+        }
+
+        narrowIndices[i] = static_cast<uint16_t>( indices[i] );
+    }
+
+    return true;
+}
+
+// The error that is thrown if a mesh needs 32-bit indices on a feature level 9.1 device.
+static const char* IndexFormatNotSupportedError = "Feature level 9.1 only supports 16-bit index buffers (at most 65535 vertices).";
+
+void Mesh::Initialize( ID3D11DeviceContext* deviceContext, VertexCollection& vertices, IndexCollection& indices, bool rhcoords, unsigned int flags )
+{
+    PROFILE_FUNCTION();
+
+    if ( vertices.size() > UINT_MAX )
+    {
+        throw std::exception("Too many vertices for 32-bit index buffer");
+    }
+
+    if ( flags & WeldDuplicateVertices )
+    {
+        m_WeldStatistics = WeldVertices( vertices, indices, MeshWeldTolerances );
+    }
+    else
+    {
+        m_WeldStatistics.InitialVertexCount = m_WeldStatistics.VertexCount = vertices.size();
+        m_WeldStatistics.InitialTriangleCount = m_WeldStatistics.TriangleCount = indices.size() / 3;
+        m_WeldStatistics.DegenerateTriangleCount = 0;
+    }
 
     ComPtr<ID3D11Device> device;
     deviceContext->GetDevice(&device);
 
-    CreateBuffer( device.Get(), vertices, D3D11_BIND_VERTEX_BUFFER, &m_VertexBuffer );
-    CreateBuffer( device.Get(), indices, D3D11_BIND_INDEX_BUFFER, &m_IndexBuffer );
+    // Fail before any buffers are created if the device cannot address all (welded) vertices.
+    m_IndexFormat = SelectIndexFormat( vertices.size(), device->GetFeatureLevel() );
+    if ( m_IndexFormat == DXGI_FORMAT_UNKNOWN )
+    {
+        throw std::exception( IndexFormatNotSupportedError );
+    }
+
+    if ( !rhcoords )
+        ReverseWinding( indices, vertices );
+
+    m_InitialVertexCacheStatistics = AnalyzeVertexCache( indices, vertices.size() );
+
+    if ( flags & OptimizeForVertexCache )
+    {
+        OptimizeVertexCache( indices, vertices.size() );
+        OptimizeVertexFetch( vertices, indices );
+    }
+
+    m_VertexCacheStatistics = AnalyzeVertexCache( indices, vertices.size() );
+
+    XMVECTOR boundsMin = vertices.empty() ? XMVectorZero() : g_XMFltMax;
+    XMVECTOR boundsMax = vertices.empty() ? XMVectorZero() : -g_XMFltMax;
+    for ( auto it = vertices.begin(); it != vertices.end(); ++it )
+    {
+        XMVECTOR position = XMLoadFloat3( &it->position );
+        boundsMin = XMVectorMin( boundsMin, position );
+        boundsMax = XMVectorMax( boundsMax, position );
+    }
+    BoundingBox::CreateFromPoints( m_BoundingBox, boundsMin, boundsMax );
 
+    // The bounding sphere is centered on the bounding box. For the procedural shapes
+    // this is as tight as the minimal bounding sphere.
+    XMVECTOR center = XMLoadFloat3( &m_BoundingBox.Center );
+    XMVECTOR radiusSq = XMVectorZero();
+    for ( auto it = vertices.begin(); it != vertices.end(); ++it )
+    {
+        radiusSq = XMVectorMax( radiusSq, XMVector3LengthSq( XMLoadFloat3( &it->position ) - center ) );
+    }
+    m_BoundingSphere.Center = m_BoundingBox.Center;
+    m_BoundingSphere.Radius = XMVectorGetX( XMVectorSqrt( radiusSq ) );
+
+    if ( flags & BuildClusters )
+    {
+        BuildMeshClusters( vertices, indices, MeshCluster::DefaultMaxVertices, MeshCluster::DefaultMaxTriangles, m_Clusters );
+    }
+
+    if ( flags & PackVerticesAsHalf )
+    {
+        PositionQuantization quantization = ComputeHalfQuantization( vertices );
+
+        std::vector<VertexPositionNormalTextureHalf> packedVertices;
+        EncodeVertices( vertices, quantization, packedVertices );
+        CreateBuffer( device.Get(), packedVertices, D3D11_BIND_VERTEX_BUFFER, &m_VertexBuffer );
+
+        m_VertexFormat = HalfVertexFormat;
+        m_VertexStride = sizeof(VertexPositionNormalTextureHalf);
+        m_PositionScale = quantization.Scale;
+        m_PositionOffset = quantization.Offset;
+    }
+    else if ( flags & PackVerticesAsUnorm16 )
+    {
+        PositionQuantization quantization = ComputeUnorm16Quantization( vertices );
+
+        std::vector<VertexPositionNormalTextureUnorm16> packedVertices;
+        EncodeVertices( vertices, quantization, packedVertices );
+        CreateBuffer( device.Get(), packedVertices, D3D11_BIND_VERTEX_BUFFER, &m_VertexBuffer );
+
+        m_VertexFormat = Unorm16VertexFormat;
+        m_VertexStride = sizeof(VertexPositionNormalTextureUnorm16);
+        m_PositionScale = quantization.Scale;
+        m_PositionOffset = quantization.Offset;
+    }
+    else
+    {
+        CreateBuffer( device.Get(), vertices, D3D11_BIND_VERTEX_BUFFER, &m_VertexBuffer );
+    }
+
+    if ( m_IndexFormat == DXGI_FORMAT_R16_UINT )
+    {
+        std::vector<uint16_t> narrowIndices;
+        if ( !NarrowIndices( indices, narrowIndices ) )
+        {
+            throw std::out_of_range("index out of range");
+        }
+
+        CreateBuffer( device.Get(), narrowIndices, D3D11_BIND_INDEX_BUFFER, &m_IndexBuffer );
+    }
+    else
+    {
+        CreateBuffer( device.Get(), indices, D3D11_BIND_INDEX_BUFFER, &m_IndexBuffer );
+    }
+
+    m_VertexCount = static_cast<UINT>( vertices.size() );
     m_IndexCount = static_cast<UINT>( indices.size() );
 }
 
+// Helpers to close file handles and unmap views of memory mapped files when they go out of scope.
+struct HandleCloser
+{
+    void operator()( HANDLE handle ) const
+    {
+        if ( handle )
+            CloseHandle( handle );
+    }
+};
+typedef std::unique_ptr<void, HandleCloser> ScopedHandle;
+
+struct ViewUnmapper
+{
+    void operator()( const void* view ) const
+    {
+        if ( view )
+            UnmapViewOfFile( view );
+    }
+};
+typedef std::unique_ptr<const void, ViewUnmapper> ScopedView;
+
+static HANDLE SafeHandle( HANDLE handle )
+{
+    return ( handle == INVALID_HANDLE_VALUE ) ? nullptr : handle;
+}
+
+// Copy a range of a (default usage) buffer to the CPU using a staging buffer.
+static void ReadBuffer( ID3D11DeviceContext* deviceContext, ID3D11Buffer* buffer, UINT offset, UINT size, std::vector<uint8_t>& data )
+{
+    D3D11_BUFFER_DESC bufferDesc;
+    buffer->GetDesc( &bufferDesc );
+
+    bufferDesc.ByteWidth = size;
+    bufferDesc.Usage = D3D11_USAGE_STAGING;
+    bufferDesc.BindFlags = 0;
+    bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+    bufferDesc.MiscFlags = 0;
+    bufferDesc.StructureByteStride = 0;
+
+    ComPtr<ID3D11Device> device;
+    deviceContext->GetDevice( &device );
+
+    ComPtr<ID3D11Buffer> stagingBuffer;
+    if ( FAILED( device->CreateBuffer( &bufferDesc, nullptr, &stagingBuffer ) ) )
+    {
+        throw std::exception("Failed to create staging buffer.");
+    }
+
+    D3D11_BOX box = { offset, 0, 0, offset + size, 1, 1 };
+    deviceContext->CopySubresourceRegion( stagingBuffer.Get(), 0, 0, 0, 0, buffer, 0, &box );
+
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
+    if ( FAILED( deviceContext->Map( stagingBuffer.Get(), 0, D3D11_MAP_READ, 0, &mappedResource ) ) )
+    {
+        throw std::exception("Failed to map staging buffer.");
+    }
+
+    const uint8_t* bufferData = static_cast<const uint8_t*>( mappedResource.pData );
+    data.assign( bufferData, bufferData + bufferDesc.ByteWidth );
+
+    deviceContext->Unmap( stagingBuffer.Get(), 0 );
+}
+
+// Pad the file data to the payload alignment and return the offset of the next payload.
+static uint64_t AlignPayload( std::vector<uint8_t>& fileData )
+{
+    const size_t alignment = MeshFileHeader::PayloadAlignment;
+    fileData.resize( ( fileData.size() + alignment - 1 ) & ~( alignment - 1 ), 0 );
+    return fileData.size();
+}
+
+void Mesh::Save( ID3D11DeviceContext* deviceContext, const std::wstring& fileName ) const
+{
+    PROFILE_FUNCTION();
+
+    assert( deviceContext );
+
+    // Level 0 is this mesh.
+    std::vector<const Mesh*> levels( 1, this );
+    for ( auto it = m_LevelsOfDetail.begin(); it != m_LevelsOfDetail.end(); ++it )
+    {
+        levels.push_back( it->get() );
+    }
+
+    std::vector<MeshFileLevelOfDetail> descriptors( levels.size() );
+    std::vector<uint8_t> fileData( sizeof(MeshFileHeader) + sizeof(MeshFileLevelOfDetail) * levels.size(), 0 );
+    std::vector<uint8_t> bufferData;
+
+    for ( size_t i = 0; i < levels.size(); ++i )
+    {
+        const Mesh& mesh = *levels[i];
+        MeshFileLevelOfDetail& descriptor = descriptors[i];
+        ZeroMemory( &descriptor, sizeof(MeshFileLevelOfDetail) );
+
+        descriptor.VertexFormat = static_cast<uint32_t>( mesh.m_VertexFormat );
+        descriptor.VertexStride = mesh.m_VertexStride;
+        descriptor.VertexCount = mesh.m_VertexCount;
+        descriptor.IndexSize = ( mesh.m_IndexFormat == DXGI_FORMAT_R32_UINT ) ? 4 : 2;
+        descriptor.IndexCount = mesh.m_IndexCount;
+        descriptor.ClusterCount = static_cast<uint32_t>( mesh.m_Clusters.size() );
+        descriptor.MaxScreenSize = mesh.m_MaxScreenSize;
+        memcpy( descriptor.PositionScale, &mesh.m_PositionScale, sizeof(descriptor.PositionScale) );
+        memcpy( descriptor.PositionOffset, &mesh.m_PositionOffset, sizeof(descriptor.PositionOffset) );
+        XMStoreFloat3( reinterpret_cast<XMFLOAT3*>( descriptor.BoundsMin ), XMLoadFloat3( &mesh.m_BoundingBox.Center ) - XMLoadFloat3( &mesh.m_BoundingBox.Extents ) );
+        XMStoreFloat3( reinterpret_cast<XMFLOAT3*>( descriptor.BoundsMax ), XMLoadFloat3( &mesh.m_BoundingBox.Center ) + XMLoadFloat3( &mesh.m_BoundingBox.Extents ) );
+        memcpy( descriptor.BoundingSphere, &mesh.m_BoundingSphere.Center, sizeof(XMFLOAT3) );
+        descriptor.BoundingSphere[3] = mesh.m_BoundingSphere.Radius;
+        descriptor.InitialCacheStatistics = mesh.m_InitialVertexCacheStatistics;
+        descriptor.CacheStatistics = mesh.m_VertexCacheStatistics;
+
+        ReadBuffer( deviceContext, mesh.get_VertexBuffer(), mesh.get_BaseVertex() * mesh.m_VertexStride, mesh.m_VertexCount * mesh.m_VertexStride, bufferData );
+        descriptor.VertexDataOffset = AlignPayload( fileData );
+        fileData.insert( fileData.end(), bufferData.begin(), bufferData.end() );
+
+        ReadBuffer( deviceContext, mesh.get_IndexBuffer(), mesh.get_StartIndex() * descriptor.IndexSize, mesh.m_IndexCount * descriptor.IndexSize, bufferData );
+        descriptor.IndexDataOffset = AlignPayload( fileData );
+        fileData.insert( fileData.end(), bufferData.begin(), bufferData.end() );
+
+        const uint8_t* clusterData = reinterpret_cast<const uint8_t*>( mesh.m_Clusters.data() );
+        descriptor.ClusterDataOffset = AlignPayload( fileData );
+        fileData.insert( fileData.end(), clusterData, clusterData + mesh.m_Clusters.size() * sizeof(MeshCluster) );
+    }
+
+    AlignPayload( fileData );
+
+    MeshFileHeader header = {};
+    header.Magic = MeshFileHeader::FileMagic;
+    header.Version = MeshFileHeader::FileVersion;
+    header.FileSize = fileData.size();
+    header.LevelOfDetailCount = static_cast<uint32_t>( levels.size() );
+
+    memcpy( fileData.data(), &header, sizeof(MeshFileHeader) );
+    memcpy( fileData.data() + sizeof(MeshFileHeader), descriptors.data(), sizeof(MeshFileLevelOfDetail) * descriptors.size() );
+
+    ScopedHandle file( SafeHandle( CreateFileW( fileName.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr ) ) );
+    if ( !file )
+    {
+        throw std::exception("Failed to create mesh file.");
+    }
+
+    DWORD bytesWritten = 0;
+    if ( !WriteFile( file.get(), fileData.data(), static_cast<DWORD>( fileData.size() ), &bytesWritten, nullptr ) || bytesWritten != fileData.size() )
+    {
+        throw std::exception("Failed to write mesh file.");
+    }
+}
+
+// Check that a payload of the given size lies within the file.
+static bool IsPayloadValid( uint64_t offset, uint64_t size, uint64_t fileSize )
+{
+    return ( offset % MeshFileHeader::PayloadAlignment ) == 0 && offset <= fileSize && size <= fileSize - offset;
+}
+
+std::unique_ptr<Mesh> Mesh::Load( ID3D11DeviceContext* deviceContext, const std::wstring& fileName )
+{
+    PROFILE_FUNCTION();
+
+    assert( deviceContext );
+
+    ScopedHandle file( SafeHandle( CreateFileW( fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr ) ) );
+    if ( !file )
+    {
+        throw std::exception("Failed to open mesh file.");
+    }
+
+    LARGE_INTEGER fileSize;
+    if ( !GetFileSizeEx( file.get(), &fileSize ) || fileSize.QuadPart < static_cast<LONGLONG>( sizeof(MeshFileHeader) ) )
+    {
+        throw std::exception("Invalid mesh file.");
+    }
+
+    ScopedHandle fileMapping( CreateFileMappingW( file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr ) );
+    if ( !fileMapping )
+    {
+        throw std::exception("Failed to map mesh file.");
+    }
+
+    ScopedView view( MapViewOfFile( fileMapping.get(), FILE_MAP_READ, 0, 0, 0 ) );
+    if ( !view )
+    {
+        throw std::exception("Failed to map mesh file.");
+    }
+
+    const uint8_t* fileData = static_cast<const uint8_t*>( view.get() );
+    const uint64_t size = static_cast<uint64_t>( fileSize.QuadPart );
+
+    const MeshFileHeader* header = reinterpret_cast<const MeshFileHeader*>( fileData );
+    if ( header->Magic != MeshFileHeader::FileMagic || header->FileSize != size )
+    {
+        throw std::exception("Invalid mesh file.");
+    }
+    if ( header->Version != MeshFileHeader::FileVersion )
+    {
+        throw std::exception("Unsupported mesh file version.");
+    }
+    if ( header->LevelOfDetailCount == 0 || !IsPayloadValid( 0, sizeof(MeshFileHeader) + uint64_t( header->LevelOfDetailCount ) * sizeof(MeshFileLevelOfDetail), size ) )
+    {
+        throw std::exception("Invalid mesh file.");
+    }
+
+    ComPtr<ID3D11Device> device;
+    deviceContext->GetDevice( &device );
+
+    const MeshFileLevelOfDetail* descriptors = reinterpret_cast<const MeshFileLevelOfDetail*>( fileData + sizeof(MeshFileHeader) );
+
+    std::unique_ptr<Mesh> mesh( new Mesh() );
+    mesh->Initialize( device.Get(), descriptors[0], fileData );
+
+    for ( uint32_t i = 1; i < header->LevelOfDetailCount; ++i )
+    {
+        std::unique_ptr<Mesh> levelOfDetail( new Mesh() );
+        levelOfDetail->Initialize( device.Get(), descriptors[i], fileData );
+        mesh->AddLevelOfDetail( std::move( levelOfDetail ), descriptors[i].MaxScreenSize );
+    }
+
+    return mesh;
+}
+
+void Mesh::Initialize( ID3D11Device* device, const MeshFileLevelOfDetail& levelOfDetail, const uint8_t* fileData )
+{
+    PROFILE_FUNCTION();
+
+    const uint64_t fileSize = reinterpret_cast<const MeshFileHeader*>( fileData )->FileSize;
+
+    UINT expectedStride = 0;
+    switch ( levelOfDetail.VertexFormat )
+    {
+    case FloatVertexFormat:
+        expectedStride = sizeof(VertexPositionNormalTexture);
+        break;
+    case HalfVertexFormat:
+        expectedStride = sizeof(VertexPositionNormalTextureHalf);
+        break;
+    case Unorm16VertexFormat:
+        expectedStride = sizeof(VertexPositionNormalTextureUnorm16);
+        break;
+    }
+
+    const uint64_t vertexDataSize = uint64_t( levelOfDetail.VertexCount ) * levelOfDetail.VertexStride;
+    const uint64_t indexDataSize = uint64_t( levelOfDetail.IndexCount ) * levelOfDetail.IndexSize;
+    const uint64_t clusterDataSize = uint64_t( levelOfDetail.ClusterCount ) * sizeof(MeshCluster);
+
+    if ( levelOfDetail.VertexStride != expectedStride ||
+        ( levelOfDetail.IndexSize != 2 && levelOfDetail.IndexSize != 4 ) ||
+        levelOfDetail.VertexCount == 0 || levelOfDetail.IndexCount == 0 || ( levelOfDetail.IndexCount % 3 ) != 0 ||
+        !IsPayloadValid( levelOfDetail.VertexDataOffset, vertexDataSize, fileSize ) ||
+        !IsPayloadValid( levelOfDetail.IndexDataOffset, indexDataSize, fileSize ) ||
+        !IsPayloadValid( levelOfDetail.ClusterDataOffset, clusterDataSize, fileSize ) )
+    {
+        throw std::exception("Invalid mesh file.");
+    }
+
+    if ( levelOfDetail.IndexSize == 4 && device->GetFeatureLevel() < D3D_FEATURE_LEVEL_9_2 )
+    {
+        throw std::exception( IndexFormatNotSupportedError );
+    }
+
+    // The buffers are initialized directly from the memory mapped file.
+    CreateBuffer( device, fileData + levelOfDetail.VertexDataOffset, static_cast<UINT>( vertexDataSize ), D3D11_BIND_VERTEX_BUFFER, &m_VertexBuffer );
+    CreateBuffer( device, fileData + levelOfDetail.IndexDataOffset, static_cast<UINT>( indexDataSize ), D3D11_BIND_INDEX_BUFFER, &m_IndexBuffer );
+
+    const MeshCluster* clusters = reinterpret_cast<const MeshCluster*>( fileData + levelOfDetail.ClusterDataOffset );
+    m_Clusters.assign( clusters, clusters + levelOfDetail.ClusterCount );
+
+    m_VertexFormat = static_cast<VertexFormat>( levelOfDetail.VertexFormat );
+    m_VertexStride = levelOfDetail.VertexStride;
+    m_VertexCount = levelOfDetail.VertexCount;
+    m_IndexCount = levelOfDetail.IndexCount;
+    m_IndexFormat = ( levelOfDetail.IndexSize == 4 ) ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT;
+
+    memcpy( &m_PositionScale, levelOfDetail.PositionScale, sizeof(m_PositionScale) );
+    memcpy( &m_PositionOffset, levelOfDetail.PositionOffset, sizeof(m_PositionOffset) );
+    BoundingBox::CreateFromPoints( m_BoundingBox, XMLoadFloat3( reinterpret_cast<const XMFLOAT3*>( levelOfDetail.BoundsMin ) ), XMLoadFloat3( reinterpret_cast<const XMFLOAT3*>( levelOfDetail.BoundsMax ) ) );
+    memcpy( &m_BoundingSphere.Center, levelOfDetail.BoundingSphere, sizeof(XMFLOAT3) );
+    m_BoundingSphere.Radius = levelOfDetail.BoundingSphere[3];
+
+    m_InitialVertexCacheStatistics = levelOfDetail.InitialCacheStatistics;
+    m_VertexCacheStatistics = levelOfDetail.CacheStatistics;
+}
+
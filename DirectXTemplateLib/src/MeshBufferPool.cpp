@@ -0,0 +1,249 @@
+#include <DirectXTemplateLibPCH.h>
+#include <MeshBufferPool.h>
+#include <Profiler.h>
+
+using namespace Microsoft::WRL;
+
+MeshBufferAllocation::MeshBufferAllocation( const std::shared_ptr<MeshBufferPool>& pool, OffsetAllocator::Handle vertices, OffsetAllocator::Handle indices )
+    : m_Pool( pool )
+    , m_Vertices( vertices )
+    , m_Indices( indices )
+{}
+
+MeshBufferAllocation::~MeshBufferAllocation()
+{
+    m_Pool->Free( m_Vertices, m_Indices );
+}
+
+MeshBufferPool& MeshBufferAllocation::get_Pool() const
+{
+    return *m_Pool;
+}
+
+UINT MeshBufferAllocation::get_BaseVertex() const
+{
+    return m_Pool->m_VertexAllocator.get_Offset( m_Vertices );
+}
+
+UINT MeshBufferAllocation::get_StartIndex() const
+{
+    return m_Pool->m_IndexAllocator.get_Offset( m_Indices );
+}
+
+UINT MeshBufferAllocation::get_VertexCount() const
+{
+    return m_Pool->m_VertexAllocator.get_Size( m_Vertices );
+}
+
+UINT MeshBufferAllocation::get_IndexCount() const
+{
+    return m_Pool->m_IndexAllocator.get_Size( m_Indices );
+}
+
+static ComPtr<ID3D11Buffer> CreatePoolBuffer( ID3D11Device* device, UINT elementCount, UINT elementSize, UINT bindFlags )
+{
+    uint64_t byteWidth = static_cast<uint64_t>( elementCount ) * elementSize;
+    if ( byteWidth > UINT_MAX )
+    {
+        throw std::exception("Mesh buffer pool too large.");
+    }
+
+    D3D11_BUFFER_DESC bufferDesc = {};
+    bufferDesc.ByteWidth = static_cast<UINT>( byteWidth );
+    bufferDesc.Usage = D3D11_USAGE_DEFAULT;
+    bufferDesc.BindFlags = bindFlags;
+
+    ComPtr<ID3D11Buffer> buffer;
+    if ( FAILED( device->CreateBuffer( &bufferDesc, nullptr, &buffer ) ) )
+    {
+        throw std::exception("Failed to create mesh buffer pool.");
+    }
+
+    return buffer;
+}
+
+// Copy the allocations from the old buffer to their defragmented offsets in the new buffer.
+// Allocations that were not moved are at the beginning of the buffer, so they are copied
+// with a single copy. The source and destination are always different buffers, so the
+// copied ranges may overlap.
+static void CopyPoolBuffer( ID3D11DeviceContext* deviceContext, ID3D11Buffer* destination, ID3D11Buffer* source, UINT usedSize, UINT elementSize, const std::vector<OffsetAllocator::Move>& moves )
+{
+    UINT unmovedSize = moves.empty() ? usedSize : moves.front().DestinationOffset;
+    if ( unmovedSize > 0 )
+    {
+        D3D11_BOX box = { 0, 0, 0, unmovedSize * elementSize, 1, 1 };
+        deviceContext->CopySubresourceRegion( destination, 0, 0, 0, 0, source, 0, &box );
+    }
+
+    for ( auto it = moves.begin(); it != moves.end(); ++it )
+    {
+        D3D11_BOX box = { it->SourceOffset * elementSize, 0, 0, ( it->SourceOffset + it->Size ) * elementSize, 1, 1 };
+        deviceContext->CopySubresourceRegion( destination, 0, it->DestinationOffset * elementSize, 0, 0, source, 0, &box );
+    }
+}
+
+// The capacity that is required to allocate size elements after defragmentation.
+static UINT GrowCapacity( const OffsetAllocator& allocator, UINT size )
+{
+    uint64_t capacity = std::max( allocator.get_Capacity(), 1u );
+    while ( capacity - allocator.get_UsedSize() < size )
+    {
+        capacity *= 2;
+    }
+
+    return static_cast<UINT>( std::min<uint64_t>( capacity, UINT_MAX ) );
+}
+
+std::shared_ptr<MeshBufferPool> MeshBufferPool::Create( ID3D11Device* device, UINT vertexStride, DXGI_FORMAT indexFormat, UINT vertexCapacity, UINT indexCapacity )
+{
+    return std::shared_ptr<MeshBufferPool>( new MeshBufferPool( device, vertexStride, indexFormat, vertexCapacity, indexCapacity ) );
+}
+
+MeshBufferPool::MeshBufferPool( ID3D11Device* device, UINT vertexStride, DXGI_FORMAT indexFormat, UINT vertexCapacity, UINT indexCapacity )
+    : m_Device( device )
+    , m_VertexStride( vertexStride )
+    , m_IndexFormat( indexFormat )
+    , m_VertexAllocator( vertexCapacity )
+    , m_IndexAllocator( indexCapacity )
+{
+    assert( device );
+    assert( indexFormat == DXGI_FORMAT_R16_UINT || indexFormat == DXGI_FORMAT_R32_UINT );
+    assert( vertexCapacity > 0 && indexCapacity > 0 );
+
+    m_VertexBuffer = CreatePoolBuffer( device, vertexCapacity, m_VertexStride, D3D11_BIND_VERTEX_BUFFER );
+    m_IndexBuffer = CreatePoolBuffer( device, indexCapacity, get_IndexSize(), D3D11_BIND_INDEX_BUFFER );
+}
+
+MeshBufferPool::~MeshBufferPool()
+{
+    // All allocations hold a reference to the pool, so they have been freed already.
+    assert( m_VertexAllocator.get_AllocationCount() == 0 && m_IndexAllocator.get_AllocationCount() == 0 );
+}
+
+bool MeshBufferPool::TryAllocate( UINT vertexCount, UINT indexCount, OffsetAllocator::Handle& vertices, OffsetAllocator::Handle& indices )
+{
+    vertices = m_VertexAllocator.Allocate( vertexCount );
+    if ( vertices == OffsetAllocator::InvalidHandle )
+    {
+        return false;
+    }
+
+    indices = m_IndexAllocator.Allocate( indexCount );
+    if ( indices == OffsetAllocator::InvalidHandle )
+    {
+        m_VertexAllocator.Free( vertices );
+        return false;
+    }
+
+    return true;
+}
+
+std::shared_ptr<MeshBufferAllocation> MeshBufferPool::Allocate( ID3D11DeviceContext* deviceContext, UINT vertexCount, UINT indexCount )
+{
+    assert( deviceContext );
+    assert( vertexCount > 0 && indexCount > 0 );
+
+    OffsetAllocator::Handle vertices, indices;
+    if ( !TryAllocate( vertexCount, indexCount, vertices, indices ) )
+    {
+        // After defragmentation the free space of each buffer is a single range at
+        // the end, so the buffers only have to be grown if that range is too small.
+        Resize( deviceContext, GrowCapacity( m_VertexAllocator, vertexCount ), GrowCapacity( m_IndexAllocator, indexCount ) );
+
+        if ( !TryAllocate( vertexCount, indexCount, vertices, indices ) )
+        {
+            throw std::exception("Failed to allocate from mesh buffer pool.");
+        }
+    }
+
+    return std::shared_ptr<MeshBufferAllocation>( new MeshBufferAllocation( shared_from_this(), vertices, indices ) );
+}
+
+void MeshBufferPool::Free( OffsetAllocator::Handle vertices, OffsetAllocator::Handle indices )
+{
+    m_VertexAllocator.Free( vertices );
+    m_IndexAllocator.Free( indices );
+}
+
+void MeshBufferPool::Defragment( ID3D11DeviceContext* deviceContext )
+{
+    Resize( deviceContext, m_VertexAllocator.get_Capacity(), m_IndexAllocator.get_Capacity() );
+}
+
+void MeshBufferPool::Resize( ID3D11DeviceContext* deviceContext, UINT vertexCapacity, UINT indexCapacity )
+{
+    PROFILE_FUNCTION();
+
+    assert( deviceContext );
+
+    std::vector<OffsetAllocator::Move> vertexMoves, indexMoves;
+    m_VertexAllocator.Defragment( vertexMoves );
+    m_IndexAllocator.Defragment( indexMoves );
+
+    // Allocations can only be moved in place if the ranges don't overlap, so the
+    // buffers are always copied into new buffers.
+    if ( vertexMoves.size() > 0 || vertexCapacity != m_VertexAllocator.get_Capacity() )
+    {
+        ComPtr<ID3D11Buffer> vertexBuffer = CreatePoolBuffer( m_Device.Get(), vertexCapacity, m_VertexStride, D3D11_BIND_VERTEX_BUFFER );
+        CopyPoolBuffer( deviceContext, vertexBuffer.Get(), m_VertexBuffer.Get(), m_VertexAllocator.get_UsedSize(), m_VertexStride, vertexMoves );
+
+        m_VertexAllocator.Grow( vertexCapacity );
+        m_VertexBuffer = vertexBuffer;
+    }
+
+    if ( indexMoves.size() > 0 || indexCapacity != m_IndexAllocator.get_Capacity() )
+    {
+        ComPtr<ID3D11Buffer> indexBuffer = CreatePoolBuffer( m_Device.Get(), indexCapacity, get_IndexSize(), D3D11_BIND_INDEX_BUFFER );
+        CopyPoolBuffer( deviceContext, indexBuffer.Get(), m_IndexBuffer.Get(), m_IndexAllocator.get_UsedSize(), get_IndexSize(), indexMoves );
+
+        m_IndexAllocator.Grow( indexCapacity );
+        m_IndexBuffer = indexBuffer;
+    }
+}
+
+void MeshBufferPool::Bind( ID3D11DeviceContext* deviceContext ) const
+{
+    assert( deviceContext );
+
+    const UINT strides[] = { m_VertexStride };
+    const UINT offsets[] = { 0 };
+
+    deviceContext->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+    deviceContext->IASetVertexBuffers( 0, 1, m_VertexBuffer.GetAddressOf(), strides, offsets );
+    deviceContext->IASetIndexBuffer( m_IndexBuffer.Get(), m_IndexFormat, 0 );
+}
+
+ID3D11Buffer* MeshBufferPool::get_VertexBuffer() const
+{
+    return m_VertexBuffer.Get();
+}
+
+ID3D11Buffer* MeshBufferPool::get_IndexBuffer() const
+{
+    return m_IndexBuffer.Get();
+}
+
+UINT MeshBufferPool::get_VertexStride() const
+{
+    return m_VertexStride;
+}
+
+DXGI_FORMAT MeshBufferPool::get_IndexFormat() const
+{
+    return m_IndexFormat;
+}
+
+UINT MeshBufferPool::get_IndexSize() const
+{
+    return ( m_IndexFormat == DXGI_FORMAT_R32_UINT ) ? 4 : 2;
+}
+
+const OffsetAllocator& MeshBufferPool::get_VertexAllocator() const
+{
+    return m_VertexAllocator;
+}
+
+const OffsetAllocator& MeshBufferPool::get_IndexAllocator() const
+{
+    return m_IndexAllocator;
+}
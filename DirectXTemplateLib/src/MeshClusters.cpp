@@ -0,0 +1,274 @@
+#include <DirectXTemplateLibPCH.h>
+#include <MeshClusters.h>
+#include <Camera.h>
+#include <Profiler.h>
+
+using namespace DirectX;
+
+// Compute the bounding sphere and normal cone of the triangles of a cluster.
+static void ComputeClusterBounds( const VertexCollection& vertices, const IndexCollection& indices, MeshCluster& cluster )
+{
+    const uint32_t* clusterIndices = indices.data() + cluster.StartIndex;
+
+    // The center of the bounding sphere is the center of the cluster's AABB.
+    XMVECTOR minPosition = g_XMFltMax;
+    XMVECTOR maxPosition = -g_XMFltMax;
+    for ( UINT i = 0; i < cluster.IndexCount; ++i )
+    {
+        XMVECTOR position = XMLoadFloat3( &vertices[clusterIndices[i]].position );
+        minPosition = XMVectorMin( minPosition, position );
+        maxPosition = XMVectorMax( maxPosition, position );
+    }
+
+    XMVECTOR center = ( minPosition + maxPosition ) * 0.5f;
+    XMVECTOR radiusSq = XMVectorZero();
+    for ( UINT i = 0; i < cluster.IndexCount; ++i )
+    {
+        XMVECTOR position = XMLoadFloat3( &vertices[clusterIndices[i]].position );
+        radiusSq = XMVectorMax( radiusSq, XMVector3LengthSq( position - center ) );
+    }
+
+    XMStoreFloat4( &cluster.BoundingSphere, XMVectorSetW( center, XMVectorGetX( XMVectorSqrt( radiusSq ) ) ) );
+
+    // The face normals are oriented to agree with the vertex normals so the
+    // cone does not depend on the winding order of the triangles.
+    const size_t triangleCount = cluster.IndexCount / 3;
+    std::vector<XMFLOAT3> faceNormals;
+    faceNormals.reserve( triangleCount );
+
+    XMVECTOR axis = XMVectorZero();
+    for ( size_t t = 0; t < triangleCount; ++t )
+    {
+        const VertexPositionNormalTexture& v0 = vertices[clusterIndices[t * 3 + 0]];
+        const VertexPositionNormalTexture& v1 = vertices[clusterIndices[t * 3 + 1]];
+        const VertexPositionNormalTexture& v2 = vertices[clusterIndices[t * 3 + 2]];
+
+        XMVECTOR p0 = XMLoadFloat3( &v0.position );
+        XMVECTOR faceNormal = XMVector3Cross( XMLoadFloat3( &v1.position ) - p0, XMLoadFloat3( &v2.position ) - p0 );
+        if ( XMVector3Equal( faceNormal, XMVectorZero() ) )
+        {
+            // Degenerate triangles are never visible.
+            continue;
+        }
+
+        XMVECTOR vertexNormal = XMLoadFloat3( &v0.normal ) + XMLoadFloat3( &v1.normal ) + XMLoadFloat3( &v2.normal );
+        if ( XMVectorGetX( XMVector3Dot( faceNormal, vertexNormal ) ) < 0.0f )
+        {
+            faceNormal = -faceNormal;
+        }
+
+        faceNormal = XMVector3Normalize( faceNormal );
+        axis += faceNormal;
+
+        XMFLOAT3 normal;
+        XMStoreFloat3( &normal, faceNormal );
+        faceNormals.push_back( normal );
+    }
+
+    float cutoff = 1.0f;
+    if ( !faceNormals.empty() && !XMVector3NearEqual( axis, XMVectorZero(), g_XMEpsilon ) )
+    {
+        axis = XMVector3Normalize( axis );
+
+        // The cosine of the angle between the axis and the most divergent normal.
+        float minDot = 1.0f;
+        for ( auto it = faceNormals.begin(); it != faceNormals.end(); ++it )
+        {
+            minDot = std::min( minDot, XMVectorGetX( XMVector3Dot( axis, XMLoadFloat3( &(*it) ) ) ) );
+        }
+
+        // The cluster can only be back-facing if the cone is narrower than a hemisphere.
+        if ( minDot > 0.0f )
+        {
+            cutoff = std::sqrt( 1.0f - minDot * minDot );
+        }
+    }
+    else
+    {
+        axis = g_XMIdentityR1;
+    }
+
+    XMStoreFloat4( &cluster.NormalCone, XMVectorSetW( axis, cutoff ) );
+}
+
+void BuildMeshClusters( const VertexCollection& vertices, const IndexCollection& indices, size_t maxVertices, size_t maxTriangles, MeshClusterCollection& clusters )
+{
+    assert( ( indices.size() % 3 ) == 0 );
+    assert( maxVertices >= 3 && maxTriangles >= 1 );
+
+    clusters.clear();
+
+    // The cluster that last referenced each vertex.
+    std::vector<size_t> vertexCluster( vertices.size(), SIZE_MAX );
+
+    MeshCluster cluster = {};
+    size_t clusterIndex = 0;
+
+    for ( size_t i = 0; i < indices.size(); i += 3 )
+    {
+        // Count the vertices of this triangle that are not yet part of the current cluster.
+        UINT newVertices = 0;
+        for ( int k = 0; k < 3; ++k )
+        {
+            uint32_t v = indices[i + k];
+            if ( vertexCluster[v] != clusterIndex && ( k < 1 || v != indices[i] ) && ( k < 2 || v != indices[i + 1] ) )
+            {
+                ++newVertices;
+            }
+        }
+
+        if ( cluster.IndexCount > 0 &&
+            ( cluster.VertexCount + newVertices > maxVertices || cluster.IndexCount / 3 + 1 > maxTriangles ) )
+        {
+            // Close the current cluster and start a new one with this triangle.
+            ComputeClusterBounds( vertices, indices, cluster );
+            clusters.push_back( cluster );
+
+            ++clusterIndex;
+            cluster = MeshCluster();
+            cluster.StartIndex = static_cast<UINT>( i );
+        }
+
+        for ( int k = 0; k < 3; ++k )
+        {
+            uint32_t v = indices[i + k];
+            if ( vertexCluster[v] != clusterIndex )
+            {
+                vertexCluster[v] = clusterIndex;
+                ++cluster.VertexCount;
+            }
+        }
+
+        cluster.IndexCount += 3;
+    }
+
+    if ( cluster.IndexCount > 0 )
+    {
+        ComputeClusterBounds( vertices, indices, cluster );
+        clusters.push_back( cluster );
+    }
+}
+
+MeshClusterCuller::MeshClusterCuller()
+    : m_ClusterCount( 0 )
+{}
+
+MeshClusterCuller::MeshClusterCuller( const MeshClusterCollection& clusters )
+    : m_ClusterCount( 0 )
+{
+    set_Clusters( clusters );
+}
+
+void MeshClusterCuller::set_Clusters( const MeshClusterCollection& clusters )
+{
+    m_ClusterCount = clusters.size();
+
+    // The padding clusters are tested but never reported as visible.
+    size_t paddedCount = ( m_ClusterCount + 3 ) & ~static_cast<size_t>(3);
+
+    m_CenterX.assign( paddedCount, 0.0f );
+    m_CenterY.assign( paddedCount, 0.0f );
+    m_CenterZ.assign( paddedCount, 0.0f );
+    m_Radius.assign( paddedCount, 0.0f );
+    m_AxisX.assign( paddedCount, 0.0f );
+    m_AxisY.assign( paddedCount, 0.0f );
+    m_AxisZ.assign( paddedCount, 0.0f );
+    m_Cutoff.assign( paddedCount, 1.0f );
+
+    for ( size_t i = 0; i < m_ClusterCount; ++i )
+    {
+        const MeshCluster& cluster = clusters[i];
+
+        m_CenterX[i] = cluster.BoundingSphere.x;
+        m_CenterY[i] = cluster.BoundingSphere.y;
+        m_CenterZ[i] = cluster.BoundingSphere.z;
+        m_Radius[i] = cluster.BoundingSphere.w;
+
+        m_AxisX[i] = cluster.NormalCone.x;
+        m_AxisY[i] = cluster.NormalCone.y;
+        m_AxisZ[i] = cluster.NormalCone.z;
+        m_Cutoff[i] = cluster.NormalCone.w;
+    }
+}
+
+size_t MeshClusterCuller::get_ClusterCount() const
+{
+    return m_ClusterCount;
+}
+
+size_t XM_CALLCONV MeshClusterCuller::Cull( FXMMATRIX worldMatrix, const Camera& camera, std::vector<UINT>& visibleClusters ) const
+{
+    PROFILE_FUNCTION();
+
+    visibleClusters.clear();
+
+    // Transform the frustum planes and the camera position into the object space of the
+    // mesh so that the cluster bounds do not need to be transformed.
+    XMVECTOR planes[Camera::FrustumPlaneCount];
+    Camera::ExtractFrustumPlanes( worldMatrix * camera.get_ViewProjectionMatrix(), planes, camera.get_DepthMode() );
+
+    XMMATRIX inverseWorldMatrix = XMMatrixInverse( nullptr, worldMatrix );
+    XMVECTOR cameraPosition = XMVector3TransformCoord( camera.get_Translation(), inverseWorldMatrix );
+
+    // Splat the plane and camera components for the 4-wide tests.
+    XMVECTOR planeX[Camera::FrustumPlaneCount], planeY[Camera::FrustumPlaneCount], planeZ[Camera::FrustumPlaneCount], planeW[Camera::FrustumPlaneCount];
+    for ( int i = 0; i < Camera::FrustumPlaneCount; ++i )
+    {
+        planeX[i] = XMVectorSplatX( planes[i] );
+        planeY[i] = XMVectorSplatY( planes[i] );
+        planeZ[i] = XMVectorSplatZ( planes[i] );
+        planeW[i] = XMVectorSplatW( planes[i] );
+    }
+
+    XMVECTOR cameraX = XMVectorSplatX( cameraPosition );
+    XMVECTOR cameraY = XMVectorSplatY( cameraPosition );
+    XMVECTOR cameraZ = XMVectorSplatZ( cameraPosition );
+
+    for ( size_t i = 0; i < m_ClusterCount; i += 4 )
+    {
+        XMVECTOR centerX = XMLoadFloat4( reinterpret_cast<const XMFLOAT4*>( &m_CenterX[i] ) );
+        XMVECTOR centerY = XMLoadFloat4( reinterpret_cast<const XMFLOAT4*>( &m_CenterY[i] ) );
+        XMVECTOR centerZ = XMLoadFloat4( reinterpret_cast<const XMFLOAT4*>( &m_CenterZ[i] ) );
+        XMVECTOR radius = XMLoadFloat4( reinterpret_cast<const XMFLOAT4*>( &m_Radius[i] ) );
+        XMVECTOR negativeRadius = XMVectorNegate( radius );
+
+        // A cluster is outside the frustum if it is completely behind any of the planes.
+        XMVECTOR visible = XMVectorTrueInt();
+        for ( int p = 0; p < Camera::FrustumPlaneCount; ++p )
+        {
+            XMVECTOR distance = XMVectorMultiplyAdd( centerX, planeX[p], XMVectorMultiplyAdd( centerY, planeY[p], XMVectorMultiplyAdd( centerZ, planeZ[p], planeW[p] ) ) );
+            visible = XMVectorAndInt( visible, XMVectorGreaterOrEqual( distance, negativeRadius ) );
+        }
+
+        // A cluster is back-facing if the view direction to every point in the bounding
+        // sphere is within (90 degrees - the cone's half angle) of the cone axis:
+        //     dot( center - camera, axis ) >= cutoff * length( center - camera ) + radius
+        XMVECTOR viewX = centerX - cameraX;
+        XMVECTOR viewY = centerY - cameraY;
+        XMVECTOR viewZ = centerZ - cameraZ;
+
+        XMVECTOR axisX = XMLoadFloat4( reinterpret_cast<const XMFLOAT4*>( &m_AxisX[i] ) );
+        XMVECTOR axisY = XMLoadFloat4( reinterpret_cast<const XMFLOAT4*>( &m_AxisY[i] ) );
+        XMVECTOR axisZ = XMLoadFloat4( reinterpret_cast<const XMFLOAT4*>( &m_AxisZ[i] ) );
+        XMVECTOR cutoff = XMLoadFloat4( reinterpret_cast<const XMFLOAT4*>( &m_Cutoff[i] ) );
+
+        XMVECTOR viewDotAxis = XMVectorMultiplyAdd( viewX, axisX, XMVectorMultiplyAdd( viewY, axisY, viewZ * axisZ ) );
+        XMVECTOR viewLength = XMVectorSqrt( XMVectorMultiplyAdd( viewX, viewX, XMVectorMultiplyAdd( viewY, viewY, viewZ * viewZ ) ) );
+
+        XMVECTOR backFacing = XMVectorGreaterOrEqual( viewDotAxis, XMVectorMultiplyAdd( cutoff, viewLength, radius ) );
+        visible = XMVectorAndCInt( visible, backFacing );
+
+        uint32_t visibleMask[4];
+        XMStoreInt4( visibleMask, visible );
+
+        for ( size_t k = 0; k < 4 && i + k < m_ClusterCount; ++k )
+        {
+            if ( visibleMask[k] )
+            {
+                visibleClusters.push_back( static_cast<UINT>( i + k ) );
+            }
+        }
+    }
+
+    return visibleClusters.size();
+}
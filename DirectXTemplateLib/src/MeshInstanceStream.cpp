@@ -0,0 +1,98 @@
+#include <DirectXTemplateLibPCH.h>
+#include <MeshInstanceStream.h>
+
+const D3D11_INPUT_ELEMENT_DESC MeshInstance::InputElements[] =
+{
+    { "WORLDMATRIX", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, InputSlot, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    { "WORLDMATRIX", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, InputSlot, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    { "WORLDMATRIX", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, InputSlot, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    { "WORLDMATRIX", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, InputSlot, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    { "INVERSETRANSPOSEWORLDMATRIX", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, InputSlot, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    { "INVERSETRANSPOSEWORLDMATRIX", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, InputSlot, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    { "INVERSETRANSPOSEWORLDMATRIX", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, InputSlot, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    { "INVERSETRANSPOSEWORLDMATRIX", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, InputSlot, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    { "MATERIALINDEX", 0, DXGI_FORMAT_R32_UINT, InputSlot, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+};
+
+MeshInstanceStream::MeshInstanceStream()
+    : m_Capacity( 0 )
+    , m_InstanceCount( 0 )
+{}
+
+bool MeshInstanceStream::Initialize( ID3D11Device* device, UINT capacity )
+{
+    assert( device && capacity > 0 );
+
+    D3D11_BUFFER_DESC bufferDesc;
+    ZeroMemory( &bufferDesc, sizeof(D3D11_BUFFER_DESC) );
+
+    bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+    bufferDesc.ByteWidth = sizeof(MeshInstance) * capacity;
+    bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+
+    HRESULT hr = device->CreateBuffer( &bufferDesc, nullptr, &m_d3dBuffer );
+    if ( FAILED( hr ) )
+    {
+        return false;
+    }
+
+    m_Capacity = capacity;
+    m_InstanceCount = 0;
+
+    return true;
+}
+
+bool MeshInstanceStream::Append( ID3D11DeviceContext* deviceContext, const MeshInstance* instances, UINT instanceCount, UINT& startInstance )
+{
+    assert( m_d3dBuffer );
+
+    if ( instanceCount > m_Capacity )
+    {
+        return false;
+    }
+
+    if ( m_InstanceCount + instanceCount > m_Capacity )
+    {
+        m_InstanceCount = 0;
+    }
+
+    D3D11_MAP mapType = ( m_InstanceCount == 0 ) ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE;
+
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
+    HRESULT hr = deviceContext->Map( m_d3dBuffer.Get(), 0, mapType, 0, &mappedResource );
+    if ( FAILED( hr ) )
+    {
+        return false;
+    }
+
+    MeshInstance* destination = static_cast<MeshInstance*>( mappedResource.pData ) + m_InstanceCount;
+    memcpy( destination, instances, sizeof(MeshInstance) * instanceCount );
+
+    deviceContext->Unmap( m_d3dBuffer.Get(), 0 );
+
+    startInstance = m_InstanceCount;
+    m_InstanceCount += instanceCount;
+
+    return true;
+}
+
+void MeshInstanceStream::Bind( ID3D11DeviceContext* deviceContext ) const
+{
+    assert( deviceContext );
+
+    const UINT strides[] = { sizeof(MeshInstance) };
+    const UINT offsets[] = { 0 };
+
+    deviceContext->IASetVertexBuffers( MeshInstance::InputSlot, 1, m_d3dBuffer.GetAddressOf(), strides, offsets );
+}
+
+UINT MeshInstanceStream::get_Capacity() const
+{
+    return m_Capacity;
+}
+
+ID3D11Buffer* MeshInstanceStream::get_Buffer() const
+{
+    return m_d3dBuffer.Get();
+}
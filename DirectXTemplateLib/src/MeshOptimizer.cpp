@@ -0,0 +1,488 @@
+#include <DirectXTemplateLibPCH.h>
+#include <MeshOptimizer.h>
+#include <Profiler.h>
+
+// Tuning parameters of the Forsyth vertex scoring function.
+// See: https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+static const size_t MaxCacheSize = 32;
+static const float CacheDecayPower = 1.5f;
+static const float LastTriangleScore = 0.75f;
+static const float ValenceBoostScale = 2.0f;
+static const float ValenceBoostPower = 0.5f;
+
+static const uint32_t InvalidIndex = UINT_MAX;
+
+VertexCacheStatistics AnalyzeVertexCache( const IndexCollection& indices, size_t vertexCount, size_t cacheSize )
+{
+    assert( ( indices.size() % 3 ) == 0 );
+
+    VertexCacheStatistics statistics = { 0.0f, 0.0f };
+    if ( indices.empty() || vertexCount == 0 )
+    {
+        return statistics;
+    }
+
+    // A vertex is in the FIFO cache if fewer than cacheSize vertices
+    // have been transformed since it was last transformed.
+    std::vector<size_t> cacheTimestamps( vertexCount, 0 );
+    size_t timestamp = cacheSize + 1;
+    size_t transformedVertices = 0;
+
+    for ( auto it = indices.begin(); it != indices.end(); ++it )
+    {
+        assert( *it < vertexCount );
+
+        if ( timestamp - cacheTimestamps[*it] > cacheSize )
+        {
+            cacheTimestamps[*it] = timestamp++;
+            ++transformedVertices;
+        }
+    }
+
+    statistics.ACMR = static_cast<float>( transformedVertices ) / ( indices.size() / 3 );
+    statistics.ATVR = static_cast<float>( transformedVertices ) / vertexCount;
+
+    return statistics;
+}
+
+// Compute the score of a vertex given its position in the LRU cache and the
+// number of triangles that still need to be emitted that use this vertex.
+static float ScoreVertex( int cachePosition, uint32_t remainingTriangles )
+{
+    if ( remainingTriangles == 0 )
+    {
+        // The vertex is not used by any more triangles.
+        return -1.0f;
+    }
+
+    float score = 0.0f;
+    if ( cachePosition >= 0 )
+    {
+        if ( cachePosition < 3 )
+        {
+            // The vertex was used in the last triangle. Give it a fixed score so
+            // that strips are not preferred over fans.
+            score = LastTriangleScore;
+        }
+        else
+        {
+            const float scale = 1.0f / ( MaxCacheSize - 3 );
+            score = std::pow( 1.0f - ( cachePosition - 3 ) * scale, CacheDecayPower );
+        }
+    }
+
+    // Boost vertices with few remaining triangles so that lone triangles are not left behind.
+    score += ValenceBoostScale * std::pow( static_cast<float>( remainingTriangles ), -ValenceBoostPower );
+
+    return score;
+}
+
+void OptimizeVertexCache( IndexCollection& indices, size_t vertexCount )
+{
+    PROFILE_FUNCTION();
+
+    assert( ( indices.size() % 3 ) == 0 );
+
+    const size_t triangleCount = indices.size() / 3;
+    if ( triangleCount == 0 )
+    {
+        return;
+    }
+
+    // Build the vertex-triangle adjacency. The triangles that use vertex v
+    // are stored in adjacency[adjacencyOffsets[v]...adjacencyOffsets[v] + remainingTriangles[v]].
+    std::vector<uint32_t> remainingTriangles( vertexCount, 0 );
+    for ( auto it = indices.begin(); it != indices.end(); ++it )
+    {
+        assert( *it < vertexCount );
+        ++remainingTriangles[*it];
+    }
+
+    std::vector<uint32_t> adjacencyOffsets( vertexCount, 0 );
+    for ( size_t v = 1; v < vertexCount; ++v )
+    {
+        adjacencyOffsets[v] = adjacencyOffsets[v - 1] + remainingTriangles[v - 1];
+    }
+
+    std::vector<uint32_t> adjacency( indices.size() );
+    {
+        std::vector<uint32_t> adjacencyCursor( adjacencyOffsets );
+        for ( size_t i = 0; i < indices.size(); ++i )
+        {
+            adjacency[adjacencyCursor[indices[i]]++] = static_cast<uint32_t>( i / 3 );
+        }
+    }
+
+    std::vector<int> cachePositions( vertexCount, -1 );
+    std::vector<float> vertexScores( vertexCount );
+    for ( size_t v = 0; v < vertexCount; ++v )
+    {
+        vertexScores[v] = ScoreVertex( -1, remainingTriangles[v] );
+    }
+
+    std::vector<float> triangleScores( triangleCount );
+    std::vector<bool> triangleEmitted( triangleCount, false );
+    uint32_t bestTriangle = 0;
+    for ( size_t t = 0; t < triangleCount; ++t )
+    {
+        triangleScores[t] = vertexScores[indices[t * 3 + 0]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+        if ( triangleScores[t] > triangleScores[bestTriangle] )
+        {
+            bestTriangle = static_cast<uint32_t>( t );
+        }
+    }
+
+    IndexCollection optimizedIndices;
+    optimizedIndices.reserve( indices.size() );
+
+    // The simulated LRU cache. It can temporarily grow by the 3 vertices of the
+    // emitted triangle before the least recently used vertices are evicted.
+    uint32_t cache[MaxCacheSize + 3];
+    size_t cacheSize = 0;
+
+    // If there is no candidate triangle in the cache, continue with the
+    // next triangle (in input order) that has not been emitted yet.
+    size_t nextUnemittedTriangle = 0;
+
+    for ( size_t emitted = 0; emitted < triangleCount; ++emitted )
+    {
+        if ( bestTriangle == InvalidIndex )
+        {
+            while ( triangleEmitted[nextUnemittedTriangle] )
+            {
+                ++nextUnemittedTriangle;
+            }
+            bestTriangle = static_cast<uint32_t>( nextUnemittedTriangle );
+        }
+
+        const uint32_t* triangle = &indices[bestTriangle * 3];
+        optimizedIndices.push_back( triangle[0] );
+        optimizedIndices.push_back( triangle[1] );
+        optimizedIndices.push_back( triangle[2] );
+        triangleEmitted[bestTriangle] = true;
+
+        // Remove the emitted triangle from the adjacency of its vertices.
+        for ( int k = 0; k < 3; ++k )
+        {
+            uint32_t v = triangle[k];
+            uint32_t* begin = adjacency.data() + adjacencyOffsets[v];
+            uint32_t* end = begin + remainingTriangles[v];
+            uint32_t* it = std::find( begin, end, bestTriangle );
+            assert( it != end );
+            *it = *( end - 1 );
+            --remainingTriangles[v];
+        }
+
+        // Move the vertices of the emitted triangle to the front of the cache.
+        uint32_t newCache[MaxCacheSize + 3];
+        size_t newCacheSize = 0;
+        for ( int k = 0; k < 3; ++k )
+        {
+            if ( std::find( newCache, newCache + newCacheSize, triangle[k] ) == newCache + newCacheSize )
+            {
+                newCache[newCacheSize++] = triangle[k];
+            }
+        }
+        for ( size_t i = 0; i < cacheSize; ++i )
+        {
+            uint32_t v = cache[i];
+            if ( v != triangle[0] && v != triangle[1] && v != triangle[2] )
+            {
+                newCache[newCacheSize++] = v;
+            }
+        }
+
+        // Update the scores of all vertices whose cache position changed (including
+        // the ones that were evicted) and propagate the change to their triangles.
+        for ( size_t i = 0; i < newCacheSize; ++i )
+        {
+            uint32_t v = newCache[i];
+            cachePositions[v] = ( i < MaxCacheSize ) ? static_cast<int>( i ) : -1;
+
+            float score = ScoreVertex( cachePositions[v], remainingTriangles[v] );
+            float scoreDelta = score - vertexScores[v];
+            vertexScores[v] = score;
+
+            const uint32_t* begin = adjacency.data() + adjacencyOffsets[v];
+            const uint32_t* end = begin + remainingTriangles[v];
+            for ( const uint32_t* it = begin; it != end; ++it )
+            {
+                triangleScores[*it] += scoreDelta;
+            }
+        }
+
+        cacheSize = std::min( newCacheSize, MaxCacheSize );
+        std::copy( newCache, newCache + cacheSize, cache );
+
+        // The next triangle is the highest scoring triangle that uses a vertex in the cache.
+        bestTriangle = InvalidIndex;
+        float bestScore = -FLT_MAX;
+        for ( size_t i = 0; i < cacheSize; ++i )
+        {
+            uint32_t v = cache[i];
+            const uint32_t* begin = adjacency.data() + adjacencyOffsets[v];
+            const uint32_t* end = begin + remainingTriangles[v];
+            for ( const uint32_t* it = begin; it != end; ++it )
+            {
+                if ( triangleScores[*it] > bestScore )
+                {
+                    bestScore = triangleScores[*it];
+                    bestTriangle = *it;
+                }
+            }
+        }
+    }
+
+    indices.swap( optimizedIndices );
+}
+
+size_t OptimizeVertexFetch( VertexCollection& vertices, IndexCollection& indices )
+{
+    PROFILE_FUNCTION();
+
+    std::vector<uint32_t> remap( vertices.size(), InvalidIndex );
+
+    VertexCollection reorderedVertices;
+    reorderedVertices.reserve( vertices.size() );
+
+    for ( auto it = indices.begin(); it != indices.end(); ++it )
+    {
+        assert( *it < vertices.size() );
+
+        uint32_t& newIndex = remap[*it];
+        if ( newIndex == InvalidIndex )
+        {
+            newIndex = static_cast<uint32_t>( reorderedVertices.size() );
+            reorderedVertices.push_back( vertices[*it] );
+        }
+
+        *it = newIndex;
+    }
+
+    vertices.swap( reorderedVertices );
+
+    return vertices.size();
+}
+
+// Returns true if all components of a and b differ by at most tolerance.
+static bool NearEqual( const float* a, const float* b, int count, float tolerance )
+{
+    for ( int i = 0; i < count; ++i )
+    {
+        if ( !( std::abs( a[i] - b[i] ) <= tolerance ) )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool CanWeld( const VertexPositionNormalTexture& a, const VertexPositionNormalTexture& b, const WeldTolerances& tolerances )
+{
+    return NearEqual( &a.position.x, &b.position.x, 3, tolerances.Position ) &&
+        NearEqual( &a.normal.x, &b.normal.x, 3, tolerances.Normal ) &&
+        NearEqual( &a.textureCoordinate.x, &b.textureCoordinate.x, 2, tolerances.TextureCoordinate );
+}
+
+// Hash the integer coordinates of a cell of the spatial hash grid.
+static size_t HashCell( int64_t x, int64_t y, int64_t z )
+{
+    return static_cast<size_t>( ( x * 73856093 ) ^ ( y * 19349663 ) ^ ( z * 83492791 ) );
+}
+
+// Hash the bit pattern of a position (used when the position tolerance is 0).
+static size_t HashPosition( const DirectX::XMFLOAT3& position )
+{
+    // Adding 0 turns -0 into +0 so equal positions have the same hash.
+    float p[3] = { position.x + 0.0f, position.y + 0.0f, position.z + 0.0f };
+    uint32_t bits[3];
+    memcpy( bits, p, sizeof(bits) );
+
+    return HashCell( bits[0], bits[1], bits[2] );
+}
+
+// Find the representative of every vertex: the first vertex whose attributes are all within the tolerances.
+static void FindWeldedVertices( const VertexCollection& vertices, const WeldTolerances& tolerances, std::vector<uint32_t>& weldedIndices )
+{
+    weldedIndices.resize( vertices.size() );
+
+    // The vertices that have been kept so far, bucketed by position. Hash collisions are
+    // harmless because the candidates are always compared attribute by attribute.
+    std::unordered_multimap<size_t, uint32_t> buckets;
+    buckets.reserve( vertices.size() );
+
+    // With a cell size of twice the tolerance, the vertices that are within the tolerance
+    // of a position are in at most 2 cells per axis.
+    const bool exact = !( tolerances.Position > 0.0f );
+    const float invCellSize = exact ? 0.0f : 0.5f / tolerances.Position;
+
+    for ( size_t v = 0; v < vertices.size(); ++v )
+    {
+        const VertexPositionNormalTexture& vertex = vertices[v];
+        uint32_t weldedIndex = InvalidIndex;
+
+        if ( exact )
+        {
+            auto range = buckets.equal_range( HashPosition( vertex.position ) );
+            for ( auto it = range.first; it != range.second && weldedIndex == InvalidIndex; ++it )
+            {
+                if ( CanWeld( vertices[it->second], vertex, tolerances ) )
+                {
+                    weldedIndex = it->second;
+                }
+            }
+
+            if ( weldedIndex == InvalidIndex )
+            {
+                buckets.insert( std::make_pair( HashPosition( vertex.position ), static_cast<uint32_t>( v ) ) );
+            }
+        }
+        else
+        {
+            const float* p = &vertex.position.x;
+            int64_t minCell[3], maxCell[3];
+            for ( int k = 0; k < 3; ++k )
+            {
+                minCell[k] = static_cast<int64_t>( std::floor( ( p[k] - tolerances.Position ) * invCellSize ) );
+                maxCell[k] = static_cast<int64_t>( std::floor( ( p[k] + tolerances.Position ) * invCellSize ) );
+            }
+
+            for ( int64_t x = minCell[0]; x <= maxCell[0] && weldedIndex == InvalidIndex; ++x )
+            for ( int64_t y = minCell[1]; y <= maxCell[1] && weldedIndex == InvalidIndex; ++y )
+            for ( int64_t z = minCell[2]; z <= maxCell[2] && weldedIndex == InvalidIndex; ++z )
+            {
+                auto range = buckets.equal_range( HashCell( x, y, z ) );
+                for ( auto it = range.first; it != range.second && weldedIndex == InvalidIndex; ++it )
+                {
+                    if ( CanWeld( vertices[it->second], vertex, tolerances ) )
+                    {
+                        weldedIndex = it->second;
+                    }
+                }
+            }
+
+            if ( weldedIndex == InvalidIndex )
+            {
+                size_t cell = HashCell( static_cast<int64_t>( std::floor( p[0] * invCellSize ) ),
+                    static_cast<int64_t>( std::floor( p[1] * invCellSize ) ),
+                    static_cast<int64_t>( std::floor( p[2] * invCellSize ) ) );
+                buckets.insert( std::make_pair( cell, static_cast<uint32_t>( v ) ) );
+            }
+        }
+
+        weldedIndices[v] = ( weldedIndex == InvalidIndex ) ? static_cast<uint32_t>( v ) : weldedIndex;
+    }
+}
+
+WeldStatistics WeldVertices( VertexCollection& vertices, IndexCollection& indices, const WeldTolerances& tolerances, std::vector<uint32_t>* remap )
+{
+    PROFILE_FUNCTION();
+
+    assert( ( indices.size() % 3 ) == 0 );
+
+    WeldStatistics statistics;
+    statistics.InitialVertexCount = vertices.size();
+    statistics.InitialTriangleCount = indices.size() / 3;
+
+    // The representative vertex of each vertex.
+    std::vector<uint32_t> weldedIndices;
+    FindWeldedVertices( vertices, tolerances, weldedIndices );
+
+    for ( auto it = indices.begin(); it != indices.end(); ++it )
+    {
+        assert( *it < vertices.size() );
+        *it = weldedIndices[*it];
+    }
+
+    statistics.DegenerateTriangleCount = RemoveDegenerateTriangles( vertices, indices, tolerances.Position );
+
+    // Remove the vertices that are no longer referenced and compact the vertex buffer.
+    std::vector<uint32_t> newIndices( vertices.size(), InvalidIndex );
+    for ( auto it = indices.begin(); it != indices.end(); ++it )
+    {
+        newIndices[*it] = 0;
+    }
+
+    uint32_t vertexCount = 0;
+    for ( size_t v = 0; v < vertices.size(); ++v )
+    {
+        if ( newIndices[v] != InvalidIndex )
+        {
+            newIndices[v] = vertexCount;
+            vertices[vertexCount++] = vertices[v];
+        }
+    }
+    vertices.resize( vertexCount );
+
+    for ( auto it = indices.begin(); it != indices.end(); ++it )
+    {
+        *it = newIndices[*it];
+    }
+
+    if ( remap )
+    {
+        remap->resize( weldedIndices.size() );
+        for ( size_t v = 0; v < weldedIndices.size(); ++v )
+        {
+            ( *remap )[v] = newIndices[weldedIndices[v]];
+        }
+    }
+
+    statistics.VertexCount = vertices.size();
+    statistics.TriangleCount = indices.size() / 3;
+
+    return statistics;
+}
+
+size_t RemoveDegenerateTriangles( const VertexCollection& vertices, IndexCollection& indices, float positionTolerance )
+{
+    assert( ( indices.size() % 3 ) == 0 );
+
+    // Weld the positions only. Corners with different normals or texture coordinates
+    // (for example at the poles and seams of the procedural shapes) can still coincide.
+    std::vector<uint32_t> positionIndices;
+    FindWeldedVertices( vertices, WeldTolerances( positionTolerance, FLT_MAX, FLT_MAX ), positionIndices );
+
+    size_t triangleCount = 0;
+    for ( size_t i = 0; i < indices.size(); i += 3 )
+    {
+        uint32_t i0 = indices[i + 0];
+        uint32_t i1 = indices[i + 1];
+        uint32_t i2 = indices[i + 2];
+
+        uint32_t p0Index = positionIndices[i0];
+        uint32_t p1Index = positionIndices[i1];
+        uint32_t p2Index = positionIndices[i2];
+
+        if ( p0Index == p1Index || p1Index == p2Index || p2Index == p0Index )
+        {
+            continue;
+        }
+
+        // Triangles with collinear (or coincident) corners have no area.
+        const DirectX::XMFLOAT3& p0 = vertices[i0].position;
+        const DirectX::XMFLOAT3& p1 = vertices[i1].position;
+        const DirectX::XMFLOAT3& p2 = vertices[i2].position;
+
+        float e1[3] = { p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+        float e2[3] = { p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+        float nx = e1[1] * e2[2] - e1[2] * e2[1];
+        float ny = e1[2] * e2[0] - e1[0] * e2[2];
+        float nz = e1[0] * e2[1] - e1[1] * e2[0];
+
+        if ( nx == 0.0f && ny == 0.0f && nz == 0.0f )
+        {
+            continue;
+        }
+
+        indices[triangleCount * 3 + 0] = i0;
+        indices[triangleCount * 3 + 1] = i1;
+        indices[triangleCount * 3 + 2] = i2;
+        ++triangleCount;
+    }
+
+    size_t removedTriangles = indices.size() / 3 - triangleCount;
+    indices.resize( triangleCount * 3 );
+
+    return removedTriangles;
+}
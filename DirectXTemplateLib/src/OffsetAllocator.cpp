@@ -0,0 +1,199 @@
+#include <DirectXTemplateLibPCH.h>
+#include <OffsetAllocator.h>
+
+OffsetAllocator::OffsetAllocator( UINT capacity )
+    : m_Capacity( 0 )
+    , m_UsedSize( 0 )
+    , m_AllocationCount( 0 )
+{
+    Grow( capacity );
+}
+
+void OffsetAllocator::AddFreeRange( UINT offset, UINT size )
+{
+    assert( size > 0 );
+
+    // Merge with the following range.
+    auto next = m_FreeRanges.find( offset + size );
+    if ( next != m_FreeRanges.end() )
+    {
+        size += next->second;
+        RemoveFreeRange( next );
+    }
+
+    // Merge with the preceding range.
+    auto previous = m_FreeRanges.lower_bound( offset );
+    if ( previous != m_FreeRanges.begin() )
+    {
+        --previous;
+        if ( previous->first + previous->second == offset )
+        {
+            offset = previous->first;
+            size += previous->second;
+            RemoveFreeRange( previous );
+        }
+    }
+
+    m_FreeRanges.insert( std::make_pair( offset, size ) );
+    m_FreeRangesBySize.insert( std::make_pair( size, offset ) );
+}
+
+void OffsetAllocator::RemoveFreeRange( std::map<UINT, UINT>::iterator range )
+{
+    auto bySize = m_FreeRangesBySize.equal_range( range->second );
+    for ( auto it = bySize.first; it != bySize.second; ++it )
+    {
+        if ( it->second == range->first )
+        {
+            m_FreeRangesBySize.erase( it );
+            break;
+        }
+    }
+
+    m_FreeRanges.erase( range );
+}
+
+OffsetAllocator::Handle OffsetAllocator::Allocate( UINT size )
+{
+    assert( size > 0 );
+
+    // Best fit: the smallest free range that is large enough.
+    auto bySize = m_FreeRangesBySize.lower_bound( size );
+    if ( bySize == m_FreeRangesBySize.end() )
+    {
+        return InvalidHandle;
+    }
+
+    UINT offset = bySize->second;
+    UINT freeSize = bySize->first;
+    RemoveFreeRange( m_FreeRanges.find( offset ) );
+
+    if ( freeSize > size )
+    {
+        AddFreeRange( offset + size, freeSize - size );
+    }
+
+    Handle handle;
+    if ( !m_UnusedHandles.empty() )
+    {
+        handle = m_UnusedHandles.back();
+        m_UnusedHandles.pop_back();
+    }
+    else
+    {
+        handle = static_cast<Handle>( m_Allocations.size() );
+        m_Allocations.push_back( Range() );
+    }
+
+    m_Allocations[handle].Offset = offset;
+    m_Allocations[handle].Size = size;
+
+    m_UsedSize += size;
+    ++m_AllocationCount;
+
+    return handle;
+}
+
+void OffsetAllocator::Free( Handle handle )
+{
+    assert( handle < m_Allocations.size() && m_Allocations[handle].Size > 0 );
+
+    Range& allocation = m_Allocations[handle];
+    AddFreeRange( allocation.Offset, allocation.Size );
+
+    m_UsedSize -= allocation.Size;
+    --m_AllocationCount;
+
+    allocation.Size = 0;
+    m_UnusedHandles.push_back( handle );
+}
+
+UINT OffsetAllocator::get_Offset( Handle handle ) const
+{
+    assert( handle < m_Allocations.size() && m_Allocations[handle].Size > 0 );
+    return m_Allocations[handle].Offset;
+}
+
+UINT OffsetAllocator::get_Size( Handle handle ) const
+{
+    assert( handle < m_Allocations.size() );
+    return m_Allocations[handle].Size;
+}
+
+void OffsetAllocator::Grow( UINT capacity )
+{
+    assert( capacity >= m_Capacity );
+
+    if ( capacity > m_Capacity )
+    {
+        AddFreeRange( m_Capacity, capacity - m_Capacity );
+        m_Capacity = capacity;
+    }
+}
+
+void OffsetAllocator::Defragment( std::vector<Move>& moves )
+{
+    moves.clear();
+
+    // The live allocations sorted by offset.
+    std::vector< std::pair<UINT, Handle> > allocations;
+    allocations.reserve( m_AllocationCount );
+    for ( size_t handle = 0; handle < m_Allocations.size(); ++handle )
+    {
+        if ( m_Allocations[handle].Size > 0 )
+        {
+            allocations.push_back( std::make_pair( m_Allocations[handle].Offset, static_cast<Handle>( handle ) ) );
+        }
+    }
+    std::sort( allocations.begin(), allocations.end() );
+
+    UINT offset = 0;
+    for ( auto it = allocations.begin(); it != allocations.end(); ++it )
+    {
+        Range& allocation = m_Allocations[it->second];
+        if ( allocation.Offset != offset )
+        {
+            Move move = { it->second, allocation.Offset, offset, allocation.Size };
+            moves.push_back( move );
+            allocation.Offset = offset;
+        }
+        offset += allocation.Size;
+    }
+
+    m_FreeRanges.clear();
+    m_FreeRangesBySize.clear();
+    if ( offset < m_Capacity )
+    {
+        AddFreeRange( offset, m_Capacity - offset );
+    }
+}
+
+UINT OffsetAllocator::get_Capacity() const
+{
+    return m_Capacity;
+}
+
+UINT OffsetAllocator::get_UsedSize() const
+{
+    return m_UsedSize;
+}
+
+UINT OffsetAllocator::get_FreeSize() const
+{
+    return m_Capacity - m_UsedSize;
+}
+
+UINT OffsetAllocator::get_LargestFreeRange() const
+{
+    return m_FreeRangesBySize.empty() ? 0 : m_FreeRangesBySize.rbegin()->first;
+}
+
+UINT OffsetAllocator::get_FreeRangeCount() const
+{
+    return static_cast<UINT>( m_FreeRanges.size() );
+}
+
+UINT OffsetAllocator::get_AllocationCount() const
+{
+    return m_AllocationCount;
+}
@@ -0,0 +1,192 @@
+#include <DirectXTemplateLibPCH.h>
+#include <PackedVertex.h>
+
+using namespace DirectX;
+using namespace DirectX::PackedVector;
+
+// The position is declared as a 4 component format because there is no 3 component 16-bit format.
+// The shaders can still declare it as float3.
+const D3D11_INPUT_ELEMENT_DESC VertexPositionNormalTextureHalf::InputElements[] =
+{
+    { "POSITION",   0, DXGI_FORMAT_R16G16B16A16_FLOAT,  0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+    { "NORMAL",     0, DXGI_FORMAT_R16G16_SNORM,        0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+    { "TEXCOORD",   0, DXGI_FORMAT_R16G16_FLOAT,        0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+};
+
+const D3D11_INPUT_ELEMENT_DESC VertexPositionNormalTextureUnorm16::InputElements[] =
+{
+    { "POSITION",   0, DXGI_FORMAT_R16G16B16A16_UNORM,  0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+    { "NORMAL",     0, DXGI_FORMAT_R16G16_SNORM,        0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+    { "TEXCOORD",   0, DXGI_FORMAT_R16G16_FLOAT,        0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+};
+
+static_assert( sizeof(VertexPositionNormalTextureHalf) == 16, "Unexpected size of packed vertex." );
+static_assert( sizeof(VertexPositionNormalTextureUnorm16) == 16, "Unexpected size of packed vertex." );
+
+// Compute the axis-aligned bounding box of the vertex positions.
+static void ComputeBounds( const VertexCollection& vertices, XMVECTOR& minPosition, XMVECTOR& maxPosition )
+{
+    if ( vertices.empty() )
+    {
+        minPosition = maxPosition = XMVectorZero();
+        return;
+    }
+
+    minPosition = g_XMFltMax;
+    maxPosition = -g_XMFltMax;
+    for ( auto it = vertices.begin(); it != vertices.end(); ++it )
+    {
+        XMVECTOR position = XMLoadFloat3( &it->position );
+        minPosition = XMVectorMin( minPosition, position );
+        maxPosition = XMVectorMax( maxPosition, position );
+    }
+}
+
+PositionQuantization ComputeHalfQuantization( const VertexCollection& vertices )
+{
+    XMVECTOR minPosition, maxPosition;
+    ComputeBounds( vertices, minPosition, maxPosition );
+
+    PositionQuantization quantization;
+    quantization.Scale = XMFLOAT3( 1.0f, 1.0f, 1.0f );
+    XMStoreFloat3( &quantization.Offset, ( minPosition + maxPosition ) * 0.5f );
+
+    return quantization;
+}
+
+PositionQuantization ComputeUnorm16Quantization( const VertexCollection& vertices )
+{
+    XMVECTOR minPosition, maxPosition;
+    ComputeBounds( vertices, minPosition, maxPosition );
+
+    // Avoid a division by zero for flat meshes.
+    XMVECTOR size = maxPosition - minPosition;
+    size = XMVectorSelect( size, g_XMOne, XMVectorEqual( size, XMVectorZero() ) );
+
+    PositionQuantization quantization;
+    XMStoreFloat3( &quantization.Scale, size );
+    XMStoreFloat3( &quantization.Offset, minPosition );
+
+    return quantization;
+}
+
+// Returns -1 for negative values and 1 otherwise.
+static float SignNotZero( float value )
+{
+    return ( value < 0.0f ) ? -1.0f : 1.0f;
+}
+
+// Map a point on the octahedron to the unit square (or back). The lower hemisphere
+// is folded over the diagonals of the upper hemisphere.
+static void OctahedralWrap( float& x, float& y )
+{
+    float wrappedX = ( 1.0f - std::abs( y ) ) * SignNotZero( x );
+    float wrappedY = ( 1.0f - std::abs( x ) ) * SignNotZero( y );
+    x = wrappedX;
+    y = wrappedY;
+}
+
+static XMVECTOR DecodeOctahedral( float x, float y )
+{
+    float z = 1.0f - std::abs( x ) - std::abs( y );
+    if ( z < 0.0f )
+    {
+        OctahedralWrap( x, y );
+    }
+
+    return XMVector3Normalize( XMVectorSet( x, y, z, 0.0f ) );
+}
+
+// The range of a 16-bit normalized value (-32768 and -32767 both map to -1).
+static const float SnormScale = 32767.0f;
+
+XMSHORTN2 XM_CALLCONV EncodeOctahedralNormal( FXMVECTOR normal )
+{
+    XMFLOAT3 n;
+    XMStoreFloat3( &n, normal );
+
+    // Project the normal onto the octahedron |x| + |y| + |z| = 1.
+    float invL1Norm = 1.0f / ( std::abs( n.x ) + std::abs( n.y ) + std::abs( n.z ) );
+    float x = n.x * invL1Norm;
+    float y = n.y * invL1Norm;
+    if ( n.z < 0.0f )
+    {
+        OctahedralWrap( x, y );
+    }
+
+    // Rounding each component to the nearest value does not always produce the closest
+    // normal, so test all combinations of rounding down and up.
+    float floorX = std::floor( x * SnormScale );
+    float floorY = std::floor( y * SnormScale );
+
+    XMSHORTN2 bestEncoding( static_cast<short>( floorX ), static_cast<short>( floorY ) );
+    float bestDot = -FLT_MAX;
+
+    for ( int i = 0; i < 4; ++i )
+    {
+        float encodedX = std::min( std::max( floorX + ( i & 1 ), -SnormScale ), SnormScale );
+        float encodedY = std::min( std::max( floorY + ( i >> 1 ), -SnormScale ), SnormScale );
+
+        XMVECTOR decoded = DecodeOctahedral( encodedX / SnormScale, encodedY / SnormScale );
+        float dot = XMVectorGetX( XMVector3Dot( decoded, normal ) );
+        if ( dot > bestDot )
+        {
+            bestDot = dot;
+            bestEncoding.x = static_cast<short>( encodedX );
+            bestEncoding.y = static_cast<short>( encodedY );
+        }
+    }
+
+    return bestEncoding;
+}
+
+XMVECTOR XM_CALLCONV DecodeOctahedralNormal( const XMSHORTN2& encodedNormal )
+{
+    XMFLOAT2 encoded;
+    XMStoreFloat2( &encoded, XMLoadShortN2( &encodedNormal ) );
+
+    return DecodeOctahedral( encoded.x, encoded.y );
+}
+
+// Apply the inverse of the position quantization.
+static XMVECTOR QuantizePosition( const XMFLOAT3& position, const PositionQuantization& quantization )
+{
+    XMVECTOR p = XMLoadFloat3( &position ) - XMLoadFloat3( &quantization.Offset );
+    return XMVectorSetW( p / XMLoadFloat3( &quantization.Scale ), 1.0f );
+}
+
+static XMFLOAT3 XM_CALLCONV DequantizePosition( FXMVECTOR position, const PositionQuantization& quantization )
+{
+    XMFLOAT3 p;
+    XMStoreFloat3( &p, XMVectorMultiplyAdd( position, XMLoadFloat3( &quantization.Scale ), XMLoadFloat3( &quantization.Offset ) ) );
+    return p;
+}
+
+void EncodeVertex( const VertexPositionNormalTexture& vertex, const PositionQuantization& quantization, VertexPositionNormalTextureHalf& packedVertex )
+{
+    XMStoreHalf4( &packedVertex.position, QuantizePosition( vertex.position, quantization ) );
+    packedVertex.normal = EncodeOctahedralNormal( XMLoadFloat3( &vertex.normal ) );
+    XMStoreHalf2( &packedVertex.textureCoordinate, XMLoadFloat2( &vertex.textureCoordinate ) );
+}
+
+void EncodeVertex( const VertexPositionNormalTexture& vertex, const PositionQuantization& quantization, VertexPositionNormalTextureUnorm16& packedVertex )
+{
+    // XMStoreUShortN4 saturates and rounds to the nearest representable value.
+    XMStoreUShortN4( &packedVertex.position, QuantizePosition( vertex.position, quantization ) );
+    packedVertex.normal = EncodeOctahedralNormal( XMLoadFloat3( &vertex.normal ) );
+    XMStoreHalf2( &packedVertex.textureCoordinate, XMLoadFloat2( &vertex.textureCoordinate ) );
+}
+
+void DecodeVertex( const VertexPositionNormalTextureHalf& packedVertex, const PositionQuantization& quantization, VertexPositionNormalTexture& vertex )
+{
+    vertex.position = DequantizePosition( XMLoadHalf4( &packedVertex.position ), quantization );
+    XMStoreFloat3( &vertex.normal, DecodeOctahedralNormal( packedVertex.normal ) );
+    XMStoreFloat2( &vertex.textureCoordinate, XMLoadHalf2( &packedVertex.textureCoordinate ) );
+}
+
+void DecodeVertex( const VertexPositionNormalTextureUnorm16& packedVertex, const PositionQuantization& quantization, VertexPositionNormalTexture& vertex )
+{
+    vertex.position = DequantizePosition( XMLoadUShortN4( &packedVertex.position ), quantization );
+    XMStoreFloat3( &vertex.normal, DecodeOctahedralNormal( packedVertex.normal ) );
+    XMStoreFloat2( &vertex.textureCoordinate, XMLoadHalf2( &packedVertex.textureCoordinate ) );
+}
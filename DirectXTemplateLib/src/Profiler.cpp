@@ -0,0 +1,224 @@
+#include <DirectXTemplateLibPCH.h>
+#include <Profiler.h>
+
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+
+struct ProfilerEvent
+{
+    const char* Name;
+    int64_t StartTime;
+    int64_t EndTime;
+};
+
+// The ring buffer of a single thread. Only the owning thread writes events. An event is
+// visible to readers after WriteIndex has been incremented past it.
+struct ProfilerThreadBuffer
+{
+    ProfilerThreadBuffer()
+        : ThreadId( GetCurrentThreadId() )
+        , ThreadName( nullptr )
+        , Events( Profiler::EventsPerThread )
+        , WriteIndex( 0 )
+        , ReadIndex( 0 )
+    {}
+
+    DWORD ThreadId;
+    std::atomic<const char*> ThreadName;
+    std::vector<ProfilerEvent> Events;
+    // The number of events that have been written.
+    std::atomic<uint64_t> WriteIndex;
+    // Events before this index have been cleared.
+    std::atomic<uint64_t> ReadIndex;
+};
+
+// The buffers are never released so the events of threads that have exited can still be exported.
+struct ProfilerThreadBufferList
+{
+    std::mutex Mutex;
+    std::vector<std::unique_ptr<ProfilerThreadBuffer>> Buffers;
+};
+
+static ProfilerThreadBufferList& get_ThreadBufferList()
+{
+    static ProfilerThreadBufferList threadBufferList;
+    return threadBufferList;
+}
+
+static thread_local ProfilerThreadBuffer* t_ThreadBuffer = nullptr;
+
+static ProfilerThreadBuffer& get_ThreadBuffer()
+{
+    if ( !t_ThreadBuffer )
+    {
+        ProfilerThreadBufferList& list = get_ThreadBufferList();
+        std::lock_guard<std::mutex> lock( list.Mutex );
+
+        list.Buffers.emplace_back( new ProfilerThreadBuffer() );
+        t_ThreadBuffer = list.Buffers.back().get();
+    }
+
+    return *t_ThreadBuffer;
+}
+
+static std::atomic<bool> g_ProfilerEnabled( true );
+
+void Profiler::set_Enabled( bool enabled )
+{
+    g_ProfilerEnabled.store( enabled, std::memory_order_relaxed );
+}
+
+bool Profiler::get_Enabled()
+{
+    return g_ProfilerEnabled.load( std::memory_order_relaxed );
+}
+
+void Profiler::set_ThreadName( const char* name )
+{
+    get_ThreadBuffer().ThreadName.store( name, std::memory_order_relaxed );
+}
+
+int64_t Profiler::BeginScope()
+{
+    if ( !get_Enabled() )
+    {
+        return 0;
+    }
+
+    LARGE_INTEGER currentTime;
+    QueryPerformanceCounter( &currentTime );
+    return currentTime.QuadPart;
+}
+
+void Profiler::EndScope( const char* name, int64_t startTime )
+{
+    LARGE_INTEGER currentTime;
+    QueryPerformanceCounter( &currentTime );
+
+    ProfilerThreadBuffer& buffer = get_ThreadBuffer();
+    uint64_t writeIndex = buffer.WriteIndex.load( std::memory_order_relaxed );
+
+    ProfilerEvent& event = buffer.Events[writeIndex % EventsPerThread];
+    event.Name = name;
+    event.StartTime = startTime;
+    event.EndTime = currentTime.QuadPart;
+
+    buffer.WriteIndex.store( writeIndex + 1, std::memory_order_release );
+}
+
+void Profiler::Clear()
+{
+    ProfilerThreadBufferList& list = get_ThreadBufferList();
+    std::lock_guard<std::mutex> lock( list.Mutex );
+
+    for ( auto& buffer : list.Buffers )
+    {
+        buffer->ReadIndex.store( buffer->WriteIndex.load( std::memory_order_acquire ), std::memory_order_relaxed );
+    }
+}
+
+// Write a string literal with the characters that JSON does not allow in strings replaced.
+static void WriteJsonString( std::ostream& stream, const char* string )
+{
+    stream << '"';
+    for ( const char* c = string; *c; ++c )
+    {
+        if ( *c == '"' || *c == '\\' )
+        {
+            stream << '\\' << *c;
+        }
+        else if ( static_cast<unsigned char>( *c ) >= 0x20 )
+        {
+            stream << *c;
+        }
+    }
+    stream << '"';
+}
+
+bool Profiler::SaveChromeTrace( const std::wstring& fileName )
+{
+    std::ofstream file( fileName );
+    if ( !file )
+    {
+        return false;
+    }
+
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency( &frequency );
+    const double microsecondsPerTick = 1000000.0 / frequency.QuadPart;
+
+    DWORD processId = GetCurrentProcessId();
+
+    ProfilerThreadBufferList& list = get_ThreadBufferList();
+    std::lock_guard<std::mutex> lock( list.Mutex );
+
+    // Copy the events of each thread first, so the time stamps can be made relative to the first event.
+    std::vector<std::vector<ProfilerEvent>> threadEvents( list.Buffers.size() );
+    int64_t firstTime = INT64_MAX;
+
+    for ( size_t i = 0; i < list.Buffers.size(); ++i )
+    {
+        ProfilerThreadBuffer& buffer = *list.Buffers[i];
+        std::vector<ProfilerEvent>& events = threadEvents[i];
+
+        uint64_t writeIndex = buffer.WriteIndex.load( std::memory_order_acquire );
+        uint64_t readIndex = std::max( buffer.ReadIndex.load( std::memory_order_relaxed ),
+            ( writeIndex > EventsPerThread ) ? writeIndex - EventsPerThread : 0 );
+
+        for ( uint64_t index = readIndex; index < writeIndex; ++index )
+        {
+            events.push_back( buffer.Events[index % EventsPerThread] );
+        }
+
+        // The owning thread keeps writing while the events are copied. Drop the
+        // events whose slots may have been reused during the copy.
+        uint64_t newWriteIndex = buffer.WriteIndex.load( std::memory_order_acquire );
+        if ( newWriteIndex > readIndex + EventsPerThread )
+        {
+            size_t overwritten = static_cast<size_t>( std::min<uint64_t>( newWriteIndex - EventsPerThread - readIndex, events.size() ) );
+            events.erase( events.begin(), events.begin() + overwritten );
+        }
+
+        for ( const ProfilerEvent& event : events )
+        {
+            firstTime = std::min( firstTime, event.StartTime );
+        }
+    }
+
+    // Time stamps are in microseconds.
+    file << std::fixed << std::setprecision( 3 );
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    bool firstEvent = true;
+    for ( size_t i = 0; i < list.Buffers.size(); ++i )
+    {
+        const ProfilerThreadBuffer& buffer = *list.Buffers[i];
+
+        const char* threadName = buffer.ThreadName.load( std::memory_order_relaxed );
+        if ( threadName )
+        {
+            file << ( firstEvent ? "" : ",\n" ) << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << processId
+                 << ",\"tid\":" << buffer.ThreadId << ",\"args\":{\"name\":";
+            WriteJsonString( file, threadName );
+            file << "}}";
+            firstEvent = false;
+        }
+
+        for ( const ProfilerEvent& event : threadEvents[i] )
+        {
+            file << ( firstEvent ? "" : ",\n" ) << "{\"name\":";
+            WriteJsonString( file, event.Name );
+            file << ",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":" << processId << ",\"tid\":" << buffer.ThreadId
+                 << ",\"ts\":" << ( event.StartTime - firstTime ) * microsecondsPerTick
+                 << ",\"dur\":" << ( event.EndTime - event.StartTime ) * microsecondsPerTick << "}";
+            firstEvent = false;
+        }
+    }
+
+    file << "\n]}\n";
+
+    return static_cast<bool>( file );
+}
@@ -0,0 +1,93 @@
+#include <DirectXTemplateLibPCH.h>
+#include <RecordingDeviceContext.h>
+
+#include <iomanip>
+
+RecordingDeviceContext::RecordingDeviceContext( ID3D11DeviceContext* context )
+    : DeviceContextWrapper( context )
+{
+    Reset();
+}
+
+uint64_t RecordingDeviceContext::get_CallCount( Call call ) const
+{
+    assert( call >= 0 && call < CallCount );
+    return m_CallCounts[call];
+}
+
+uint64_t RecordingDeviceContext::get_TotalCallCount() const
+{
+    uint64_t totalCallCount = 0;
+    for ( uint64_t callCount : m_CallCounts )
+    {
+        totalCallCount += callCount;
+    }
+
+    return totalCallCount;
+}
+
+uint64_t RecordingDeviceContext::get_DrawnVertexCount() const
+{
+    return m_DrawnVertexCount;
+}
+
+void RecordingDeviceContext::Reset()
+{
+    std::fill( m_CallCounts, m_CallCounts + CallCount, 0 );
+    m_DrawnVertexCount = 0;
+}
+
+void RecordingDeviceContext::Print( std::ostream& stream, uint64_t frameCount ) const
+{
+    frameCount = std::max<uint64_t>( frameCount, 1 );
+
+    stream << std::left << std::setw( 44 ) << "Call" << std::right << std::setw( 12 ) << "Count" << std::setw( 12 ) << "Per frame" << std::endl;
+
+    stream << std::fixed << std::setprecision( 1 );
+    for ( int call = 0; call < CallCount; ++call )
+    {
+        if ( m_CallCounts[call] > 0 )
+        {
+            stream << std::left << std::setw( 44 ) << get_CallName( static_cast<Call>( call ) ) << std::right
+                   << std::setw( 12 ) << m_CallCounts[call]
+                   << std::setw( 12 ) << m_CallCounts[call] / static_cast<double>( frameCount ) << std::endl;
+        }
+    }
+
+    uint64_t totalCallCount = get_TotalCallCount();
+    stream << std::left << std::setw( 44 ) << "Total" << std::right
+           << std::setw( 12 ) << totalCallCount
+           << std::setw( 12 ) << totalCallCount / static_cast<double>( frameCount ) << std::endl;
+    stream << std::left << std::setw( 44 ) << "Drawn vertices" << std::right
+           << std::setw( 12 ) << m_DrawnVertexCount
+           << std::setw( 12 ) << m_DrawnVertexCount / static_cast<double>( frameCount ) << std::endl;
+}
+
+void RecordingDeviceContext::OnCall( Call call )
+{
+    ++m_CallCounts[call];
+}
+
+void STDMETHODCALLTYPE RecordingDeviceContext::Draw( UINT VertexCount, UINT StartVertexLocation )
+{
+    m_DrawnVertexCount += VertexCount;
+    DeviceContextWrapper::Draw( VertexCount, StartVertexLocation );
+}
+
+void STDMETHODCALLTYPE RecordingDeviceContext::DrawIndexed( UINT IndexCount, UINT StartIndexLocation, INT BaseVertexLocation )
+{
+    m_DrawnVertexCount += IndexCount;
+    DeviceContextWrapper::DrawIndexed( IndexCount, StartIndexLocation, BaseVertexLocation );
+}
+
+void STDMETHODCALLTYPE RecordingDeviceContext::DrawInstanced( UINT VertexCountPerInstance, UINT InstanceCount, UINT StartVertexLocation, UINT StartInstanceLocation )
+{
+    m_DrawnVertexCount += static_cast<uint64_t>( VertexCountPerInstance ) * InstanceCount;
+    DeviceContextWrapper::DrawInstanced( VertexCountPerInstance, InstanceCount, StartVertexLocation, StartInstanceLocation );
+}
+
+void STDMETHODCALLTYPE RecordingDeviceContext::DrawIndexedInstanced( UINT IndexCountPerInstance, UINT InstanceCount, UINT StartIndexLocation, INT BaseVertexLocation, UINT StartInstanceLocation )
+{
+    m_DrawnVertexCount += static_cast<uint64_t>( IndexCountPerInstance ) * InstanceCount;
+    DeviceContextWrapper::DrawIndexedInstanced( IndexCountPerInstance, InstanceCount, StartIndexLocation, BaseVertexLocation, StartInstanceLocation );
+}
@@ -0,0 +1,221 @@
+#include <DirectXTemplateLibPCH.h>
+#include <RenderQueue.h>
+#include <Profiler.h>
+
+static const uint64_t LayerMask = ( 1ull << RenderKey::LayerBits ) - 1;
+static const uint64_t ShaderMask = ( 1ull << RenderKey::ShaderBits ) - 1;
+static const uint64_t MaterialMask = ( 1ull << RenderKey::MaterialBits ) - 1;
+static const uint64_t MeshMask = ( 1ull << RenderKey::MeshBits ) - 1;
+static const uint64_t DepthMask = ( 1ull << RenderKey::DepthBits ) - 1;
+
+// The position of the translucency bit. The layer is above it.
+static const UINT TranslucentShift = RenderKey::ShaderBits + RenderKey::MaterialBits + RenderKey::MeshBits + RenderKey::DepthBits;
+static const UINT LayerShift = TranslucentShift + 1;
+
+static_assert( LayerShift + RenderKey::LayerBits == 64, "The fields of a render key must use 64 bits." );
+
+RenderKey::RenderKey()
+    : Layer( 0 )
+    , Translucent( false )
+    , Shader( 0 )
+    , Material( 0 )
+    , Mesh( 0 )
+    , Depth( 0 )
+{}
+
+RenderKey::RenderKey( UINT layer, bool translucent, UINT shader, UINT material, UINT mesh, UINT depth )
+    : Layer( layer )
+    , Translucent( translucent )
+    , Shader( shader )
+    , Material( material )
+    , Mesh( mesh )
+    , Depth( depth )
+{}
+
+uint64_t RenderKey::Pack() const
+{
+    assert( Layer <= LayerMask && Shader <= ShaderMask && Material <= MaterialMask && Mesh <= MeshMask && Depth <= DepthMask );
+
+    uint64_t key = ( static_cast<uint64_t>( Layer ) << LayerShift ) | ( static_cast<uint64_t>( Translucent ) << TranslucentShift );
+
+    if ( Translucent )
+    {
+        // Back to front: the farthest depth gets the smallest key.
+        key |= ( DepthMask - Depth ) << ( ShaderBits + MaterialBits + MeshBits );
+        key |= static_cast<uint64_t>( Shader ) << ( MaterialBits + MeshBits );
+        key |= static_cast<uint64_t>( Material ) << MeshBits;
+        key |= Mesh;
+    }
+    else
+    {
+        key |= static_cast<uint64_t>( Shader ) << ( MaterialBits + MeshBits + DepthBits );
+        key |= static_cast<uint64_t>( Material ) << ( MeshBits + DepthBits );
+        key |= static_cast<uint64_t>( Mesh ) << DepthBits;
+        key |= Depth;
+    }
+
+    return key;
+}
+
+RenderKey RenderKey::Unpack( uint64_t key )
+{
+    RenderKey renderKey;
+    renderKey.Layer = static_cast<UINT>( ( key >> LayerShift ) & LayerMask );
+    renderKey.Translucent = ( ( key >> TranslucentShift ) & 1 ) != 0;
+
+    if ( renderKey.Translucent )
+    {
+        renderKey.Depth = static_cast<UINT>( DepthMask - ( ( key >> ( ShaderBits + MaterialBits + MeshBits ) ) & DepthMask ) );
+        renderKey.Shader = static_cast<UINT>( ( key >> ( MaterialBits + MeshBits ) ) & ShaderMask );
+        renderKey.Material = static_cast<UINT>( ( key >> MeshBits ) & MaterialMask );
+        renderKey.Mesh = static_cast<UINT>( key & MeshMask );
+    }
+    else
+    {
+        renderKey.Shader = static_cast<UINT>( ( key >> ( MaterialBits + MeshBits + DepthBits ) ) & ShaderMask );
+        renderKey.Material = static_cast<UINT>( ( key >> ( MeshBits + DepthBits ) ) & MaterialMask );
+        renderKey.Mesh = static_cast<UINT>( ( key >> DepthBits ) & MeshMask );
+        renderKey.Depth = static_cast<UINT>( key & DepthMask );
+    }
+
+    return renderKey;
+}
+
+unsigned int RenderKey::get_Changes( uint64_t previousKey, uint64_t key )
+{
+    RenderKey previous = Unpack( previousKey );
+    RenderKey current = Unpack( key );
+
+    unsigned int changes = NoChanges;
+    changes |= ( previous.Layer != current.Layer ) ? LayerChanged : NoChanges;
+    changes |= ( previous.Translucent != current.Translucent ) ? TranslucencyChanged : NoChanges;
+    changes |= ( previous.Shader != current.Shader ) ? ShaderChanged : NoChanges;
+    changes |= ( previous.Material != current.Material ) ? MaterialChanged : NoChanges;
+    changes |= ( previous.Mesh != current.Mesh ) ? MeshChanged : NoChanges;
+
+    return changes;
+}
+
+UINT RenderKey::QuantizeDepth( float depth )
+{
+    if ( !( depth > 0.0f ) )
+    {
+        return 0;
+    }
+
+    // The bits of positive floats are ordered like the floats. Keep the exponent and the upper mantissa bits.
+    uint32_t bits;
+    memcpy( &bits, &depth, sizeof(bits) );
+
+    return static_cast<UINT>( bits >> ( 31 - DepthBits ) );
+}
+
+RenderQueue::RenderQueue()
+    : m_SortPassCount( 0 )
+{}
+
+void RenderQueue::Clear()
+{
+    m_Items.clear();
+}
+
+void RenderQueue::Reserve( size_t itemCount )
+{
+    m_Items.reserve( itemCount );
+    m_SortBuffer.reserve( itemCount );
+}
+
+void RenderQueue::Submit( uint64_t key, UINT data )
+{
+    RenderItem item = { key, data };
+    m_Items.push_back( item );
+}
+
+void RenderQueue::Submit( const RenderKey& key, UINT data )
+{
+    Submit( key.Pack(), data );
+}
+
+void RenderQueue::Sort()
+{
+    PROFILE_FUNCTION();
+
+    m_SortPassCount = 0;
+
+    const size_t itemCount = m_Items.size();
+    if ( itemCount < 2 )
+    {
+        return;
+    }
+
+    // Count the bytes of all keys with a single pass over the items.
+    memset( m_Histograms, 0, sizeof(m_Histograms) );
+    for ( const RenderItem& item : m_Items )
+    {
+        uint64_t key = item.Key;
+        for ( UINT byte = 0; byte < 8; ++byte )
+        {
+            ++m_Histograms[byte][( key >> ( byte * 8 ) ) & 0xFF];
+        }
+    }
+
+    m_SortBuffer.resize( itemCount );
+    RenderItem* source = m_Items.data();
+    RenderItem* destination = m_SortBuffer.data();
+
+    for ( UINT byte = 0; byte < 8; ++byte )
+    {
+        size_t* histogram = m_Histograms[byte];
+        const UINT shift = byte * 8;
+
+        // All keys have the same byte, the pass would not change the order.
+        if ( histogram[( source[0].Key >> shift ) & 0xFF] == itemCount )
+        {
+            continue;
+        }
+
+        // Turn the counts into the offsets of the buckets.
+        size_t offset = 0;
+        for ( UINT bucket = 0; bucket < 256; ++bucket )
+        {
+            size_t count = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += count;
+        }
+
+        for ( size_t i = 0; i < itemCount; ++i )
+        {
+            destination[histogram[( source[i].Key >> shift ) & 0xFF]++] = source[i];
+        }
+
+        std::swap( source, destination );
+        ++m_SortPassCount;
+    }
+
+    // The sorted items end up in the sort buffer after an odd number of passes.
+    if ( source != m_Items.data() )
+    {
+        m_Items.swap( m_SortBuffer );
+    }
+}
+
+void RenderQueue::Dispatch( const DispatchFunction& dispatch ) const
+{
+    PROFILE_FUNCTION();
+
+    for ( size_t i = 0; i < m_Items.size(); ++i )
+    {
+        unsigned int changes = ( i == 0 ) ? RenderKey::AllChanged : RenderKey::get_Changes( m_Items[i - 1].Key, m_Items[i].Key );
+        dispatch( m_Items[i], changes );
+    }
+}
+
+const std::vector<RenderItem>& RenderQueue::get_Items() const
+{
+    return m_Items;
+}
+
+UINT RenderQueue::get_SortPassCount() const
+{
+    return m_SortPassCount;
+}
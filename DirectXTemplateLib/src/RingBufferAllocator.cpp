@@ -0,0 +1,118 @@
+#include <DirectXTemplateLibPCH.h>
+#include <RingBufferAllocator.h>
+
+RingBufferAllocator::RingBufferAllocator( UINT capacity )
+    : m_Capacity( capacity )
+    , m_Head( 0 )
+    , m_Tail( 0 )
+    , m_AllocatedSize( 0 )
+    , m_ReleasedSize( 0 )
+{}
+
+UINT RingBufferAllocator::Allocate( UINT size, UINT alignment, bool& discard )
+{
+    assert( size > 0 );
+    assert( alignment > 0 && ( alignment & ( alignment - 1 ) ) == 0 && "The alignment must be a power of 2." );
+
+    discard = false;
+
+    if ( size > m_Capacity )
+    {
+        return InvalidOffset;
+    }
+
+    if ( get_UsedSize() == 0 )
+    {
+        // Start at the beginning of the ring, so the allocations of a frame are less likely to wrap around.
+        // The frames that are still queued have no ranges left, so they can be dropped with their offsets.
+        Discard();
+    }
+
+    uint64_t alignedHead = ( static_cast<uint64_t>( m_Head ) + alignment - 1 ) & ~static_cast<uint64_t>( alignment - 1 );
+    uint64_t offset = 0;
+
+    if ( m_Head >= m_Tail && get_UsedSize() < m_Capacity )
+    {
+        // The free space is after the head and before the tail.
+        if ( alignedHead + size <= m_Capacity )
+        {
+            offset = alignedHead;
+        }
+        else if ( size <= m_Tail )
+        {
+            // Wrap around to the beginning of the ring.
+            offset = 0;
+        }
+        else
+        {
+            discard = true;
+        }
+    }
+    else
+    {
+        // The ring has wrapped around, the free space is between the head and the tail.
+        if ( alignedHead + size <= m_Tail )
+        {
+            offset = alignedHead;
+        }
+        else
+        {
+            discard = true;
+        }
+    }
+
+    if ( discard )
+    {
+        Discard();
+        offset = 0;
+    }
+
+    // The bytes between the head and the range (the alignment padding or the skipped
+    // end of the ring) are released together with the range.
+    uint64_t skippedSize = ( offset >= m_Head ) ? offset - m_Head : m_Capacity - m_Head;
+
+    m_AllocatedSize += skippedSize + size;
+    m_Head = static_cast<UINT>( offset ) + size;
+
+    return static_cast<UINT>( offset );
+}
+
+void RingBufferAllocator::FinishFrame( uint64_t fenceValue )
+{
+    assert( m_Frames.empty() || fenceValue > m_Frames.back().FenceValue );
+
+    Frame frame = { fenceValue, m_Head, m_AllocatedSize };
+    m_Frames.push_back( frame );
+}
+
+void RingBufferAllocator::ReleaseFrames( uint64_t completedFenceValue )
+{
+    while ( !m_Frames.empty() && m_Frames.front().FenceValue <= completedFenceValue )
+    {
+        m_Tail = m_Frames.front().EndOffset;
+        m_ReleasedSize = m_Frames.front().AllocatedSize;
+        m_Frames.pop_front();
+    }
+}
+
+void RingBufferAllocator::Discard()
+{
+    m_Frames.clear();
+    m_Head = m_Tail = 0;
+    m_ReleasedSize = m_AllocatedSize;
+}
+
+UINT RingBufferAllocator::get_Capacity() const
+{
+    return m_Capacity;
+}
+
+UINT RingBufferAllocator::get_UsedSize() const
+{
+    return static_cast<UINT>( m_AllocatedSize - m_ReleasedSize );
+}
+
+UINT RingBufferAllocator::get_FrameCount() const
+{
+    return static_cast<UINT>( m_Frames.size() );
+}
@@ -0,0 +1,740 @@
+#include <DirectXTemplateLibPCH.h>
+#include <StateFilteringDeviceContext.h>
+
+#include <iomanip>
+
+// Compare the values of a call with the shadowed values of the slots [startSlot, startSlot + numValues)
+// and shadow the values. first and count are set to the range of values that changed.
+// Returns false if no value changed.
+template<typename Slot, typename GetValue>
+static bool FilterSlots( Slot* slots, UINT slotCount, UINT startSlot, UINT numValues, GetValue getValue, UINT& first, UINT& count )
+{
+    first = 0;
+    count = numValues;
+
+    if ( startSlot > slotCount || numValues > slotCount - startSlot )
+    {
+        // Forward the call unchanged, so the runtime reports the invalid slots.
+        return true;
+    }
+
+    UINT end = 0;
+    first = numValues;
+    for ( UINT i = 0; i < numValues; ++i )
+    {
+        Slot& slot = slots[startSlot + i];
+        auto value = getValue( i );
+        if ( !slot.Known || !( slot.Value == value ) )
+        {
+            slot.Value = value;
+            slot.Known = true;
+            first = std::min( first, i );
+            end = i + 1;
+        }
+    }
+
+    if ( end == 0 )
+    {
+        first = 0;
+        count = 0;
+        return false;
+    }
+
+    count = end - first;
+    return true;
+}
+
+// Forget the shadowed values of the slots [startSlot, startSlot + numSlots).
+template<typename Slot>
+static void ForgetSlots( Slot* slots, UINT slotCount, UINT startSlot, UINT numSlots )
+{
+    for ( UINT i = startSlot; i < slotCount && i - startSlot < numSlots; ++i )
+    {
+        slots[i].Known = false;
+    }
+}
+
+// Offset an optional array of a call that is narrowed to the slots that changed.
+template<typename T>
+static T* Advance( T* pValues, UINT first )
+{
+    return pValues ? pValues + first : nullptr;
+}
+
+bool StateFilteringDeviceContext::VertexBufferBinding::operator==( const VertexBufferBinding& other ) const
+{
+    return Buffer == other.Buffer && Stride == other.Stride && Offset == other.Offset;
+}
+
+bool StateFilteringDeviceContext::IndexBufferBinding::operator==( const IndexBufferBinding& other ) const
+{
+    return Buffer == other.Buffer && Format == other.Format && Offset == other.Offset;
+}
+
+bool StateFilteringDeviceContext::ConstantBufferBinding::operator==( const ConstantBufferBinding& other ) const
+{
+    return Buffer == other.Buffer && FirstConstant == other.FirstConstant && NumConstants == other.NumConstants;
+}
+
+bool StateFilteringDeviceContext::BlendStateBinding::operator==( const BlendStateBinding& other ) const
+{
+    return BlendState == other.BlendState && SampleMask == other.SampleMask &&
+        BlendFactor[0] == other.BlendFactor[0] && BlendFactor[1] == other.BlendFactor[1] &&
+        BlendFactor[2] == other.BlendFactor[2] && BlendFactor[3] == other.BlendFactor[3];
+}
+
+bool StateFilteringDeviceContext::DepthStencilStateBinding::operator==( const DepthStencilStateBinding& other ) const
+{
+    return DepthStencilState == other.DepthStencilState && StencilRef == other.StencilRef;
+}
+
+StateFilteringDeviceContext::StateFilteringDeviceContext( ID3D11DeviceContext* context )
+    : DeviceContextWrapper( context )
+{
+    InvalidateState();
+    Reset();
+}
+
+uint64_t StateFilteringDeviceContext::get_IssuedCallCount( Call call ) const
+{
+    assert( call >= 0 && call < CallCount );
+    return m_IssuedCallCounts[call];
+}
+
+uint64_t StateFilteringDeviceContext::get_ElidedCallCount( Call call ) const
+{
+    assert( call >= 0 && call < CallCount );
+    return m_ElidedCallCounts[call];
+}
+
+uint64_t StateFilteringDeviceContext::get_TotalIssuedCallCount() const
+{
+    uint64_t totalCallCount = 0;
+    for ( uint64_t callCount : m_IssuedCallCounts )
+    {
+        totalCallCount += callCount;
+    }
+
+    return totalCallCount;
+}
+
+uint64_t StateFilteringDeviceContext::get_TotalElidedCallCount() const
+{
+    uint64_t totalCallCount = 0;
+    for ( uint64_t callCount : m_ElidedCallCounts )
+    {
+        totalCallCount += callCount;
+    }
+
+    return totalCallCount;
+}
+
+void StateFilteringDeviceContext::Reset()
+{
+    std::fill( m_IssuedCallCounts, m_IssuedCallCounts + CallCount, 0 );
+    std::fill( m_ElidedCallCounts, m_ElidedCallCounts + CallCount, 0 );
+}
+
+void StateFilteringDeviceContext::InvalidateState()
+{
+    m_State = PipelineState();
+    m_State.ViewportCount = 0;
+    m_State.ViewportsKnown = false;
+    m_State.ScissorRectCount = 0;
+    m_State.ScissorRectsKnown = false;
+}
+
+void StateFilteringDeviceContext::InvalidateInputs()
+{
+    ForgetSlots( m_State.VertexBuffers, D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT, 0, D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT );
+    m_State.IndexBuffer.Known = false;
+
+    for ( StageState& stage : m_State.Stages )
+    {
+        ForgetSlots( stage.ConstantBuffers, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT, 0, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT );
+        ForgetSlots( stage.ShaderResources, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT, 0, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT );
+    }
+}
+
+void StateFilteringDeviceContext::Print( std::ostream& stream, uint64_t frameCount ) const
+{
+    frameCount = std::max<uint64_t>( frameCount, 1 );
+
+    stream << std::left << std::setw( 44 ) << "Call" << std::right << std::setw( 12 ) << "Issued" << std::setw( 12 ) << "Elided"
+           << std::setw( 14 ) << "Issued/frame" << std::setw( 14 ) << "Elided/frame" << std::endl;
+
+    // Only the pipeline state calls are filtered.
+    uint64_t totalIssuedCallCount = 0;
+    uint64_t totalElidedCallCount = 0;
+
+    stream << std::fixed << std::setprecision( 1 );
+    for ( int call = 0; call < DrawCall; ++call )
+    {
+        if ( m_IssuedCallCounts[call] > 0 || m_ElidedCallCounts[call] > 0 )
+        {
+            stream << std::left << std::setw( 44 ) << get_CallName( static_cast<Call>( call ) ) << std::right
+                   << std::setw( 12 ) << m_IssuedCallCounts[call]
+                   << std::setw( 12 ) << m_ElidedCallCounts[call]
+                   << std::setw( 14 ) << m_IssuedCallCounts[call] / static_cast<double>( frameCount )
+                   << std::setw( 14 ) << m_ElidedCallCounts[call] / static_cast<double>( frameCount ) << std::endl;
+
+            totalIssuedCallCount += m_IssuedCallCounts[call];
+            totalElidedCallCount += m_ElidedCallCounts[call];
+        }
+    }
+
+    stream << std::left << std::setw( 44 ) << "Total" << std::right
+           << std::setw( 12 ) << totalIssuedCallCount
+           << std::setw( 12 ) << totalElidedCallCount
+           << std::setw( 14 ) << totalIssuedCallCount / static_cast<double>( frameCount )
+           << std::setw( 14 ) << totalElidedCallCount / static_cast<double>( frameCount ) << std::endl;
+}
+
+void StateFilteringDeviceContext::OnCall( Call call )
+{
+    ++m_IssuedCallCounts[call];
+}
+
+template<typename T>
+bool StateFilteringDeviceContext::FilterValue( Call call, Shadow<T>& shadow, const T& value )
+{
+    if ( shadow.Known && shadow.Value == value )
+    {
+        ++m_ElidedCallCounts[call];
+        return false;
+    }
+
+    shadow.Value = value;
+    shadow.Known = true;
+    return true;
+}
+
+bool StateFilteringDeviceContext::FilterShader( Call call, Stage stage, ID3D11DeviceChild* pShader, UINT NumClassInstances )
+{
+    Shadow<ID3D11DeviceChild*>& shader = m_State.Stages[stage].Shader;
+
+    if ( NumClassInstances > 0 )
+    {
+        // The class instances are not shadowed.
+        shader.Known = false;
+        return true;
+    }
+
+    return FilterValue( call, shader, pShader );
+}
+
+bool StateFilteringDeviceContext::FilterConstantBuffers( Call call, Stage stage, UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants, UINT& first, UINT& count )
+{
+    Shadow<ConstantBufferBinding>* slots = m_State.Stages[stage].ConstantBuffers;
+
+    if ( !ppConstantBuffers )
+    {
+        ForgetSlots( slots, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT, StartSlot, NumBuffers );
+        first = 0;
+        count = NumBuffers;
+        return true;
+    }
+
+    auto getValue = [=]( UINT i )
+    {
+        ConstantBufferBinding binding = { ppConstantBuffers[i], pFirstConstant ? pFirstConstant[i] : 0, pNumConstants ? pNumConstants[i] : 0 };
+        return binding;
+    };
+
+    if ( !FilterSlots( slots, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT, StartSlot, NumBuffers, getValue, first, count ) )
+    {
+        ++m_ElidedCallCounts[call];
+        return false;
+    }
+
+    return true;
+}
+
+bool StateFilteringDeviceContext::FilterShaderResources( Call call, Stage stage, UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews, UINT& first, UINT& count )
+{
+    Shadow<ID3D11ShaderResourceView*>* slots = m_State.Stages[stage].ShaderResources;
+
+    if ( !ppShaderResourceViews )
+    {
+        ForgetSlots( slots, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT, StartSlot, NumViews );
+        first = 0;
+        count = NumViews;
+        return true;
+    }
+
+    if ( !FilterSlots( slots, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT, StartSlot, NumViews, [=]( UINT i ) { return ppShaderResourceViews[i]; }, first, count ) )
+    {
+        ++m_ElidedCallCounts[call];
+        return false;
+    }
+
+    return true;
+}
+
+bool StateFilteringDeviceContext::FilterSamplers( Call call, Stage stage, UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers, UINT& first, UINT& count )
+{
+    Shadow<ID3D11SamplerState*>* slots = m_State.Stages[stage].Samplers;
+
+    if ( !ppSamplers )
+    {
+        ForgetSlots( slots, D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT, StartSlot, NumSamplers );
+        first = 0;
+        count = NumSamplers;
+        return true;
+    }
+
+    if ( !FilterSlots( slots, D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT, StartSlot, NumSamplers, [=]( UINT i ) { return ppSamplers[i]; }, first, count ) )
+    {
+        ++m_ElidedCallCounts[call];
+        return false;
+    }
+
+    return true;
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::IASetInputLayout( ID3D11InputLayout* pInputLayout )
+{
+    if ( FilterValue( IASetInputLayoutCall, m_State.InputLayout, pInputLayout ) )
+    {
+        DeviceContextWrapper::IASetInputLayout( pInputLayout );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::IASetVertexBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppVertexBuffers, const UINT* pStrides, const UINT* pOffsets )
+{
+    if ( !ppVertexBuffers || !pStrides || !pOffsets )
+    {
+        ForgetSlots( m_State.VertexBuffers, D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT, StartSlot, NumBuffers );
+        DeviceContextWrapper::IASetVertexBuffers( StartSlot, NumBuffers, ppVertexBuffers, pStrides, pOffsets );
+        return;
+    }
+
+    auto getValue = [=]( UINT i )
+    {
+        VertexBufferBinding binding = { ppVertexBuffers[i], pStrides[i], pOffsets[i] };
+        return binding;
+    };
+
+    UINT first, count;
+    if ( FilterSlots( m_State.VertexBuffers, D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT, StartSlot, NumBuffers, getValue, first, count ) )
+    {
+        DeviceContextWrapper::IASetVertexBuffers( StartSlot + first, count, ppVertexBuffers + first, pStrides + first, pOffsets + first );
+    }
+    else
+    {
+        ++m_ElidedCallCounts[IASetVertexBuffersCall];
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::IASetIndexBuffer( ID3D11Buffer* pIndexBuffer, DXGI_FORMAT Format, UINT Offset )
+{
+    IndexBufferBinding binding = { pIndexBuffer, Format, Offset };
+    if ( FilterValue( IASetIndexBufferCall, m_State.IndexBuffer, binding ) )
+    {
+        DeviceContextWrapper::IASetIndexBuffer( pIndexBuffer, Format, Offset );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY Topology )
+{
+    if ( FilterValue( IASetPrimitiveTopologyCall, m_State.PrimitiveTopology, Topology ) )
+    {
+        DeviceContextWrapper::IASetPrimitiveTopology( Topology );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::VSSetShader( ID3D11VertexShader* pVertexShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances )
+{
+    if ( FilterShader( VSSetShaderCall, VertexStage, pVertexShader, NumClassInstances ) )
+    {
+        DeviceContextWrapper::VSSetShader( pVertexShader, ppClassInstances, NumClassInstances );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::VSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers )
+{
+    UINT first, count;
+    if ( FilterConstantBuffers( VSSetConstantBuffersCall, VertexStage, StartSlot, NumBuffers, ppConstantBuffers, nullptr, nullptr, first, count ) )
+    {
+        DeviceContextWrapper::VSSetConstantBuffers( StartSlot + first, count, Advance( ppConstantBuffers, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::VSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants )
+{
+    UINT first, count;
+    if ( FilterConstantBuffers( VSSetConstantBuffers1Call, VertexStage, StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants, first, count ) )
+    {
+        DeviceContextWrapper::VSSetConstantBuffers1( StartSlot + first, count, Advance( ppConstantBuffers, first ), Advance( pFirstConstant, first ), Advance( pNumConstants, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::VSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews )
+{
+    UINT first, count;
+    if ( FilterShaderResources( VSSetShaderResourcesCall, VertexStage, StartSlot, NumViews, ppShaderResourceViews, first, count ) )
+    {
+        DeviceContextWrapper::VSSetShaderResources( StartSlot + first, count, Advance( ppShaderResourceViews, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::VSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers )
+{
+    UINT first, count;
+    if ( FilterSamplers( VSSetSamplersCall, VertexStage, StartSlot, NumSamplers, ppSamplers, first, count ) )
+    {
+        DeviceContextWrapper::VSSetSamplers( StartSlot + first, count, Advance( ppSamplers, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::HSSetShader( ID3D11HullShader* pHullShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances )
+{
+    if ( FilterShader( HSSetShaderCall, HullStage, pHullShader, NumClassInstances ) )
+    {
+        DeviceContextWrapper::HSSetShader( pHullShader, ppClassInstances, NumClassInstances );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::HSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers )
+{
+    UINT first, count;
+    if ( FilterConstantBuffers( HSSetConstantBuffersCall, HullStage, StartSlot, NumBuffers, ppConstantBuffers, nullptr, nullptr, first, count ) )
+    {
+        DeviceContextWrapper::HSSetConstantBuffers( StartSlot + first, count, Advance( ppConstantBuffers, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::HSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants )
+{
+    UINT first, count;
+    if ( FilterConstantBuffers( HSSetConstantBuffers1Call, HullStage, StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants, first, count ) )
+    {
+        DeviceContextWrapper::HSSetConstantBuffers1( StartSlot + first, count, Advance( ppConstantBuffers, first ), Advance( pFirstConstant, first ), Advance( pNumConstants, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::HSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews )
+{
+    UINT first, count;
+    if ( FilterShaderResources( HSSetShaderResourcesCall, HullStage, StartSlot, NumViews, ppShaderResourceViews, first, count ) )
+    {
+        DeviceContextWrapper::HSSetShaderResources( StartSlot + first, count, Advance( ppShaderResourceViews, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::HSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers )
+{
+    UINT first, count;
+    if ( FilterSamplers( HSSetSamplersCall, HullStage, StartSlot, NumSamplers, ppSamplers, first, count ) )
+    {
+        DeviceContextWrapper::HSSetSamplers( StartSlot + first, count, Advance( ppSamplers, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::DSSetShader( ID3D11DomainShader* pDomainShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances )
+{
+    if ( FilterShader( DSSetShaderCall, DomainStage, pDomainShader, NumClassInstances ) )
+    {
+        DeviceContextWrapper::DSSetShader( pDomainShader, ppClassInstances, NumClassInstances );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::DSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers )
+{
+    UINT first, count;
+    if ( FilterConstantBuffers( DSSetConstantBuffersCall, DomainStage, StartSlot, NumBuffers, ppConstantBuffers, nullptr, nullptr, first, count ) )
+    {
+        DeviceContextWrapper::DSSetConstantBuffers( StartSlot + first, count, Advance( ppConstantBuffers, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::DSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants )
+{
+    UINT first, count;
+    if ( FilterConstantBuffers( DSSetConstantBuffers1Call, DomainStage, StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants, first, count ) )
+    {
+        DeviceContextWrapper::DSSetConstantBuffers1( StartSlot + first, count, Advance( ppConstantBuffers, first ), Advance( pFirstConstant, first ), Advance( pNumConstants, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::DSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews )
+{
+    UINT first, count;
+    if ( FilterShaderResources( DSSetShaderResourcesCall, DomainStage, StartSlot, NumViews, ppShaderResourceViews, first, count ) )
+    {
+        DeviceContextWrapper::DSSetShaderResources( StartSlot + first, count, Advance( ppShaderResourceViews, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::DSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers )
+{
+    UINT first, count;
+    if ( FilterSamplers( DSSetSamplersCall, DomainStage, StartSlot, NumSamplers, ppSamplers, first, count ) )
+    {
+        DeviceContextWrapper::DSSetSamplers( StartSlot + first, count, Advance( ppSamplers, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::GSSetShader( ID3D11GeometryShader* pGeometryShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances )
+{
+    if ( FilterShader( GSSetShaderCall, GeometryStage, pGeometryShader, NumClassInstances ) )
+    {
+        DeviceContextWrapper::GSSetShader( pGeometryShader, ppClassInstances, NumClassInstances );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::GSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers )
+{
+    UINT first, count;
+    if ( FilterConstantBuffers( GSSetConstantBuffersCall, GeometryStage, StartSlot, NumBuffers, ppConstantBuffers, nullptr, nullptr, first, count ) )
+    {
+        DeviceContextWrapper::GSSetConstantBuffers( StartSlot + first, count, Advance( ppConstantBuffers, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::GSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants )
+{
+    UINT first, count;
+    if ( FilterConstantBuffers( GSSetConstantBuffers1Call, GeometryStage, StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants, first, count ) )
+    {
+        DeviceContextWrapper::GSSetConstantBuffers1( StartSlot + first, count, Advance( ppConstantBuffers, first ), Advance( pFirstConstant, first ), Advance( pNumConstants, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::GSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews )
+{
+    UINT first, count;
+    if ( FilterShaderResources( GSSetShaderResourcesCall, GeometryStage, StartSlot, NumViews, ppShaderResourceViews, first, count ) )
+    {
+        DeviceContextWrapper::GSSetShaderResources( StartSlot + first, count, Advance( ppShaderResourceViews, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::GSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers )
+{
+    UINT first, count;
+    if ( FilterSamplers( GSSetSamplersCall, GeometryStage, StartSlot, NumSamplers, ppSamplers, first, count ) )
+    {
+        DeviceContextWrapper::GSSetSamplers( StartSlot + first, count, Advance( ppSamplers, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::PSSetShader( ID3D11PixelShader* pPixelShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances )
+{
+    if ( FilterShader( PSSetShaderCall, PixelStage, pPixelShader, NumClassInstances ) )
+    {
+        DeviceContextWrapper::PSSetShader( pPixelShader, ppClassInstances, NumClassInstances );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::PSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers )
+{
+    UINT first, count;
+    if ( FilterConstantBuffers( PSSetConstantBuffersCall, PixelStage, StartSlot, NumBuffers, ppConstantBuffers, nullptr, nullptr, first, count ) )
+    {
+        DeviceContextWrapper::PSSetConstantBuffers( StartSlot + first, count, Advance( ppConstantBuffers, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::PSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants )
+{
+    UINT first, count;
+    if ( FilterConstantBuffers( PSSetConstantBuffers1Call, PixelStage, StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants, first, count ) )
+    {
+        DeviceContextWrapper::PSSetConstantBuffers1( StartSlot + first, count, Advance( ppConstantBuffers, first ), Advance( pFirstConstant, first ), Advance( pNumConstants, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::PSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews )
+{
+    UINT first, count;
+    if ( FilterShaderResources( PSSetShaderResourcesCall, PixelStage, StartSlot, NumViews, ppShaderResourceViews, first, count ) )
+    {
+        DeviceContextWrapper::PSSetShaderResources( StartSlot + first, count, Advance( ppShaderResourceViews, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::PSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers )
+{
+    UINT first, count;
+    if ( FilterSamplers( PSSetSamplersCall, PixelStage, StartSlot, NumSamplers, ppSamplers, first, count ) )
+    {
+        DeviceContextWrapper::PSSetSamplers( StartSlot + first, count, Advance( ppSamplers, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::CSSetShader( ID3D11ComputeShader* pComputeShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances )
+{
+    if ( FilterShader( CSSetShaderCall, ComputeStage, pComputeShader, NumClassInstances ) )
+    {
+        DeviceContextWrapper::CSSetShader( pComputeShader, ppClassInstances, NumClassInstances );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::CSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers )
+{
+    UINT first, count;
+    if ( FilterConstantBuffers( CSSetConstantBuffersCall, ComputeStage, StartSlot, NumBuffers, ppConstantBuffers, nullptr, nullptr, first, count ) )
+    {
+        DeviceContextWrapper::CSSetConstantBuffers( StartSlot + first, count, Advance( ppConstantBuffers, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::CSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants )
+{
+    UINT first, count;
+    if ( FilterConstantBuffers( CSSetConstantBuffers1Call, ComputeStage, StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants, first, count ) )
+    {
+        DeviceContextWrapper::CSSetConstantBuffers1( StartSlot + first, count, Advance( ppConstantBuffers, first ), Advance( pFirstConstant, first ), Advance( pNumConstants, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::CSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews )
+{
+    UINT first, count;
+    if ( FilterShaderResources( CSSetShaderResourcesCall, ComputeStage, StartSlot, NumViews, ppShaderResourceViews, first, count ) )
+    {
+        DeviceContextWrapper::CSSetShaderResources( StartSlot + first, count, Advance( ppShaderResourceViews, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::CSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers )
+{
+    UINT first, count;
+    if ( FilterSamplers( CSSetSamplersCall, ComputeStage, StartSlot, NumSamplers, ppSamplers, first, count ) )
+    {
+        DeviceContextWrapper::CSSetSamplers( StartSlot + first, count, Advance( ppSamplers, first ) );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::CSSetUnorderedAccessViews( UINT StartSlot, UINT NumUAVs, ID3D11UnorderedAccessView* const* ppUnorderedAccessViews, const UINT* pUAVInitialCounts )
+{
+    InvalidateInputs();
+    DeviceContextWrapper::CSSetUnorderedAccessViews( StartSlot, NumUAVs, ppUnorderedAccessViews, pUAVInitialCounts );
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::SOSetTargets( UINT NumBuffers, ID3D11Buffer* const* ppSOTargets, const UINT* pOffsets )
+{
+    InvalidateInputs();
+    DeviceContextWrapper::SOSetTargets( NumBuffers, ppSOTargets, pOffsets );
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::RSSetState( ID3D11RasterizerState* pRasterizerState )
+{
+    if ( FilterValue( RSSetStateCall, m_State.RasterizerState, pRasterizerState ) )
+    {
+        DeviceContextWrapper::RSSetState( pRasterizerState );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::RSSetViewports( UINT NumViewports, const D3D11_VIEWPORT* pViewports )
+{
+    if ( !pViewports || NumViewports > _countof(m_State.Viewports) )
+    {
+        m_State.ViewportsKnown = false;
+    }
+    else if ( m_State.ViewportsKnown && m_State.ViewportCount == NumViewports &&
+              memcmp( m_State.Viewports, pViewports, NumViewports * sizeof(D3D11_VIEWPORT) ) == 0 )
+    {
+        ++m_ElidedCallCounts[RSSetViewportsCall];
+        return;
+    }
+    else
+    {
+        std::copy( pViewports, pViewports + NumViewports, m_State.Viewports );
+        m_State.ViewportCount = NumViewports;
+        m_State.ViewportsKnown = true;
+    }
+
+    DeviceContextWrapper::RSSetViewports( NumViewports, pViewports );
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::RSSetScissorRects( UINT NumRects, const D3D11_RECT* pRects )
+{
+    if ( !pRects || NumRects > _countof(m_State.ScissorRects) )
+    {
+        m_State.ScissorRectsKnown = false;
+    }
+    else if ( m_State.ScissorRectsKnown && m_State.ScissorRectCount == NumRects &&
+              memcmp( m_State.ScissorRects, pRects, NumRects * sizeof(D3D11_RECT) ) == 0 )
+    {
+        ++m_ElidedCallCounts[RSSetScissorRectsCall];
+        return;
+    }
+    else
+    {
+        std::copy( pRects, pRects + NumRects, m_State.ScissorRects );
+        m_State.ScissorRectCount = NumRects;
+        m_State.ScissorRectsKnown = true;
+    }
+
+    DeviceContextWrapper::RSSetScissorRects( NumRects, pRects );
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::OMSetRenderTargets( UINT NumViews, ID3D11RenderTargetView* const* ppRenderTargetViews, ID3D11DepthStencilView* pDepthStencilView )
+{
+    // The outputs are not filtered. Binding them is rare compared to binding inputs.
+    InvalidateInputs();
+    DeviceContextWrapper::OMSetRenderTargets( NumViews, ppRenderTargetViews, pDepthStencilView );
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::OMSetRenderTargetsAndUnorderedAccessViews( UINT NumRTVs, ID3D11RenderTargetView* const* ppRenderTargetViews, ID3D11DepthStencilView* pDepthStencilView, UINT UAVStartSlot, UINT NumUAVs, ID3D11UnorderedAccessView* const* ppUnorderedAccessViews, const UINT* pUAVInitialCounts )
+{
+    InvalidateInputs();
+    DeviceContextWrapper::OMSetRenderTargetsAndUnorderedAccessViews( NumRTVs, ppRenderTargetViews, pDepthStencilView, UAVStartSlot, NumUAVs, ppUnorderedAccessViews, pUAVInitialCounts );
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::OMSetBlendState( ID3D11BlendState* pBlendState, const FLOAT BlendFactor[4], UINT SampleMask )
+{
+    // A null blend factor is the same as { 1, 1, 1, 1 }.
+    BlendStateBinding binding = { pBlendState, { 1.0f, 1.0f, 1.0f, 1.0f }, SampleMask };
+    if ( BlendFactor )
+    {
+        std::copy( BlendFactor, BlendFactor + 4, binding.BlendFactor );
+    }
+
+    if ( FilterValue( OMSetBlendStateCall, m_State.BlendState, binding ) )
+    {
+        DeviceContextWrapper::OMSetBlendState( pBlendState, BlendFactor, SampleMask );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::OMSetDepthStencilState( ID3D11DepthStencilState* pDepthStencilState, UINT StencilRef )
+{
+    DepthStencilStateBinding binding = { pDepthStencilState, StencilRef };
+    if ( FilterValue( OMSetDepthStencilStateCall, m_State.DepthStencilState, binding ) )
+    {
+        DeviceContextWrapper::OMSetDepthStencilState( pDepthStencilState, StencilRef );
+    }
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::ClearState()
+{
+    InvalidateState();
+    DeviceContextWrapper::ClearState();
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::ExecuteCommandList( ID3D11CommandList* pCommandList, BOOL RestoreContextState )
+{
+    // The context state is cleared after the command list if it is not restored.
+    if ( !RestoreContextState )
+    {
+        InvalidateState();
+    }
+    DeviceContextWrapper::ExecuteCommandList( pCommandList, RestoreContextState );
+}
+
+HRESULT STDMETHODCALLTYPE StateFilteringDeviceContext::FinishCommandList( BOOL RestoreDeferredContextState, ID3D11CommandList** ppCommandList )
+{
+    if ( !RestoreDeferredContextState )
+    {
+        InvalidateState();
+    }
+    return DeviceContextWrapper::FinishCommandList( RestoreDeferredContextState, ppCommandList );
+}
+
+void STDMETHODCALLTYPE StateFilteringDeviceContext::SwapDeviceContextState( ID3DDeviceContextState* pState, ID3DDeviceContextState** ppPreviousState )
+{
+    InvalidateState();
+    DeviceContextWrapper::SwapDeviceContextState( pState, ppPreviousState );
+}
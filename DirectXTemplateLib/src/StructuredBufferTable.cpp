@@ -0,0 +1,125 @@
+#include <DirectXTemplateLibPCH.h>
+#include <StructuredBufferTable.h>
+
+StructuredBufferTable::StructuredBufferTable()
+    : m_ElementSize( 0 )
+    , m_Capacity( 0 )
+{}
+
+bool StructuredBufferTable::Initialize( ID3D11Device* device, UINT elementSize, UINT capacity, UINT mergeDistance )
+{
+    assert( device );
+    assert( elementSize > 0 && elementSize % 4 == 0 && capacity > 0 );
+
+    D3D11_BUFFER_DESC bufferDesc;
+    ZeroMemory( &bufferDesc, sizeof(D3D11_BUFFER_DESC) );
+
+    bufferDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    bufferDesc.ByteWidth = elementSize * capacity;
+    bufferDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+    bufferDesc.StructureByteStride = elementSize;
+    bufferDesc.Usage = D3D11_USAGE_DEFAULT;
+
+    HRESULT hr = device->CreateBuffer( &bufferDesc, nullptr, &m_d3dBuffer );
+    if ( FAILED( hr ) )
+    {
+        return false;
+    }
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc;
+    ZeroMemory( &shaderResourceViewDesc, sizeof(D3D11_SHADER_RESOURCE_VIEW_DESC) );
+
+    shaderResourceViewDesc.Format = DXGI_FORMAT_UNKNOWN;
+    shaderResourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+    shaderResourceViewDesc.Buffer.FirstElement = 0;
+    shaderResourceViewDesc.Buffer.NumElements = capacity;
+
+    hr = device->CreateShaderResourceView( m_d3dBuffer.Get(), &shaderResourceViewDesc, &m_d3dShaderResourceView );
+    if ( FAILED( hr ) )
+    {
+        m_d3dBuffer.Reset();
+        return false;
+    }
+
+    m_ElementSize = elementSize;
+    m_Capacity = capacity;
+    m_Elements.assign( elementSize * capacity, 0 );
+
+    // The contents of the buffer are undefined until all elements have been uploaded once.
+    m_DirtyRanges = DirtyRangeTracker( mergeDistance );
+    m_DirtyRanges.MarkDirty( 0, capacity );
+
+    return true;
+}
+
+bool StructuredBufferTable::Set( UINT index, const void* element )
+{
+    assert( index < m_Capacity );
+
+    uint8_t* destination = &m_Elements[index * m_ElementSize];
+    if ( memcmp( destination, element, m_ElementSize ) == 0 )
+    {
+        return false;
+    }
+
+    memcpy( destination, element, m_ElementSize );
+    m_DirtyRanges.MarkDirty( index );
+
+    return true;
+}
+
+const void* StructuredBufferTable::Get( UINT index ) const
+{
+    assert( index < m_Capacity );
+    return &m_Elements[index * m_ElementSize];
+}
+
+UINT StructuredBufferTable::Upload( ID3D11DeviceContext* deviceContext )
+{
+    assert( m_d3dBuffer );
+
+    UINT uploadedCount = 0;
+
+    for ( const DirtyRangeTracker::Range& range : m_DirtyRanges.get_Ranges() )
+    {
+        D3D11_BOX box;
+        box.left = range.Begin * m_ElementSize;
+        box.right = range.End * m_ElementSize;
+        box.top = 0;
+        box.bottom = 1;
+        box.front = 0;
+        box.back = 1;
+
+        deviceContext->UpdateSubresource( m_d3dBuffer.Get(), 0, &box, &m_Elements[box.left], 0, 0 );
+        uploadedCount += range.End - range.Begin;
+    }
+
+    m_DirtyRanges.Clear();
+
+    return uploadedCount;
+}
+
+UINT StructuredBufferTable::get_ElementSize() const
+{
+    return m_ElementSize;
+}
+
+UINT StructuredBufferTable::get_Capacity() const
+{
+    return m_Capacity;
+}
+
+ID3D11Buffer* StructuredBufferTable::get_Buffer() const
+{
+    return m_d3dBuffer.Get();
+}
+
+ID3D11ShaderResourceView* StructuredBufferTable::get_ShaderResourceView() const
+{
+    return m_d3dShaderResourceView.Get();
+}
+
+const DirtyRangeTracker& StructuredBufferTable::get_DirtyRanges() const
+{
+    return m_DirtyRanges;
+}
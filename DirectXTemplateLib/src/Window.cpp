@@ -1,6 +1,8 @@
 #include <DirectXTemplateLibPCH.h>
 #include <Window.h>
 #include <Game.h>
+#include <HighResolutionClock.h>
+#include <Profiler.h>
 
 Window::Window()
     : m_hWnd(nullptr)
@@ -8,6 +10,7 @@ Window::Window()
     , m_ClientHeight( 0 )
     , m_VSync( true )
     , m_bWindowed( true )
+    , m_bHeadless( false )
     , m_pGame( nullptr )
 {}
 
@@ -18,11 +21,23 @@ Window::Window( HWND hWnd, const std::string& windowName, int clientWidth, int c
     , m_ClientHeight( clientHeight )
     , m_VSync( vSync )
     , m_bWindowed( windowed )
+    , m_bHeadless( false )
     , m_pGame( nullptr )
 {
 
 }
 
+Window::Window( const std::string& windowName, int clientWidth, int clientHeight )
+    : m_hWnd( nullptr )
+    , m_WindowName( windowName )
+    , m_ClientWidth( clientWidth )
+    , m_ClientHeight( clientHeight )
+    , m_VSync( false )
+    , m_bWindowed( true )
+    , m_bHeadless( true )
+    , m_pGame( nullptr )
+{}
+
 Window::~Window()
 {
     Destroy();
@@ -55,7 +70,12 @@ void Window::Destroy()
 
 bool Window::IsValid() const
 {
-    return ( m_hWnd != nullptr );
+    return ( m_hWnd != nullptr || m_bHeadless );
+}
+
+bool Window::IsHeadless() const
+{
+    return m_bHeadless;
 }
 
 int Window::get_ClientWidth() const
@@ -92,17 +112,42 @@ bool Window::RegisterDirectXTemplate( Game* pTemplate )
 
 void Window::OnUpdate( UpdateEventArgs& e )
 {
+    PROFILE_FUNCTION();
+
     if ( m_pGame )
     {
+        double startTime = HighResolutionClock::get_CurrentSeconds();
         m_pGame->OnUpdate( e );
+        m_pGame->m_FrameStatistics.AddTime( FrameStatistics::UpdatePhase, HighResolutionClock::get_CurrentSeconds() - startTime );
     }
 }
 
 void Window::OnRender( RenderEventArgs& e )
 {
+    PROFILE_FUNCTION();
+
     if ( m_pGame )
     {
+        FrameStatistics& frameStatistics = m_pGame->m_FrameStatistics;
+
+        // The present time is recorded by Game::Present and is not part of the render time.
+        double startTime = HighResolutionClock::get_CurrentSeconds();
+        double presentTime = frameStatistics.get_CurrentTime( FrameStatistics::PresentPhase );
         m_pGame->OnRender( e );
+        double renderTime = HighResolutionClock::get_CurrentSeconds() - startTime;
+        renderTime -= frameStatistics.get_CurrentTime( FrameStatistics::PresentPhase ) - presentTime;
+
+        frameStatistics.AddTime( FrameStatistics::RenderPhase, renderTime );
+    }
+}
+
+void Window::OnFrameEnd()
+{
+    if ( m_pGame )
+    {
+        // In Pipelined mode the update of the next frame records its time on the update thread.
+        // The frame is ended after the update has finished, so the statistics are never accessed concurrently.
+        m_pGame->m_FrameStatistics.EndFrame();
     }
 }
 
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <DirectXTemplateLibPCH.h>
+
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <random>
+#include <sstream>
\ No newline at end of file
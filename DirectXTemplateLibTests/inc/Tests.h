@@ -0,0 +1,52 @@
+/**
+ *   @brief The self-tests of the template library. Every test prints one line per check
+ *   and returns true if all of its checks passed.
+ */
+#pragma once
+
+// Print the result of a single self-test check.
+bool Check( std::ostream& stream, bool condition, const char* description );
+
+// Create a WARP device that is limited to the given feature level.
+Microsoft::WRL::ComPtr<ID3D11DeviceContext> CreateWarpDeviceContext( D3D_FEATURE_LEVEL featureLevel );
+
+// Mesh
+bool TestIndexFormat( std::ostream& stream );
+bool TestMeshGenerators( std::ostream& stream );
+bool TestWeldSphere( std::ostream& stream );
+void RunMeshGenerationBenchmark( std::ostream& stream );
+
+// MeshOptimizer
+bool TestVertexCache( std::ostream& stream );
+void RunVertexCacheReport( std::ostream& stream );
+
+// PackedVertex
+bool TestPackedVertices( std::ostream& stream );
+
+// GeometryCache
+bool TestGeometryCache( std::ostream& stream );
+
+// Camera
+bool TestProjection( std::ostream& stream );
+bool TestDepthPrecision( std::ostream& stream );
+
+// StateFilteringDeviceContext
+bool TestStateFilter( std::ostream& stream );
+
+// MeshClusters
+bool TestMeshClusters( std::ostream& stream );
+
+// OffsetAllocator
+bool TestOffsetAllocator( std::ostream& stream );
+
+// FramePipeline
+bool TestFramePipeline( std::ostream& stream );
+
+// JobSystem
+bool TestJobSystem( std::ostream& stream );
+
+// RingBufferAllocator
+bool TestRingBufferAllocator( std::ostream& stream );
+
+// RenderQueue
+bool TestRenderQueue( std::ostream& stream );
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include <DirectXTemplateLibTestsPCH.h>
+#include <Tests.h>
+#include <Camera.h>
+
+using namespace DirectX;
+
+// The near plane and the far distance map to the depths of the depth mode for both handedness
+// conventions, and the degenerate far plane of an infinite projection is replaced by a plane
+// that contains every point.
+bool TestProjection( std::ostream& stream )
+{
+    static const float NearDistance = 0.1f;
+    static const float FarDistance = 100.0f;
+    // Stands in for infinity with an infinite far plane.
+    static const float InfiniteDistance = 1e6f;
+    static const float Tolerance = 1e-5f;
+
+    bool passed = true;
+
+    for ( Camera::Handedness handedness : { Camera::LeftHanded, Camera::RightHanded } )
+    for ( Camera::DepthMode depthMode : { Camera::StandardDepth, Camera::ReverseDepth } )
+    for ( bool infiniteFarPlane : { false, true } )
+    {
+        Camera camera( handedness );
+        camera.set_Projection( 45.0f, 1.5f, NearDistance, FarDistance );
+        camera.set_DepthMode( depthMode );
+        camera.set_InfiniteFarPlane( infiniteFarPlane );
+
+        XMMATRIX projection = camera.get_ProjectionMatrix();
+
+        // The camera looks along +z (left-handed) or -z (right-handed) in view space.
+        float direction = ( handedness == Camera::LeftHanded ) ? 1.0f : -1.0f;
+        float farDistance = infiniteFarPlane ? InfiniteDistance : FarDistance;
+
+        float nearDepth = XMVectorGetZ( XMVector3TransformCoord( XMVectorSet( 0, 0, direction * NearDistance, 1 ), projection ) );
+        float farDepth = XMVectorGetZ( XMVector3TransformCoord( XMVectorSet( 0, 0, direction * farDistance, 1 ), projection ) );
+
+        float expectedNearDepth = ( depthMode == Camera::ReverseDepth ) ? 1.0f : 0.0f;
+        float expectedFarDepth = ( depthMode == Camera::ReverseDepth ) ? 0.0f : 1.0f;
+
+        std::string mode = std::string( ( handedness == Camera::LeftHanded ) ? "left-handed" : "right-handed" ) +
+            ( ( depthMode == Camera::ReverseDepth ) ? ", reverse depth" : ", standard depth" ) +
+            ( infiniteFarPlane ? ", infinite far plane" : "" );
+
+        std::string description = mode + ": near plane maps to depth " + std::to_string( expectedNearDepth ) + " (" + std::to_string( nearDepth ) + ")";
+        passed &= Check( stream, std::abs( nearDepth - expectedNearDepth ) <= Tolerance, description.c_str() );
+        description = mode + ": far distance maps to depth " + std::to_string( expectedFarDepth ) + " (" + std::to_string( farDepth ) + ")";
+        passed &= Check( stream, std::abs( farDepth - expectedFarDepth ) <= Tolerance, description.c_str() );
+
+        XMVECTOR planes[Camera::FrustumPlaneCount];
+        Camera::ExtractFrustumPlanes( projection, planes, depthMode );
+
+        XMVECTOR farPoint = XMVectorSet( 0, 0, direction * FarDistance, 1 );
+        if ( infiniteFarPlane )
+        {
+            description = mode + ": far plane is replaced by (0, 0, 0, 1)";
+            passed &= Check( stream, XMVector4Equal( planes[Camera::FarPlane], XMVectorSet( 0, 0, 0, 1 ) ), description.c_str() );
+        }
+        else
+        {
+            description = mode + ": far plane contains the far distance";
+            passed &= Check( stream, std::abs( XMVectorGetX( XMPlaneDotCoord( planes[Camera::FarPlane], farPoint ) ) ) <= 1e-3f, description.c_str() );
+        }
+
+        description = mode + ": near plane contains the near distance";
+        passed &= Check( stream, std::abs( XMVectorGetX( XMPlaneDotCoord( planes[Camera::NearPlane], XMVectorSet( 0, 0, direction * NearDistance, 1 ) ) ) ) <= 1e-5f, description.c_str() );
+    }
+
+    return passed;
+}
+
+// The relative error of a view distance that is reconstructed with the inverse projection matrix
+// from its 32-bit float depth, or from the next representable depth towards the far plane.
+static float DepthReconstructionError( const Camera& camera, float distance )
+{
+    XMMATRIX projection = camera.get_ProjectionMatrix();
+    XMMATRIX inverseProjection = camera.get_InverseProjectionMatrix();
+
+    float depth = XMVectorGetZ( XMVector3TransformCoord( XMVectorSet( 0, 0, distance, 1 ), projection ) );
+    float farDepth = ( camera.get_DepthMode() == Camera::ReverseDepth ) ? 0.0f : 1.0f;
+
+    float error = 0.0f;
+    for ( float storedDepth : { depth, std::nextafter( depth, farDepth ) } )
+    {
+        float reconstructedDistance = XMVectorGetZ( XMVector3TransformCoord( XMVectorSet( 0, 0, storedDepth, 1 ), inverseProjection ) );
+        error = std::max( error, std::abs( reconstructedDistance - distance ) / distance );
+    }
+
+    return error;
+}
+
+// Sweep the view distance from the near plane to 10^4 and compare how precisely the distance can be
+// reconstructed from a 32-bit float depth buffer. Reverse depth keeps the relative error close to
+// the float epsilon at every distance, while standard depth loses most of its precision far away.
+bool TestDepthPrecision( std::ostream& stream )
+{
+    static const float NearDistance = 0.1f;
+    static const float FarDistance = 1e5f;
+    static const float Distances[] = { 0.1f, 1.0f, 10.0f, 100.0f, 1000.0f, 10000.0f };
+
+    Camera standard;
+    standard.set_Projection( 45.0f, 1.5f, NearDistance, FarDistance );
+
+    Camera reverse;
+    reverse.set_Projection( 45.0f, 1.5f, NearDistance, FarDistance );
+    reverse.set_DepthMode( Camera::ReverseDepth );
+
+    Camera reverseInfinite;
+    reverseInfinite.set_Projection( 45.0f, 1.5f, NearDistance, FarDistance );
+    reverseInfinite.set_DepthMode( Camera::ReverseDepth );
+    reverseInfinite.set_InfiniteFarPlane( true );
+
+    bool passed = true;
+
+    for ( float distance : Distances )
+    {
+        float standardError = DepthReconstructionError( standard, distance );
+        float reverseError = DepthReconstructionError( reverse, distance );
+        float reverseInfiniteError = DepthReconstructionError( reverseInfinite, distance );
+
+        std::ostringstream description;
+        description << "distance " << distance << ": relative error standard " << standardError
+            << ", reverse " << reverseError << ", reverse infinite " << reverseInfiniteError;
+        passed &= Check( stream, reverseError < 1e-5f && reverseInfiniteError < 1e-5f, description.str().c_str() );
+
+        // Far away, standard depth is at least two orders of magnitude less precise.
+        if ( distance >= 1000.0f )
+        {
+            description.str( "" );
+            description << "distance " << distance << ": reverse depth is more precise than standard depth";
+            passed &= Check( stream, reverseError * 100.0f < standardError && reverseInfiniteError * 100.0f < standardError, description.str().c_str() );
+        }
+    }
+
+    return passed;
+}
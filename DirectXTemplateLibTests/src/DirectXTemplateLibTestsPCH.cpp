@@ -0,0 +1 @@
+#include <DirectXTemplateLibTestsPCH.h>
\ No newline at end of file
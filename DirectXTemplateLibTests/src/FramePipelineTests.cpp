@@ -0,0 +1,109 @@
+#include <DirectXTemplateLibTestsPCH.h>
+#include <Tests.h>
+#include <FramePipeline.h>
+#include <CameraSnapshot.h>
+
+#include <stdexcept>
+
+using namespace DirectX;
+
+// Drive a pipeline like the Pipelined loop mode of Application::Run: frame 0 is updated on the
+// calling thread, then the update of frame N + 1 runs on the worker while frame N is rendered.
+// The update moves a camera and publishes it, and the render uses the snapshot that was read
+// after its update was waited for. An exception thrown by an update is rethrown by WaitForUpdate.
+bool TestFramePipeline( std::ostream& stream )
+{
+    static const uint64_t FrameCount = 100;
+
+    bool passed = true;
+
+    Camera camera;
+    CameraSnapshotBuffer snapshots;
+
+    // Only accessed by the thread that runs the update and read by this thread after WaitForUpdate.
+    std::vector<uint64_t> updatedFrames;
+    std::vector<std::thread::id> updateThreads;
+
+    auto update = [&]( UpdateEventArgs& e )
+    {
+        updatedFrames.push_back( e.FrameIndex );
+        updateThreads.push_back( std::this_thread::get_id() );
+
+        camera.set_Translation( XMVectorSet( static_cast<float>( e.FrameIndex ), 0.0f, 0.0f, 1.0f ) );
+        snapshots.Publish( camera );
+    };
+
+    std::vector<uint64_t> renderedFrames;
+    bool snapshotsMatch = true;
+    {
+        FramePipeline pipeline( update );
+
+        UpdateEventArgs firstFrame( 1.0f / 60.0f, 1.0f / 60.0f, 0 );
+        update( firstFrame );
+
+        for ( uint64_t frameIndex = 0; frameIndex < FrameCount; ++frameIndex )
+        {
+            // The snapshot of the frame that is rendered next is read before its successor is updated.
+            CameraSnapshot snapshot;
+            snapshotsMatch &= snapshots.Read( snapshot ) && snapshot.Version == frameIndex + 1 && snapshot.Translation.x == static_cast<float>( frameIndex );
+
+            pipeline.BeginUpdate( UpdateEventArgs( 1.0f / 60.0f, ( frameIndex + 2 ) / 60.0f, frameIndex + 1 ) );
+            renderedFrames.push_back( frameIndex );
+            pipeline.WaitForUpdate();
+        }
+
+        passed &= Check( stream, !pipeline.IsUpdating(), "no update is running after WaitForUpdate" );
+    }
+
+    bool updatesInOrder = updatedFrames.size() == FrameCount + 1;
+    bool rendersInOrder = renderedFrames.size() == FrameCount;
+    for ( uint64_t i = 0; i < updatedFrames.size(); ++i )
+    {
+        updatesInOrder &= updatedFrames[i] == i;
+    }
+    for ( uint64_t i = 0; i < renderedFrames.size(); ++i )
+    {
+        rendersInOrder &= renderedFrames[i] == i;
+    }
+
+    bool updatesOnWorker = !updateThreads.empty() && updateThreads[0] == std::this_thread::get_id();
+    for ( size_t i = 1; i < updateThreads.size(); ++i )
+    {
+        updatesOnWorker &= updateThreads[i] != std::this_thread::get_id();
+    }
+
+    passed &= Check( stream, updatesInOrder, "frames 0 to N are updated in order" );
+    passed &= Check( stream, rendersInOrder, "frames 0 to N - 1 are rendered in order" );
+    passed &= Check( stream, updatesOnWorker, "frame 0 is updated on the calling thread and later frames on the worker thread" );
+    passed &= Check( stream, snapshotsMatch, "every frame is rendered with the camera snapshot of its own update" );
+
+    // The update of frame 2 fails.
+    FramePipeline pipeline( []( UpdateEventArgs& e )
+    {
+        if ( e.FrameIndex == 2 )
+        {
+            throw std::runtime_error( "update failed" );
+        }
+    } );
+
+    pipeline.WaitForUpdate();
+    passed &= Check( stream, !pipeline.IsUpdating(), "WaitForUpdate returns immediately if no update was started" );
+
+    std::string message;
+    for ( uint64_t frameIndex = 1; frameIndex <= 3; ++frameIndex )
+    {
+        pipeline.BeginUpdate( UpdateEventArgs( 1.0f / 60.0f, frameIndex / 60.0f, frameIndex ) );
+        try
+        {
+            pipeline.WaitForUpdate();
+        }
+        catch ( const std::runtime_error& exception )
+        {
+            message += std::to_string( frameIndex ) + ": " + exception.what();
+        }
+    }
+
+    passed &= Check( stream, message == "2: update failed", "the exception of an update is rethrown once by WaitForUpdate" );
+
+    return passed;
+}
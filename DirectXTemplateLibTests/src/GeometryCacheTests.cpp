@@ -0,0 +1,32 @@
+#include <DirectXTemplateLibTestsPCH.h>
+#include <Tests.h>
+#include <GeometryCache.h>
+
+// Identical keys share an instance until the last reference to it is released.
+bool TestGeometryCache( std::ostream& stream )
+{
+    GeometryCache<GeometryKey, int> cache;
+    int createCount = 0;
+    auto create = [&]() { return std::unique_ptr<int>( new int( ++createCount ) ); };
+
+    bool passed = true;
+
+    std::shared_ptr<int> sphere = cache.DemandCreate( GeometryKey::MakeSphere( 1.0f, 16 ), create );
+    std::shared_ptr<int> sameSphere = cache.DemandCreate( GeometryKey::MakeSphere( 1.0f, 16 ), create );
+    std::shared_ptr<int> otherSphere = cache.DemandCreate( GeometryKey::MakeSphere( 1.0f, 32 ), create );
+    std::shared_ptr<int> torus = cache.DemandCreate( GeometryKey::MakeTorus( 1.0f, 0.333f, 16 ), create );
+
+    passed &= Check( stream, sphere == sameSphere && createCount == 3, "identical keys share an instance" );
+    passed &= Check( stream, sphere != otherSphere && sphere != torus && cache.get_Size() == 3, "different keys have separate instances" );
+
+    sphere.reset();
+    passed &= Check( stream, cache.get_Size() == 3, "the instance is kept while it is referenced" );
+
+    sameSphere.reset();
+    passed &= Check( stream, cache.get_Size() == 2, "the instance is removed when the last reference is released" );
+
+    sphere = cache.DemandCreate( GeometryKey::MakeSphere( 1.0f, 16 ), create );
+    passed &= Check( stream, *sphere == 4, "a released instance is created again" );
+
+    return passed;
+}
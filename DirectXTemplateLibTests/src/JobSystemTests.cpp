@@ -0,0 +1,105 @@
+#include <DirectXTemplateLibTestsPCH.h>
+#include <Tests.h>
+#include <JobSystem.h>
+
+#include <chrono>
+#include <stdexcept>
+
+// Jobs with a dependency start after all jobs of the dependency have finished, a throwing job
+// still decrements its counter and its exception is rethrown by Wait, a job whose dependency is
+// never done does not keep the job system from being destroyed, and more jobs than fit into a
+// block of the job pool all run.
+bool TestJobSystem( std::ostream& stream )
+{
+    static const int JobCount = 64;
+
+    bool passed = true;
+
+    JobCounter first;
+    JobCounter second;
+    JobCounter failing;
+    JobCounter dependent;
+    JobCounter spawned;
+    JobCounter never;
+
+    std::atomic<int> firstFinished( 0 );
+    std::atomic<int> startedEarly( 0 );
+    std::atomic<int> failingRan( 0 );
+    std::atomic<int> dependentRan( 0 );
+    std::atomic<int> spawnedRan( 0 );
+    bool neverRan = false;
+    std::string message;
+
+    {
+        JobSystem jobSystem( 4 );
+
+        // The second jobs are scheduled before the first ones finish, so they have to wait.
+        for ( int i = 0; i < JobCount; ++i )
+        {
+            jobSystem.Schedule( [&firstFinished]()
+            {
+                std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+                ++firstFinished;
+            }, &first );
+        }
+        for ( int i = 0; i < JobCount; ++i )
+        {
+            jobSystem.Schedule( [&]()
+            {
+                if ( firstFinished.load() != JobCount )
+                {
+                    ++startedEarly;
+                }
+            }, &second, &first );
+        }
+        jobSystem.Wait( second );
+
+        passed &= Check( stream, first.IsDone() && second.IsDone() && startedEarly == 0, "dependent jobs start after all jobs of their dependency have finished" );
+
+        // One of the jobs throws. The jobs that depend on the failed counter still run.
+        for ( int i = 0; i < 10; ++i )
+        {
+            jobSystem.Schedule( [&failingRan, i]()
+            {
+                ++failingRan;
+                if ( i == 3 )
+                {
+                    throw std::runtime_error( "job failed" );
+                }
+            }, &failing );
+        }
+        jobSystem.Schedule( [&dependentRan]() { ++dependentRan; }, &dependent, &failing );
+
+        try
+        {
+            jobSystem.Wait( failing );
+        }
+        catch ( const std::runtime_error& exception )
+        {
+            message = exception.what();
+        }
+        jobSystem.Wait( dependent );
+
+        passed &= Check( stream, message == "job failed" && failingRan == 10, "Wait rethrows the exception of a job after all jobs of the counter have finished" );
+        passed &= Check( stream, dependentRan == 1, "the jobs that depend on a counter with a failed job still run" );
+
+        // A job that schedules more jobs than fit into its queue and into a block of the pool.
+        jobSystem.Schedule( [&]()
+        {
+            for ( int i = 0; i < 10000; ++i )
+            {
+                jobSystem.Schedule( [&spawnedRan]() { ++spawnedRan; }, &spawned );
+            }
+        }, &spawned );
+        jobSystem.Wait( spawned );
+
+        passed &= Check( stream, spawnedRan == 10000, "jobs that are scheduled by jobs all run" );
+
+        // The job depends on its own counter, so it can never run.
+        jobSystem.Schedule( [&neverRan]() { neverRan = true; }, &never, &never );
+    }
+
+    passed &= Check( stream, !neverRan && !never.IsDone(), "the job system is destroyed while a job waits for a dependency that is never done" );
+
+    return passed;
+}
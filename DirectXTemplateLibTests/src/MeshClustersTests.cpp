@@ -0,0 +1,154 @@
+#include <DirectXTemplateLibTestsPCH.h>
+#include <Tests.h>
+#include <Mesh.h>
+#include <MeshClusters.h>
+#include <MeshOptimizer.h>
+#include <Camera.h>
+
+using namespace DirectX;
+
+// Whether all non-degenerate triangles of a cluster face away from the given position.
+// The face normals are oriented by the vertex normals like the normal cones of the clusters.
+static bool IsBackFacing( const VertexCollection& vertices, const IndexCollection& indices, const MeshCluster& cluster, FXMVECTOR position )
+{
+    for ( UINT i = cluster.StartIndex; i < cluster.StartIndex + cluster.IndexCount; i += 3 )
+    {
+        const VertexPositionNormalTexture& v0 = vertices[indices[i + 0]];
+        const VertexPositionNormalTexture& v1 = vertices[indices[i + 1]];
+        const VertexPositionNormalTexture& v2 = vertices[indices[i + 2]];
+
+        XMVECTOR p0 = XMLoadFloat3( &v0.position );
+        XMVECTOR p1 = XMLoadFloat3( &v1.position );
+        XMVECTOR p2 = XMLoadFloat3( &v2.position );
+        XMVECTOR faceNormal = XMVector3Cross( p1 - p0, p2 - p0 );
+        if ( XMVector3Equal( faceNormal, XMVectorZero() ) )
+        {
+            continue;
+        }
+
+        XMVECTOR vertexNormal = XMLoadFloat3( &v0.normal ) + XMLoadFloat3( &v1.normal ) + XMLoadFloat3( &v2.normal );
+        if ( XMVectorGetX( XMVector3Dot( faceNormal, vertexNormal ) ) < 0.0f )
+        {
+            faceNormal = -faceNormal;
+        }
+
+        for ( XMVECTOR p : { p0, p1, p2 } )
+        {
+            if ( XMVectorGetX( XMVector3Dot( faceNormal, p - position ) ) <= 0.0f )
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// Every triangle of the sphere and the torus is in exactly one cluster, the clusters respect the
+// vertex and triangle limits, and their bounding spheres contain their vertices.
+// A camera below the sphere culls the clusters of the top cap and only back-facing clusters.
+bool TestMeshClusters( std::ostream& stream )
+{
+    bool passed = true;
+
+    struct Shape
+    {
+        const char* Name;
+        VertexCollection Vertices;
+        IndexCollection Indices;
+        MeshClusterCollection Clusters;
+    };
+
+    Shape shapes[2];
+    shapes[0].Name = "sphere";
+    Mesh::GenerateSphere( shapes[0].Vertices, shapes[0].Indices, 1.0f, 16 );
+    shapes[1].Name = "torus";
+    Mesh::GenerateTorus( shapes[1].Vertices, shapes[1].Indices, 1.0f, 0.33f, 32 );
+
+    for ( Shape& shape : shapes )
+    {
+        const VertexCollection& vertices = shape.Vertices;
+        IndexCollection& indices = shape.Indices;
+
+        // The clusters are built from the optimized triangle order, like in Mesh::Initialize.
+        OptimizeVertexCache( indices, vertices.size() );
+        BuildMeshClusters( vertices, indices, MeshCluster::DefaultMaxVertices, MeshCluster::DefaultMaxTriangles, shape.Clusters );
+
+        std::vector<int> triangleClusterCount( indices.size() / 3, 0 );
+        bool withinLimits = true;
+        bool vertexCountsMatch = true;
+        bool spheresContainVertices = true;
+
+        for ( const MeshCluster& cluster : shape.Clusters )
+        {
+            withinLimits &= cluster.VertexCount <= MeshCluster::DefaultMaxVertices && cluster.IndexCount / 3 <= MeshCluster::DefaultMaxTriangles;
+
+            std::vector<uint32_t> clusterVertices( indices.begin() + cluster.StartIndex, indices.begin() + cluster.StartIndex + cluster.IndexCount );
+            std::sort( clusterVertices.begin(), clusterVertices.end() );
+            vertexCountsMatch &= std::unique( clusterVertices.begin(), clusterVertices.end() ) - clusterVertices.begin() == cluster.VertexCount;
+
+            XMVECTOR center = XMLoadFloat4( &cluster.BoundingSphere );
+            for ( uint32_t v : clusterVertices )
+            {
+                float distance = XMVectorGetX( XMVector3Length( XMLoadFloat3( &vertices[v].position ) - center ) );
+                spheresContainVertices &= distance <= cluster.BoundingSphere.w + 1e-5f;
+            }
+
+            for ( UINT i = cluster.StartIndex; i < cluster.StartIndex + cluster.IndexCount && i / 3 < triangleClusterCount.size(); i += 3 )
+            {
+                ++triangleClusterCount[i / 3];
+            }
+        }
+
+        std::string name = shape.Name;
+        passed &= Check( stream, !shape.Clusters.empty() && withinLimits, ( name + " clusters have at most 64 vertices and 124 triangles" ).c_str() );
+        passed &= Check( stream, vertexCountsMatch, ( name + " clusters count their unique vertices" ).c_str() );
+        passed &= Check( stream, std::all_of( triangleClusterCount.begin(), triangleClusterCount.end(), []( int count ) { return count == 1; } ),
+            ( name + " triangles are each in exactly one cluster" ).c_str() );
+        passed &= Check( stream, spheresContainVertices, ( name + " cluster bounding spheres contain their vertices" ).c_str() );
+    }
+
+    // Look at the sphere from below. The whole sphere is inside the frustum, so only the
+    // normal cones decide which clusters are culled.
+    const Shape& sphere = shapes[0];
+    XMVECTOR eye = XMVectorSet( 0.0f, -10.0f, 0.0f, 1.0f );
+
+    Camera camera;
+    camera.set_LookAt( eye, XMVectorZero(), XMVectorSet( 0.0f, 0.0f, 1.0f, 0.0f ) );
+    camera.set_Projection( 45.0f, 1.0f, 0.1f, 100.0f );
+
+    MeshClusterCuller culler( sphere.Clusters );
+    std::vector<UINT> visibleClusters;
+    culler.Cull( XMMatrixIdentity(), camera, visibleClusters );
+
+    bool capCulled = true;
+    bool onlyBackFacingCulled = true;
+    size_t culledCount = 0;
+    for ( size_t i = 0; i < sphere.Clusters.size(); ++i )
+    {
+        const MeshCluster& cluster = sphere.Clusters[i];
+        bool visible = std::find( visibleClusters.begin(), visibleClusters.end(), static_cast<UINT>( i ) ) != visibleClusters.end();
+        if ( !visible )
+        {
+            ++culledCount;
+            onlyBackFacingCulled &= IsBackFacing( sphere.Vertices, sphere.Indices, cluster, eye );
+        }
+
+        // The clusters of the top cap (above 80% of the radius) face straight away from the camera.
+        float minY = FLT_MAX;
+        for ( UINT k = cluster.StartIndex; k < cluster.StartIndex + cluster.IndexCount; ++k )
+        {
+            minY = std::min( minY, sphere.Vertices[sphere.Indices[k]].position.y );
+        }
+        if ( minY >= 0.4f )
+        {
+            capCulled &= !visible;
+        }
+    }
+
+    std::string description = "a camera below the sphere culls back-facing clusters (" + std::to_string( culledCount ) + " of " + std::to_string( sphere.Clusters.size() ) + ")";
+    passed &= Check( stream, culledCount > 0 && capCulled, description.c_str() );
+    passed &= Check( stream, onlyBackFacingCulled, "every culled cluster is back-facing" );
+
+    return passed;
+}
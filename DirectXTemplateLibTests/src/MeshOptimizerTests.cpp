@@ -0,0 +1,96 @@
+#include <DirectXTemplateLibTestsPCH.h>
+#include <Tests.h>
+#include <Mesh.h>
+#include <MeshOptimizer.h>
+
+// The shapes of the demo with the demo's tessellations.
+struct DemoShape
+{
+    const char* Name;
+    std::function<void ( VertexCollection&, IndexCollection& )> Generate;
+};
+
+static std::vector<DemoShape> GetDemoShapes()
+{
+    std::vector<DemoShape> shapes;
+    shapes.push_back( { "Cube", []( VertexCollection& vertices, IndexCollection& indices ) { Mesh::GenerateCube( vertices, indices, 1.0f ); } } );
+    shapes.push_back( { "Sphere", []( VertexCollection& vertices, IndexCollection& indices ) { Mesh::GenerateSphere( vertices, indices, 1.0f, 16 ); } } );
+    shapes.push_back( { "Cone", []( VertexCollection& vertices, IndexCollection& indices ) { Mesh::GenerateCone( vertices, indices, 1.0f, 1.0f, 32 ); } } );
+    shapes.push_back( { "Torus", []( VertexCollection& vertices, IndexCollection& indices ) { Mesh::GenerateTorus( vertices, indices, 1.0f, 0.33f, 32 ); } } );
+    return shapes;
+}
+
+static bool IsNear( float value, float expected )
+{
+    return std::abs( value - expected ) < 1e-6f;
+}
+
+// The simulated FIFO cache gives the hand-computed ratios for small index lists, and the
+// optimized order of the demo's sphere and torus transforms fewer vertices than the generated order.
+bool TestVertexCache( std::ostream& stream )
+{
+    bool passed = true;
+
+    // Two triangles of a quad share an edge: 4 vertices are transformed for 2 triangles.
+    IndexCollection quad = { 0, 1, 2, 2, 1, 3 };
+    VertexCacheStatistics statistics = AnalyzeVertexCache( quad, 4 );
+    passed &= Check( stream, IsNear( statistics.ACMR, 2.0f ) && IsNear( statistics.ATVR, 1.0f ), "a quad has ACMR 2 and ATVR 1" );
+
+    // With a 3 entry cache, the first triangle is evicted by the second one and is transformed again.
+    IndexCollection repeated = { 0, 1, 2, 3, 4, 5, 0, 1, 2 };
+    statistics = AnalyzeVertexCache( repeated, 6, 3 );
+    passed &= Check( stream, IsNear( statistics.ACMR, 3.0f ) && IsNear( statistics.ATVR, 1.5f ), "an evicted triangle is transformed again (ACMR 3, ATVR 1.5)" );
+    statistics = AnalyzeVertexCache( repeated, 6, 16 );
+    passed &= Check( stream, IsNear( statistics.ACMR, 2.0f ) && IsNear( statistics.ATVR, 1.0f ), "a large cache keeps the repeated triangle (ACMR 2, ATVR 1)" );
+
+    // A cache hit does not move a vertex to the front of a FIFO cache, so vertex 0 is evicted
+    // by vertices 3 and 4 even though it was used by the second triangle (8 transforms).
+    IndexCollection fifo = { 0, 1, 2, 0, 3, 4, 0, 1, 2 };
+    statistics = AnalyzeVertexCache( fifo, 5, 3 );
+    passed &= Check( stream, IsNear( statistics.ACMR, 8.0f / 3.0f ) && IsNear( statistics.ATVR, 1.6f ), "a cache hit does not refresh a vertex (ACMR 8/3, ATVR 1.6)" );
+
+    for ( const DemoShape& shape : GetDemoShapes() )
+    {
+        // The faces of the cube and the sides and cap of the cone are already generated in an
+        // order that cannot be improved. The rings of the sphere and the torus do not fit into the cache.
+        if ( strcmp( shape.Name, "Sphere" ) != 0 && strcmp( shape.Name, "Torus" ) != 0 )
+        {
+            continue;
+        }
+
+        VertexCollection vertices;
+        IndexCollection indices;
+        shape.Generate( vertices, indices );
+
+        VertexCacheStatistics input = AnalyzeVertexCache( indices, vertices.size() );
+        OptimizeVertexCache( indices, vertices.size() );
+        VertexCacheStatistics optimized = AnalyzeVertexCache( indices, vertices.size() );
+
+        std::string description = std::string( "optimized " ) + shape.Name + " has a lower ACMR (" + std::to_string( input.ACMR ) + " -> " + std::to_string( optimized.ACMR ) + ")";
+        passed &= Check( stream, optimized.ACMR < input.ACMR, description.c_str() );
+    }
+
+    return passed;
+}
+
+// Print the vertex cache statistics of the demo's shapes before and after they are optimized.
+void RunVertexCacheReport( std::ostream& stream )
+{
+    stream << "Vertex cache statistics (16 entry FIFO)" << std::endl;
+    stream << std::setw( 8 ) << "Shape" << std::setw( 12 ) << "Vertices" << std::setw( 12 ) << "Triangles"
+        << std::setw( 12 ) << "ACMR" << std::setw( 12 ) << "Optimized" << std::setw( 12 ) << "ATVR" << std::setw( 12 ) << "Optimized" << std::endl;
+
+    for ( const DemoShape& shape : GetDemoShapes() )
+    {
+        VertexCollection vertices;
+        IndexCollection indices;
+        shape.Generate( vertices, indices );
+
+        VertexCacheStatistics input = AnalyzeVertexCache( indices, vertices.size() );
+        OptimizeVertexCache( indices, vertices.size() );
+        VertexCacheStatistics optimized = AnalyzeVertexCache( indices, vertices.size() );
+
+        stream << std::setw( 8 ) << shape.Name << std::setw( 12 ) << vertices.size() << std::setw( 12 ) << indices.size() / 3
+            << std::setw( 12 ) << input.ACMR << std::setw( 12 ) << optimized.ACMR << std::setw( 12 ) << input.ATVR << std::setw( 12 ) << optimized.ATVR << std::endl;
+    }
+}
@@ -0,0 +1,357 @@
+#include <DirectXTemplateLibTestsPCH.h>
+#include <Tests.h>
+#include <Mesh.h>
+#include <MeshOptimizer.h>
+#include <HighResolutionClock.h>
+
+using namespace DirectX;
+
+// Create a strip of vertexCount vertices on a spiral, so that no triangle is degenerate.
+static void CreateTriangleStrip( size_t vertexCount, VertexCollection& vertices, IndexCollection& indices )
+{
+    vertices.resize( vertexCount );
+    for ( size_t i = 0; i < vertexCount; ++i )
+    {
+        float angle = i * 0.1f;
+        float radius = 1.0f + i * 0.001f;
+        vertices[i] = VertexPositionNormalTexture( XMFLOAT3( radius * cosf( angle ), radius * sinf( angle ), i * 0.001f ), XMFLOAT3( 0, 0, 1 ), XMFLOAT2( 0, 0 ) );
+    }
+
+    indices.clear();
+    for ( size_t i = 0; i + 2 < vertexCount; ++i )
+    {
+        indices.push_back( static_cast<uint32_t>( i ) );
+        indices.push_back( static_cast<uint32_t>( i + 1 ) );
+        indices.push_back( static_cast<uint32_t>( i + 2 ) );
+    }
+}
+
+// Meshes with at most 65535 vertices use 16-bit indices, larger meshes use 32-bit indices,
+// which feature level 9.1 does not support.
+bool TestIndexFormat( std::ostream& stream )
+{
+    bool passed = true;
+
+    passed &= Check( stream, Mesh::SelectIndexFormat( 65534, D3D_FEATURE_LEVEL_11_0 ) == DXGI_FORMAT_R16_UINT, "65534 vertices use 16-bit indices" );
+    passed &= Check( stream, Mesh::SelectIndexFormat( 65535, D3D_FEATURE_LEVEL_11_0 ) == DXGI_FORMAT_R16_UINT, "65535 vertices use 16-bit indices" );
+    passed &= Check( stream, Mesh::SelectIndexFormat( 65536, D3D_FEATURE_LEVEL_11_0 ) == DXGI_FORMAT_R32_UINT, "65536 vertices use 32-bit indices" );
+    passed &= Check( stream, Mesh::SelectIndexFormat( 65535, D3D_FEATURE_LEVEL_9_1 ) == DXGI_FORMAT_R16_UINT, "65535 vertices use 16-bit indices on feature level 9.1" );
+    passed &= Check( stream, Mesh::SelectIndexFormat( 65536, D3D_FEATURE_LEVEL_9_1 ) == DXGI_FORMAT_UNKNOWN, "65536 vertices are not supported on feature level 9.1" );
+    passed &= Check( stream, Mesh::SelectIndexFormat( 65536, D3D_FEATURE_LEVEL_9_2 ) == DXGI_FORMAT_R32_UINT, "65536 vertices use 32-bit indices on feature level 9.2" );
+
+    VertexCollection vertices;
+    IndexCollection indices;
+    CreateTriangleStrip( 65535, vertices, indices );
+
+    std::vector<uint16_t> narrowIndices;
+    bool narrowed = Mesh::NarrowIndices( indices, narrowIndices );
+    passed &= Check( stream, narrowed && std::equal( indices.begin(), indices.end(), narrowIndices.begin(), narrowIndices.end() ), "narrowed indices match the original indices" );
+
+    indices.push_back( 0xFFFF );
+    passed &= Check( stream, !Mesh::NarrowIndices( indices, narrowIndices ), "the strip-cut index 0xFFFF cannot be narrowed" );
+
+    auto deviceContext = CreateWarpDeviceContext( D3D_FEATURE_LEVEL_11_0 );
+    if ( Check( stream, deviceContext != nullptr, "create WARP device (feature level 11.0)" ) )
+    {
+        for ( size_t vertexCount : { 65534, 65535, 65536 } )
+        {
+            CreateTriangleStrip( vertexCount, vertices, indices );
+            auto mesh = Mesh::CreateCustom( deviceContext.Get(), vertices, indices );
+
+            std::string description = std::to_string( vertexCount ) + " vertex mesh has the selected index format";
+            passed &= Check( stream, mesh->get_IndexFormat() == Mesh::SelectIndexFormat( vertexCount, D3D_FEATURE_LEVEL_11_0 ), description.c_str() );
+        }
+    }
+    else
+    {
+        passed = false;
+    }
+
+    deviceContext = CreateWarpDeviceContext( D3D_FEATURE_LEVEL_9_1 );
+    if ( Check( stream, deviceContext != nullptr, "create WARP device (feature level 9.1)" ) )
+    {
+        CreateTriangleStrip( 65535, vertices, indices );
+        auto mesh = Mesh::CreateCustom( deviceContext.Get(), vertices, indices );
+        passed &= Check( stream, mesh->get_IndexFormat() == DXGI_FORMAT_R16_UINT, "65535 vertex mesh is created on feature level 9.1" );
+
+        bool threw = false;
+        CreateTriangleStrip( 65536, vertices, indices );
+        try
+        {
+            mesh = Mesh::CreateCustom( deviceContext.Get(), vertices, indices );
+        }
+        catch ( const std::exception& )
+        {
+            threw = true;
+        }
+        passed &= Check( stream, threw, "65536 vertex mesh fails on feature level 9.1" );
+    }
+    else
+    {
+        passed = false;
+    }
+
+    return passed;
+}
+
+// The sphere generator from before the generators were vectorized and parallelized,
+// one vertex at a time. Used to test and benchmark Mesh::GenerateSphere.
+static void GenerateReferenceSphere( VertexCollection& vertices, IndexCollection& indices, float diameter, size_t tessellation )
+{
+    vertices.clear();
+    indices.clear();
+
+    float radius = diameter / 2.0f;
+    size_t verticalSegments = tessellation;
+    size_t horizontalSegments = tessellation * 2;
+
+    // Create rings of vertices at progressively higher latitudes.
+    for (size_t i = 0; i <= verticalSegments; i++)
+    {
+        float v = 1 - (float)i / verticalSegments;
+
+        float latitude = (i * XM_PI / verticalSegments) - XM_PIDIV2;
+        float dy, dxz;
+
+        XMScalarSinCos(&dy, &dxz, latitude);
+
+        // Create a single ring of vertices at this latitude.
+        for (size_t j = 0; j <= horizontalSegments; j++)
+        {
+            float u = (float)j / horizontalSegments;
+
+            float longitude = j * XM_2PI / horizontalSegments;
+            float dx, dz;
+
+            XMScalarSinCos(&dx, &dz, longitude);
+
+            dx *= dxz;
+            dz *= dxz;
+
+            XMVECTOR normal = XMVectorSet(dx, dy, dz, 0);
+            XMVECTOR textureCoordinate = XMVectorSet(u, v, 0, 0);
+
+            vertices.push_back(VertexPositionNormalTexture(normal * radius, normal, textureCoordinate));
+        }
+    }
+
+    // Fill the index buffer with triangles joining each pair of latitude rings.
+    size_t stride = horizontalSegments + 1;
+
+    for (size_t i = 0; i < verticalSegments; i++)
+    {
+        for (size_t j = 0; j <= horizontalSegments; j++)
+        {
+            size_t nextI = i + 1;
+            size_t nextJ = (j + 1) % stride;
+
+            indices.push_back(static_cast<uint32_t>(i * stride + j));
+            indices.push_back(static_cast<uint32_t>(nextI * stride + j));
+            indices.push_back(static_cast<uint32_t>(i * stride + nextJ));
+
+            indices.push_back(static_cast<uint32_t>(i * stride + nextJ));
+            indices.push_back(static_cast<uint32_t>(nextI * stride + j));
+            indices.push_back(static_cast<uint32_t>(nextI * stride + nextJ));
+        }
+    }
+}
+
+// The torus generator from before the generators were vectorized and parallelized.
+static void GenerateReferenceTorus( VertexCollection& vertices, IndexCollection& indices, float diameter, float thickness, size_t tessellation )
+{
+    vertices.clear();
+    indices.clear();
+
+    size_t stride = tessellation + 1;
+
+    // First we loop around the main ring of the torus.
+    for (size_t i = 0; i <= tessellation; i++)
+    {
+        float u = (float)i / tessellation;
+
+        float outerAngle = i * XM_2PI / tessellation - XM_PIDIV2;
+
+        // Create a transform matrix that will align geometry to
+        // slice perpendicularly though the current ring position.
+        XMMATRIX transform = XMMatrixTranslation(diameter / 2, 0, 0) * XMMatrixRotationY(outerAngle);
+
+        // Now we loop along the other axis, around the side of the tube.
+        for (size_t j = 0; j <= tessellation; j++)
+        {
+            float v = 1 - (float)j / tessellation;
+
+            float innerAngle = j * XM_2PI / tessellation + XM_PI;
+            float dx, dy;
+
+            XMScalarSinCos(&dy, &dx, innerAngle);
+
+            // Create a vertex.
+            XMVECTOR normal = XMVectorSet(dx, dy, 0, 0);
+            XMVECTOR position = normal * thickness / 2;
+            XMVECTOR textureCoordinate = XMVectorSet(u, v, 0, 0);
+
+            position = XMVector3Transform(position, transform);
+            normal = XMVector3TransformNormal(normal, transform);
+
+            vertices.push_back(VertexPositionNormalTexture(position, normal, textureCoordinate));
+
+            // And create indices for two triangles.
+            size_t nextI = (i + 1) % stride;
+            size_t nextJ = (j + 1) % stride;
+
+            indices.push_back(static_cast<uint32_t>(i * stride + j));
+            indices.push_back(static_cast<uint32_t>(i * stride + nextJ));
+            indices.push_back(static_cast<uint32_t>(nextI * stride + j));
+
+            indices.push_back(static_cast<uint32_t>(i * stride + nextJ));
+            indices.push_back(static_cast<uint32_t>(nextI * stride + nextJ));
+            indices.push_back(static_cast<uint32_t>(nextI * stride + j));
+        }
+    }
+}
+
+// The largest difference between the attributes of two vertex collections.
+static float MaxVertexDifference( const VertexCollection& a, const VertexCollection& b )
+{
+    float maxDifference = 0.0f;
+    for ( size_t i = 0; i < std::min( a.size(), b.size() ); ++i )
+    {
+        XMVECTOR difference = XMVectorAbs( XMLoadFloat3( &a[i].position ) - XMLoadFloat3( &b[i].position ) );
+        difference = XMVectorMax( difference, XMVectorAbs( XMLoadFloat3( &a[i].normal ) - XMLoadFloat3( &b[i].normal ) ) );
+        difference = XMVectorMax( difference, XMVectorAbs( XMLoadFloat2( &a[i].textureCoordinate ) - XMLoadFloat2( &b[i].textureCoordinate ) ) );
+
+        maxDifference = std::max( { maxDifference, XMVectorGetX( difference ), XMVectorGetY( difference ), XMVectorGetZ( difference ) } );
+    }
+    return maxDifference;
+}
+
+// The generated shapes have the same topology as the reference generators. The table driven
+// sines and cosines differ from the reference in the lowest bits, so the vertex attributes
+// are compared with a tolerance.
+bool TestMeshGenerators( std::ostream& stream )
+{
+    static const float Tolerance = 1e-5f;
+
+    bool passed = true;
+    size_t parallelThreshold = Mesh::get_ParallelGenerationThreshold();
+
+    // Generate all shapes serially and in parallel.
+    for ( size_t threshold : { SIZE_MAX, size_t(0) } )
+    {
+        Mesh::set_ParallelGenerationThreshold( threshold );
+        const char* mode = ( threshold == 0 ) ? "parallel" : "serial";
+
+        for ( size_t tessellation : { 3, 16, 100 } )
+        {
+            VertexCollection vertices, referenceVertices;
+            IndexCollection indices, referenceIndices;
+
+            Mesh::GenerateSphere( vertices, indices, 1.0f, tessellation );
+            GenerateReferenceSphere( referenceVertices, referenceIndices, 1.0f, tessellation );
+
+            float maxDifference = MaxVertexDifference( vertices, referenceVertices );
+            std::string description = std::string( "sphere " ) + std::to_string( tessellation ) + " (" + mode + ") matches the reference, max difference " + std::to_string( maxDifference );
+            passed &= Check( stream, indices == referenceIndices && vertices.size() == referenceVertices.size() && maxDifference <= Tolerance, description.c_str() );
+
+            Mesh::GenerateTorus( vertices, indices, 1.0f, 0.333f, tessellation );
+            GenerateReferenceTorus( referenceVertices, referenceIndices, 1.0f, 0.333f, tessellation );
+
+            maxDifference = MaxVertexDifference( vertices, referenceVertices );
+            description = std::string( "torus " ) + std::to_string( tessellation ) + " (" + mode + ") matches the reference, max difference " + std::to_string( maxDifference );
+            passed &= Check( stream, indices == referenceIndices && vertices.size() == referenceVertices.size() && maxDifference <= Tolerance, description.c_str() );
+        }
+    }
+
+    Mesh::set_ParallelGenerationThreshold( parallelThreshold );
+
+    return passed;
+}
+
+// Welding a sphere removes the triangles that touch a pole with two corners and the
+// triangles of the seam, whose corners only differ in their texture coordinates.
+bool TestWeldSphere( std::ostream& stream )
+{
+    bool passed = true;
+
+    for ( size_t tessellation : { 3, 16, 64 } )
+    {
+        // Every ring except the two pole caps has two triangles per segment.
+        const size_t horizontalSegments = tessellation * 2;
+        const size_t expectedTriangleCount = horizontalSegments * ( 2 * tessellation - 2 );
+
+        VertexCollection vertices;
+        IndexCollection indices;
+        Mesh::GenerateSphere( vertices, indices, 1.0f, tessellation );
+
+        WeldStatistics statistics = WeldVertices( vertices, indices, WeldTolerances( 1e-5f, 1e-4f, 1e-5f ) );
+
+        std::string description = "welded sphere " + std::to_string( tessellation ) + " has " + std::to_string( expectedTriangleCount ) + " triangles (" + std::to_string( statistics.TriangleCount ) + ")";
+        passed &= Check( stream, statistics.TriangleCount == expectedTriangleCount && indices.size() == expectedTriangleCount * 3, description.c_str() );
+    }
+
+    auto deviceContext = CreateWarpDeviceContext( D3D_FEATURE_LEVEL_11_0 );
+    if ( Check( stream, deviceContext != nullptr, "create WARP device (feature level 11.0)" ) )
+    {
+        auto sphere = Mesh::CreateSphere( deviceContext.Get(), 1.0f, 16, false, Mesh::OptimizeForVertexCache | Mesh::WeldDuplicateVertices );
+        passed &= Check( stream, sphere->get_WeldStatistics().TriangleCount == 32 * 30, "the demo's sphere has no pole or seam triangles" );
+    }
+    else
+    {
+        passed = false;
+    }
+
+    return passed;
+}
+
+// Measure generating spheres and tori with the reference generators, and with the
+// vectorized generators on the calling thread and in parallel.
+void RunMeshGenerationBenchmark( std::ostream& stream )
+{
+    static const int Repetitions = 5;
+
+    size_t parallelThreshold = Mesh::get_ParallelGenerationThreshold();
+
+    // The average time in milliseconds to generate a shape.
+    auto measure = [&]( const std::function<void ( VertexCollection&, IndexCollection& )>& generate )
+    {
+        VertexCollection vertices;
+        IndexCollection indices;
+
+        double startTime = HighResolutionClock::get_CurrentSeconds();
+        for ( int i = 0; i < Repetitions; ++i )
+        {
+            generate( vertices, indices );
+        }
+        return ( HighResolutionClock::get_CurrentSeconds() - startTime ) * 1000.0 / Repetitions;
+    };
+
+    stream << "Mesh generation benchmark (ms per mesh)" << std::endl;
+    stream << std::setw( 8 ) << "Shape" << std::setw( 14 ) << "Tessellation" << std::setw( 12 ) << "Vertices"
+        << std::setw( 12 ) << "Reference" << std::setw( 12 ) << "Serial" << std::setw( 12 ) << "Parallel" << std::endl;
+
+    for ( size_t tessellation = 16; tessellation <= 1024; tessellation *= 2 )
+    {
+        double referenceTime = measure( [=]( VertexCollection& vertices, IndexCollection& indices ) { GenerateReferenceSphere( vertices, indices, 1.0f, tessellation ); } );
+        Mesh::set_ParallelGenerationThreshold( SIZE_MAX );
+        double serialTime = measure( [=]( VertexCollection& vertices, IndexCollection& indices ) { Mesh::GenerateSphere( vertices, indices, 1.0f, tessellation ); } );
+        Mesh::set_ParallelGenerationThreshold( 0 );
+        double parallelTime = measure( [=]( VertexCollection& vertices, IndexCollection& indices ) { Mesh::GenerateSphere( vertices, indices, 1.0f, tessellation ); } );
+
+        stream << std::setw( 8 ) << "Sphere" << std::setw( 14 ) << tessellation << std::setw( 12 ) << ( tessellation + 1 ) * ( tessellation * 2 + 1 )
+            << std::setw( 12 ) << referenceTime << std::setw( 12 ) << serialTime << std::setw( 12 ) << parallelTime << std::endl;
+    }
+
+    for ( size_t tessellation = 16; tessellation <= 1024; tessellation *= 2 )
+    {
+        double referenceTime = measure( [=]( VertexCollection& vertices, IndexCollection& indices ) { GenerateReferenceTorus( vertices, indices, 1.0f, 0.333f, tessellation ); } );
+        Mesh::set_ParallelGenerationThreshold( SIZE_MAX );
+        double serialTime = measure( [=]( VertexCollection& vertices, IndexCollection& indices ) { Mesh::GenerateTorus( vertices, indices, 1.0f, 0.333f, tessellation ); } );
+        Mesh::set_ParallelGenerationThreshold( 0 );
+        double parallelTime = measure( [=]( VertexCollection& vertices, IndexCollection& indices ) { Mesh::GenerateTorus( vertices, indices, 1.0f, 0.333f, tessellation ); } );
+
+        stream << std::setw( 8 ) << "Torus" << std::setw( 14 ) << tessellation << std::setw( 12 ) << ( tessellation + 1 ) * ( tessellation + 1 )
+            << std::setw( 12 ) << referenceTime << std::setw( 12 ) << serialTime << std::setw( 12 ) << parallelTime << std::endl;
+    }
+
+    Mesh::set_ParallelGenerationThreshold( parallelThreshold );
+}
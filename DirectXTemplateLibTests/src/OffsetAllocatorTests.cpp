@@ -0,0 +1,50 @@
+#include <DirectXTemplateLibTestsPCH.h>
+#include <Tests.h>
+#include <OffsetAllocator.h>
+
+// Allocations use the smallest free range that fits, freed neighbours are merged into a single
+// range, freed handles are reused and Defragment moves the allocations to the beginning.
+bool TestOffsetAllocator( std::ostream& stream )
+{
+    bool passed = true;
+
+    // [a 0..10][b 10..30][c 30..40][d 40..70][e 70..80][free 80..110]
+    OffsetAllocator allocator( 110 );
+    OffsetAllocator::Handle a = allocator.Allocate( 10 );
+    OffsetAllocator::Handle b = allocator.Allocate( 20 );
+    OffsetAllocator::Handle c = allocator.Allocate( 10 );
+    OffsetAllocator::Handle d = allocator.Allocate( 30 );
+    OffsetAllocator::Handle e = allocator.Allocate( 10 );
+    passed &= Check( stream, allocator.get_Offset( a ) == 0 && allocator.get_Offset( b ) == 10 && allocator.get_Offset( c ) == 30 &&
+        allocator.get_Offset( d ) == 40 && allocator.get_Offset( e ) == 70 && allocator.get_UsedSize() == 80, "allocations are placed one after another" );
+
+    // [a][free 10..30][c][free 40..70][e][free 80..110]
+    allocator.Free( b );
+    allocator.Free( d );
+    passed &= Check( stream, allocator.get_FreeRangeCount() == 3 && allocator.get_LargestFreeRange() == 30, "freed ranges without free neighbours are kept separate" );
+
+    // The 20 element range at 10 is the smallest one that fits. The most recently freed handle is reused.
+    OffsetAllocator::Handle f = allocator.Allocate( 15 );
+    passed &= Check( stream, allocator.get_Offset( f ) == 10, "best fit uses the smallest free range that is large enough" );
+    passed &= Check( stream, f == d && allocator.get_AllocationCount() == 4, "a freed handle is reused" );
+
+    // [a][f 10..25][free 25..30][c][free 40..70][e][free 80..110]
+    // Freeing c merges it with the free ranges on both sides into 25..70.
+    allocator.Free( c );
+    passed &= Check( stream, allocator.get_FreeRangeCount() == 2 && allocator.get_LargestFreeRange() == 45, "a freed range is merged with both neighbours" );
+
+    passed &= Check( stream, allocator.Allocate( 60 ) == OffsetAllocator::InvalidHandle, "an allocation larger than every free range fails" );
+
+    // Only e needs to move to compact [a 0..10][f 10..25][e 25..35].
+    std::vector<OffsetAllocator::Move> moves;
+    allocator.Defragment( moves );
+    passed &= Check( stream, moves.size() == 1 && moves[0].Allocation == e && moves[0].SourceOffset == 70 &&
+        moves[0].DestinationOffset == 25 && moves[0].Size == 10, "defragmenting moves only the allocations after a gap" );
+    passed &= Check( stream, allocator.get_Offset( a ) == 0 && allocator.get_Offset( f ) == 10 && allocator.get_Offset( e ) == 25, "the allocations are compact after defragmenting" );
+    passed &= Check( stream, allocator.get_FreeRangeCount() == 1 && allocator.get_LargestFreeRange() == 75 && allocator.get_UsedSize() == 35, "the free space is a single range after defragmenting" );
+
+    OffsetAllocator::Handle g = allocator.Allocate( 60 );
+    passed &= Check( stream, g != OffsetAllocator::InvalidHandle && allocator.get_Offset( g ) == 35, "the defragmented free range can be allocated" );
+
+    return passed;
+}
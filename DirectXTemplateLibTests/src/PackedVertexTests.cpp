@@ -0,0 +1,114 @@
+#include <DirectXTemplateLibTestsPCH.h>
+#include <Tests.h>
+#include <Mesh.h>
+#include <PackedVertex.h>
+
+using namespace DirectX;
+
+// Encode and decode random vertices and check the errors against the bounds that are
+// documented in PackedVertex.h.
+bool TestPackedVertices( std::ostream& stream )
+{
+    static const size_t VertexCount = 100000;
+    // The largest angle between a normal and its decoded octahedral encoding.
+    static const float MaxNormalAngle = 0.01f;
+    // Rounding errors of the float arithmetic in the encoders and decoders.
+    static const float Epsilon = 1e-6f;
+
+    std::mt19937 random;
+    std::normal_distribution<float> direction;
+    std::uniform_real_distribution<float> x( -3.0f, 5.0f );
+    std::uniform_real_distribution<float> y( 10.0f, 12.0f );
+    std::uniform_real_distribution<float> z( -0.5f, 0.5f );
+    std::uniform_real_distribution<float> textureCoordinate( 0.0f, 1.0f );
+
+    VertexCollection vertices( VertexCount );
+    for ( VertexPositionNormalTexture& vertex : vertices )
+    {
+        vertex.position = XMFLOAT3( x( random ), y( random ), z( random ) );
+        XMStoreFloat3( &vertex.normal, XMVector3Normalize( XMVectorSet( direction( random ), direction( random ), direction( random ), 0 ) ) );
+        vertex.textureCoordinate = XMFLOAT2( textureCoordinate( random ), textureCoordinate( random ) );
+    }
+
+    // The axes and the diagonals lie on the edges and vertices of the octahedron.
+    static const XMFLOAT3 Directions[] =
+    {
+        XMFLOAT3( 1, 0, 0 ), XMFLOAT3( -1, 0, 0 ), XMFLOAT3( 0, 1, 0 ), XMFLOAT3( 0, -1, 0 ), XMFLOAT3( 0, 0, 1 ), XMFLOAT3( 0, 0, -1 ),
+        XMFLOAT3( 1, 1, 1 ), XMFLOAT3( -1, 1, -1 ), XMFLOAT3( 1, -1, -1 ), XMFLOAT3( -1, -1, 1 ),
+    };
+    for ( size_t i = 0; i < _countof( Directions ); ++i )
+    {
+        XMStoreFloat3( &vertices[i].normal, XMVector3Normalize( XMLoadFloat3( &Directions[i] ) ) );
+    }
+
+    PositionQuantization halfQuantization = ComputeHalfQuantization( vertices );
+    PositionQuantization unorm16Quantization = ComputeUnorm16Quantization( vertices );
+
+    XMVECTOR center = XMLoadFloat3( &halfQuantization.Offset );
+    XMVECTOR unorm16Bound = XMLoadFloat3( &unorm16Quantization.Scale ) / ( 2.0f * 65535.0f ) + XMVectorReplicate( Epsilon * 12.0f );
+
+    // The angle in degrees between two directions. The arc cosine of the dot product is
+    // not accurate enough for angles this small.
+    auto angleBetween = []( FXMVECTOR a, FXMVECTOR b )
+    {
+        return XMConvertToDegrees( atan2f( XMVectorGetX( XMVector3Length( XMVector3Cross( a, b ) ) ), XMVectorGetX( XMVector3Dot( a, b ) ) ) );
+    };
+
+    float maxAngle = 0.0f;
+    XMVECTOR maxHalfError = XMVectorZero();
+    XMVECTOR maxUnorm16Error = XMVectorZero();
+    XMVECTOR maxTextureCoordinateError = XMVectorZero();
+    bool halfPositionsInBounds = true;
+    bool unorm16PositionsInBounds = true;
+    bool textureCoordinatesInBounds = true;
+
+    for ( const VertexPositionNormalTexture& vertex : vertices )
+    {
+        XMVECTOR position = XMLoadFloat3( &vertex.position );
+        XMVECTOR normal = XMLoadFloat3( &vertex.normal );
+        XMVECTOR uv = XMLoadFloat2( &vertex.textureCoordinate );
+
+        VertexPositionNormalTextureHalf halfVertex;
+        VertexPositionNormalTexture decodedVertex;
+        EncodeVertex( vertex, halfQuantization, halfVertex );
+        DecodeVertex( halfVertex, halfQuantization, decodedVertex );
+
+        XMVECTOR error = XMVectorAbs( XMLoadFloat3( &decodedVertex.position ) - position );
+        XMVECTOR bound = XMVectorAbs( position - center ) * ( 1.0f / 2048.0f ) + XMVectorReplicate( Epsilon * 12.0f );
+        halfPositionsInBounds &= XMVector3LessOrEqual( error, bound );
+        maxHalfError = XMVectorMax( maxHalfError, error );
+
+        float angle = angleBetween( normal, XMLoadFloat3( &decodedVertex.normal ) );
+        maxAngle = std::max( maxAngle, angle );
+
+        error = XMVectorAbs( XMLoadFloat2( &decodedVertex.textureCoordinate ) - uv );
+        bound = XMVectorAbs( uv ) * ( 1.0f / 2048.0f ) + XMVectorReplicate( Epsilon * 0.1f );
+        textureCoordinatesInBounds &= XMVector2LessOrEqual( error, bound );
+        maxTextureCoordinateError = XMVectorMax( maxTextureCoordinateError, error );
+
+        VertexPositionNormalTextureUnorm16 unorm16Vertex;
+        EncodeVertex( vertex, unorm16Quantization, unorm16Vertex );
+        DecodeVertex( unorm16Vertex, unorm16Quantization, decodedVertex );
+
+        error = XMVectorAbs( XMLoadFloat3( &decodedVertex.position ) - position );
+        unorm16PositionsInBounds &= XMVector3LessOrEqual( error, unorm16Bound );
+        maxUnorm16Error = XMVectorMax( maxUnorm16Error, error );
+
+        angle = angleBetween( normal, XMLoadFloat3( &decodedVertex.normal ) );
+        maxAngle = std::max( maxAngle, angle );
+    }
+
+    auto maxComponent = []( FXMVECTOR v ) { return std::max( { XMVectorGetX( v ), XMVectorGetY( v ), XMVectorGetZ( v ) } ); };
+
+    bool passed = true;
+    std::string description = "octahedral normals are within " + std::to_string( MaxNormalAngle ) + " degrees, max angle " + std::to_string( maxAngle );
+    passed &= Check( stream, maxAngle < MaxNormalAngle, description.c_str() );
+    description = "half positions are within 2^-11 of the distance to the center, max error " + std::to_string( maxComponent( maxHalfError ) );
+    passed &= Check( stream, halfPositionsInBounds, description.c_str() );
+    description = "unorm16 positions are within size / (2 * 65535), max error " + std::to_string( maxComponent( maxUnorm16Error ) );
+    passed &= Check( stream, unorm16PositionsInBounds, description.c_str() );
+    description = "half texture coordinates are within 2^-11, max error " + std::to_string( std::max( XMVectorGetX( maxTextureCoordinateError ), XMVectorGetY( maxTextureCoordinateError ) ) );
+    passed &= Check( stream, textureCoordinatesInBounds, description.c_str() );
+
+    return passed;
+}
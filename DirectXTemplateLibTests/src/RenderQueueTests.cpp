@@ -0,0 +1,64 @@
+#include <DirectXTemplateLibTestsPCH.h>
+#include <Tests.h>
+#include <RenderQueue.h>
+
+// Whether the items are in key order and items with equal keys are in submission order.
+static bool IsSortedAndStable( const std::vector<RenderItem>& items )
+{
+    for ( size_t i = 1; i < items.size(); ++i )
+    {
+        if ( items[i - 1].Key > items[i].Key || ( items[i - 1].Key == items[i].Key && items[i - 1].Data > items[i].Data ) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// The sort is stable, only makes passes over the bytes that differ between the keys, and gives
+// the same result when a queue is sorted again with other keys.
+bool TestRenderQueue( std::ostream& stream )
+{
+    bool passed = true;
+
+    RenderQueue queue;
+    for ( UINT i = 0; i < 100; ++i )
+    {
+        queue.Submit( 0x0123456789ABCDEFull, i );
+    }
+    queue.Sort();
+    passed &= Check( stream, queue.get_SortPassCount() == 0 && IsSortedAndStable( queue.get_Items() ), "identical keys take no passes" );
+
+    // The keys only differ in their second byte.
+    queue.Clear();
+    for ( UINT i = 0; i < 100; ++i )
+    {
+        queue.Submit( ( static_cast<uint64_t>( ( i * 7 ) % 5 ) << 8 ) | 0xFF, i );
+    }
+    queue.Sort();
+    passed &= Check( stream, queue.get_SortPassCount() == 1 && IsSortedAndStable( queue.get_Items() ), "keys that differ in one byte take one pass" );
+
+    // Random keys with duplicates, sorted twice so the second sort starts with the counts of the first one cleared.
+    std::mt19937_64 random( 42 );
+    bool sorted = true;
+    for ( int round = 0; round < 2; ++round )
+    {
+        queue.Clear();
+        for ( UINT i = 0; i < 1000; ++i )
+        {
+            queue.Submit( random() & 0xFFFF0000FFFF00FFull, 2 * i );
+            queue.Submit( queue.get_Items().back().Key, 2 * i + 1 );
+        }
+        queue.Sort();
+        sorted &= queue.get_Items().size() == 2000 && queue.get_SortPassCount() <= 5 && IsSortedAndStable( queue.get_Items() );
+    }
+    passed &= Check( stream, sorted, "random keys are sorted stably every time the queue is sorted" );
+
+    RenderKey key( 3, true, 5, 7, 11, RenderKey::QuantizeDepth( 2.5f ) );
+    RenderKey unpacked = RenderKey::Unpack( key.Pack() );
+    passed &= Check( stream, unpacked.Layer == 3 && unpacked.Translucent && unpacked.Shader == 5 && unpacked.Material == 7 &&
+        unpacked.Mesh == 11 && unpacked.Depth == key.Depth, "a packed key unpacks to the same fields" );
+
+    return passed;
+}
@@ -0,0 +1,66 @@
+#include <DirectXTemplateLibTestsPCH.h>
+#include <Tests.h>
+#include <RingBufferAllocator.h>
+
+// Ranges are aligned and the padding counts as used, ranges are released by the fence values of
+// their frames, an allocation that does not fit at the end wraps around to the beginning, and an
+// allocation that does not fit behind the frames in flight discards the ring.
+bool TestRingBufferAllocator( std::ostream& stream )
+{
+    bool passed = true;
+    bool discard = false;
+
+    RingBufferAllocator allocator( 256 );
+
+    // Frame 1: [a 0..10][padding 10..16][b 16..32][c 32..36]
+    UINT a = allocator.Allocate( 10, 1, discard );
+    UINT b = allocator.Allocate( 16, 16, discard );
+    UINT c = allocator.Allocate( 4, 4, discard );
+    passed &= Check( stream, a == 0 && b == 16 && c == 32 && !discard, "ranges are placed after the previous range at the next aligned offset" );
+    passed &= Check( stream, allocator.get_UsedSize() == 36, "the alignment padding is part of the used size" );
+    allocator.FinishFrame( 1 );
+
+    // Frame 2: [d 36..136]
+    UINT d = allocator.Allocate( 100, 1, discard );
+    allocator.FinishFrame( 2 );
+    passed &= Check( stream, d == 36 && allocator.get_UsedSize() == 136 && allocator.get_FrameCount() == 2, "the ranges of a frame stay in use after the frame has finished" );
+
+    allocator.ReleaseFrames( 0 );
+    passed &= Check( stream, allocator.get_UsedSize() == 136 && allocator.get_FrameCount() == 2, "no frame is released before its fence value has completed" );
+
+    allocator.ReleaseFrames( 1 );
+    passed &= Check( stream, allocator.get_UsedSize() == 100 && allocator.get_FrameCount() == 1, "completing a fence value releases the ranges of its frame only" );
+
+    // Frame 3: [f 0..30][free 30..36][d 36..136][e 136..236][skipped 236..256]
+    // f does not fit at the end, so it wraps around to the space that frame 1 released.
+    UINT e = allocator.Allocate( 100, 1, discard );
+    UINT f = allocator.Allocate( 30, 1, discard );
+    allocator.FinishFrame( 3 );
+    passed &= Check( stream, e == 136 && f == 0 && !discard, "a range that does not fit at the end wraps around to the beginning" );
+    passed &= Check( stream, allocator.get_UsedSize() == 250, "the skipped end of the ring is part of the used size" );
+
+    // Frame 4: Only 6 bytes are free between frame 3 and frame 2, which are both still in flight.
+    UINT g = allocator.Allocate( 8, 1, discard );
+    passed &= Check( stream, g == 0 && discard, "a range that does not fit behind the frames in flight discards the ring" );
+    passed &= Check( stream, allocator.get_UsedSize() == 8 && allocator.get_FrameCount() == 0, "discarding the ring drops the frames in flight" );
+    allocator.FinishFrame( 4 );
+
+    // Frames 5 and 6: [g 0..8][h 8..108][i 108..158]
+    UINT h = allocator.Allocate( 100, 1, discard );
+    allocator.FinishFrame( 5 );
+    UINT i = allocator.Allocate( 50, 1, discard );
+    allocator.FinishFrame( 6 );
+    passed &= Check( stream, h == 8 && i == 108 && !discard, "allocations continue after the discarded range" );
+
+    // The fence values of frames 4 and 5 have completed.
+    allocator.ReleaseFrames( 5 );
+    passed &= Check( stream, allocator.get_UsedSize() == 50 && allocator.get_FrameCount() == 1, "completing a fence value releases all frames up to it" );
+
+    allocator.ReleaseFrames( 6 );
+    UINT j = allocator.Allocate( 16, 16, discard );
+    passed &= Check( stream, j == 0 && !discard && allocator.get_UsedSize() == 16, "an empty ring starts again at the beginning without a discard" );
+
+    passed &= Check( stream, allocator.Allocate( 257, 1, discard ) == RingBufferAllocator::InvalidOffset, "a range larger than the ring fails" );
+
+    return passed;
+}
@@ -0,0 +1,34 @@
+#include <DirectXTemplateLibTestsPCH.h>
+#include <Tests.h>
+#include <RecordingDeviceContext.h>
+#include <StateFilteringDeviceContext.h>
+
+// Repeated bindings are dropped until an output is bound, which may unbind the inputs.
+bool TestStateFilter( std::ostream& stream )
+{
+    Microsoft::WRL::ComPtr<RecordingDeviceContext> recordingDeviceContext;
+    recordingDeviceContext.Attach( new RecordingDeviceContext() );
+    Microsoft::WRL::ComPtr<StateFilteringDeviceContext> stateFilteringDeviceContext;
+    stateFilteringDeviceContext.Attach( new StateFilteringDeviceContext( recordingDeviceContext.Get() ) );
+
+    ID3D11ShaderResourceView* shaderResourceViews[1] = { nullptr };
+
+    bool passed = true;
+
+    stateFilteringDeviceContext->PSSetShaderResources( 0, 1, shaderResourceViews );
+    passed &= Check( stream, recordingDeviceContext->get_CallCount( DeviceContextWrapper::PSSetShaderResourcesCall ) == 1, "the first binding is forwarded" );
+
+    stateFilteringDeviceContext->PSSetShaderResources( 0, 1, shaderResourceViews );
+    passed &= Check( stream, recordingDeviceContext->get_CallCount( DeviceContextWrapper::PSSetShaderResourcesCall ) == 1 &&
+        stateFilteringDeviceContext->get_ElidedCallCount( DeviceContextWrapper::PSSetShaderResourcesCall ) == 1, "a repeated binding is dropped" );
+
+    stateFilteringDeviceContext->OMSetRenderTargets( 0, nullptr, nullptr );
+    stateFilteringDeviceContext->PSSetShaderResources( 0, 1, shaderResourceViews );
+    passed &= Check( stream, recordingDeviceContext->get_CallCount( DeviceContextWrapper::PSSetShaderResourcesCall ) == 2, "the binding is forwarded after OMSetRenderTargets" );
+
+    stateFilteringDeviceContext->ClearState();
+    stateFilteringDeviceContext->PSSetShaderResources( 0, 1, shaderResourceViews );
+    passed &= Check( stream, recordingDeviceContext->get_CallCount( DeviceContextWrapper::PSSetShaderResourcesCall ) == 3, "the binding is forwarded after ClearState" );
+
+    return passed;
+}
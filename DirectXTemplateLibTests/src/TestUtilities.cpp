@@ -0,0 +1,21 @@
+#include <DirectXTemplateLibTestsPCH.h>
+#include <Tests.h>
+
+// Print the result of a single self-test check.
+bool Check( std::ostream& stream, bool condition, const char* description )
+{
+    stream << ( condition ? "PASS " : "FAIL " ) << description << std::endl;
+    return condition;
+}
+
+// Create a WARP device that is limited to the given feature level.
+Microsoft::WRL::ComPtr<ID3D11DeviceContext> CreateWarpDeviceContext( D3D_FEATURE_LEVEL featureLevel )
+{
+    Microsoft::WRL::ComPtr<ID3D11Device> device;
+    Microsoft::WRL::ComPtr<ID3D11DeviceContext> deviceContext;
+    if ( FAILED( D3D11CreateDevice( nullptr, D3D_DRIVER_TYPE_WARP, nullptr, 0, &featureLevel, 1, D3D11_SDK_VERSION, &device, nullptr, &deviceContext ) ) )
+    {
+        deviceContext.Reset();
+    }
+    return deviceContext;
+}
@@ -0,0 +1,59 @@
+#include <DirectXTemplateLibTestsPCH.h>
+#include <Tests.h>
+
+// Run the self-tests and return the number of failed tests.
+static int RunSelfTests( std::ostream& stream )
+{
+    typedef bool (*TestFunction)( std::ostream& );
+    static const std::pair<const char*, TestFunction> Tests[] =
+    {
+        { "Index format", &TestIndexFormat },
+        { "Mesh generators", &TestMeshGenerators },
+        { "Packed vertices", &TestPackedVertices },
+        { "Geometry cache", &TestGeometryCache },
+        { "Weld sphere", &TestWeldSphere },
+        { "Vertex cache", &TestVertexCache },
+        { "Projection", &TestProjection },
+        { "Depth precision", &TestDepthPrecision },
+        { "State filter", &TestStateFilter },
+        { "Mesh clusters", &TestMeshClusters },
+        { "Offset allocator", &TestOffsetAllocator },
+        { "Frame pipeline", &TestFramePipeline },
+        { "Job system", &TestJobSystem },
+        { "Ring buffer allocator", &TestRingBufferAllocator },
+        { "Render queue", &TestRenderQueue },
+    };
+
+    int failedCount = 0;
+    for ( const auto& test : Tests )
+    {
+        stream << test.first << ":" << std::endl;
+        if ( !test.second( stream ) )
+        {
+            ++failedCount;
+        }
+        stream << std::endl;
+    }
+
+    stream << failedCount << " of " << _countof( Tests ) << " tests failed." << std::endl;
+    return failedCount;
+}
+
+// Run the self-tests and return the number of failed tests.
+// With "-meshbenchmark" the mesh generators are benchmarked and the vertex cache
+// statistics of the demo's shapes are printed instead.
+int main( int argc, char* argv[] )
+{
+    for ( int i = 1; i < argc; ++i )
+    {
+        if ( strcmp( argv[i], "-meshbenchmark" ) == 0 )
+        {
+            RunMeshGenerationBenchmark( std::cout );
+            std::cout << std::endl;
+            RunVertexCacheReport( std::cout );
+            return 0;
+        }
+    }
+
+    return RunSelfTests( std::cout );
+}
@@ -9,9 +9,10 @@ struct AppData
     float3 Position : POSITION;
     float3 Normal   : NORMAL;
     float2 TexCoord : TEXCOORD;
-    // Per-instance data
+    // Per-instance data (see MeshInstance)
     matrix Matrix   : WORLDMATRIX;
     matrix InverseTranspose : INVERSETRANSPOSEWORLDMATRIX;
+    uint MaterialIndex : MATERIALINDEX;
 };
 
 struct VertexShaderOutput
@@ -19,6 +20,7 @@ struct VertexShaderOutput
     float4 PositionWS   : TEXCOORD1;
     float3 NormalWS     : TEXCOORD2;
     float2 TexCoord     : TEXCOORD0;
+    nointerpolation uint MaterialIndex : MATERIALINDEX;
     float4 Position     : SV_Position;
 };
 
@@ -32,6 +34,7 @@ VertexShaderOutput InstancedVertexShader( AppData IN )
     OUT.PositionWS = mul( IN.Matrix, float4( IN.Position, 1.0f ) );
     OUT.NormalWS = mul( (float3x3)IN.InverseTranspose, IN.Normal );
     OUT.TexCoord = IN.TexCoord;
+    OUT.MaterialIndex = IN.MaterialIndex;
 
     return OUT;
 }
\ No newline at end of file
@@ -24,10 +24,11 @@ struct _Material
     //----------------------------------- (16 byte boundary)
 };  // Total:               // 80 bytes ( 5 * 16 )
 
-cbuffer MaterialProperties : register(b0)
-{
-    _Material Material;
-};
+// The material table. Each draw or instance selects its material with an index.
+StructuredBuffer<_Material> Materials : register(t1);
+
+// The material of the pixel that is shaded (loaded from the material table in the entry point).
+static _Material Material;
 
 struct Light
 {
@@ -186,10 +187,13 @@ struct PixelShaderInput
     float4 PositionWS   : TEXCOORD1;
     float3 NormalWS     : TEXCOORD2;
     float2 TexCoord     : TEXCOORD0;
+    nointerpolation uint MaterialIndex : MATERIALINDEX;
 };
 
 float4 TexturedLitPixelShader( PixelShaderInput IN ) : SV_TARGET
 {
+    Material = Materials[IN.MaterialIndex];
+
     LightingResult lit = ComputeLighting( IN.PositionWS, normalize(IN.NormalWS) );
     
     float4 emissive = Material.Emissive;
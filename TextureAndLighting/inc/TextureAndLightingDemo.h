@@ -3,6 +3,12 @@
 #include <Game.h>
 #include <Camera.h>
 #include <Mesh.h>
+#include <MeshBufferPool.h>
+#include <FrustumCuller.h>
+#include <CameraPath.h>
+#include <ConstantBufferRing.h>
+#include <StructuredBufferTable.h>
+#include <RenderQueue.h>
 
 #define MAX_LIGHTS 8
 
@@ -33,11 +39,6 @@ struct _Material
     //----------------------------------- (16 byte boundary)
 }; // Total:                                80 bytes (5 * 16)
 
-struct MaterialProperties
-{
-    _Material   Material;
-};
-
 enum LightType
 {
     DirectionalLight    = 0,
@@ -110,6 +111,12 @@ public:
      */
     virtual void UnloadContent();
 
+    /**
+     * Write the frustum culling statistics to a stream about once per second.
+     * The report is disabled if the stream is nullptr (the default).
+     */
+    void set_CullingReportStream( std::ostream* stream );
+
 protected:
     // Don't allow copying of the demo.
     TextureAndLightingDemo( const TextureAndLightingDemo& copy );
@@ -130,10 +137,20 @@ protected:
 private:
     Camera m_Camera;
 
+    // Record the camera movement (F5) and play it back (F6) for reproducible benchmarks.
+    CameraPathRecorder m_CameraPathRecorder;
+    CameraPathPlayer m_CameraPathPlayer;
+    CameraPath m_CameraPath;
+
     __declspec(align(16)) struct AlignedData
     {
         DirectX::XMVECTOR m_InitialCameraPos;
         DirectX::XMVECTOR m_InitialCameraRot;
+        // The camera pose after the last two updates. The rendered pose is interpolated between them.
+        DirectX::XMVECTOR m_PreviousCameraPos;
+        DirectX::XMVECTOR m_PreviousCameraRot;
+        DirectX::XMVECTOR m_CurrentCameraPos;
+        DirectX::XMVECTOR m_CurrentCameraRot;
     };
     AlignedData* pData;
 
@@ -157,32 +174,40 @@ private:
 
     // Vertex shader for instanced rendering.
     Microsoft::WRL::ComPtr<ID3D11VertexShader> m_d3dInstancedVertexShader;
-    // Vertex shader for simple (non-instanced) geometry.
-    Microsoft::WRL::ComPtr<ID3D11VertexShader> m_d3dSimplVertexShader;
     Microsoft::WRL::ComPtr<ID3D11PixelShader> m_d3dTexturedLitPixelShader;
 
     Microsoft::WRL::ComPtr<ID3D11InputLayout> m_d3dInstancedInputLayout;
 
-    // Per-Frame constant buffer defined in the instanced vertex shader.
-    Microsoft::WRL::ComPtr<ID3D11Buffer> m_d3dPerFrameConstantBuffer;
-    // Per-Object constant buffer defined in the simple vertex shader.
-    Microsoft::WRL::ComPtr<ID3D11Buffer> m_d3dPerObjectConstantBuffer;
+    // The per-frame constants of the instanced vertex shader are written once per frame and
+    // bound with constant buffer offsets.
+    ConstantBufferRing m_ConstantBufferRing;
+    Microsoft::WRL::ComPtr<ID3D11DeviceContext1> m_d3dDeviceContext1;
 
-    // Material properties defined in the pixel shader
-    Microsoft::WRL::ComPtr<ID3D11Buffer> m_d3dMaterialPropertiesConstantBuffer;
-    std::vector<MaterialProperties> m_MaterialProperties;
+    // The material table of the pixel shader. Draws and instances select their material by index
+    // and only the materials that have changed are uploaded.
+    StructuredBufferTable m_MaterialTable;
 
     // Light properties defined in the pixel shader
     Microsoft::WRL::ComPtr<ID3D11Buffer> m_d3dLightPropertiesConstantBuffer;
     LightProperties m_LightProperties;
 
     // Create some geometric primitives for the scene.
-    // The outer walls of our room.
-    Microsoft::WRL::ComPtr<ID3D11InputLayout> m_d3dVertexPositionNormalTextureInputLayout;
     std::unique_ptr<Mesh> m_Sphere;
     std::unique_ptr<Mesh> m_Cube;
     std::unique_ptr<Mesh> m_Cone;
     std::unique_ptr<Mesh> m_Torus;
+    // Holds the geometry of all shapes.
+    std::shared_ptr<MeshBufferPool> m_MeshBufferPool;
+    // The per-frame instances of the shapes.
+    MeshInstanceStream m_InstanceStream;
+    // Sorts the draws of a frame by layer, shader, material, mesh and depth.
+    RenderQueue m_RenderQueue;
+
+    // Culls the shapes against the view frustum before they are drawn.
+    FrustumCuller m_FrustumCuller;
+    // Receives the culling statistics (if not null) and the time since they were last written.
+    std::ostream* m_CullingReportStream;
+    float m_CullingReportTime;
 
     // Some textures used by our demo.
     Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_DirectXTexture;
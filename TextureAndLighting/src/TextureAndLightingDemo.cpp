@@ -2,13 +2,18 @@
 #include <TextureAndLightingDemo.h>
 
 #include <Window.h>
+#include <GeometryCache.h>
+#include <Profiler.h>
+#include <JobSystem.h>
+#include <HighResolutionClock.h>
+
+#include <fstream>
+#include <random>
 
 #if _DEBUG
-#include <SimpleVertexShader_d.h>
 #include <InstancedVertexShader_d.h>
 #include <TexturedLitPixelShader_d.h>
 #else
-#include <SimpleVertexShader.h>
 #include <InstancedVertexShader.h>
 #include <TexturedLitPixelShader.h>
 #endif
@@ -22,13 +27,6 @@ struct VertexPosNormTex
     XMFLOAT3 Normal;
     XMFLOAT2 Tex0;
 };
-// Per-instance data (must be 16 byte aligned)
-__declspec(align(16)) struct PlaneInstanceData
-{
-    XMMATRIX WorldMatrix;
-    XMMATRIX InverseTransposeWorldMatrix;
-};
-
 // Vertices for a unit plane.
 VertexPosNormTex g_PlaneVerts[4] =
 {
@@ -44,19 +42,23 @@ WORD g_PlaneIndex[6] =
     0, 1, 3, 1, 2, 3
 };
 
-// A structure to hold the data for a per-object constant buffer
-// defined in the vertex shader.
+// A structure to hold the data for the per-frame constant buffer
+// defined in the instanced vertex shader.
 struct PerFrameConstantBufferData
 {
     XMMATRIX ViewProjectionMatrix;
 };
 
-// This structure is used in the simple vertex shader.
-struct PerObjectConstantBufferData
+// The entries of the material table.
+enum MaterialTableEntry
 {
-    XMMATRIX WorldMatrix;
-    XMMATRIX InverseTransposeWorldMatrix;
-    XMMATRIX WorldViewProjectionMatrix;
+    EarthMaterial,
+    WallMaterial,
+    RedPlasticMaterial,
+    PearlMaterial,
+    // The emissive material of each light (set when the lights are rendered).
+    LightMaterial,
+    MaterialCount = LightMaterial + MAX_LIGHTS
 };
 
 TextureAndLightingDemo::TextureAndLightingDemo( Window& window )
@@ -72,6 +74,8 @@ TextureAndLightingDemo::TextureAndLightingDemo( Window& window )
     , m_Yaw( 0.0f )
     , m_bAnimate( false )
     , m_NumInstances( 6 )
+    , m_CullingReportStream( nullptr )
+    , m_CullingReportTime( 0.0f )
 {
     pData = (AlignedData*)_aligned_malloc( sizeof(AlignedData), 16 );
     
@@ -81,8 +85,16 @@ TextureAndLightingDemo::TextureAndLightingDemo( Window& window )
 
     m_Camera.set_LookAt( cameraPos, cameraTarget, cameraUp );
 
+    // Use reverse depth with an infinite far plane and a floating-point depth buffer.
+    m_Camera.set_DepthMode( Camera::ReverseDepth );
+    m_Camera.set_InfiniteFarPlane( true );
+    m_DepthStencilFormat = DXGI_FORMAT_D32_FLOAT_S8X24_UINT;
+    m_DepthComparison = m_Camera.get_DepthComparison();
+
     pData->m_InitialCameraPos = m_Camera.get_Translation();
     pData->m_InitialCameraRot = m_Camera.get_Rotation();
+    pData->m_PreviousCameraPos = pData->m_CurrentCameraPos = pData->m_InitialCameraPos;
+    pData->m_PreviousCameraRot = pData->m_CurrentCameraRot = pData->m_InitialCameraRot;
 }
 
 TextureAndLightingDemo::~TextureAndLightingDemo()
@@ -92,8 +104,66 @@ TextureAndLightingDemo::~TextureAndLightingDemo()
     _aligned_free(pData);
 }
 
+// The name of the mesh cache file of a procedural shape. All generation parameters are part
+// of the name, so a file that was saved with different parameters is never loaded.
+static std::wstring GetMeshFileName( const GeometryKey& key, bool rhcoords, unsigned int flags, size_t levelsOfDetail )
+{
+    static const wchar_t* ShapeNames[] = { L"Cube", L"Sphere", L"Cone", L"Torus" };
+
+    std::wostringstream fileName;
+    fileName << ShapeNames[key.Shape] << L"_" << key.Parameters[0] << L"_" << key.Parameters[1] << L"_" << key.Tessellation
+        << ( rhcoords ? L"_rh" : L"_lh" ) << L"_f" << flags << L"_lod" << levelsOfDetail << L".mesh";
+    return fileName.str();
+}
+
+// Load a procedural shape from its mesh cache file. If the file does not exist (or is out of date)
+// the mesh is created and saved to the file so it does not need to be generated the next time.
+static std::unique_ptr<Mesh> LoadOrCreateMesh( ID3D11DeviceContext* deviceContext, const GeometryKey& key, bool rhcoords, unsigned int flags, size_t levelsOfDetail )
+{
+    PROFILE_FUNCTION();
+
+    const std::wstring fileName = GetMeshFileName( key, rhcoords, flags, levelsOfDetail );
+
+    try
+    {
+        return Mesh::Load( deviceContext, fileName );
+    }
+    catch ( std::exception& )
+    {}
+
+    std::unique_ptr<Mesh> mesh;
+    switch ( key.Shape )
+    {
+    case GeometryKey::Cube:
+        mesh = Mesh::CreateCube( deviceContext, key.Parameters[0], rhcoords, flags );
+        break;
+    case GeometryKey::Sphere:
+        mesh = Mesh::CreateSphere( deviceContext, key.Parameters[0], key.Tessellation, rhcoords, flags, levelsOfDetail );
+        break;
+    case GeometryKey::Cone:
+        mesh = Mesh::CreateCone( deviceContext, key.Parameters[0], key.Parameters[1], key.Tessellation, rhcoords, flags, levelsOfDetail );
+        break;
+    case GeometryKey::Torus:
+        mesh = Mesh::CreateTorus( deviceContext, key.Parameters[0], key.Parameters[1], key.Tessellation, rhcoords, flags, levelsOfDetail );
+        break;
+    }
+
+    try
+    {
+        mesh->Save( deviceContext, fileName );
+    }
+    catch ( std::exception& )
+    {
+        // The cache file is optional.
+    }
+
+    return mesh;
+}
+
 bool TextureAndLightingDemo::LoadContent()
 {
+    PROFILE_FUNCTION();
+
     HRESULT hr = 0;
 
     m_EffectFactory = std::unique_ptr<EffectFactory>(new EffectFactory(m_d3dDevice.Get()));
@@ -101,6 +171,8 @@ bool TextureAndLightingDemo::LoadContent()
 
     try 
     {
+        // The DirectXTK texture loaders are profiled from here.
+        PROFILE_SCOPE( "LoadTextures" );
         m_EffectFactory->CreateTexture( L"Textures\\DirectX9.png", m_d3dDeviceContext.Get(), &m_DirectXTexture );
         m_EffectFactory->CreateTexture( L"Textures\\earth.dds", m_d3dDeviceContext.Get(), &m_EarthTexture );
     }
@@ -135,29 +207,38 @@ bool TextureAndLightingDemo::LoadContent()
         return false;
     }
 
+    // Create the material table. The materials are uploaded before the first frame is rendered.
+    if ( !m_MaterialTable.Initialize( m_d3dDevice.Get(), sizeof(_Material), MaterialCount ) )
+    {
+        MessageBoxA(m_Window.get_WindowHandle(), "Failed to create the material table.", "Error", MB_OK|MB_ICONERROR );
+        return false;
+    }
+
     // Create some materials
-    MaterialProperties defaultMaterial;
-    m_MaterialProperties.push_back( defaultMaterial );
-
-    MaterialProperties greenMaterial;
-    greenMaterial.Material.Ambient = XMFLOAT4(  0.07568f, 0.61424f, 0.07568f, 1.0f );
-    greenMaterial.Material.Diffuse = XMFLOAT4( 0.07568f, 0.61424f, 0.07568f, 1.0f );
-    greenMaterial.Material.Specular = XMFLOAT4( 0.07568f, 0.61424f, 0.07568f, 1.0f );
-    greenMaterial.Material.SpecularPower = 76.8f;
-    m_MaterialProperties.push_back( greenMaterial );
-
-    MaterialProperties redPlasticMaterial;
-    redPlasticMaterial.Material.Diffuse = XMFLOAT4( 0.6f, 0.1f, 0.1f, 1.0f );
-    redPlasticMaterial.Material.Specular = XMFLOAT4( 1.0f, 0.2f, 0.2f, 1.0f );
-    redPlasticMaterial.Material.SpecularPower = 32.0f;
-    m_MaterialProperties.push_back( redPlasticMaterial );
-
-    MaterialProperties pearlMaterial;
-    pearlMaterial.Material.Ambient = XMFLOAT4( 0.25f, 0.20725f, 0.20725f, 1.0f );
-    pearlMaterial.Material.Diffuse = XMFLOAT4( 1.0f, 0.829f, 0.829f, 1.0f );
-    pearlMaterial.Material.Specular = XMFLOAT4( 0.296648f, 0.296648f, 0.296648f, 1.0f );
-    pearlMaterial.Material.SpecularPower = 11.264f;
-    m_MaterialProperties.push_back( pearlMaterial );
+    _Material earthMaterial;
+    earthMaterial.UseTexture = true;
+    m_MaterialTable.Set( EarthMaterial, earthMaterial );
+
+    _Material wallMaterial;
+    wallMaterial.Ambient = XMFLOAT4(  0.07568f, 0.61424f, 0.07568f, 1.0f );
+    wallMaterial.Diffuse = XMFLOAT4( 0.07568f, 0.61424f, 0.07568f, 1.0f );
+    wallMaterial.Specular = XMFLOAT4( 0.07568f, 0.61424f, 0.07568f, 1.0f );
+    wallMaterial.SpecularPower = 76.8f;
+    wallMaterial.UseTexture = true;
+    m_MaterialTable.Set( WallMaterial, wallMaterial );
+
+    _Material redPlasticMaterial;
+    redPlasticMaterial.Diffuse = XMFLOAT4( 0.6f, 0.1f, 0.1f, 1.0f );
+    redPlasticMaterial.Specular = XMFLOAT4( 1.0f, 0.2f, 0.2f, 1.0f );
+    redPlasticMaterial.SpecularPower = 32.0f;
+    m_MaterialTable.Set( RedPlasticMaterial, redPlasticMaterial );
+
+    _Material pearlMaterial;
+    pearlMaterial.Ambient = XMFLOAT4( 0.25f, 0.20725f, 0.20725f, 1.0f );
+    pearlMaterial.Diffuse = XMFLOAT4( 1.0f, 0.829f, 0.829f, 1.0f );
+    pearlMaterial.Specular = XMFLOAT4( 0.296648f, 0.296648f, 0.296648f, 1.0f );
+    pearlMaterial.SpecularPower = 11.264f;
+    m_MaterialTable.Set( PearlMaterial, pearlMaterial );
 
     // Create and initialize a vertex buffer for a plane.
     D3D11_BUFFER_DESC vertexBufferDesc;
@@ -181,7 +262,7 @@ bool TextureAndLightingDemo::LoadContent()
     }
 
     // Create and setup the per-instance buffer data
-    PlaneInstanceData* planeInstanceData = (PlaneInstanceData*)_aligned_malloc( sizeof(PlaneInstanceData) * m_NumInstances, 16 );
+    std::vector<MeshInstance> planeInstanceData( m_NumInstances );
 
     float scalePlane = 20.0f;
     float translateOffset = scalePlane / 2.0f;
@@ -191,48 +272,54 @@ bool TextureAndLightingDemo::LoadContent()
 
     // Floor plane.
     XMMATRIX worldMatrix = scaleMatrix * rotateMatrix * translateMatrix;
-    planeInstanceData[0].WorldMatrix = worldMatrix;
-    planeInstanceData[0].InverseTransposeWorldMatrix = XMMatrixTranspose( XMMatrixInverse(nullptr, worldMatrix) );
+    XMStoreFloat4x4( &planeInstanceData[0].WorldMatrix, worldMatrix );
+    XMStoreFloat4x4( &planeInstanceData[0].InverseTransposeWorldMatrix, XMMatrixTranspose( XMMatrixInverse(nullptr, worldMatrix) ) );
+    planeInstanceData[0].MaterialIndex = WallMaterial;
     
     // Back wall plane.
     translateMatrix = XMMatrixTranslation( 0, translateOffset, translateOffset );
     rotateMatrix = XMMatrixRotationX( XMConvertToRadians(-90) );
     worldMatrix = scaleMatrix * rotateMatrix * translateMatrix;
 
-    planeInstanceData[1].WorldMatrix = worldMatrix;
-    planeInstanceData[1].InverseTransposeWorldMatrix = XMMatrixTranspose( XMMatrixInverse(nullptr, worldMatrix) );
+    XMStoreFloat4x4( &planeInstanceData[1].WorldMatrix, worldMatrix );
+    XMStoreFloat4x4( &planeInstanceData[1].InverseTransposeWorldMatrix, XMMatrixTranspose( XMMatrixInverse(nullptr, worldMatrix) ) );
+    planeInstanceData[1].MaterialIndex = WallMaterial;
 
     // Ceiling plane.
     translateMatrix = XMMatrixTranslation( 0, translateOffset * 2.0f, 0 );
     rotateMatrix = XMMatrixRotationX( XMConvertToRadians(180) );
     worldMatrix = scaleMatrix * rotateMatrix * translateMatrix;
 
-    planeInstanceData[2].WorldMatrix = worldMatrix;
-    planeInstanceData[2].InverseTransposeWorldMatrix = XMMatrixTranspose( XMMatrixInverse(nullptr, worldMatrix) );
+    XMStoreFloat4x4( &planeInstanceData[2].WorldMatrix, worldMatrix );
+    XMStoreFloat4x4( &planeInstanceData[2].InverseTransposeWorldMatrix, XMMatrixTranspose( XMMatrixInverse(nullptr, worldMatrix) ) );
+    planeInstanceData[2].MaterialIndex = WallMaterial;
 
     // Front wall plane.
     translateMatrix = XMMatrixTranslation( 0, translateOffset, -translateOffset );
     rotateMatrix = XMMatrixRotationX( XMConvertToRadians(90) );
     worldMatrix = scaleMatrix * rotateMatrix * translateMatrix;
 
-    planeInstanceData[3].WorldMatrix = worldMatrix;
-    planeInstanceData[3].InverseTransposeWorldMatrix = XMMatrixTranspose( XMMatrixInverse(nullptr, worldMatrix) );
+    XMStoreFloat4x4( &planeInstanceData[3].WorldMatrix, worldMatrix );
+    XMStoreFloat4x4( &planeInstanceData[3].InverseTransposeWorldMatrix, XMMatrixTranspose( XMMatrixInverse(nullptr, worldMatrix) ) );
+    planeInstanceData[3].MaterialIndex = WallMaterial;
 
     // Left wall plane.
     translateMatrix = XMMatrixTranslation( -translateOffset, translateOffset, 0);
     rotateMatrix = XMMatrixRotationZ( XMConvertToRadians(-90) );
     worldMatrix = scaleMatrix * rotateMatrix * translateMatrix;
 
-    planeInstanceData[4].WorldMatrix = worldMatrix;
-    planeInstanceData[4].InverseTransposeWorldMatrix = XMMatrixTranspose( XMMatrixInverse(nullptr, worldMatrix) );
+    XMStoreFloat4x4( &planeInstanceData[4].WorldMatrix, worldMatrix );
+    XMStoreFloat4x4( &planeInstanceData[4].InverseTransposeWorldMatrix, XMMatrixTranspose( XMMatrixInverse(nullptr, worldMatrix) ) );
+    planeInstanceData[4].MaterialIndex = WallMaterial;
 
     // Right wall plane.
     translateMatrix = XMMatrixTranslation( translateOffset, translateOffset, 0);
     rotateMatrix = XMMatrixRotationZ( XMConvertToRadians(90) );
     worldMatrix = scaleMatrix * rotateMatrix * translateMatrix;
 
-    planeInstanceData[5].WorldMatrix = worldMatrix;
-    planeInstanceData[5].InverseTransposeWorldMatrix = XMMatrixTranspose( XMMatrixInverse(nullptr, worldMatrix) );
+    XMStoreFloat4x4( &planeInstanceData[5].WorldMatrix, worldMatrix );
+    XMStoreFloat4x4( &planeInstanceData[5].InverseTransposeWorldMatrix, XMMatrixTranspose( XMMatrixInverse(nullptr, worldMatrix) ) );
+    planeInstanceData[5].MaterialIndex = WallMaterial;
 
 
     // Create the per-instance vertex buffer.
@@ -240,16 +327,13 @@ bool TextureAndLightingDemo::LoadContent()
     ZeroMemory( &instanceBufferDesc, sizeof(D3D11_BUFFER_DESC) );
 
     instanceBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-    instanceBufferDesc.ByteWidth = sizeof( PlaneInstanceData ) * m_NumInstances;
+    instanceBufferDesc.ByteWidth = sizeof( MeshInstance ) * m_NumInstances;
     instanceBufferDesc.CPUAccessFlags = 0;
     instanceBufferDesc.Usage = D3D11_USAGE_DEFAULT;
 
-    resourceData.pSysMem = planeInstanceData;
+    resourceData.pSysMem = planeInstanceData.data();
 
     hr = m_d3dDevice->CreateBuffer( &instanceBufferDesc, &resourceData, &m_d3dPlaneInstanceBuffer );
-
-    _aligned_free( planeInstanceData );
-
     if ( FAILED(hr) )
     {
         MessageBoxA( m_Window.get_WindowHandle(), "Failed to create instance buffer.", "Error", MB_OK|MB_ICONERROR );
@@ -281,23 +365,11 @@ bool TextureAndLightingDemo::LoadContent()
         return false;
     }
 
-    // Create the input layout for rendering instanced vertex data.
-    D3D11_INPUT_ELEMENT_DESC vertexLayoutDesc[] = 
-    {
-        // Per-vertex data.
-        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-        { "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-        { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-        // Per-instance data.
-        { "WORLDMATRIX", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
-        { "WORLDMATRIX", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
-        { "WORLDMATRIX", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
-        { "WORLDMATRIX", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
-        { "INVERSETRANSPOSEWORLDMATRIX", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
-        { "INVERSETRANSPOSEWORLDMATRIX", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
-        { "INVERSETRANSPOSEWORLDMATRIX", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
-        { "INVERSETRANSPOSEWORLDMATRIX", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
-    };
+    // Create the input layout for rendering instanced vertex data. The planes and the shapes
+    // have the same vertex format and share the per-instance data.
+    D3D11_INPUT_ELEMENT_DESC vertexLayoutDesc[VertexPositionNormalTexture::InputElementCount + MeshInstance::InputElementCount];
+    std::copy( VertexPositionNormalTexture::InputElements, VertexPositionNormalTexture::InputElements + VertexPositionNormalTexture::InputElementCount, vertexLayoutDesc );
+    std::copy( MeshInstance::InputElements, MeshInstance::InputElements + MeshInstance::InputElementCount, vertexLayoutDesc + VertexPositionNormalTexture::InputElementCount );
 
     hr = m_d3dDevice->CreateInputLayout( vertexLayoutDesc, _countof(vertexLayoutDesc), g_InstancedVertexShader, sizeof(g_InstancedVertexShader), &m_d3dInstancedInputLayout );
     if ( FAILED(hr) )
@@ -313,44 +385,29 @@ bool TextureAndLightingDemo::LoadContent()
         return false;
     }
 
-    // Create a constant buffer for the per-frame data required by the instanced vertex shader.
-    D3D11_BUFFER_DESC constantBufferDesc;
-    ZeroMemory( &constantBufferDesc, sizeof(D3D11_BUFFER_DESC) );
-
-    constantBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-    constantBufferDesc.ByteWidth = sizeof( PerFrameConstantBufferData );
-    constantBufferDesc.CPUAccessFlags = 0;
-    constantBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-
-    hr = m_d3dDevice->CreateBuffer( &constantBufferDesc, nullptr, &m_d3dPerFrameConstantBuffer );
-    if ( FAILED(hr) )
-    {
-        MessageBoxA( m_Window.get_WindowHandle(), "Failed to create constant buffer for per-frame data.", "Error", MB_OK|MB_ICONERROR );
-        return false;
-    }
-
-    // Create a constant buffer for the per-object data required by teh simple vertex shader.
-    constantBufferDesc.ByteWidth = sizeof( PerObjectConstantBufferData );
-
-    hr = m_d3dDevice->CreateBuffer( &constantBufferDesc, nullptr, &m_d3dPerObjectConstantBuffer );
-    if ( FAILED(hr) )
+    // The per-frame constants of the instanced vertex shader are written to the constant buffer ring.
+    if ( FAILED( m_d3dDeviceContext.As( &m_d3dDeviceContext1 ) ) || !m_ConstantBufferRing.Initialize( m_d3dDevice.Get(), 64 * 1024 ) )
     {
-        MessageBoxA( m_Window.get_WindowHandle(), "Failed to create constant buffer for per-object data.", "Error", MB_OK|MB_ICONERROR );
+        MessageBoxA( m_Window.get_WindowHandle(), "Failed to create the constant buffer ring (requires Direct3D 11.1 constant buffer offsets).", "Error", MB_OK|MB_ICONERROR );
         return false;
     }
-    
-    // Create a constant buffer for the material properties required by the pixel shader.
-    constantBufferDesc.ByteWidth = sizeof( MaterialProperties );
 
-    hr = m_d3dDevice->CreateBuffer( &constantBufferDesc, nullptr, &m_d3dMaterialPropertiesConstantBuffer );
-    if ( FAILED( hr ) )
+    // The instances of the shapes are written to a dynamic vertex buffer every frame.
+    if ( !m_InstanceStream.Initialize( m_d3dDevice.Get(), 1024 ) )
     {
-        MessageBoxA( m_Window.get_WindowHandle(), "Failed to create constant buffer for material properties.", "Error", MB_OK|MB_ICONERROR );
+        MessageBoxA( m_Window.get_WindowHandle(), "Failed to create the instance buffer for the shapes.", "Error", MB_OK|MB_ICONERROR );
         return false;
     }
 
     // Create a constant buffer for the light properties required by the pixel shader.
+    D3D11_BUFFER_DESC constantBufferDesc;
+    ZeroMemory( &constantBufferDesc, sizeof(D3D11_BUFFER_DESC) );
+
+    constantBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
     constantBufferDesc.ByteWidth = sizeof( LightProperties );
+    constantBufferDesc.CPUAccessFlags = 0;
+    constantBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+
     hr = m_d3dDevice->CreateBuffer( &constantBufferDesc, nullptr, &m_d3dLightPropertiesConstantBuffer );
     if ( FAILED( hr ) )
     {
@@ -362,28 +419,29 @@ bool TextureAndLightingDemo::LoadContent()
     // Global ambient
     m_LightProperties.GlobalAmbient = XMFLOAT4( 0.2f, 0.2f, 0.2f, 1.0f );
 
-    m_Sphere = Mesh::CreateSphere( m_d3dDeviceContext.Get(), 1.0f, 16, false );
-    m_Cube = Mesh::CreateCube( m_d3dDeviceContext.Get(), 1.0f, false );
-    m_Cone = Mesh::CreateCone( m_d3dDeviceContext.Get(), 1.0f, 1.0f, 32, false );
-    m_Torus = Mesh::CreateTorus( m_d3dDeviceContext.Get(), 1.0f, 0.33f, 32, false );
+    ID3D11DeviceContext* deviceContext = m_d3dDeviceContext.Get();
 
-    // Load a simple vertex shader that will be used to render the shapes.
-    hr = m_d3dDevice->CreateVertexShader( g_SimpleVertexShader, sizeof(g_SimpleVertexShader), nullptr, &m_d3dSimplVertexShader );
-    if ( FAILED(hr) )
+    m_Sphere = LoadOrCreateMesh( deviceContext, GeometryKey::MakeSphere( 1.0f, 16 ), false, Mesh::OptimizeForVertexCache | Mesh::WeldDuplicateVertices, 3 );
+    m_Cube = LoadOrCreateMesh( deviceContext, GeometryKey::MakeCube( 1.0f ), false, Mesh::DefaultFlags, 1 );
+    m_Cone = LoadOrCreateMesh( deviceContext, GeometryKey::MakeCone( 1.0f, 1.0f, 32 ), false, Mesh::OptimizeForVertexCache, 4 );
+    m_Torus = LoadOrCreateMesh( deviceContext, GeometryKey::MakeTorus( 1.0f, 0.33f, 32 ), false, Mesh::OptimizeForVertexCache, 1 );
+
+    // Pack all shapes into a single vertex and index buffer so they can be drawn without rebinding the buffers.
+    try
     {
-        MessageBoxA(m_Window.get_WindowHandle(), "Failed to create the simple vertex shader.", "Error", MB_OK|MB_ICONERROR );
-        return false;
+        m_MeshBufferPool = MeshBufferPool::Create( m_d3dDevice.Get(), sizeof(VertexPositionNormalTexture), DXGI_FORMAT_R16_UINT, 16384, 65536 );
+        m_Sphere->MoveToBufferPool( deviceContext, m_MeshBufferPool );
+        m_Cube->MoveToBufferPool( deviceContext, m_MeshBufferPool );
+        m_Cone->MoveToBufferPool( deviceContext, m_MeshBufferPool );
+        m_Torus->MoveToBufferPool( deviceContext, m_MeshBufferPool );
     }
-
-    // Create the input layout for the simple shapes.
-    hr = m_d3dDevice->CreateInputLayout( VertexPositionNormalTexture::InputElements, VertexPositionNormalTexture::InputElementCount, g_SimpleVertexShader, sizeof(g_SimpleVertexShader), &m_d3dVertexPositionNormalTextureInputLayout );
-    if ( FAILED(hr) )
+    catch ( std::exception& )
     {
-        MessageBoxA(m_Window.get_WindowHandle(), "Failed to create the input layout for the simple vertex shader.", "Error", MB_OK|MB_ICONERROR );
+        MessageBoxA(m_Window.get_WindowHandle(), "Failed to create the mesh buffer pool.", "Error", MB_OK|MB_ICONERROR );
         return false;
     }
-    
-    
+
+
     // Force a resize event so the camera's projection matrix gets initialized.
     ResizeEventArgs resizeEventArgs( m_Window.get_ClientWidth(), m_Window.get_ClientHeight() );
     OnResize( resizeEventArgs );
@@ -393,15 +451,32 @@ bool TextureAndLightingDemo::LoadContent()
 
 void TextureAndLightingDemo::OnUpdate( UpdateEventArgs& e )
 {
-    float speedMultipler = ( m_bShift ? 8.0f : 4.0f );
+    PROFILE_FUNCTION();
+
+    // OnRender moves the camera to the interpolated pose. Continue from the last updated pose.
+    m_Camera.set_Translation( pData->m_CurrentCameraPos );
+    m_Camera.set_Rotation( pData->m_CurrentCameraRot );
+
+    // The camera follows the recorded path instead of the user input while it is playing.
+    if ( !m_CameraPathPlayer.Update( m_Camera, e.ElapsedTime ) )
+    {
+        float speedMultipler = ( m_bShift ? 8.0f : 4.0f );
+
+        XMVECTOR cameraTranslate = XMVectorSet( static_cast<float>(m_D - m_A), 0.0f, static_cast<float>(m_W - m_S), 1.0f ) * speedMultipler * e.ElapsedTime;
+        XMVECTOR cameraPan = XMVectorSet( 0.0f, static_cast<float>(m_E - m_Q), 0.0f, 1.0f ) * speedMultipler * e.ElapsedTime;
+        m_Camera.Translate( cameraTranslate, Camera::LocalSpace );
+        m_Camera.Translate( cameraPan, Camera::WorldSpace );
+
+        XMVECTOR cameraRotation = XMQuaternionRotationRollPitchYaw( XMConvertToRadians(m_Pitch), XMConvertToRadians(m_Yaw), 0.0f );
+        m_Camera.set_Rotation( cameraRotation );
+    }
 
-    XMVECTOR cameraTranslate = XMVectorSet( static_cast<float>(m_D - m_A), 0.0f, static_cast<float>(m_W - m_S), 1.0f ) * speedMultipler * e.ElapsedTime;
-    XMVECTOR cameraPan = XMVectorSet( 0.0f, static_cast<float>(m_E - m_Q), 0.0f, 1.0f ) * speedMultipler * e.ElapsedTime;
-    m_Camera.Translate( cameraTranslate, Camera::LocalSpace );
-    m_Camera.Translate( cameraPan, Camera::WorldSpace );
+    m_CameraPathRecorder.Record( m_Camera, e.ElapsedTime );
 
-    XMVECTOR cameraRotation = XMQuaternionRotationRollPitchYaw( XMConvertToRadians(m_Pitch), XMConvertToRadians(m_Yaw), 0.0f );
-    m_Camera.set_Rotation( cameraRotation );
+    pData->m_PreviousCameraPos = pData->m_CurrentCameraPos;
+    pData->m_PreviousCameraRot = pData->m_CurrentCameraRot;
+    pData->m_CurrentCameraPos = m_Camera.get_Translation();
+    pData->m_CurrentCameraRot = m_Camera.get_Rotation();
 
     // Update the light properties
     XMStoreFloat4( &m_LightProperties.EyePosition, m_Camera.get_Translation() );
@@ -471,157 +546,306 @@ XMMATRIX XM_CALLCONV LookAtMatrix( FXMVECTOR Position, FXMVECTOR Direction, FXMV
     return M;
 }
 
+// The layers of the render queue.
+enum RenderLayer
+{
+    ShapeLayer,
+    RoomLayer,
+};
+
+// The meshes in the mesh field of the render keys.
+enum MeshId
+{
+    PlaneMesh,
+    SphereMesh,
+    CubeMesh,
+    ConeMesh,
+    TorusMesh,
+};
+
+// A shape that is submitted to the render queue.
+struct ShapeDraw
+{
+    Mesh* pMesh;
+    UINT MeshId;
+    size_t LevelOfDetail;
+    XMMATRIX WorldMatrix;
+    UINT MaterialIndex;
+};
+
 void TextureAndLightingDemo::OnRender( RenderEventArgs& e )
 {
-    Clear( DirectX::Colors::CornflowerBlue, 1.0f, 0 );
+    PROFILE_FUNCTION();
+
+    // Render the camera between the last two updates when the application uses a fixed timestep.
+    m_Camera.set_Translation( XMVectorLerp( pData->m_PreviousCameraPos, pData->m_CurrentCameraPos, e.Alpha ) );
+    m_Camera.set_Rotation( XMQuaternionSlerp( pData->m_PreviousCameraRot, pData->m_CurrentCameraRot, e.Alpha ) );
+
+    Clear( DirectX::Colors::CornflowerBlue, m_Camera.get_DepthClearValue(), 0 );
     
     float aspectRatio = m_Window.get_ClientWidth() / (float)m_Window.get_ClientHeight();
 
-    XMMATRIX viewMatrix = m_Camera.get_ViewMatrix();
-    XMMATRIX projectionMatrix = m_Camera.get_ProjectionMatrix();
-    XMMATRIX viewProjectionMatrix = viewMatrix * projectionMatrix;
+    XMMATRIX viewProjectionMatrix = m_Camera.get_ViewProjectionMatrix();
 
-    PerFrameConstantBufferData constantBufferData;
-    constantBufferData.ViewProjectionMatrix = viewProjectionMatrix;
+    // Compute the world matrices of the shapes and cull their bounding boxes against the view frustum.
+    XMMATRIX sphereWorldMatrix = XMMatrixScaling( 4.0f, 4.0f, 4.0f ) * XMMatrixTranslation( -4.0f, 2.0f, -4.0f );
+    XMMATRIX cubeWorldMatrix = XMMatrixScaling( 4.0f, 8.0f, 4.0f ) * XMMatrixRotationY( XMConvertToRadians(45.0f) ) * XMMatrixTranslation( 4.0f, 4.0f, 4.0f );
+    XMMATRIX torusWorldMatrix = XMMatrixScaling( 4.0f, 4.0f, 4.0f ) * XMMatrixRotationY( XMConvertToRadians(45.0f) ) * XMMatrixTranslation( 4.0f, 0.5f, -4.0f );
+    XMMATRIX lightWorldMatrices[MAX_LIGHTS];
 
-    MaterialProperties wallMaterial = m_MaterialProperties[1];
-    wallMaterial.Material.UseTexture = true;
+    m_FrustumCuller.Clear();
+    size_t sphereBox = m_FrustumCuller.AddBox( m_Sphere->get_BoundingBox(), sphereWorldMatrix );
+    size_t cubeBox = m_FrustumCuller.AddBox( m_Cube->get_BoundingBox(), cubeWorldMatrix );
+    size_t torusBox = m_FrustumCuller.AddBox( m_Torus->get_BoundingBox(), torusWorldMatrix );
+    size_t lightBoxes[MAX_LIGHTS];
 
-    m_d3dDeviceContext->UpdateSubresource( m_d3dPerFrameConstantBuffer.Get(), 0, nullptr, &constantBufferData, 0, 0 );
-    m_d3dDeviceContext->UpdateSubresource( m_d3dMaterialPropertiesConstantBuffer.Get(), 0, nullptr, &wallMaterial, 0, 0 );
+    for ( int i = 0; i < MAX_LIGHTS; ++i )
+    {
+        Light* pLight = &(m_LightProperties.Lights[i]);
 
-    const UINT vertexStride[2] = { sizeof(VertexPosNormTex), sizeof(PlaneInstanceData) };
-    const UINT offset[2] = { 0, 0 };
-    ID3D11Buffer* buffers[2] = { m_d3dPlaneVertexBuffer.Get(), m_d3dPlaneInstanceBuffer.Get() };
+        XMVECTOR lightPos = XMLoadFloat4( &(pLight->Position) );
+        XMVECTOR lightDir = XMLoadFloat4( &(pLight->Direction) );
+        XMVECTOR UpDirection = XMVectorSet( 0, 1, 0, 0 );
 
-    m_d3dDeviceContext->IASetVertexBuffers( 0, 2, buffers, vertexStride, offset );
-    m_d3dDeviceContext->IASetInputLayout( m_d3dInstancedInputLayout.Get() );
-    m_d3dDeviceContext->IASetIndexBuffer( m_d3dPlaneIndexBuffer.Get(), DXGI_FORMAT_R16_UINT, 0 );
-    m_d3dDeviceContext->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+        lightWorldMatrices[i] = XMMatrixRotationX( -90.0f ) * LookAtMatrix( lightPos, lightDir, UpDirection );
 
-    m_d3dDeviceContext->RSSetState( m_d3dRasterizerState.Get() );
-    D3D11_VIEWPORT viewport = m_Camera.get_Viewport();
-    m_d3dDeviceContext->RSSetViewports( 1, &viewport ); 
+        const Mesh* lightMesh = ( pLight->LightType == PointLight ) ? m_Sphere.get() : m_Cone.get();
+        lightBoxes[i] = m_FrustumCuller.AddBox( lightMesh->get_BoundingBox(), lightWorldMatrices[i] );
+
+        // The light geometry glows in the color of the light. The material is only uploaded when the color changes.
+        _Material lightMaterial;
+        lightMaterial.Emissive = pLight->Color;
+        m_MaterialTable.Set( LightMaterial + i, lightMaterial );
+    }
+
+    m_FrustumCuller.Cull( m_Camera, &get_JobSystem() );
 
-    m_d3dDeviceContext->VSSetShader( m_d3dInstancedVertexShader.Get(), nullptr, 0 );
-    m_d3dDeviceContext->VSSetConstantBuffers( 0, 1, m_d3dPerFrameConstantBuffer.GetAddressOf() );
+    // Report the culling throughput about once per second.
+    if ( m_CullingReportStream )
+    {
+        m_CullingReportTime += e.ElapsedTime;
+        if ( m_CullingReportTime >= 1.0f )
+        {
+            *m_CullingReportStream << "Frustum culling: " << m_FrustumCuller.get_VisibleBoxes().size() << "/" << m_FrustumCuller.get_BoxCount()
+                << " boxes visible, " << m_FrustumCuller.get_BoxesPerMillisecond() << " boxes/ms" << std::endl;
+            m_CullingReportTime = 0.0f;
+        }
+    }
 
-    m_d3dDeviceContext->PSSetShader( m_d3dTexturedLitPixelShader.Get(), nullptr, 0 );
+    // Only the materials that have changed since the last frame are uploaded.
+    m_MaterialTable.Upload( m_d3dDeviceContext.Get() );
 
-    ID3D11Buffer* pixelShaderConstantBuffers[2] = { m_d3dMaterialPropertiesConstantBuffer.Get(), m_d3dLightPropertiesConstantBuffer.Get() };
-    m_d3dDeviceContext->PSSetConstantBuffers( 0, 2, pixelShaderConstantBuffers );
+    // The per-frame constants are written to the constant buffer ring.
+    const UINT perFrameSize = ConstantBufferRing::get_AlignedSize( sizeof(PerFrameConstantBufferData) );
 
-    m_d3dDeviceContext->PSSetSamplers( 0, 1, m_d3dSamplerState.GetAddressOf() );
-    m_d3dDeviceContext->PSSetShaderResources( 0, 1, m_DirectXTexture.GetAddressOf() );
+    m_ConstantBufferRing.BeginFrame( m_d3dDeviceContext.Get() );
 
-    m_d3dDeviceContext->OMSetRenderTargets( 1, m_d3dRenderTargetView.GetAddressOf(), m_d3dDepthStencilView.Get() );
-    m_d3dDeviceContext->OMSetDepthStencilState( m_d3dDepthStencilState.Get(), 0 );
+    UINT perFrameOffset;
+    PerFrameConstantBufferData* pPerFrameData = static_cast<PerFrameConstantBufferData*>( m_ConstantBufferRing.Map( m_d3dDeviceContext.Get(), perFrameSize, perFrameOffset ) );
+    if ( !pPerFrameData )
+    {
+        // Skip the frame if the constants can't be written.
+        m_ConstantBufferRing.EndFrame( m_d3dDeviceContext.Get() );
+        Present();
+        return;
+    }
 
-    m_d3dDeviceContext->DrawIndexedInstanced( _countof(g_PlaneIndex), m_NumInstances, 0, 0, 0 );
+    pPerFrameData->ViewProjectionMatrix = viewProjectionMatrix;
 
-    // Draw the sphere
-    XMMATRIX translationMatrix = XMMatrixTranslation( -4.0f, 2.0f, -4.0f );
-    XMMATRIX rotationMatrix = XMMatrixIdentity();
-    XMMATRIX scaleMatrix = XMMatrixScaling( 4.0f, 4.0f, 4.0f );
-    XMMATRIX worldMatrix = scaleMatrix * rotationMatrix * translationMatrix;
+    m_ConstantBufferRing.Unmap( m_d3dDeviceContext.Get() );
 
-    PerObjectConstantBufferData perObjectConstantBufferData;
-    perObjectConstantBufferData.WorldMatrix = worldMatrix;
-    perObjectConstantBufferData.InverseTransposeWorldMatrix = XMMatrixTranspose( XMMatrixInverse(nullptr, worldMatrix) );
-    perObjectConstantBufferData.WorldViewProjectionMatrix = worldMatrix * viewProjectionMatrix;
+    // Collect the visible shapes and submit them to the render queue.
+    ShapeDraw shapeDraws[3 + MAX_LIGHTS];
+    UINT shapeDrawCount = 0;
 
-    m_d3dDeviceContext->UpdateSubresource( m_d3dPerObjectConstantBuffer.Get(), 0, nullptr, &perObjectConstantBufferData, 0, 0 );
+    if ( m_FrustumCuller.IsVisible( sphereBox ) )
+    {
+        ShapeDraw draw = { m_Sphere.get(), SphereMesh, 0, sphereWorldMatrix, EarthMaterial };
+        shapeDraws[shapeDrawCount++] = draw;
+    }
 
-    MaterialProperties sphereMaterial = m_MaterialProperties[0];
-    sphereMaterial.Material.UseTexture = true;
+    if ( m_FrustumCuller.IsVisible( cubeBox ) )
+    {
+        ShapeDraw draw = { m_Cube.get(), CubeMesh, 0, cubeWorldMatrix, RedPlasticMaterial };
+        shapeDraws[shapeDrawCount++] = draw;
+    }
 
-    m_d3dDeviceContext->UpdateSubresource( m_d3dMaterialPropertiesConstantBuffer.Get(), 0, nullptr, &sphereMaterial, 0, 0 );
-    
-    m_d3dDeviceContext->VSSetShader( m_d3dSimplVertexShader.Get(), nullptr, 0 );
-    m_d3dDeviceContext->VSSetConstantBuffers( 0, 1, m_d3dPerObjectConstantBuffer.GetAddressOf() );
-    
-    m_d3dDeviceContext->PSSetShaderResources( 0, 1, m_EarthTexture.GetAddressOf() );
+    if ( m_FrustumCuller.IsVisible( torusBox ) )
+    {
+        ShapeDraw draw = { m_Torus.get(), TorusMesh, 0, torusWorldMatrix, PearlMaterial };
+        shapeDraws[shapeDrawCount++] = draw;
+    }
 
-    m_d3dDeviceContext->IASetInputLayout( m_d3dVertexPositionNormalTextureInputLayout.Get() );
+    // Draw geometry at the position of the active lights in the scene.
+    for ( int i = 0; i < MAX_LIGHTS; ++i )
+    {
+        Light* pLight = &(m_LightProperties.Lights[i]);
+        if ( !pLight->Enabled || !m_FrustumCuller.IsVisible( lightBoxes[i] ) ) continue;
 
-    m_Sphere->Draw( m_d3dDeviceContext.Get() );
+        XMVECTOR lightPos = XMLoadFloat4( &(pLight->Position) );
+        bool pointLight = ( pLight->LightType == PointLight );
+        Mesh* lightMesh = pointLight ? m_Sphere.get() : m_Cone.get();
 
-    // Draw a cube
-    translationMatrix = XMMatrixTranslation( 4.0f, 4.0f, 4.0f );
-    rotationMatrix = XMMatrixRotationY( XMConvertToRadians(45.0f) );
-    scaleMatrix = XMMatrixScaling( 4.0f, 8.0f, 4.0f );
-    worldMatrix = scaleMatrix * rotationMatrix * translationMatrix;
+        size_t levelOfDetail = lightMesh->SelectLevelOfDetail( m_Camera, lightPos, lightMesh->get_BoundingSphere().Radius );
+        ShapeDraw draw = { lightMesh, pointLight ? SphereMesh : ConeMesh, levelOfDetail, lightWorldMatrices[i], LightMaterial + i };
+        shapeDraws[shapeDrawCount++] = draw;
+    }
 
-    perObjectConstantBufferData.WorldMatrix = worldMatrix;
-    perObjectConstantBufferData.InverseTransposeWorldMatrix = XMMatrixTranspose( XMMatrixInverse(nullptr, worldMatrix) );
-    perObjectConstantBufferData.WorldViewProjectionMatrix = worldMatrix * viewProjectionMatrix;
+    // All draws use the same shaders. The materials are selected per instance from the material
+    // table and don't change any state, so the material field of the keys is not used.
+    XMMATRIX viewMatrix = m_Camera.get_ViewMatrix();
 
-    m_d3dDeviceContext->UpdateSubresource( m_d3dPerObjectConstantBuffer.Get(), 0, nullptr, &perObjectConstantBufferData, 0, 0 );
+    m_RenderQueue.Clear();
+    for ( UINT i = 0; i < shapeDrawCount; ++i )
+    {
+        float depth = XMVectorGetZ( XMVector3Transform( shapeDraws[i].WorldMatrix.r[3], viewMatrix ) );
+        m_RenderQueue.Submit( RenderKey( ShapeLayer, false, 0, 0, shapeDraws[i].MeshId, RenderKey::QuantizeDepth( depth ) ), i );
+    }
 
-    m_d3dDeviceContext->UpdateSubresource( m_d3dMaterialPropertiesConstantBuffer.Get(), 0, nullptr, &m_MaterialProperties[2], 0, 0 );
+    // The room is drawn after the shapes, so the parts of the walls behind the shapes fail the depth test.
+    m_RenderQueue.Submit( RenderKey( RoomLayer, false, 0, 0, PlaneMesh, 0 ), 0 );
 
-    m_Cube->Draw( m_d3dDeviceContext.Get() );
+    m_RenderQueue.Sort();
 
-    // Draw a torus
-    translationMatrix = XMMatrixTranslation( 4.0f, 0.5f, -4.0f );
-    rotationMatrix = XMMatrixRotationY( XMConvertToRadians(45.0f) );
-    scaleMatrix = XMMatrixScaling( 4.0f, 4.0f, 4.0f );
-    worldMatrix = scaleMatrix * rotationMatrix * translationMatrix;
+    // The state that is shared by all draws.
+    m_d3dDeviceContext->IASetInputLayout( m_d3dInstancedInputLayout.Get() );
 
-    perObjectConstantBufferData.WorldMatrix = worldMatrix;
-    perObjectConstantBufferData.InverseTransposeWorldMatrix = XMMatrixTranspose( XMMatrixInverse(nullptr, worldMatrix) );
-    perObjectConstantBufferData.WorldViewProjectionMatrix = worldMatrix * viewProjectionMatrix;
+    m_d3dDeviceContext->RSSetState( m_d3dRasterizerState.Get() );
+    D3D11_VIEWPORT viewport = m_Camera.get_Viewport();
+    m_d3dDeviceContext->RSSetViewports( 1, &viewport ); 
 
-    m_d3dDeviceContext->UpdateSubresource( m_d3dPerObjectConstantBuffer.Get(), 0, nullptr, &perObjectConstantBufferData, 0, 0 );
-    m_d3dDeviceContext->UpdateSubresource( m_d3dMaterialPropertiesConstantBuffer.Get(), 0, nullptr, &m_MaterialProperties[3], 0, 0 );
+    m_d3dDeviceContext->PSSetConstantBuffers( 1, 1, m_d3dLightPropertiesConstantBuffer.GetAddressOf() );
+    m_d3dDeviceContext->PSSetSamplers( 0, 1, m_d3dSamplerState.GetAddressOf() );
+    ID3D11ShaderResourceView* materialTable = m_MaterialTable.get_ShaderResourceView();
+    m_d3dDeviceContext->PSSetShaderResources( 1, 1, &materialTable );
 
-    m_Torus->Draw( m_d3dDeviceContext.Get() );
+    m_d3dDeviceContext->OMSetRenderTargets( 1, m_d3dRenderTargetView.GetAddressOf(), m_d3dDepthStencilView.Get() );
+    m_d3dDeviceContext->OMSetDepthStencilState( m_d3dDepthStencilState.Get(), 0 );
 
-    // Draw geometry at the position of the active lights in the scene.
-    MaterialProperties lightMaterial = m_MaterialProperties[0];
-    for ( int i = 0; i < MAX_LIGHTS; ++i )
+    // Dispatch the draws in key order. The instances of consecutive draws of the same mesh
+    // are batched and drawn when the mesh changes.
+    Mesh* pBatchMesh = nullptr;
+
+    m_RenderQueue.Dispatch( [&]( const RenderItem& item, unsigned int changes )
     {
-        Light* pLight = &(m_LightProperties.Lights[i]);
-        if ( !pLight->Enabled ) continue;
+        RenderKey key = RenderKey::Unpack( item.Key );
 
-        XMVECTOR lightPos = XMLoadFloat4( &(pLight->Position) );
-        XMVECTOR lightDir = XMLoadFloat4( &(pLight->Direction) );
-        XMVECTOR UpDirection = XMVectorSet( 0, 1, 0, 0 );
+        if ( pBatchMesh && ( changes & ( RenderKey::LayerChanged | RenderKey::MeshChanged ) ) )
+        {
+            pBatchMesh->SubmitInstances( m_d3dDeviceContext.Get(), m_InstanceStream );
+            pBatchMesh = nullptr;
+        }
 
-        scaleMatrix = XMMatrixScaling( 1.0f, 1.0f, 1.0f );
-        rotationMatrix = XMMatrixRotationX( -90.0f );
-        worldMatrix = scaleMatrix * rotationMatrix * LookAtMatrix( lightPos, lightDir, UpDirection );
+        if ( changes & RenderKey::ShaderChanged )
+        {
+            m_d3dDeviceContext->VSSetShader( m_d3dInstancedVertexShader.Get(), nullptr, 0 );
+            m_ConstantBufferRing.VSSetConstantBuffer( m_d3dDeviceContext1.Get(), 0, perFrameOffset, sizeof(PerFrameConstantBufferData) );
+            m_d3dDeviceContext->PSSetShader( m_d3dTexturedLitPixelShader.Get(), nullptr, 0 );
+        }
 
-        perObjectConstantBufferData.WorldMatrix = worldMatrix;
-        perObjectConstantBufferData.InverseTransposeWorldMatrix = XMMatrixTranspose( XMMatrixInverse(nullptr, worldMatrix) );
-        perObjectConstantBufferData.WorldViewProjectionMatrix = worldMatrix * viewProjectionMatrix;
+        if ( key.Layer == RoomLayer )
+        {
+            const UINT vertexStride[2] = { sizeof(VertexPosNormTex), sizeof(MeshInstance) };
+            const UINT offset[2] = { 0, 0 };
+            ID3D11Buffer* buffers[2] = { m_d3dPlaneVertexBuffer.Get(), m_d3dPlaneInstanceBuffer.Get() };
+
+            m_d3dDeviceContext->IASetVertexBuffers( 0, 2, buffers, vertexStride, offset );
+            m_d3dDeviceContext->IASetIndexBuffer( m_d3dPlaneIndexBuffer.Get(), DXGI_FORMAT_R16_UINT, 0 );
+            m_d3dDeviceContext->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+            m_d3dDeviceContext->PSSetShaderResources( 0, 1, m_DirectXTexture.GetAddressOf() );
 
-        lightMaterial.Material.Emissive = pLight->Color;
+            m_d3dDeviceContext->DrawIndexedInstanced( _countof(g_PlaneIndex), m_NumInstances, 0, 0, 0 );
+            return;
+        }
 
-        m_d3dDeviceContext->UpdateSubresource( m_d3dPerObjectConstantBuffer.Get(), 0, nullptr, &perObjectConstantBufferData, 0, 0 );
-        m_d3dDeviceContext->UpdateSubresource( m_d3dMaterialPropertiesConstantBuffer.Get(), 0, nullptr, &lightMaterial, 0, 0 );
-        switch( pLight->LightType )
+        if ( changes & RenderKey::LayerChanged )
         {
-        case PointLight:
-            {
-                m_Sphere->Draw( m_d3dDeviceContext.Get() );
-            }
-            break;
-        case DirectionalLight:
-        case SpotLight:
-            {
-                m_Cone->Draw( m_d3dDeviceContext.Get() );
-            }
-            break;
+            // The shapes share the buffers of the pool. Only the earth material samples the texture.
+            m_MeshBufferPool->Bind( m_d3dDeviceContext.Get() );
+            m_InstanceStream.Bind( m_d3dDeviceContext.Get() );
+            m_d3dDeviceContext->PSSetShaderResources( 0, 1, m_EarthTexture.GetAddressOf() );
         }
+
+        const ShapeDraw& draw = shapeDraws[item.Data];
+        draw.pMesh->AddInstance( draw.WorldMatrix, draw.MaterialIndex, draw.LevelOfDetail );
+        pBatchMesh = draw.pMesh;
+    } );
+
+    if ( pBatchMesh )
+    {
+        pBatchMesh->SubmitInstances( m_d3dDeviceContext.Get(), m_InstanceStream );
     }
 
+    m_ConstantBufferRing.EndFrame( m_d3dDeviceContext.Get() );
+
     Present();
 }
 
+// Measure how culling and transforming a large number of objects scales from 1 to all hardware threads.
+// The results are written to a CSV file (one line per thread count).
+static bool RunJobSystemBenchmark( const Camera& camera )
+{
+    static const size_t ObjectCount = 1 << 20;
+    static const int Repetitions = 10;
+
+    std::mt19937 random;
+    std::uniform_real_distribution<float> position( -500.0f, 500.0f );
+    std::uniform_real_distribution<float> extent( 0.1f, 5.0f );
+
+    FrustumCuller frustumCuller;
+    std::vector<XMFLOAT3> points( ObjectCount );
+    for ( size_t i = 0; i < ObjectCount; ++i )
+    {
+        points[i] = XMFLOAT3( position( random ), position( random ), position( random ) );
+        frustumCuller.AddBox( BoundingBox( points[i], XMFLOAT3( extent( random ), extent( random ), extent( random ) ) ) );
+    }
+    std::vector<XMFLOAT3> transformedPoints( ObjectCount );
+    XMFLOAT4X4 viewProjectionMatrix;
+    XMStoreFloat4x4( &viewProjectionMatrix, camera.get_ViewProjectionMatrix() );
+
+    std::ofstream file( L"JobSystemScaling.csv" );
+    file << "Threads,FrustumCulling (ms),TransformPoints (ms)\n";
+
+    size_t maxThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 1 );
+    for ( size_t threadCount = 1; threadCount <= maxThreadCount; ++threadCount )
+    {
+        JobSystem jobSystem( threadCount );
+
+        double startTime = HighResolutionClock::get_CurrentSeconds();
+        for ( int i = 0; i < Repetitions; ++i )
+        {
+            frustumCuller.Cull( camera, &jobSystem );
+        }
+        double cullingTime = ( HighResolutionClock::get_CurrentSeconds() - startTime ) * 1000.0 / Repetitions;
+
+        startTime = HighResolutionClock::get_CurrentSeconds();
+        for ( int i = 0; i < Repetitions; ++i )
+        {
+            jobSystem.ParallelFor( 0, ObjectCount, 4096, [&]( size_t begin, size_t end )
+            {
+                XMMATRIX matrix = XMLoadFloat4x4( &viewProjectionMatrix );
+                XMVector3TransformCoordStream( &transformedPoints[begin], sizeof(XMFLOAT3), &points[begin], sizeof(XMFLOAT3), end - begin, matrix );
+            } );
+        }
+        double transformTime = ( HighResolutionClock::get_CurrentSeconds() - startTime ) * 1000.0 / Repetitions;
+
+        file << threadCount << "," << cullingTime << "," << transformTime << "\n";
+    }
+
+    return static_cast<bool>( file );
+}
+
 void TextureAndLightingDemo::UnloadContent()
 {
+    // Keep the frame statistics of the session.
+    m_FrameStatistics.SaveCsv( L"FrameStatistics.csv" );
+    m_FrameStatistics.SaveJson( L"FrameStatistics.json" );
+}
 
+void TextureAndLightingDemo::set_CullingReportStream( std::ostream* stream )
+{
+    m_CullingReportStream = stream;
+    m_CullingReportTime = 0.0f;
 }
 
 void TextureAndLightingDemo::OnKeyPressed( KeyEventArgs& e )
@@ -675,6 +899,8 @@ void TextureAndLightingDemo::OnKeyPressed( KeyEventArgs& e )
             // Reset camera position and orientation
             m_Camera.set_Translation( pData->m_InitialCameraPos );
             m_Camera.set_Rotation( pData->m_InitialCameraRot );
+            pData->m_PreviousCameraPos = pData->m_CurrentCameraPos = pData->m_InitialCameraPos;
+            pData->m_PreviousCameraRot = pData->m_CurrentCameraRot = pData->m_InitialCameraRot;
             m_Pitch = 0.0f;
             m_Yaw = 0.0f;
         }
@@ -689,6 +915,76 @@ void TextureAndLightingDemo::OnKeyPressed( KeyEventArgs& e )
             m_bAnimate = !m_bAnimate;
         }
         break;
+    case KeyCode::F5:
+        {
+            // Toggle recording of the camera path.
+            if ( m_CameraPathRecorder.IsRecording() )
+            {
+                m_CameraPathRecorder.Stop( m_Camera );
+                try
+                {
+                    m_CameraPathRecorder.get_Path().Save( L"CameraPath.path" );
+                }
+                catch ( std::exception& )
+                {
+                    MessageBoxA( m_Window.get_WindowHandle(), "Failed to save the camera path.", "Error", MB_OK|MB_ICONERROR );
+                }
+            }
+            else
+            {
+                m_CameraPathPlayer.Stop();
+                m_CameraPathRecorder.Start();
+            }
+        }
+        break;
+    case KeyCode::F6:
+        {
+            // Toggle playback of the recorded camera path.
+            if ( m_CameraPathPlayer.IsPlaying() )
+            {
+                m_CameraPathPlayer.Stop();
+            }
+            else if ( !m_CameraPathRecorder.IsRecording() )
+            {
+                try
+                {
+                    m_CameraPath.Load( L"CameraPath.path" );
+                    m_CameraPathPlayer.Play( m_CameraPath );
+                }
+                catch ( std::exception& )
+                {
+                    MessageBoxA( m_Window.get_WindowHandle(), "Failed to load the camera path.", "Error", MB_OK|MB_ICONERROR );
+                }
+            }
+        }
+        break;
+    case KeyCode::F7:
+        {
+            // Save the statistics of the last frames.
+            if ( !m_FrameStatistics.SaveCsv( L"FrameStatistics.csv" ) || !m_FrameStatistics.SaveJson( L"FrameStatistics.json" ) )
+            {
+                MessageBoxA( m_Window.get_WindowHandle(), "Failed to save the frame statistics.", "Error", MB_OK|MB_ICONERROR );
+            }
+        }
+        break;
+    case KeyCode::F8:
+        {
+            // Save the profiled scopes for chrome://tracing.
+            if ( !Profiler::SaveChromeTrace( L"Profile.json" ) )
+            {
+                MessageBoxA( m_Window.get_WindowHandle(), "Failed to save the profile.", "Error", MB_OK|MB_ICONERROR );
+            }
+        }
+        break;
+    case KeyCode::F9:
+        {
+            // Measure the scaling of the job system from 1 to N threads.
+            if ( !RunJobSystemBenchmark( m_Camera ) )
+            {
+                MessageBoxA( m_Window.get_WindowHandle(), "Failed to save the job system benchmark.", "Error", MB_OK|MB_ICONERROR );
+            }
+        }
+        break;
     }
 }
 
@@ -1,26 +1,183 @@
 #include <TextureAndLightingPCH.h>
 #include <Application.h>
 #include <Window.h>
+#include <HeadlessRunner.h>
+#include <RenderQueue.h>
+#include <StateFilteringDeviceContext.h>
+#include <HighResolutionClock.h>
 
 #include <TextureAndLightingDemo.h>
 
+#include <random>
+
 const char* g_windowName = "Texture and Lighting Demo";
 int g_WindowWidth = 800;
 int g_WindowHeight = 600;
 bool g_VSync = false;
 bool g_Windowed = true;
 
+// Measure sorting and dispatching a large render queue. The draws are dispatched to a recording
+// device context without a device, so the state changes in submission order and in key order can be compared.
+static void RunRenderQueueBenchmark( std::ostream& stream )
+{
+    static const UINT ItemCount = 1 << 16;
+    static const int Repetitions = 20;
+
+    std::mt19937 random;
+    std::uniform_int_distribution<UINT> shader( 0, 7 );
+    std::uniform_int_distribution<UINT> material( 0, 255 );
+    std::uniform_int_distribution<UINT> mesh( 0, 63 );
+    std::uniform_real_distribution<float> depth( 0.1f, 1000.0f );
+    std::bernoulli_distribution translucent( 0.1 );
+
+    std::vector<uint64_t> keys( ItemCount );
+    for ( uint64_t& key : keys )
+    {
+        key = RenderKey( 0, translucent( random ), shader( random ), material( random ), mesh( random ), RenderKey::QuantizeDepth( depth( random ) ) ).Pack();
+    }
+
+    RenderQueue renderQueue;
+    renderQueue.Reserve( ItemCount );
+    std::vector<RenderItem> items( ItemCount );
+
+    double radixSortTime = 0.0;
+    double stdSortTime = 0.0;
+    for ( int i = 0; i < Repetitions; ++i )
+    {
+        renderQueue.Clear();
+        for ( UINT j = 0; j < ItemCount; ++j )
+        {
+            renderQueue.Submit( keys[j], j );
+            items[j].Key = keys[j];
+            items[j].Data = j;
+        }
+
+        double startTime = HighResolutionClock::get_CurrentSeconds();
+        renderQueue.Sort();
+        radixSortTime += HighResolutionClock::get_CurrentSeconds() - startTime;
+
+        startTime = HighResolutionClock::get_CurrentSeconds();
+        std::sort( items.begin(), items.end(), []( const RenderItem& a, const RenderItem& b ) { return a.Key < b.Key; } );
+        stdSortTime += HighResolutionClock::get_CurrentSeconds() - startTime;
+    }
+
+    // Set only the state that changed between two draws.
+    auto dispatch = []( RecordingDeviceContext* context, const RenderItem& item, unsigned int changes )
+    {
+        ID3D11ShaderResourceView* shaderResourceViews[1] = { nullptr };
+        ID3D11Buffer* vertexBuffers[1] = { nullptr };
+        const UINT strides[1] = { 0 };
+        const UINT offsets[1] = { 0 };
+
+        if ( changes & RenderKey::TranslucencyChanged )
+        {
+            context->OMSetBlendState( nullptr, nullptr, 0xffffffff );
+        }
+        if ( changes & RenderKey::ShaderChanged )
+        {
+            context->VSSetShader( nullptr, nullptr, 0 );
+            context->PSSetShader( nullptr, nullptr, 0 );
+        }
+        if ( changes & RenderKey::MaterialChanged )
+        {
+            context->PSSetShaderResources( 0, 1, shaderResourceViews );
+        }
+        if ( changes & RenderKey::MeshChanged )
+        {
+            context->IASetVertexBuffers( 0, 1, vertexBuffers, strides, offsets );
+        }
+        context->DrawIndexed( 36, 0, 0 );
+    };
+
+    Microsoft::WRL::ComPtr<RecordingDeviceContext> submissionOrderContext;
+    submissionOrderContext.Attach( new RecordingDeviceContext() );
+    Microsoft::WRL::ComPtr<RecordingDeviceContext> keyOrderContext;
+    keyOrderContext.Attach( new RecordingDeviceContext() );
+
+    renderQueue.Clear();
+    for ( UINT j = 0; j < ItemCount; ++j )
+    {
+        renderQueue.Submit( keys[j], j );
+    }
+    renderQueue.Dispatch( [&]( const RenderItem& item, unsigned int changes ) { dispatch( submissionOrderContext.Get(), item, changes ); } );
+
+    renderQueue.Sort();
+    double startTime = HighResolutionClock::get_CurrentSeconds();
+    renderQueue.Dispatch( [&]( const RenderItem& item, unsigned int changes ) { dispatch( keyOrderContext.Get(), item, changes ); } );
+    double dispatchTime = HighResolutionClock::get_CurrentSeconds() - startTime;
+
+    stream << "Render queue benchmark (" << ItemCount << " draws)" << std::endl;
+    stream << "Radix sort: " << radixSortTime * 1000.0 / Repetitions << " ms (" << renderQueue.get_SortPassCount() << " passes)" << std::endl;
+    stream << "std::sort:  " << stdSortTime * 1000.0 / Repetitions << " ms" << std::endl;
+    stream << "Dispatch:   " << dispatchTime * 1000.0 << " ms" << std::endl;
+    stream << std::endl << "Submission order:" << std::endl;
+    submissionOrderContext->Print( stream );
+    stream << std::endl << "Key order:" << std::endl;
+    keyOrderContext->Print( stream );
+}
+
+// Run the demo without a window with "-headless [-frames N]" and print the frame times
+// and the device context calls to the console that started the demo.
+// With "-headless -renderqueue" the render queue benchmark is run instead.
+// With "-headless -cullingreport" the frustum culling statistics are printed once per (simulated) second.
+// With "-statefilter" (also without "-headless") the redundant set calls are filtered,
+// to compare the call counts and frame times.
+int RunHeadless( LPWSTR cmdLine )
+{
+    int frameCount = 1000;
+    const wchar_t* framesArgument = wcsstr( cmdLine, L"-frames" );
+    if ( framesArgument )
+    {
+        swscanf_s( framesArgument, L"-frames %d", &frameCount );
+    }
+
+    if ( AttachConsole( ATTACH_PARENT_PROCESS ) )
+    {
+        FILE* file;
+        freopen_s( &file, "CONOUT$", "w", stdout );
+    }
+
+    if ( wcsstr( cmdLine, L"-renderqueue" ) )
+    {
+        RunRenderQueueBenchmark( std::cout );
+        return 0;
+    }
+
+    HeadlessRunner runner( g_windowName, g_WindowWidth, g_WindowHeight );
+    TextureAndLightingDemo* pDemo = new TextureAndLightingDemo( runner.get_Window() );
+    pDemo->set_FilterRedundantState( wcsstr( cmdLine, L"-statefilter" ) != nullptr );
+    if ( wcsstr( cmdLine, L"-cullingreport" ) )
+    {
+        pDemo->set_CullingReportStream( &std::cout );
+    }
+
+    bool succeeded = runner.Run( *pDemo, std::max( frameCount, 0 ), 1.0f / 60.0f, std::cout );
+
+    delete pDemo;
+
+    return succeeded ? 0 : -1;
+}
+
 int WINAPI wWinMain( HINSTANCE hInstance, HINSTANCE prevInstance, LPWSTR cmdLine, int cmdShow )
 {
     UNREFERENCED_PARAMETER( prevInstance );
-    UNREFERENCED_PARAMETER( cmdLine );
 
     Application::Create(hInstance);
     Application& app = Application::Get();
 
+    if ( wcsstr( cmdLine, L"-headless" ) )
+    {
+        return RunHeadless( cmdLine );
+    }
+
+    // Update the scene at a fixed rate and interpolate the camera when rendering.
+    app.set_LoopMode( Application::FixedTimestep );
+    app.set_FixedTimeStep( 1.0f / 60.0f );
+
     Window& window = app.CreateRenderWindow( g_windowName, g_WindowWidth, g_WindowHeight, g_VSync, g_Windowed );
 
     TextureAndLightingDemo* pDemo = new TextureAndLightingDemo(window);
+    pDemo->set_FilterRedundantState( wcsstr( cmdLine, L"-statefilter" ) != nullptr );
 
     if ( !pDemo->Initialize() )
     {